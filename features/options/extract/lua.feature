@@ -149,3 +149,202 @@ Feature: osrm-extract lua ways:get_nodes()
         When I run "osrm-extract --profile {profile_file} {osm_file} --location-dependent-data test/data/regions/null-island.geojson"
         Then it should exit successfully
         And stdout should contain "answer 42"
+
+    Scenario: osrm-extract location-dependent data via file based locations cache
+        Given the profile file
+        """
+        functions = require('testbot')
+
+        functions.process_way = function(profile, way, result, relations)
+           print ('answer ' .. tostring(way:get_location_tag('answer')))
+           result.forward_mode = mode.driving
+           result.forward_speed = 1
+        end
+
+        return functions
+        """
+        And the node map
+            """
+            a b c
+            """
+        And the ways
+            | nodes |
+            | ab    |
+            | bc    |
+        And the data has been saved to disk
+
+        When I run "osrm-extract --profile {profile_file} {osm_file} --location-dependent-data test/data/regions/null-island.geojson --location-index dense_file"
+        Then it should exit successfully
+        And stdout should contain "answer 42"
+        When I run "osrm-extract --profile {profile_file} {osm_file} --location-dependent-data test/data/regions/null-island.geojson --location-index sparse_file"
+        Then it should exit successfully
+        And stdout should contain "answer 42"
+        When I try to run "osrm-extract --profile {profile_file} {osm_file} --location-index memory"
+        Then it should exit with an error
+
+    Scenario: osrm-extract reuses process_way results for equal tags
+        Given the profile file
+        """
+        functions = require('testbot')
+
+        local setup = functions.setup
+        functions.setup = function()
+          local profile = setup()
+          profile.process_way_cache = true
+          return profile
+        end
+
+        local calls = 0
+        functions.process_way = function(profile, way, result, relations)
+          calls = calls + 1
+          print('process_way call ' .. calls)
+          result.forward_mode = mode.driving
+          result.forward_speed = 1
+        end
+
+        return functions
+        """
+        And the node map
+            """
+            a b c d
+            """
+        And the ways
+            | nodes | highway | name |
+            | ab    | primary | main |
+            | bc    | primary | main |
+            | cd    | primary | main |
+        And the data has been saved to disk
+
+        When I run "osrm-extract --profile {profile_file} {osm_file}"
+        Then it should exit successfully
+        And stdout should contain "process_way call 1"
+        And stdout should not contain "process_way call 2"
+
+    Scenario: osrm-extract reuses process_way results for equal listed tags
+        Given the profile file
+        """
+        functions = require('testbot')
+
+        local setup = functions.setup
+        functions.setup = function()
+          local profile = setup()
+          profile.process_way_cache = {'highway', 'oneway'}
+          return profile
+        end
+
+        local calls = 0
+        functions.process_way = function(profile, way, result, relations)
+          calls = calls + 1
+          print('process_way call ' .. calls)
+          result.forward_mode = mode.driving
+          result.forward_speed = 1
+        end
+
+        return functions
+        """
+        And the node map
+            """
+            a b c d
+            """
+        And the ways
+            | nodes | highway | oneway |
+            | ab    | primary |        |
+            | bc    | primary |        |
+            | cd    | primary | yes    |
+        And the data has been saved to disk
+
+        When I run "osrm-extract --profile {profile_file} {osm_file}"
+        Then it should exit successfully
+        And stdout should contain "process_way call 2"
+        And stdout should not contain "process_way call 3"
+
+    Scenario: osrm-extract passes batches of turns to process_turns
+        Given the profile file
+        """
+        functions = require('testbot')
+
+        local batches = 0
+        functions.process_turns = function(profile, turns)
+          batches = batches + 1
+          print('process_turns batch ' .. batches .. ' turns ' .. #turns)
+          for i = 1, #turns do
+            turns[i].duration = 10
+            turns[i].weight = 10
+          end
+        end
+
+        return functions
+        """
+        And the node map
+            """
+            a b c
+            """
+        And the ways
+            | nodes |
+            | ab    |
+            | bc    |
+        And the data has been saved to disk
+
+        When I run "osrm-extract --profile {profile_file} {osm_file}"
+        Then it should exit successfully
+        And stdout should contain "process_turns batch 1 turns"
+        And stdout should not contain "process_turns batch 2"
+
+        When I route I should get
+            | from | to | route    | time    | weight |
+            | a    | b  | ab,ab    | 10s +-1 | 10     |
+            | a    | c  | ab,bc,bc | 30s +-1 | 30     |
+
+    Scenario: osrm-extract rejects unknown native turn functions
+        Given the profile file
+        """
+        functions = require('testbot')
+
+        local setup = functions.setup
+        functions.setup = function()
+          local profile = setup()
+          profile.native_turn_function = 'bicycle'
+          return profile
+        end
+
+        return functions
+        """
+        And the node map
+            """
+            a b
+            """
+        And the ways
+            | nodes |
+            | ab    |
+        And the data has been saved to disk
+
+        When I try to run "osrm-extract --profile {profile_file} {osm_file}"
+        Then it should exit with an error
+        And stderr should contain "Unknown native turn function bicycle"
+
+    Scenario: osrm-extract rejects a native turn function next to process_turn
+        Given the profile file
+        """
+        functions = require('testbot')
+
+        local setup = functions.setup
+        functions.setup = function()
+          local profile = setup()
+          profile.native_turn_function = 'car'
+          return profile
+        end
+
+        return functions
+        """
+        And the node map
+            """
+            a b
+            """
+        And the ways
+            | nodes |
+            | ab    |
+        And the data has been saved to disk
+
+        When I try to run "osrm-extract --profile {profile_file} {osm_file}"
+        Then it should exit with an error
+        And stderr should contain "defines native_turn_function and process_turn or process_turns"
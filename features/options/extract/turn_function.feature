@@ -9,6 +9,7 @@ Feature: Turn Function Information
 
         function test_setup()
           profile = functions.setup()
+          profile.native_turn_function = nil
           profile.highway_turn_classification = {
               ['motorway'] = 4,
               ['motorway_link'] = 4,
@@ -14,11 +14,25 @@ namespace contractor
 
 using GraphAndFilter = std::tuple<QueryGraph, std::vector<std::vector<bool>>>;
 
+// The contraction levels of every call to contractGraph, see there. Levels that don't fit the
+// number of calls are dropped and a new contraction order is computed.
+inline void resizeNodeLevels(std::vector<std::vector<float>> &node_levels,
+                             const std::size_t number_of_contractions)
+{
+    if (node_levels.size() != number_of_contractions)
+    {
+        node_levels.clear();
+        node_levels.resize(number_of_contractions);
+    }
+}
+
 inline auto contractFullGraph(ContractorGraph contractor_graph,
-                              std::vector<EdgeWeight> node_weights)
+                              std::vector<EdgeWeight> node_weights,
+                              std::vector<std::vector<float>> &node_levels)
 {
     auto num_nodes = contractor_graph.GetNumberOfNodes();
-    contractGraph(contractor_graph, node_weights);
+    resizeNodeLevels(node_levels, 1);
+    contractGraph(contractor_graph, {}, {}, node_weights, node_levels.front());
 
     auto edges = toEdges<QueryEdge>(std::move(contractor_graph));
     std::vector<bool> edge_filter(edges.size(), true);
@@ -26,19 +40,24 @@ inline auto contractFullGraph(ContractorGraph contractor_graph,
     return GraphAndFilter{QueryGraph{num_nodes, std::move(edges)}, {std::move(edge_filter)}};
 }
 
+// The shared core is contracted first, then the core of every filter. `node_levels` holds the
+// order of each contraction, it is filled in if it doesn't match.
 inline auto contractExcludableGraph(ContractorGraph contractor_graph_,
                                     std::vector<EdgeWeight> node_weights,
-                                    const std::vector<std::vector<bool>> &filters)
+                                    const std::vector<std::vector<bool>> &filters,
+                                    std::vector<std::vector<float>> &node_levels)
 {
     if (filters.size() == 1)
     {
         if (std::all_of(filters.front().begin(), filters.front().end(), [](auto v) { return v; }))
         {
-            return contractFullGraph(std::move(contractor_graph_), std::move(node_weights));
+            return contractFullGraph(
+                std::move(contractor_graph_), std::move(node_weights), node_levels);
         }
     }
 
     auto num_nodes = contractor_graph_.GetNumberOfNodes();
+    resizeNodeLevels(node_levels, filters.size() + 1);
     ContractedEdgeContainer edge_container;
     ContractorGraph shared_core_graph;
     std::vector<bool> is_shared_core;
@@ -57,8 +76,12 @@ inline auto contractExcludableGraph(ContractorGraph contractor_graph_,
         // a very dense core. This increases the overall graph sizes a little bit
         // but increases the final CH quality and contraction speed.
         constexpr float BASE_CORE = 0.9;
-        is_shared_core =
-            contractGraph(contractor_graph, std::move(always_allowed), node_weights, BASE_CORE);
+        is_shared_core = contractGraph(contractor_graph,
+                                       {},
+                                       std::move(always_allowed),
+                                       node_weights,
+                                       node_levels.front(),
+                                       BASE_CORE);
 
         // Add all non-core edges to container
         {
@@ -81,12 +104,17 @@ inline auto contractExcludableGraph(ContractorGraph contractor_graph_,
             [&is_shared_core](const NodeID node) { return is_shared_core[node]; });
     }
 
-    for (const auto &filter : filters)
+    for (const auto filter_index : util::irange<std::size_t>(0, filters.size()))
     {
+        const auto &filter = filters[filter_index];
         auto filtered_core_graph =
             shared_core_graph.Filter([&filter](const NodeID node) { return filter[node]; });
 
-        contractGraph(filtered_core_graph, is_shared_core, is_shared_core, node_weights);
+        contractGraph(filtered_core_graph,
+                      is_shared_core,
+                      is_shared_core,
+                      node_weights,
+                      node_levels[filter_index + 1]);
 
         edge_container.Merge(toEdges<QueryEdge>(std::move(filtered_core_graph)));
     }
@@ -45,8 +45,8 @@ struct ContractorConfig final : storage::IOConfig
     ContractorConfig()
         : IOConfig({".osrm.ebg", ".osrm.ebg_nodes", ".osrm.properties"},
                    {},
-                   {".osrm.hsgr", ".osrm.enw"}),
-          requested_num_threads(0)
+                   {".osrm.hsgr", ".osrm.enw", ".osrm.level"}),
+          reuse_order(false), requested_num_threads(0)
     {
     }
 
@@ -64,6 +64,9 @@ struct ContractorConfig final : storage::IOConfig
     // DEPRECATED to be removed in v6.0
     bool use_cached_priority;
 
+    // Contract in the order of the .osrm.level file of a previous run if the topology matches
+    bool reuse_order;
+
     unsigned requested_num_threads;
 
     // DEPRECATED to be removed in v6.0
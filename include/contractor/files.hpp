@@ -65,6 +65,39 @@ inline void writeGraph(const boost::filesystem::path &path,
         storage::serialization::write(writer, filter);
     }
 }
+
+// reads .osrm.level file
+inline void readLevels(const boost::filesystem::path &path,
+                       unsigned &checksum,
+                       std::vector<std::vector<float>> &node_levels)
+{
+    const auto fingerprint = storage::io::FileReader::VerifyFingerprint;
+    storage::io::FileReader reader{path, fingerprint};
+
+    reader.ReadInto(checksum);
+    auto count = reader.ReadElementCount64();
+    node_levels.resize(count);
+    for (const auto index : util::irange<std::size_t>(0, count))
+    {
+        storage::serialization::read(reader, node_levels[index]);
+    }
+}
+
+// writes .osrm.level file
+inline void writeLevels(const boost::filesystem::path &path,
+                        unsigned checksum,
+                        const std::vector<std::vector<float>> &node_levels)
+{
+    const auto fingerprint = storage::io::FileWriter::GenerateFingerprint;
+    storage::io::FileWriter writer{path, fingerprint};
+
+    writer.WriteOne(checksum);
+    writer.WriteElementCount64(node_levels.size());
+    for (const auto &levels : node_levels)
+    {
+        storage::serialization::write(writer, levels);
+    }
+}
 }
 }
 }
@@ -13,12 +13,34 @@ namespace osrm
 namespace contractor
 {
 
+// Contracts all contractable nodes of the graph and returns the nodes that were not contracted.
+// If `node_levels` is empty the nodes are ordered by their simulated contraction priority.
+// Otherwise the nodes are contracted in the order of the given levels, e.g. of a previous run on
+// the same topology, and only the witness searches are done again. In both cases `node_levels`
+// is set to the round in which each node was contracted.
 std::vector<bool> contractGraph(ContractorGraph &graph,
                                 std::vector<bool> node_is_uncontracted,
                                 std::vector<bool> node_is_contractable,
                                 std::vector<EdgeWeight> node_weights,
+                                std::vector<float> &node_levels,
                                 double core_factor = 1.0);
 
+// Overload that computes a new contraction order
+inline auto contractGraph(ContractorGraph &graph,
+                          std::vector<bool> node_is_uncontracted,
+                          std::vector<bool> node_is_contractable,
+                          std::vector<EdgeWeight> node_weights,
+                          double core_factor = 1.0)
+{
+    std::vector<float> node_levels;
+    return contractGraph(graph,
+                         std::move(node_is_uncontracted),
+                         std::move(node_is_contractable),
+                         std::move(node_weights),
+                         node_levels,
+                         core_factor);
+}
+
 // Overload for contracting all nodes
 inline auto contractGraph(ContractorGraph &graph,
                           std::vector<EdgeWeight> node_weights,
@@ -0,0 +1,224 @@
+#ifndef OSRM_CUSTOMIZER_CCH_CUSTOMIZER_HPP
+#define OSRM_CUSTOMIZER_CCH_CUSTOMIZER_HPP
+
+#include "customizer/cch_topology.hpp"
+
+#include "contractor/query_edge.hpp"
+#include "contractor/query_graph.hpp"
+
+#include "util/integer_range.hpp"
+#include "util/typedefs.hpp"
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace customizer
+{
+
+// One direction of a CCH arc
+struct CCHArcData
+{
+    EdgeWeight weight;
+    EdgeDuration duration;
+    // middle node of a shortcut, otherwise the turn of the graph edge
+    NodeID id;
+    bool shortcut;
+};
+
+// Metric of a CCHTopology. For an arc from a lower to a higher rank the upward data belongs to
+// the direction lower -> higher, the downward data to higher -> lower.
+struct CCHMetric
+{
+    std::vector<CCHArcData> upward;
+    std::vector<CCHArcData> downward;
+    // graph edges that start and end at the same node
+    std::vector<std::pair<NodeID, CCHArcData>> loops;
+};
+
+class CCHCustomizer
+{
+  public:
+    CCHCustomizer(const CCHTopology &topology) : topology(topology) {}
+
+    // The arcs start with the values of the graph edges, then every arc is relaxed over its lower
+    // triangles. The arcs of a rank only depend on the arcs of its descendants in the elimination
+    // tree, so all ranks of the same height are customized in parallel.
+    template <typename GraphT> CCHMetric Customize(const GraphT &graph) const
+    {
+        BOOST_ASSERT(graph.GetNumberOfNodes() == topology.GetNumberOfNodes());
+
+        const CCHArcData no_path{INVALID_EDGE_WEIGHT, MAXIMAL_EDGE_DURATION, SPECIAL_NODEID, false};
+        CCHMetric metric;
+        metric.upward.resize(topology.GetNumberOfArcs(), no_path);
+        metric.downward.resize(topology.GetNumberOfArcs(), no_path);
+
+        for (const auto node : util::irange<NodeID>(0, graph.GetNumberOfNodes()))
+        {
+            for (const auto edge : graph.GetAdjacentEdgeRange(node))
+            {
+                const auto &data = graph.GetEdgeData(edge);
+                if (!data.forward)
+                {
+                    continue;
+                }
+
+                const auto target = graph.GetTarget(edge);
+                const CCHArcData edge_data{data.weight, data.duration, data.turn_id, false};
+                const auto rank = topology.GetRank(node);
+                const auto target_rank = topology.GetRank(target);
+                if (rank == target_rank)
+                {
+                    metric.loops.emplace_back(node, edge_data);
+                }
+                else if (rank < target_rank)
+                {
+                    Relax(metric.upward[topology.FindArc(rank, target_rank)], edge_data);
+                }
+                else
+                {
+                    Relax(metric.downward[topology.FindArc(target_rank, rank)], edge_data);
+                }
+            }
+        }
+
+        for (const auto height : util::irange<std::size_t>(0, topology.GetNumberOfHeights()))
+        {
+            const auto ranks = topology.GetRanksOfHeight(height);
+            tbb::parallel_for(tbb::blocked_range<std::size_t>(0, ranks.size()),
+                              [&](const tbb::blocked_range<std::size_t> &range) {
+                                  for (auto index = range.begin(), end = range.end(); index != end;
+                                       ++index)
+                                  {
+                                      RelaxLowerTriangles(metric, ranks[index]);
+                                  }
+                              });
+        }
+
+        return metric;
+    }
+
+  private:
+    static void Relax(CCHArcData &arc, const CCHArcData &candidate)
+    {
+        if (std::tie(candidate.weight, candidate.duration) < std::tie(arc.weight, arc.duration))
+        {
+            arc = candidate;
+        }
+    }
+
+    // Relaxes `arc` with the path over the arcs `first` and `second` that meet at `middle_rank`
+    void Relax(CCHArcData &arc,
+               const CCHArcData &first,
+               const CCHArcData &second,
+               const NodeID middle_rank) const
+    {
+        if (first.weight == INVALID_EDGE_WEIGHT || second.weight == INVALID_EDGE_WEIGHT)
+        {
+            return;
+        }
+
+        Relax(arc,
+              {first.weight + second.weight,
+               first.duration + second.duration,
+               topology.GetNode(middle_rank),
+               true});
+    }
+
+    // A lower triangle of the arc rank -> head is a lower neighbour adjacent to both nodes. The
+    // upward neighbours of a lower neighbour that are ranked above `rank` are all upward
+    // neighbours of `rank` as well, so the arcs are found by walking both sorted lists.
+    void RelaxLowerTriangles(CCHMetric &metric, const NodeID rank) const
+    {
+        const auto upward_arcs = topology.GetUpwardArcs(rank);
+        for (const auto lower_arc : topology.GetDownwardArcs(rank))
+        {
+            const auto lower_rank = topology.GetTail(lower_arc);
+            const auto lower_upward_arcs = topology.GetUpwardArcs(lower_rank);
+
+            auto arc = upward_arcs.begin();
+            for (const auto other_arc :
+                 util::irange<EdgeID>(lower_arc + 1, lower_upward_arcs.back() + 1))
+            {
+                const auto other_head = topology.GetHead(other_arc);
+                while (topology.GetHead(*arc) != other_head)
+                {
+                    ++arc;
+                    BOOST_ASSERT(arc != upward_arcs.end());
+                }
+
+                // rank -> lower_rank -> other_head
+                Relax(metric.upward[*arc],
+                      metric.downward[lower_arc],
+                      metric.upward[other_arc],
+                      lower_rank);
+                // other_head -> lower_rank -> rank
+                Relax(metric.downward[*arc],
+                      metric.downward[other_arc],
+                      metric.upward[lower_arc],
+                      lower_rank);
+            }
+        }
+    }
+
+    const CCHTopology &topology;
+};
+
+// Builds a query graph in the format of a contraction hierarchy. Both directions of an arc are
+// stored at the lower ranked node, as a forward and as a backward edge. The graph contains all
+// arcs even if there is no path for the current metric, those are disabled in `edge_filter`.
+inline contractor::QueryGraph makeQueryGraph(const CCHTopology &topology,
+                                             const CCHMetric &metric,
+                                             std::vector<bool> &edge_filter)
+{
+    using EdgeData = contractor::QueryEdge::EdgeData;
+    const auto makeEdgeData = [](const CCHArcData &data, const bool forward) {
+        if (data.weight == INVALID_EDGE_WEIGHT)
+        {
+            return EdgeData{
+                0, false, INVALID_EDGE_WEIGHT, MAXIMAL_EDGE_DURATION_INT_30, forward, !forward};
+        }
+        return EdgeData{data.id, data.shortcut, data.weight, data.duration, forward, !forward};
+    };
+
+    std::vector<contractor::QueryEdge> edges;
+    edges.reserve(2 * topology.GetNumberOfArcs() + metric.loops.size());
+    for (const auto arc : util::irange<EdgeID>(0, topology.GetNumberOfArcs()))
+    {
+        const auto tail = topology.GetNode(topology.GetTail(arc));
+        const auto head = topology.GetNode(topology.GetHead(arc));
+        edges.emplace_back(tail, head, makeEdgeData(metric.upward[arc], true));
+        edges.emplace_back(tail, head, makeEdgeData(metric.downward[arc], false));
+    }
+    for (const auto &loop : metric.loops)
+    {
+        const auto &data = loop.second;
+        edges.emplace_back(
+            loop.first,
+            loop.first,
+            EdgeData{data.id, false, data.weight, data.duration, true, true});
+    }
+    std::sort(edges.begin(), edges.end());
+
+    edge_filter.resize(edges.size());
+    std::transform(edges.begin(),
+                   edges.end(),
+                   edge_filter.begin(),
+                   [](const contractor::QueryEdge &edge) {
+                       return edge.data.weight != INVALID_EDGE_WEIGHT;
+                   });
+
+    return contractor::QueryGraph(topology.GetNumberOfNodes(), edges);
+}
+}
+}
+
+#endif
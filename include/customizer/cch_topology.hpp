@@ -0,0 +1,249 @@
+#ifndef OSRM_CUSTOMIZER_CCH_TOPOLOGY_HPP
+#define OSRM_CUSTOMIZER_CCH_TOPOLOGY_HPP
+
+#include "partition/multi_level_partition.hpp"
+
+#include "storage/io_fwd.hpp"
+
+#include "util/integer_range.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+#include <boost/range/iterator_range.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+namespace osrm
+{
+namespace customizer
+{
+class CCHTopology;
+
+namespace serialization
+{
+inline void read(storage::io::FileReader &reader, CCHTopology &topology);
+inline void write(storage::io::FileWriter &writer, const CCHTopology &topology);
+}
+
+// A node of the elimination tree of a customizable contraction hierarchy
+struct EliminationTreeNode
+{
+    // lowest ranked upward neighbour, SPECIAL_NODEID for the roots
+    NodeID parent;
+    // nodes are contracted by increasing rank, the parent always has a higher rank
+    NodeID rank;
+};
+
+// Metric-independent part of a customizable contraction hierarchy (CCH).
+//
+// The contraction order is a nested dissection order taken from the multi-level partition:
+// nodes with all neighbours in their own level 1 cell come first, then the border nodes of the
+// level 1 cells and so on up to the border nodes of the highest level. Contracting the nodes in
+// this order without witness searches gives a chordal supergraph of the graph that only depends
+// on its topology. The arcs of this supergraph are kept in rank space, every arc leads from a
+// lower to a higher ranked node and the upward arcs of a node are sorted by the rank of the head.
+class CCHTopology
+{
+  public:
+    CCHTopology() = default;
+
+    template <typename GraphT>
+    CCHTopology(const partition::MultiLevelPartition &partition, const GraphT &graph)
+    {
+        const NodeID num_nodes = graph.GetNumberOfNodes();
+
+        // the highest level on which a node has a neighbour in another cell
+        std::vector<LevelID> separator_level(num_nodes, 0);
+        for (const auto node : util::irange<NodeID>(0, num_nodes))
+        {
+            for (const auto edge : graph.GetAdjacentEdgeRange(node))
+            {
+                separator_level[node] =
+                    std::max(separator_level[node],
+                             partition.GetHighestDifferentLevel(node, graph.GetTarget(edge)));
+            }
+        }
+
+        rank_to_node.resize(num_nodes);
+        std::iota(rank_to_node.begin(), rank_to_node.end(), 0);
+        std::stable_sort(rank_to_node.begin(),
+                         rank_to_node.end(),
+                         [&separator_level](const NodeID lhs, const NodeID rhs) {
+                             return separator_level[lhs] < separator_level[rhs];
+                         });
+        node_to_rank.resize(num_nodes);
+        for (const auto rank : util::irange<NodeID>(0, num_nodes))
+        {
+            node_to_rank[rank_to_node[rank]] = rank;
+        }
+
+        std::vector<std::vector<NodeID>> upward_neighbours(num_nodes);
+        for (const auto node : util::irange<NodeID>(0, num_nodes))
+        {
+            for (const auto edge : graph.GetAdjacentEdgeRange(node))
+            {
+                const auto rank = node_to_rank[node];
+                const auto target_rank = node_to_rank[graph.GetTarget(edge)];
+                if (rank < target_rank)
+                {
+                    upward_neighbours[rank].push_back(target_rank);
+                }
+                else if (target_rank < rank)
+                {
+                    upward_neighbours[target_rank].push_back(rank);
+                }
+            }
+        }
+
+        // Contracting a node connects all of its upward neighbours. It is enough to pass them to
+        // the lowest ranked one, the elimination tree parent, since its contraction will connect
+        // them to the remaining neighbours.
+        parent.resize(num_nodes, SPECIAL_NODEID);
+        first_upward_arc.reserve(num_nodes + 1);
+        for (const auto rank : util::irange<NodeID>(0, num_nodes))
+        {
+            auto &neighbours = upward_neighbours[rank];
+            std::sort(neighbours.begin(), neighbours.end());
+            neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+
+            first_upward_arc.push_back(head.size());
+            head.insert(head.end(), neighbours.begin(), neighbours.end());
+            tail.insert(tail.end(), neighbours.size(), rank);
+
+            if (!neighbours.empty())
+            {
+                parent[rank] = neighbours.front();
+                auto &parent_neighbours = upward_neighbours[parent[rank]];
+                parent_neighbours.insert(
+                    parent_neighbours.end(), std::next(neighbours.begin()), neighbours.end());
+            }
+            std::vector<NodeID>().swap(neighbours);
+        }
+        first_upward_arc.push_back(head.size());
+
+        // downward arcs are the upward arcs grouped by head, sorted by the rank of the tail
+        first_downward_arc.resize(num_nodes + 1, 0);
+        for (const auto head_rank : head)
+        {
+            ++first_downward_arc[head_rank + 1];
+        }
+        std::partial_sum(
+            first_downward_arc.begin(), first_downward_arc.end(), first_downward_arc.begin());
+        downward_arcs.resize(head.size());
+        auto next_downward_arc = first_downward_arc;
+        for (const auto arc : util::irange<EdgeID>(0, head.size()))
+        {
+            downward_arcs[next_downward_arc[head[arc]]++] = arc;
+        }
+
+        // a node only depends on the arcs of its lower neighbours, so all nodes of the same
+        // height in the elimination tree can be customized at the same time
+        std::vector<NodeID> height(num_nodes, 0);
+        for (const auto arc : util::irange<EdgeID>(0, head.size()))
+        {
+            height[head[arc]] = std::max(height[head[arc]], height[tail[arc]] + 1);
+        }
+        const auto max_height =
+            num_nodes > 0 ? *std::max_element(height.begin(), height.end()) : 0;
+        first_rank_of_height.resize(max_height + 2, 0);
+        for (const auto node_height : height)
+        {
+            ++first_rank_of_height[node_height + 1];
+        }
+        std::partial_sum(
+            first_rank_of_height.begin(), first_rank_of_height.end(), first_rank_of_height.begin());
+        ranks_by_height.resize(num_nodes);
+        auto next_rank_of_height = first_rank_of_height;
+        for (const auto rank : util::irange<NodeID>(0, num_nodes))
+        {
+            ranks_by_height[next_rank_of_height[height[rank]]++] = rank;
+        }
+    }
+
+    NodeID GetNumberOfNodes() const { return rank_to_node.size(); }
+
+    EdgeID GetNumberOfArcs() const { return head.size(); }
+
+    NodeID GetRank(const NodeID node) const { return node_to_rank[node]; }
+
+    NodeID GetNode(const NodeID rank) const { return rank_to_node[rank]; }
+
+    // Elimination tree parent of a rank, SPECIAL_NODEID for the roots
+    NodeID GetParent(const NodeID rank) const { return parent[rank]; }
+
+    NodeID GetTail(const EdgeID arc) const { return tail[arc]; }
+
+    NodeID GetHead(const EdgeID arc) const { return head[arc]; }
+
+    // Arcs to the higher ranked neighbours, sorted by the rank of the head
+    util::range<EdgeID> GetUpwardArcs(const NodeID rank) const
+    {
+        return util::irange(first_upward_arc[rank], first_upward_arc[rank + 1]);
+    }
+
+    // Arcs from the lower ranked neighbours, sorted by the rank of the tail
+    auto GetDownwardArcs(const NodeID rank) const
+    {
+        return boost::make_iterator_range(downward_arcs.begin() + first_downward_arc[rank],
+                                          downward_arcs.begin() + first_downward_arc[rank + 1]);
+    }
+
+    // Finds the arc between two ranks, SPECIAL_EDGEID if they are not adjacent
+    EdgeID FindArc(const NodeID lower_rank, const NodeID higher_rank) const
+    {
+        BOOST_ASSERT(lower_rank < higher_rank);
+        const auto begin = head.begin() + first_upward_arc[lower_rank];
+        const auto end = head.begin() + first_upward_arc[lower_rank + 1];
+        const auto iter = std::lower_bound(begin, end, higher_rank);
+        return iter != end && *iter == higher_rank ? std::distance(head.begin(), iter)
+                                                   : SPECIAL_EDGEID;
+    }
+
+    std::size_t GetNumberOfHeights() const { return first_rank_of_height.size() - 1; }
+
+    // All ranks with the given height in the elimination tree, leaves have height 0
+    auto GetRanksOfHeight(const std::size_t height) const
+    {
+        return boost::make_iterator_range(
+            ranks_by_height.begin() + first_rank_of_height[height],
+            ranks_by_height.begin() + first_rank_of_height[height + 1]);
+    }
+
+    std::vector<EliminationTreeNode> GetEliminationTree() const
+    {
+        std::vector<EliminationTreeNode> elimination_tree(GetNumberOfNodes());
+        for (const auto node : util::irange<NodeID>(0, GetNumberOfNodes()))
+        {
+            const auto rank = node_to_rank[node];
+            const auto parent_rank = parent[rank];
+            elimination_tree[node] = {
+                parent_rank == SPECIAL_NODEID ? SPECIAL_NODEID : rank_to_node[parent_rank], rank};
+        }
+        return elimination_tree;
+    }
+
+    friend void serialization::read(storage::io::FileReader &reader, CCHTopology &topology);
+    friend void serialization::write(storage::io::FileWriter &writer,
+                                     const CCHTopology &topology);
+
+  private:
+    std::vector<NodeID> node_to_rank;
+    std::vector<NodeID> rank_to_node;
+    std::vector<NodeID> parent;
+
+    std::vector<EdgeID> first_upward_arc;
+    std::vector<NodeID> tail;
+    std::vector<NodeID> head;
+
+    std::vector<EdgeID> first_downward_arc;
+    std::vector<EdgeID> downward_arcs;
+
+    std::vector<std::size_t> first_rank_of_height;
+    std::vector<NodeID> ranks_by_height;
+};
+}
+}
+
+#endif
@@ -1,8 +1,10 @@
 #ifndef OSRM_CELLS_CUSTOMIZER_HPP
 #define OSRM_CELLS_CUSTOMIZER_HPP
 
+#include "customizer/dirty_cells.hpp"
 #include "partition/cell_storage.hpp"
 #include "partition/multi_level_partition.hpp"
+#include "storage/shared_memory_ownership.hpp"
 #include "util/query_heap.hpp"
 
 #include <tbb/enumerable_thread_specific.h>
@@ -14,10 +16,18 @@ namespace osrm
 {
 namespace customizer
 {
+namespace detail
+{
 
-class CellCustomizer
+// Customizes the cells of a partition and metric that are both either containers or views
+template <storage::Ownership Ownership> class CellCustomizerImpl
 {
   private:
+    using MultiLevelPartition = partition::detail::MultiLevelPartitionImpl<Ownership>;
+    using CellStorage = partition::detail::CellStorageImpl<Ownership>;
+    using CellMetric = CellMetricImpl<Ownership>;
+    using DirtyCells = DirtyCellsImpl<Ownership>;
+
     struct HeapData
     {
         bool from_clique;
@@ -29,12 +39,12 @@ class CellCustomizer
         util::QueryHeap<NodeID, NodeID, EdgeWeight, HeapData, util::ArrayStorage<NodeID, int>>;
     using HeapPtr = tbb::enumerable_thread_specific<Heap>;
 
-    CellCustomizer(const partition::MultiLevelPartition &partition) : partition(partition) {}
+    CellCustomizerImpl(const MultiLevelPartition &partition) : partition(partition) {}
 
     template <typename GraphT>
     void Customize(const GraphT &graph,
                    Heap &heap,
-                   const partition::CellStorage &cells,
+                   const CellStorage &cells,
                    const std::vector<bool> &allowed_nodes,
                    CellMetric &metric,
                    LevelID level,
@@ -97,7 +107,7 @@ class CellCustomizer
 
     template <typename GraphT>
     void Customize(const GraphT &graph,
-                   const partition::CellStorage &cells,
+                   const CellStorage &cells,
                    const std::vector<bool> &allowed_nodes,
                    CellMetric &metric) const
     {
@@ -118,10 +128,38 @@ class CellCustomizer
         }
     }
 
+    // Recomputes only the dirty cells, all other cells keep their values in metric
+    template <typename GraphT>
+    void Customize(const GraphT &graph,
+                   const CellStorage &cells,
+                   const std::vector<bool> &allowed_nodes,
+                   CellMetric &metric,
+                   const DirtyCells &dirty_cells) const
+    {
+        Heap heap_exemplar(graph.GetNumberOfNodes());
+        HeapPtr heaps(heap_exemplar);
+
+        for (std::size_t level = 1; level < partition.GetNumberOfLevels(); ++level)
+        {
+            tbb::parallel_for(tbb::blocked_range<std::size_t>(0, partition.GetNumberOfCells(level)),
+                              [&](const tbb::blocked_range<std::size_t> &range) {
+                                  auto &heap = heaps.local();
+                                  for (auto id = range.begin(), end = range.end(); id != end; ++id)
+                                  {
+                                      if (dirty_cells.IsDirty(level, id))
+                                      {
+                                          Customize(
+                                              graph, heap, cells, allowed_nodes, metric, level, id);
+                                      }
+                                  }
+                              });
+        }
+    }
+
   private:
     template <typename GraphT>
     void RelaxNode(const GraphT &graph,
-                   const partition::CellStorage &cells,
+                   const CellStorage &cells,
                    const std::vector<bool> &allowed_nodes,
                    const CellMetric &metric,
                    Heap &heap,
@@ -209,9 +247,13 @@ class CellCustomizer
         }
     }
 
-    const partition::MultiLevelPartition &partition;
+    const MultiLevelPartition &partition;
 };
 }
+
+using CellCustomizer = detail::CellCustomizerImpl<storage::Ownership::Container>;
+using CellCustomizerView = detail::CellCustomizerImpl<storage::Ownership::View>;
+}
 }
 
 #endif // OSRM_CELLS_CUSTOMIZER_HPP
@@ -23,8 +23,8 @@ struct CustomizationConfig final : storage::IOConfig
                     ".osrm.ebg_nodes",
                     ".osrm.properties"},
                    {},
-                   {".osrm.cell_metrics", ".osrm.mldgr"}),
-          requested_num_threads(0)
+                   {".osrm.cell_metrics", ".osrm.mldgr", ".osrm.cch", ".osrm.cch_topology"}),
+          requested_num_threads(0), incremental(false), cch(false), cch_only(false)
     {
     }
 
@@ -35,6 +35,12 @@ struct CustomizationConfig final : storage::IOConfig
     }
 
     unsigned requested_num_threads;
+    // recompute only the cells with edges that changed since the previous customization
+    bool incremental;
+    // also customize a contraction hierarchy over the partition order, see CCHTopology
+    bool cch;
+    // only customize the contraction hierarchy and skip the cells of the MLD
+    bool cch_only;
 
     updater::UpdaterConfig updater_config;
 };
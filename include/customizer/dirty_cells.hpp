@@ -0,0 +1,94 @@
+#ifndef OSRM_CUSTOMIZER_DIRTY_CELLS_HPP
+#define OSRM_CUSTOMIZER_DIRTY_CELLS_HPP
+
+#include "partition/multi_level_partition.hpp"
+
+#include "storage/shared_memory_ownership.hpp"
+
+#include "util/integer_range.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace osrm
+{
+namespace customizer
+{
+namespace detail
+{
+
+// Cells whose metric has to be recomputed after edges of the graph changed.
+//
+// An edge is used by the lowest cell that contains both of its nodes and, through the cliques
+// of that cell, by all of its parents. Cells that are not dirty keep their metric.
+template <storage::Ownership Ownership> class DirtyCellsImpl
+{
+    using MultiLevelPartition = partition::detail::MultiLevelPartitionImpl<Ownership>;
+
+  public:
+    DirtyCellsImpl(const MultiLevelPartition &partition) : partition(partition)
+    {
+        // level 0 has no cells, its entry stays empty
+        dirty.resize(partition.GetNumberOfLevels());
+        for (auto level : util::irange<LevelID>(1, partition.GetNumberOfLevels()))
+        {
+            dirty[level].resize(partition.GetNumberOfCells(level), false);
+        }
+    }
+
+    // Marks the lowest cell that contains the edge from source to target
+    void MarkEdge(const NodeID source, const NodeID target)
+    {
+        const LevelID level = partition.GetHighestDifferentLevel(source, target) + 1;
+        // edges between the cells of the highest level are not part of any cell
+        if (level < partition.GetNumberOfLevels())
+        {
+            dirty[level][partition.GetCell(level, source)] = true;
+        }
+    }
+
+    // Marks the parents of all dirty cells, needs to be called after the last MarkEdge
+    void Propagate()
+    {
+        for (auto level : util::irange<LevelID>(2, partition.GetNumberOfLevels()))
+        {
+            for (auto cell : util::irange<CellID>(0, partition.GetNumberOfCells(level)))
+            {
+                const auto begin = partition.BeginChildren(level, cell);
+                const auto end = partition.EndChildren(level, cell);
+                if (std::any_of(dirty[level - 1].begin() + begin,
+                                dirty[level - 1].begin() + end,
+                                [](const bool child_dirty) { return child_dirty; }))
+                {
+                    dirty[level][cell] = true;
+                }
+            }
+        }
+    }
+
+    bool IsDirty(const LevelID level, const CellID cell) const
+    {
+        BOOST_ASSERT(level > 0 && level < dirty.size());
+        return dirty[level][cell];
+    }
+
+    std::size_t GetNumberOfDirtyCells(const LevelID level) const
+    {
+        return std::count(dirty[level].begin(), dirty[level].end(), true);
+    }
+
+  private:
+    const MultiLevelPartition &partition;
+    std::vector<std::vector<bool>> dirty;
+};
+}
+
+using DirtyCells = detail::DirtyCellsImpl<storage::Ownership::Container>;
+using DirtyCellsView = detail::DirtyCellsImpl<storage::Ownership::View>;
+}
+}
+
+#endif // OSRM_CUSTOMIZER_DIRTY_CELLS_HPP
@@ -1,11 +1,16 @@
 #ifndef OSRM_CUSTOMIZER_FILES_HPP
 #define OSRM_CUSTOMIZER_FILES_HPP
 
+#include "customizer/cch_topology.hpp"
 #include "customizer/serialization.hpp"
 
+#include "contractor/query_graph.hpp"
+
 #include "storage/io.hpp"
+#include "storage/serialization.hpp"
 
 #include "util/integer_range.hpp"
+#include "util/serialization.hpp"
 
 namespace osrm
 {
@@ -52,6 +57,80 @@ inline void writeCellMetrics(const boost::filesystem::path &path,
         serialization::write(writer, metric);
     }
 }
+
+// reads .osrm.cch_topology file
+inline void readCCHTopology(const boost::filesystem::path &path,
+                            unsigned &checksum,
+                            CCHTopology &topology)
+{
+    const auto fingerprint = storage::io::FileReader::VerifyFingerprint;
+    storage::io::FileReader reader{path, fingerprint};
+
+    reader.ReadInto(checksum);
+    serialization::read(reader, topology);
+}
+
+// writes .osrm.cch_topology file
+inline void writeCCHTopology(const boost::filesystem::path &path,
+                             const unsigned checksum,
+                             const CCHTopology &topology)
+{
+    const auto fingerprint = storage::io::FileWriter::GenerateFingerprint;
+    storage::io::FileWriter writer{path, fingerprint};
+
+    writer.WriteOne(checksum);
+    serialization::write(writer, topology);
+}
+
+// reads .osrm.cch file
+template <typename QueryGraphT, typename EliminationTreeT, typename EdgeFilterT>
+inline void readCCH(const boost::filesystem::path &path,
+                    QueryGraphT &graph,
+                    EliminationTreeT &elimination_tree,
+                    EdgeFilterT &edge_filter)
+{
+    static_assert(std::is_same<contractor::QueryGraphView, QueryGraphT>::value ||
+                      std::is_same<contractor::QueryGraph, QueryGraphT>::value,
+                  "graph must be of type QueryGraph<>");
+    static_assert(std::is_same<EliminationTreeT, std::vector<EliminationTreeNode>>::value ||
+                      std::is_same<EliminationTreeT, util::vector_view<EliminationTreeNode>>::value,
+                  "elimination_tree must be a vector or vector_view of EliminationTreeNode");
+    static_assert(std::is_same<EdgeFilterT, std::vector<bool>>::value ||
+                      std::is_same<EdgeFilterT, util::vector_view<bool>>::value,
+                  "edge_filter must be a vector<bool> or vector_view<bool>");
+
+    const auto fingerprint = storage::io::FileReader::VerifyFingerprint;
+    storage::io::FileReader reader{path, fingerprint};
+
+    util::serialization::read(reader, graph);
+    storage::serialization::read(reader, elimination_tree);
+    storage::serialization::read(reader, edge_filter);
+}
+
+// writes .osrm.cch file
+template <typename QueryGraphT, typename EliminationTreeT, typename EdgeFilterT>
+inline void writeCCH(const boost::filesystem::path &path,
+                     const QueryGraphT &graph,
+                     const EliminationTreeT &elimination_tree,
+                     const EdgeFilterT &edge_filter)
+{
+    static_assert(std::is_same<contractor::QueryGraphView, QueryGraphT>::value ||
+                      std::is_same<contractor::QueryGraph, QueryGraphT>::value,
+                  "graph must be of type QueryGraph<>");
+    static_assert(std::is_same<EliminationTreeT, std::vector<EliminationTreeNode>>::value ||
+                      std::is_same<EliminationTreeT, util::vector_view<EliminationTreeNode>>::value,
+                  "elimination_tree must be a vector or vector_view of EliminationTreeNode");
+    static_assert(std::is_same<EdgeFilterT, std::vector<bool>>::value ||
+                      std::is_same<EdgeFilterT, util::vector_view<bool>>::value,
+                  "edge_filter must be a vector<bool> or vector_view<bool>");
+
+    const auto fingerprint = storage::io::FileWriter::GenerateFingerprint;
+    storage::io::FileWriter writer{path, fingerprint};
+
+    util::serialization::write(writer, graph);
+    storage::serialization::write(writer, elimination_tree);
+    storage::serialization::write(writer, edge_filter);
+}
 }
 }
 }
@@ -1,6 +1,8 @@
 #ifndef OSRM_CUSTOMIZER_SERIALIZATION_HPP
 #define OSRM_CUSTOMIZER_SERIALIZATION_HPP
 
+#include "customizer/cch_topology.hpp"
+
 #include "partition/cell_storage.hpp"
 
 #include "storage/io.hpp"
@@ -27,6 +29,34 @@ inline void write(storage::io::FileWriter &writer, const detail::CellMetricImpl<
     storage::serialization::write(writer, metric.weights);
     storage::serialization::write(writer, metric.durations);
 }
+
+inline void read(storage::io::FileReader &reader, CCHTopology &topology)
+{
+    storage::serialization::read(reader, topology.node_to_rank);
+    storage::serialization::read(reader, topology.rank_to_node);
+    storage::serialization::read(reader, topology.parent);
+    storage::serialization::read(reader, topology.first_upward_arc);
+    storage::serialization::read(reader, topology.tail);
+    storage::serialization::read(reader, topology.head);
+    storage::serialization::read(reader, topology.first_downward_arc);
+    storage::serialization::read(reader, topology.downward_arcs);
+    storage::serialization::read(reader, topology.first_rank_of_height);
+    storage::serialization::read(reader, topology.ranks_by_height);
+}
+
+inline void write(storage::io::FileWriter &writer, const CCHTopology &topology)
+{
+    storage::serialization::write(writer, topology.node_to_rank);
+    storage::serialization::write(writer, topology.rank_to_node);
+    storage::serialization::write(writer, topology.parent);
+    storage::serialization::write(writer, topology.first_upward_arc);
+    storage::serialization::write(writer, topology.tail);
+    storage::serialization::write(writer, topology.head);
+    storage::serialization::write(writer, topology.first_downward_arc);
+    storage::serialization::write(writer, topology.downward_arcs);
+    storage::serialization::write(writer, topology.first_rank_of_height);
+    storage::serialization::write(writer, topology.ranks_by_height);
+}
 }
 }
 }
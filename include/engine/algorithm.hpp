@@ -24,11 +24,19 @@ struct Algorithm final
 {
 };
 }
+// Customizable Contraction Hierarchy
+namespace cch
+{
+struct Algorithm final
+{
+};
+}
 
 // Algorithm names
 template <typename AlgorithmT> const char *name();
 template <> inline const char *name<ch::Algorithm>() { return "CH"; }
 template <> inline const char *name<mld::Algorithm>() { return "MLD"; }
+template <> inline const char *name<cch::Algorithm>() { return "CCH"; }
 
 template <typename AlgorithmT> struct HasAlternativePathSearch final : std::false_type
 {
@@ -97,6 +105,26 @@ template <> struct HasGetTileTurns<mld::Algorithm> final : std::true_type
 template <> struct HasExcludeFlags<mld::Algorithm> final : std::true_type
 {
 };
+
+// Algorithms supported by Customizable Contraction Hierarchies
+template <> struct HasAlternativePathSearch<cch::Algorithm> final : std::true_type
+{
+};
+template <> struct HasShortestPathSearch<cch::Algorithm> final : std::true_type
+{
+};
+template <> struct HasDirectShortestPathSearch<cch::Algorithm> final : std::true_type
+{
+};
+template <> struct HasMapMatching<cch::Algorithm> final : std::true_type
+{
+};
+template <> struct HasManyToManySearch<cch::Algorithm> final : std::true_type
+{
+};
+template <> struct HasGetTileTurns<cch::Algorithm> final : std::true_type
+{
+};
 }
 }
 }
@@ -0,0 +1,47 @@
+#ifndef ENGINE_API_BASE_RESULT_HPP
+#define ENGINE_API_BASE_RESULT_HPP
+
+#include "util/cbor_writer.hpp"
+#include "util/json_container.hpp"
+#include "util/json_writer.hpp"
+
+#include <mapbox/variant.hpp>
+
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace api
+{
+
+// Result of a service request. The alternative that is set before the request selects the
+// output: a json::Object that can be inspected, JSON text that is written straight into the
+// buffer without building the object tree first, or the same response encoded as CBOR.
+using ResultT = mapbox::util::variant<util::json::Object, std::vector<char>, util::cbor::Buffer>;
+
+// Calls write with the json::Object of the result or with a writer for its buffer
+template <typename WriteFn> void VisitResult(ResultT &result, WriteFn &&write)
+{
+    if (result.is<std::vector<char>>())
+    {
+        util::json::Writer writer(result.get<std::vector<char>>());
+        write(writer);
+    }
+    else if (result.is<util::cbor::Buffer>())
+    {
+        util::cbor::Writer writer(result.get<util::cbor::Buffer>().bytes);
+        write(writer);
+    }
+    else
+    {
+        write(result.get<util::json::Object>());
+    }
+}
+
+} // ns api
+} // ns engine
+} // ns osrm
+
+#endif
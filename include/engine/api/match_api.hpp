@@ -51,6 +51,47 @@ class MatchAPI final : public RouteAPI
         response.values["code"] = "Ok";
     }
 
+    // Same response as above, written by a json::Writer or cbor::Writer without building the
+    // object tree
+    template <typename WriterT>
+    void MakeResponse(const std::vector<map_matching::SubMatching> &sub_matchings,
+                      const std::vector<InternalRouteResult> &sub_routes,
+                      WriterT &writer) const
+    {
+        BOOST_ASSERT(sub_matchings.size() == sub_routes.size());
+
+        writer.StartObject();
+        writer.Key("code");
+        writer.String("Ok");
+        writer.Key("tracepoints");
+        writer.Value(MakeTracepoints(sub_matchings));
+
+        writer.Key("matchings");
+        writer.StartArray();
+        for (auto index : util::irange<std::size_t>(0UL, sub_matchings.size()))
+        {
+            writer.StartObject();
+            WriteRouteMembers(writer,
+                              sub_routes[index].segment_end_coordinates,
+                              sub_routes[index].unpacked_path_segments,
+                              sub_routes[index].source_traversed_in_reverse,
+                              sub_routes[index].target_traversed_in_reverse);
+            writer.Key("confidence");
+            writer.Number(sub_matchings[index].confidence);
+            writer.EndObject();
+        }
+        writer.EndArray();
+        writer.EndObject();
+    }
+
+    void MakeResponse(const std::vector<map_matching::SubMatching> &sub_matchings,
+                      const std::vector<InternalRouteResult> &sub_routes,
+                      ResultT &response) const
+    {
+        VisitResult(response,
+                    [&](auto &output) { MakeResponse(sub_matchings, sub_routes, output); });
+    }
+
   protected:
     // FIXME this logic is a little backwards. We should change the output format of the
     // map_matching
@@ -86,6 +127,12 @@ class MatchAPI final : public RouteAPI
             for (auto point_index : util::irange(
                      0u, static_cast<unsigned>(sub_matchings[sub_matching_index].indices.size())))
             {
+                // the first point of a match session response belongs to an earlier request
+                if (sub_matchings[sub_matching_index].indices[point_index] >=
+                    tidy_result.tidied_to_original.size())
+                {
+                    continue;
+                }
                 // tidied_to_original: index of the input coordinate that a tidied coordinate
                 // corresponds to.
                 // sub_matching indices: index of the coordinate passed to map matching plugin that
@@ -30,6 +30,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "engine/api/route_parameters.hpp"
 
+#include <string>
 #include <vector>
 
 namespace osrm
@@ -44,6 +45,8 @@ namespace api
  *
  * Holds member attributes:
  *  - timestamps: timestamp(s) for the corresponding input coordinate(s)
+ *  - session: id of a match session that the coordinates are appended to, empty for none.
+ *    A session can be extended by a single coordinate.
  *
  * \see OSRM, Coordinate, Hint, Bearing, RouteParame, RouteParameters, TableParameters,
  *      NearestParameters, TripParameters, MatchParameters and TileParameters
@@ -88,6 +91,7 @@ struct MatchParameters : public RouteParameters
     GapsType gaps;
     bool tidy;
     std::vector<std::size_t> waypoints;
+    std::string session;
 
     bool IsValid() const
     {
@@ -95,7 +99,9 @@ struct MatchParameters : public RouteParameters
             std::all_of(waypoints.begin(), waypoints.end(), [this](const auto &w) {
                 return w < coordinates.size();
             });
-        return RouteParameters::IsValid() &&
+        const auto valid_session_extension =
+            !session.empty() && coordinates.size() == 1 && BaseParameters::IsValid();
+        return (RouteParameters::IsValid() || valid_session_extension) &&
                (timestamps.empty() || timestamps.size() == coordinates.size()) && valid_waypoints;
     }
 };
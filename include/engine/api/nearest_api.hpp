@@ -2,13 +2,20 @@
 #define ENGINE_API_NEAREST_API_HPP
 
 #include "engine/api/base_api.hpp"
+#include "engine/api/base_result.hpp"
 #include "engine/api/nearest_parameters.hpp"
 
 #include "engine/api/json_factory.hpp"
 #include "engine/phantom_node.hpp"
 
+#include "util/integer_range.hpp"
+#include "util/json_renderer.hpp"
+
 #include <boost/assert.hpp>
 
+#include <cstdint>
+#include <limits>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -42,44 +49,10 @@ class NearestAPI final : public BaseAPI
                            auto waypoint = MakeWaypoint(phantom_node);
                            waypoint.values["distance"] = phantom_with_distance.distance;
 
+                           const auto from_and_to_node = GetOSMNodes(phantom_node);
                            util::json::Array nodes;
-
-                           std::uint64_t from_node = 0;
-                           std::uint64_t to_node = 0;
-
-                           std::vector<NodeID> forward_geometry;
-                           if (phantom_node.forward_segment_id.enabled)
-                           {
-                               auto segment_id = phantom_node.forward_segment_id.id;
-                               const auto geometry_id = facade.GetGeometryIndex(segment_id).id;
-                               forward_geometry =
-                                   facade.GetUncompressedForwardGeometry(geometry_id);
-
-                               auto osm_node_id = facade.GetOSMNodeIDOfNode(
-                                   forward_geometry[phantom_node.fwd_segment_position]);
-                               to_node = static_cast<std::uint64_t>(osm_node_id);
-                           }
-
-                           if (phantom_node.reverse_segment_id.enabled)
-                           {
-                               auto segment_id = phantom_node.reverse_segment_id.id;
-                               const auto geometry_id = facade.GetGeometryIndex(segment_id).id;
-                               std::vector<NodeID> geometry =
-                                   facade.GetUncompressedForwardGeometry(geometry_id);
-                               auto osm_node_id = facade.GetOSMNodeIDOfNode(
-                                   geometry[phantom_node.fwd_segment_position + 1]);
-                               from_node = static_cast<std::uint64_t>(osm_node_id);
-                           }
-                           else if (phantom_node.forward_segment_id.enabled &&
-                                    phantom_node.fwd_segment_position > 0)
-                           {
-                               // In the case of one way, rely on forward segment only
-                               auto osm_node_id = facade.GetOSMNodeIDOfNode(
-                                   forward_geometry[phantom_node.fwd_segment_position - 1]);
-                               from_node = static_cast<std::uint64_t>(osm_node_id);
-                           }
-                           nodes.values.push_back(from_node);
-                           nodes.values.push_back(to_node);
+                           nodes.values.push_back(from_and_to_node.first);
+                           nodes.values.push_back(from_and_to_node.second);
                            waypoint.values["nodes"] = std::move(nodes);
 
                            return waypoint;
@@ -89,7 +62,171 @@ class NearestAPI final : public BaseAPI
         response.values["waypoints"] = std::move(waypoints);
     }
 
+    void MakeResponse(const std::vector<std::vector<PhantomNodeWithDistance>> &phantom_nodes,
+                      ResultT &response) const
+    {
+        if (response.is<util::json::Object>())
+        {
+            MakeResponse(phantom_nodes, response.get<util::json::Object>());
+            return;
+        }
+
+        // a handful of waypoints, not worth writing them one by one
+        util::json::Object json_response;
+        MakeResponse(phantom_nodes, json_response);
+        if (response.is<util::cbor::Buffer>())
+        {
+            util::cbor::Writer writer(response.get<util::cbor::Buffer>().bytes);
+            writer.Value(json_response);
+        }
+        else
+        {
+            util::json::render(response.get<std::vector<char>>(), json_response);
+        }
+    }
+
+    // Packed response of a batch: the snapped locations, the distances to them and the OSM nodes
+    // of the snapped segments as [from, to, from, to, ...]. Coordinates that were not snapped keep
+    // their location, their distance is missing and their nodes are 0.
+    template <typename WriterT>
+    void MakeBatchResponse(const std::vector<std::vector<PhantomNodeWithDistance>> &phantom_nodes,
+                           WriterT &writer) const
+    {
+        BOOST_ASSERT(phantom_nodes.size() == parameters.coordinates.size());
+
+        std::vector<util::Coordinate> locations;
+        std::vector<std::uint64_t> nodes;
+        MakeBatchColumns(phantom_nodes, locations, nodes);
+
+        writer.StartObject();
+        writer.Key("code");
+        writer.String("Ok");
+        writer.Key("locations");
+        writer.CoordinateArray(locations.begin(), locations.end());
+        writer.Key("distances");
+        writer.NumberArray(phantom_nodes.begin(),
+                           phantom_nodes.end(),
+                           [](const std::vector<PhantomNodeWithDistance> &phantoms) {
+                               return phantoms.empty()
+                                          ? std::numeric_limits<double>::quiet_NaN()
+                                          : phantoms.front().distance;
+                           });
+        writer.Key("nodes");
+        writer.IntegerArray(
+            nodes.begin(), nodes.end(), [](const std::uint64_t node) { return node; });
+        writer.EndObject();
+    }
+
+    void MakeBatchResponse(const std::vector<std::vector<PhantomNodeWithDistance>> &phantom_nodes,
+                           util::json::Object &response) const
+    {
+        BOOST_ASSERT(phantom_nodes.size() == parameters.coordinates.size());
+
+        std::vector<util::Coordinate> locations;
+        std::vector<std::uint64_t> nodes;
+        MakeBatchColumns(phantom_nodes, locations, nodes);
+
+        util::json::Array json_locations;
+        json_locations.values.reserve(locations.size());
+        for (const auto &location : locations)
+        {
+            json_locations.values.push_back(json::detail::coordinateToLonLat(location));
+        }
+
+        util::json::Array json_distances;
+        json_distances.values.reserve(phantom_nodes.size());
+        for (const auto &phantoms : phantom_nodes)
+        {
+            if (phantoms.empty())
+            {
+                json_distances.values.push_back(util::json::Null());
+            }
+            else
+            {
+                json_distances.values.push_back(phantoms.front().distance);
+            }
+        }
+
+        util::json::Array json_nodes;
+        json_nodes.values.assign(nodes.begin(), nodes.end());
+
+        response.values["code"] = "Ok";
+        response.values["locations"] = std::move(json_locations);
+        response.values["distances"] = std::move(json_distances);
+        response.values["nodes"] = std::move(json_nodes);
+    }
+
+    void MakeBatchResponse(const std::vector<std::vector<PhantomNodeWithDistance>> &phantom_nodes,
+                           ResultT &response) const
+    {
+        VisitResult(response, [&](auto &output) { MakeBatchResponse(phantom_nodes, output); });
+    }
+
     const NearestParameters &parameters;
+
+  private:
+    // OSM nodes of the segment of the phantom node, 0 if its direction is disabled
+    std::pair<std::uint64_t, std::uint64_t> GetOSMNodes(const PhantomNode &phantom_node) const
+    {
+        std::uint64_t from_node = 0;
+        std::uint64_t to_node = 0;
+
+        std::vector<NodeID> forward_geometry;
+        if (phantom_node.forward_segment_id.enabled)
+        {
+            auto segment_id = phantom_node.forward_segment_id.id;
+            const auto geometry_id = facade.GetGeometryIndex(segment_id).id;
+            forward_geometry = facade.GetUncompressedForwardGeometry(geometry_id);
+
+            auto osm_node_id =
+                facade.GetOSMNodeIDOfNode(forward_geometry[phantom_node.fwd_segment_position]);
+            to_node = static_cast<std::uint64_t>(osm_node_id);
+        }
+
+        if (phantom_node.reverse_segment_id.enabled)
+        {
+            auto segment_id = phantom_node.reverse_segment_id.id;
+            const auto geometry_id = facade.GetGeometryIndex(segment_id).id;
+            std::vector<NodeID> geometry = facade.GetUncompressedForwardGeometry(geometry_id);
+            auto osm_node_id =
+                facade.GetOSMNodeIDOfNode(geometry[phantom_node.fwd_segment_position + 1]);
+            from_node = static_cast<std::uint64_t>(osm_node_id);
+        }
+        else if (phantom_node.forward_segment_id.enabled && phantom_node.fwd_segment_position > 0)
+        {
+            // In the case of one way, rely on forward segment only
+            auto osm_node_id =
+                facade.GetOSMNodeIDOfNode(forward_geometry[phantom_node.fwd_segment_position - 1]);
+            from_node = static_cast<std::uint64_t>(osm_node_id);
+        }
+
+        return std::make_pair(from_node, to_node);
+    }
+
+    void MakeBatchColumns(const std::vector<std::vector<PhantomNodeWithDistance>> &phantom_nodes,
+                          std::vector<util::Coordinate> &locations,
+                          std::vector<std::uint64_t> &nodes) const
+    {
+        locations.reserve(phantom_nodes.size());
+        nodes.reserve(2 * phantom_nodes.size());
+        for (const auto index : util::irange<std::size_t>(0UL, phantom_nodes.size()))
+        {
+            if (phantom_nodes[index].empty())
+            {
+                locations.push_back(parameters.coordinates[index]);
+                nodes.push_back(0);
+                nodes.push_back(0);
+            }
+            else
+            {
+                const auto &phantom_node = phantom_nodes[index].front().phantom_node;
+                const auto from_and_to_node = GetOSMNodes(phantom_node);
+                locations.push_back(phantom_node.location);
+                nodes.push_back(from_and_to_node.first);
+                nodes.push_back(from_and_to_node.second);
+            }
+        }
+    }
 };
 
 } // ns api
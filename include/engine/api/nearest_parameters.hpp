@@ -42,6 +42,8 @@ namespace api
  *
  * Holds member attributes:
  *  - number of results: number of nearest segments that should be returned
+ *  - batch: snaps every coordinate to its nearest segment and returns the results as packed
+ *    arrays, instead of the waypoints of a single coordinate
  *
  * \see OSRM, Coordinate, Hint, Bearing, RouteParame, RouteParameters, TableParameters,
  *      NearestParameters, TripParameters, MatchParameters and TileParameters
@@ -49,6 +51,7 @@ namespace api
 struct NearestParameters : public BaseParameters
 {
     unsigned number_of_results = 1;
+    bool batch = false;
 
     bool IsValid() const { return BaseParameters::IsValid() && number_of_results >= 1; }
 };
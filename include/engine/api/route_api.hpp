@@ -2,6 +2,7 @@
 #define ENGINE_API_ROUTE_HPP
 
 #include "engine/api/base_api.hpp"
+#include "engine/api/base_result.hpp"
 #include "engine/api/json_factory.hpp"
 #include "engine/api/route_parameters.hpp"
 
@@ -22,6 +23,7 @@
 #include "util/coordinate.hpp"
 #include "util/integer_range.hpp"
 #include "util/json_util.hpp"
+#include "util/json_writer.hpp"
 
 #include <iterator>
 #include <vector>
@@ -65,6 +67,43 @@ class RouteAPI : public BaseAPI
         response.values["code"] = "Ok";
     }
 
+    // Same response as above, written by a json::Writer or cbor::Writer without building the
+    // object tree
+    template <typename WriterT>
+    void MakeResponse(const InternalManyRoutesResult &raw_routes, WriterT &writer) const
+    {
+        BOOST_ASSERT(!raw_routes.routes.empty());
+
+        writer.StartObject();
+        writer.Key("code");
+        writer.String("Ok");
+        writer.Key("waypoints");
+        writer.Value(BaseAPI::MakeWaypoints(raw_routes.routes[0].segment_end_coordinates));
+
+        writer.Key("routes");
+        writer.StartArray();
+        for (const auto &route : raw_routes.routes)
+        {
+            if (!route.is_valid())
+                continue;
+
+            writer.StartObject();
+            WriteRouteMembers(writer,
+                              route.segment_end_coordinates,
+                              route.unpacked_path_segments,
+                              route.source_traversed_in_reverse,
+                              route.target_traversed_in_reverse);
+            writer.EndObject();
+        }
+        writer.EndArray();
+        writer.EndObject();
+    }
+
+    void MakeResponse(const InternalManyRoutesResult &raw_routes, ResultT &response) const
+    {
+        VisitResult(response, [&](auto &output) { MakeResponse(raw_routes, output); });
+    }
+
   protected:
     template <typename ForwardIter>
     util::json::Value MakeGeometry(ForwardIter begin, ForwardIter end) const
@@ -83,6 +122,40 @@ class RouteAPI : public BaseAPI
         return json::makeGeoJSONGeometry(begin, end);
     }
 
+    template <typename WriterT, typename ForwardIter>
+    void WriteGeometry(WriterT &writer, ForwardIter begin, ForwardIter end) const
+    {
+        if (parameters.geometries == RouteParameters::GeometriesType::Polyline)
+        {
+            writer.String(encodePolyline<100000>(begin, end));
+            return;
+        }
+
+        if (parameters.geometries == RouteParameters::GeometriesType::Polyline6)
+        {
+            writer.String(encodePolyline<1000000>(begin, end));
+            return;
+        }
+
+        BOOST_ASSERT(parameters.geometries == RouteParameters::GeometriesType::GeoJSON);
+        BOOST_ASSERT(begin != end);
+        writer.StartObject();
+        writer.Key("type");
+        writer.String("LineString");
+        writer.Key("coordinates");
+        if (std::next(begin) != end)
+        {
+            writer.CoordinateArray(begin, end);
+        }
+        else
+        {
+            // [location, location] LineString, the same as json::makeGeoJSONGeometry
+            const util::Coordinate locations[] = {*begin, *begin};
+            writer.CoordinateArray(std::begin(locations), std::end(locations));
+        }
+        writer.EndObject();
+    }
+
     template <typename GetFn>
     util::json::Array GetAnnotations(const guidance::LegGeometry &leg, GetFn Get) const
     {
@@ -97,13 +170,72 @@ class RouteAPI : public BaseAPI
         return annotations_store;
     }
 
-    util::json::Object MakeRoute(const std::vector<PhantomNodes> &segment_end_coordinates,
-                                 const std::vector<std::vector<PathData>> &unpacked_path_segments,
-                                 const std::vector<bool> &source_traversed_in_reverse,
-                                 const std::vector<bool> &target_traversed_in_reverse) const
+    RouteParameters::AnnotationsType GetRequestedAnnotations() const
+    {
+        // To maintain support for uses of the old default constructors, we check
+        // if annotations property was set manually after default construction
+        auto requested_annotations = parameters.annotations_type;
+        if ((parameters.annotations == true) &&
+            (parameters.annotations_type == RouteParameters::AnnotationsType::None))
+        {
+            requested_annotations = RouteParameters::AnnotationsType::All;
+        }
+        return requested_annotations;
+    }
+
+    // Calls handle(name, get) for every requested annotation with a value per segment of the leg
+    // geometry, get returns the value of a segment.
+    template <typename HandlerT> void VisitSegmentAnnotations(HandlerT &&handle) const
+    {
+        const auto requested_annotations = GetRequestedAnnotations();
+
+        // AnnotationsType uses bit flags, & operator checks if a property is set
+        if (parameters.annotations_type & RouteParameters::AnnotationsType::Speed)
+        {
+            double prev_speed = 0;
+            handle("speed", [&prev_speed](const guidance::LegGeometry::Annotation &anno) {
+                if (anno.duration < std::numeric_limits<double>::min())
+                {
+                    return prev_speed;
+                }
+                else
+                {
+                    auto speed = std::round(anno.distance / anno.duration * 10.) / 10.;
+                    prev_speed = speed;
+                    return util::json::clamp_float(speed);
+                }
+            });
+        }
+
+        if (requested_annotations & RouteParameters::AnnotationsType::Duration)
+        {
+            handle("duration",
+                   [](const guidance::LegGeometry::Annotation &anno) { return anno.duration; });
+        }
+        if (requested_annotations & RouteParameters::AnnotationsType::Distance)
+        {
+            handle("distance",
+                   [](const guidance::LegGeometry::Annotation &anno) { return anno.distance; });
+        }
+        if (requested_annotations & RouteParameters::AnnotationsType::Weight)
+        {
+            handle("weight",
+                   [](const guidance::LegGeometry::Annotation &anno) { return anno.weight; });
+        }
+        if (requested_annotations & RouteParameters::AnnotationsType::Datasources)
+        {
+            handle("datasources",
+                   [](const guidance::LegGeometry::Annotation &anno) { return anno.datasource; });
+        }
+    }
+
+    void MakeLegs(const std::vector<PhantomNodes> &segment_end_coordinates,
+                  const std::vector<std::vector<PathData>> &unpacked_path_segments,
+                  const std::vector<bool> &source_traversed_in_reverse,
+                  const std::vector<bool> &target_traversed_in_reverse,
+                  std::vector<guidance::RouteLeg> &legs,
+                  std::vector<guidance::LegGeometry> &leg_geometries) const
     {
-        std::vector<guidance::RouteLeg> legs;
-        std::vector<guidance::LegGeometry> leg_geometries;
         auto number_of_legs = segment_end_coordinates.size();
         legs.reserve(number_of_legs);
         leg_geometries.reserve(number_of_legs);
@@ -188,17 +320,38 @@ class RouteAPI : public BaseAPI
             leg_geometries.push_back(std::move(leg_geometry));
             legs.push_back(std::move(leg));
         }
+    }
+
+    std::vector<util::Coordinate>
+    MakeOverview(const std::vector<guidance::LegGeometry> &leg_geometries) const
+    {
+        const auto use_simplification =
+            parameters.overview == RouteParameters::OverviewType::Simplified;
+        BOOST_ASSERT(use_simplification ||
+                     parameters.overview == RouteParameters::OverviewType::Full);
+
+        return guidance::assembleOverview(leg_geometries, use_simplification);
+    }
+
+    util::json::Object MakeRoute(const std::vector<PhantomNodes> &segment_end_coordinates,
+                                 const std::vector<std::vector<PathData>> &unpacked_path_segments,
+                                 const std::vector<bool> &source_traversed_in_reverse,
+                                 const std::vector<bool> &target_traversed_in_reverse) const
+    {
+        std::vector<guidance::RouteLeg> legs;
+        std::vector<guidance::LegGeometry> leg_geometries;
+        MakeLegs(segment_end_coordinates,
+                 unpacked_path_segments,
+                 source_traversed_in_reverse,
+                 target_traversed_in_reverse,
+                 legs,
+                 leg_geometries);
 
         auto route = guidance::assembleRoute(legs);
         boost::optional<util::json::Value> json_overview;
         if (parameters.overview != RouteParameters::OverviewType::False)
         {
-            const auto use_simplification =
-                parameters.overview == RouteParameters::OverviewType::Simplified;
-            BOOST_ASSERT(use_simplification ||
-                         parameters.overview == RouteParameters::OverviewType::Full);
-
-            auto overview = guidance::assembleOverview(leg_geometries, use_simplification);
+            auto overview = MakeOverview(leg_geometries);
             json_overview = MakeGeometry(overview.begin(), overview.end());
         }
 
@@ -209,43 +362,19 @@ class RouteAPI : public BaseAPI
 
             step_geometries.reserve(step_geometries.size() + legs[idx].steps.size());
 
-            std::transform(
-                legs[idx].steps.begin(),
-                legs[idx].steps.end(),
-                std::back_inserter(step_geometries),
-                [this, &leg_geometry](const guidance::RouteStep &step) {
-                    if (parameters.geometries == RouteParameters::GeometriesType::Polyline)
-                    {
-                        return static_cast<util::json::Value>(json::makePolyline<100000>(
-                            leg_geometry.locations.begin() + step.geometry_begin,
-                            leg_geometry.locations.begin() + step.geometry_end));
-                    }
-
-                    if (parameters.geometries == RouteParameters::GeometriesType::Polyline6)
-                    {
-                        return static_cast<util::json::Value>(json::makePolyline<1000000>(
-                            leg_geometry.locations.begin() + step.geometry_begin,
-                            leg_geometry.locations.begin() + step.geometry_end));
-                    }
-
-                    BOOST_ASSERT(parameters.geometries == RouteParameters::GeometriesType::GeoJSON);
-                    return static_cast<util::json::Value>(json::makeGeoJSONGeometry(
-                        leg_geometry.locations.begin() + step.geometry_begin,
-                        leg_geometry.locations.begin() + step.geometry_end));
-                });
+            std::transform(legs[idx].steps.begin(),
+                           legs[idx].steps.end(),
+                           std::back_inserter(step_geometries),
+                           [this, &leg_geometry](const guidance::RouteStep &step) {
+                               return MakeGeometry(
+                                   leg_geometry.locations.begin() + step.geometry_begin,
+                                   leg_geometry.locations.begin() + step.geometry_end);
+                           });
         }
 
         std::vector<util::json::Object> annotations;
 
-        // To maintain support for uses of the old default constructors, we check
-        // if annotations property was set manually after default construction
-        auto requested_annotations = parameters.annotations_type;
-        if ((parameters.annotations == true) &&
-            (parameters.annotations_type == RouteParameters::AnnotationsType::None))
-        {
-            requested_annotations = RouteParameters::AnnotationsType::All;
-        }
-
+        const auto requested_annotations = GetRequestedAnnotations();
         if (requested_annotations != RouteParameters::AnnotationsType::None)
         {
             for (const auto idx : util::irange<std::size_t>(0UL, leg_geometries.size()))
@@ -253,52 +382,10 @@ class RouteAPI : public BaseAPI
                 auto &leg_geometry = leg_geometries[idx];
                 util::json::Object annotation;
 
-                // AnnotationsType uses bit flags, & operator checks if a property is set
-                if (parameters.annotations_type & RouteParameters::AnnotationsType::Speed)
-                {
-                    double prev_speed = 0;
-                    annotation.values["speed"] = GetAnnotations(
-                        leg_geometry, [&prev_speed](const guidance::LegGeometry::Annotation &anno) {
-                            if (anno.duration < std::numeric_limits<double>::min())
-                            {
-                                return prev_speed;
-                            }
-                            else
-                            {
-                                auto speed = std::round(anno.distance / anno.duration * 10.) / 10.;
-                                prev_speed = speed;
-                                return util::json::clamp_float(speed);
-                            }
-                        });
-                }
+                VisitSegmentAnnotations([&](const char *name, auto get) {
+                    annotation.values[name] = GetAnnotations(leg_geometry, get);
+                });
 
-                if (requested_annotations & RouteParameters::AnnotationsType::Duration)
-                {
-                    annotation.values["duration"] = GetAnnotations(
-                        leg_geometry, [](const guidance::LegGeometry::Annotation &anno) {
-                            return anno.duration;
-                        });
-                }
-                if (requested_annotations & RouteParameters::AnnotationsType::Distance)
-                {
-                    annotation.values["distance"] = GetAnnotations(
-                        leg_geometry, [](const guidance::LegGeometry::Annotation &anno) {
-                            return anno.distance;
-                        });
-                }
-                if (requested_annotations & RouteParameters::AnnotationsType::Weight)
-                {
-                    annotation.values["weight"] = GetAnnotations(
-                        leg_geometry,
-                        [](const guidance::LegGeometry::Annotation &anno) { return anno.weight; });
-                }
-                if (requested_annotations & RouteParameters::AnnotationsType::Datasources)
-                {
-                    annotation.values["datasources"] = GetAnnotations(
-                        leg_geometry, [](const guidance::LegGeometry::Annotation &anno) {
-                            return anno.datasource;
-                        });
-                }
                 if (requested_annotations & RouteParameters::AnnotationsType::Nodes)
                 {
                     util::json::Array nodes;
@@ -324,6 +411,97 @@ class RouteAPI : public BaseAPI
         return result;
     }
 
+    // Writes the members of the object MakeRoute returns. Steps are small and still built as
+    // objects one by one, geometries and annotations are written directly.
+    template <typename WriterT>
+    void WriteRouteMembers(WriterT &writer,
+                           const std::vector<PhantomNodes> &segment_end_coordinates,
+                           const std::vector<std::vector<PathData>> &unpacked_path_segments,
+                           const std::vector<bool> &source_traversed_in_reverse,
+                           const std::vector<bool> &target_traversed_in_reverse) const
+    {
+        std::vector<guidance::RouteLeg> legs;
+        std::vector<guidance::LegGeometry> leg_geometries;
+        MakeLegs(segment_end_coordinates,
+                 unpacked_path_segments,
+                 source_traversed_in_reverse,
+                 target_traversed_in_reverse,
+                 legs,
+                 leg_geometries);
+
+        const auto route = guidance::assembleRoute(legs);
+        writer.Key("distance");
+        writer.Number(route.distance);
+        writer.Key("duration");
+        writer.Number(route.duration);
+        writer.Key("weight");
+        writer.Number(route.weight);
+        writer.Key("weight_name");
+        writer.String(facade.GetWeightName());
+
+        const auto requested_annotations = GetRequestedAnnotations();
+
+        writer.Key("legs");
+        writer.StartArray();
+        for (const auto idx : util::irange<std::size_t>(0UL, legs.size()))
+        {
+            const auto &leg = legs[idx];
+            const auto &leg_geometry = leg_geometries[idx];
+
+            writer.StartObject();
+            writer.Key("distance");
+            writer.Number(leg.distance);
+            writer.Key("duration");
+            writer.Number(leg.duration);
+            writer.Key("weight");
+            writer.Number(leg.weight);
+            writer.Key("summary");
+            writer.String(leg.summary);
+
+            writer.Key("steps");
+            writer.StartArray();
+            for (const auto &step : leg.steps)
+            {
+                writer.Value(json::makeRouteStep(
+                    step,
+                    MakeGeometry(leg_geometry.locations.begin() + step.geometry_begin,
+                                 leg_geometry.locations.begin() + step.geometry_end)));
+            }
+            writer.EndArray();
+
+            if (requested_annotations != RouteParameters::AnnotationsType::None)
+            {
+                writer.Key("annotation");
+                writer.StartObject();
+                VisitSegmentAnnotations([&](const char *name, auto get) {
+                    writer.Key(name);
+                    writer.NumberArray(
+                        leg_geometry.annotations.begin(), leg_geometry.annotations.end(), get);
+                });
+
+                if (requested_annotations & RouteParameters::AnnotationsType::Nodes)
+                {
+                    writer.Key("nodes");
+                    writer.IntegerArray(leg_geometry.osm_node_ids.begin(),
+                                        leg_geometry.osm_node_ids.end(),
+                                        [](const OSMNodeID node_id) {
+                                            return static_cast<std::uint64_t>(node_id);
+                                        });
+                }
+                writer.EndObject();
+            }
+            writer.EndObject();
+        }
+        writer.EndArray();
+
+        if (parameters.overview != RouteParameters::OverviewType::False)
+        {
+            const auto overview = MakeOverview(leg_geometries);
+            writer.Key("geometry");
+            WriteGeometry(writer, overview.begin(), overview.end());
+        }
+    }
+
     const RouteParameters &parameters;
 };
 
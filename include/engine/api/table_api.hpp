@@ -2,6 +2,7 @@
 #define ENGINE_API_TABLE_HPP
 
 #include "engine/api/base_api.hpp"
+#include "engine/api/base_result.hpp"
 #include "engine/api/json_factory.hpp"
 #include "engine/api/table_parameters.hpp"
 
@@ -16,10 +17,17 @@
 #include "engine/internal_route_result.hpp"
 
 #include "util/integer_range.hpp"
+#include "util/json_writer.hpp"
 
+#include <boost/assert.hpp>
 #include <boost/range/algorithm/transform.hpp>
 
+#include <algorithm>
+#include <cmath>
 #include <iterator>
+#include <limits>
+#include <utility>
+#include <vector>
 
 namespace osrm
 {
@@ -36,9 +44,10 @@ class TableAPI final : public BaseAPI
     {
     }
 
-    virtual void MakeResponse(const std::vector<EdgeWeight> &durations,
-                              const std::vector<PhantomNode> &phantoms,
-                              util::json::Object &response) const
+    virtual void
+    MakeResponse(const std::pair<std::vector<EdgeDuration>, std::vector<EdgeDistance>> &tables,
+                 const std::vector<PhantomNode> &phantoms,
+                 util::json::Object &response) const
     {
         auto number_of_sources = parameters.sources.size();
         auto number_of_destinations = parameters.destinations.size();
@@ -64,12 +73,124 @@ class TableAPI final : public BaseAPI
             response.values["destinations"] = MakeWaypoints(phantoms, parameters.destinations);
         }
 
-        response.values["durations"] =
-            MakeTable(durations, number_of_sources, number_of_destinations);
+        if (parameters.annotations & TableParameters::AnnotationsType::Duration)
+        {
+            response.values["durations"] =
+                MakeDurationTable(tables.first, number_of_sources, number_of_destinations);
+        }
+
+        if (parameters.annotations & TableParameters::AnnotationsType::Distance)
+        {
+            response.values["distances"] =
+                MakeDistanceTable(tables.second, number_of_sources, number_of_destinations);
+        }
+
         response.values["code"] = "Ok";
     }
 
+    // Same response as above, written by a json::Writer or cbor::Writer without building the
+    // object tree
+    template <typename WriterT>
+    void MakeResponse(const std::pair<std::vector<EdgeDuration>, std::vector<EdgeDistance>> &tables,
+                      const std::vector<PhantomNode> &phantoms,
+                      WriterT &writer) const
+    {
+        auto number_of_sources = parameters.sources.size();
+        auto number_of_destinations = parameters.destinations.size();
+
+        writer.StartObject();
+        writer.Key("code");
+        writer.String("Ok");
+
+        writer.Key("sources");
+        if (parameters.sources.empty())
+        {
+            WriteWaypoints(writer, phantoms, util::irange<std::size_t>(0UL, phantoms.size()));
+            number_of_sources = phantoms.size();
+        }
+        else
+        {
+            WriteWaypoints(writer, phantoms, parameters.sources);
+        }
+
+        writer.Key("destinations");
+        if (parameters.destinations.empty())
+        {
+            WriteWaypoints(writer, phantoms, util::irange<std::size_t>(0UL, phantoms.size()));
+            number_of_destinations = phantoms.size();
+        }
+        else
+        {
+            WriteWaypoints(writer, phantoms, parameters.destinations);
+        }
+
+        if (parameters.annotations & TableParameters::AnnotationsType::Duration)
+        {
+            writer.Key("durations");
+            WriteTable(writer,
+                       tables.first,
+                       number_of_sources,
+                       number_of_destinations,
+                       DurationToNumber);
+        }
+
+        if (parameters.annotations & TableParameters::AnnotationsType::Distance)
+        {
+            writer.Key("distances");
+            WriteTable(writer,
+                       tables.second,
+                       number_of_sources,
+                       number_of_destinations,
+                       DistanceToNumber);
+        }
+
+        writer.EndObject();
+    }
+
+    void MakeResponse(const std::pair<std::vector<EdgeDuration>, std::vector<EdgeDistance>> &tables,
+                      const std::vector<PhantomNode> &phantoms,
+                      ResultT &response) const
+    {
+        VisitResult(response, [&](auto &output) { MakeResponse(tables, phantoms, output); });
+    }
+
   protected:
+    static double DurationToNumber(const EdgeDuration duration)
+    {
+        if (duration == MAXIMAL_EDGE_DURATION)
+        {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        return duration / 10.;
+    }
+
+    static double DistanceToNumber(const EdgeDistance distance)
+    {
+        if (distance == INVALID_EDGE_DISTANCE)
+        {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        return std::round(distance * 10) / 10.;
+    }
+
+    static util::json::Value DurationToJSON(const EdgeDuration duration)
+    {
+        if (duration == MAXIMAL_EDGE_DURATION)
+        {
+            return util::json::Null();
+        }
+        return util::json::Number(duration / 10.);
+    }
+
+    static util::json::Value DistanceToJSON(const EdgeDistance distance)
+    {
+        if (distance == INVALID_EDGE_DISTANCE)
+        {
+            return util::json::Null();
+        }
+        return util::json::Number(std::round(distance * 10) / 10.);
+    }
+
     virtual util::json::Array MakeWaypoints(const std::vector<PhantomNode> &phantoms) const
     {
         util::json::Array json_waypoints;
@@ -97,10 +218,28 @@ class TableAPI final : public BaseAPI
         return json_waypoints;
     }
 
-    virtual util::json::Array MakeTable(const std::vector<EdgeWeight> &values,
-                                        std::size_t number_of_rows,
-                                        std::size_t number_of_columns) const
+    virtual util::json::Array MakeDurationTable(const std::vector<EdgeDuration> &values,
+                                                std::size_t number_of_rows,
+                                                std::size_t number_of_columns) const
     {
+        return MakeTable(values, number_of_rows, number_of_columns, DurationToJSON);
+    }
+
+    virtual util::json::Array MakeDistanceTable(const std::vector<EdgeDistance> &values,
+                                                std::size_t number_of_rows,
+                                                std::size_t number_of_columns) const
+    {
+        return MakeTable(values, number_of_rows, number_of_columns, DistanceToJSON);
+    }
+
+    template <typename T, typename ToJSON>
+    util::json::Array MakeTable(const std::vector<T> &values,
+                                std::size_t number_of_rows,
+                                std::size_t number_of_columns,
+                                ToJSON &&to_json) const
+    {
+        BOOST_ASSERT(values.size() == number_of_rows * number_of_columns);
+
         util::json::Array json_table;
         for (const auto row : util::irange<std::size_t>(0UL, number_of_rows))
         {
@@ -108,21 +247,46 @@ class TableAPI final : public BaseAPI
             auto row_begin_iterator = values.begin() + (row * number_of_columns);
             auto row_end_iterator = values.begin() + ((row + 1) * number_of_columns);
             json_row.values.resize(number_of_columns);
-            std::transform(row_begin_iterator,
-                           row_end_iterator,
-                           json_row.values.begin(),
-                           [](const EdgeWeight duration) {
-                               if (duration == MAXIMAL_EDGE_DURATION)
-                               {
-                                   return util::json::Value(util::json::Null());
-                               }
-                               return util::json::Value(util::json::Number(duration / 10.));
-                           });
+            std::transform(row_begin_iterator, row_end_iterator, json_row.values.begin(), to_json);
             json_table.values.push_back(std::move(json_row));
         }
         return json_table;
     }
 
+    template <typename WriterT, typename IndicesT>
+    void WriteWaypoints(WriterT &writer,
+                        const std::vector<PhantomNode> &phantoms,
+                        const IndicesT &indices) const
+    {
+        writer.StartArray();
+        for (const std::size_t idx : indices)
+        {
+            BOOST_ASSERT(idx < phantoms.size());
+            writer.Value(BaseAPI::MakeWaypoint(phantoms[idx]));
+        }
+        writer.EndArray();
+    }
+
+    template <typename WriterT, typename T, typename ToNumber>
+    void WriteTable(WriterT &writer,
+                    const std::vector<T> &values,
+                    std::size_t number_of_rows,
+                    std::size_t number_of_columns,
+                    ToNumber &&to_number) const
+    {
+        BOOST_ASSERT(values.size() == number_of_rows * number_of_columns);
+
+        // every row is a packed array, unreachable entries are NaN
+        writer.StartArray();
+        for (const auto row : util::irange<std::size_t>(0UL, number_of_rows))
+        {
+            writer.NumberArray(values.begin() + row * number_of_columns,
+                               values.begin() + (row + 1) * number_of_columns,
+                               to_number);
+        }
+        writer.EndArray();
+    }
+
     const TableParameters &parameters;
 };
 
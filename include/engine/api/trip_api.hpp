@@ -47,6 +47,48 @@ class TripAPI final : public RouteAPI
         response.values["code"] = "Ok";
     }
 
+    // Same response as above, written by a json::Writer or cbor::Writer without building the
+    // object tree
+    template <typename WriterT>
+    void MakeResponse(const std::vector<std::vector<NodeID>> &sub_trips,
+                      const std::vector<InternalRouteResult> &sub_routes,
+                      const std::vector<PhantomNode> &phantoms,
+                      WriterT &writer) const
+    {
+        BOOST_ASSERT(sub_trips.size() == sub_routes.size());
+
+        writer.StartObject();
+        writer.Key("code");
+        writer.String("Ok");
+        writer.Key("waypoints");
+        writer.Value(MakeWaypoints(sub_trips, phantoms));
+
+        writer.Key("trips");
+        writer.StartArray();
+        for (auto index : util::irange<std::size_t>(0UL, sub_trips.size()))
+        {
+            writer.StartObject();
+            WriteRouteMembers(writer,
+                              sub_routes[index].segment_end_coordinates,
+                              sub_routes[index].unpacked_path_segments,
+                              sub_routes[index].source_traversed_in_reverse,
+                              sub_routes[index].target_traversed_in_reverse);
+            writer.EndObject();
+        }
+        writer.EndArray();
+        writer.EndObject();
+    }
+
+    void MakeResponse(const std::vector<std::vector<NodeID>> &sub_trips,
+                      const std::vector<InternalRouteResult> &sub_routes,
+                      const std::vector<PhantomNode> &phantoms,
+                      ResultT &response) const
+    {
+        VisitResult(response, [&](auto &output) {
+            MakeResponse(sub_trips, sub_routes, phantoms, output);
+        });
+    }
+
   protected:
     // FIXME this logic is a little backwards. We should change the output format of the
     // trip plugin routing algorithm to be easier to consume here.
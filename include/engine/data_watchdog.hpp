@@ -14,6 +14,7 @@
 #include <boost/thread/locks.hpp>
 #include <boost/thread/shared_mutex.hpp>
 
+#include <atomic>
 #include <memory>
 #include <thread>
 
@@ -36,7 +37,8 @@ class DataWatchdogImpl<AlgorithmT, datafacade::ContiguousInternalMemoryDataFacad
     using Facade = datafacade::ContiguousInternalMemoryDataFacade<AlgorithmT>;
 
   public:
-    DataWatchdogImpl() : active(true), timestamp(0)
+    DataWatchdogImpl(std::shared_ptr<PhantomNodeCache> phantom_node_cache_)
+        : active(true), timestamp(0), phantom_node_cache(std::move(phantom_node_cache_))
     {
         // create the initial facade before launching the watchdog thread
         {
@@ -44,7 +46,9 @@ class DataWatchdogImpl<AlgorithmT, datafacade::ContiguousInternalMemoryDataFacad
 
             facade_factory =
                 DataFacadeFactory<datafacade::ContiguousInternalMemoryDataFacade, AlgorithmT>(
-                    std::make_shared<datafacade::SharedMemoryAllocator>(barrier.data().region));
+                    std::make_shared<datafacade::SharedMemoryAllocator>(
+                        barrier.data().region, barrier.data().metric_region),
+                    phantom_node_cache);
             timestamp = barrier.data().timestamp;
         }
 
@@ -67,6 +71,9 @@ class DataWatchdogImpl<AlgorithmT, datafacade::ContiguousInternalMemoryDataFacad
         return facade_factory.Get(params);
     }
 
+    // Timestamp of the dataset in use, increases with every dataset loaded by osrm-datastore
+    unsigned GetTimestamp() const { return timestamp; }
+
   private:
     void Run()
     {
@@ -81,13 +88,16 @@ class DataWatchdogImpl<AlgorithmT, datafacade::ContiguousInternalMemoryDataFacad
 
             if (timestamp != barrier.data().timestamp)
             {
+                // the metric region changes alone if osrm-datastore only loaded a new metric
                 auto region = barrier.data().region;
+                auto metric_region = barrier.data().metric_region;
                 facade_factory =
                     DataFacadeFactory<datafacade::ContiguousInternalMemoryDataFacade, AlgorithmT>(
-                        std::make_shared<datafacade::SharedMemoryAllocator>(region));
+                        std::make_shared<datafacade::SharedMemoryAllocator>(region, metric_region),
+                        phantom_node_cache);
                 timestamp = barrier.data().timestamp;
-                util::Log() << "updated facade to region " << region << " with timestamp "
-                            << timestamp;
+                util::Log() << "updated facade to region " << region << " and metric region "
+                            << metric_region << " with timestamp " << timestamp;
             }
         }
 
@@ -97,7 +107,8 @@ class DataWatchdogImpl<AlgorithmT, datafacade::ContiguousInternalMemoryDataFacad
     storage::SharedMonitor<storage::SharedDataTimestamp> barrier;
     std::thread watcher;
     bool active;
-    unsigned timestamp;
+    std::atomic<unsigned> timestamp;
+    std::shared_ptr<PhantomNodeCache> phantom_node_cache;
     DataFacadeFactory<datafacade::ContiguousInternalMemoryDataFacade, AlgorithmT> facade_factory;
 };
 }
@@ -21,6 +21,7 @@ namespace datafacade
 // Namespace local aliases for algorithms
 using CH = routing_algorithms::ch::Algorithm;
 using MLD = routing_algorithms::mld::Algorithm;
+using CCH = routing_algorithms::cch::Algorithm;
 
 template <typename AlgorithmT> class AlgorithmDataFacade;
 
@@ -85,6 +86,19 @@ template <> class AlgorithmDataFacade<MLD>
 
     // searches for a specific edge
     virtual EdgeID FindEdge(const NodeID from, const NodeID to) const = 0;
+
+    // identifies the metric and exclude flags of this facade in the unpacking cache
+    virtual std::uint32_t GetUnpackingCacheOwner() const = 0;
+};
+
+// The search graph of a CCH has the format of a CH, see AlgorithmDataFacade<CH>
+template <> class AlgorithmDataFacade<CCH>
+{
+  public:
+    // lowest ranked upward neighbour of the node, SPECIAL_NODEID for the roots
+    virtual NodeID GetEliminationTreeParent(const NodeID node) const = 0;
+
+    virtual NodeID GetRank(const NodeID node) const = 0;
 };
 }
 }
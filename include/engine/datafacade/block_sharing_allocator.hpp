@@ -0,0 +1,60 @@
+#ifndef OSRM_ENGINE_DATAFACADE_BLOCK_SHARING_ALLOCATOR_HPP_
+#define OSRM_ENGINE_DATAFACADE_BLOCK_SHARING_ALLOCATOR_HPP_
+
+#include "engine/datafacade/contiguous_block_allocator.hpp"
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace datafacade
+{
+
+/**
+ * This allocator keeps blocks that are identical in several datasets
+ * of a process only once, e.g. the names and coordinates of datasets
+ * that were built from the same extract for different profiles.
+ *
+ * The shareable blocks of the wrapped allocator are compared by a
+ * fingerprint of their content with the blocks of all other live
+ * BlockSharingAllocators. A block that another dataset loaded before
+ * is used from that dataset and the pages of the own copy are given
+ * back to the operating system, so the own copy must only be read
+ * through GetBlockMemory.
+ */
+class BlockSharingAllocator : public ContiguousBlockAllocator
+{
+  public:
+    static const std::array<storage::DataLayout::BlockID, 7> shareable_blocks;
+
+    explicit BlockSharingAllocator(std::shared_ptr<ContiguousBlockAllocator> allocator);
+    ~BlockSharingAllocator() override final;
+
+    // interface to give access to the datafacades
+    storage::DataLayout &GetLayout() override final;
+    char *GetMemory() override final;
+    storage::DataLayout &GetMetricLayout() override final;
+    char *GetMetricMemory() override final;
+    char *GetBlockMemory(storage::DataLayout::BlockID block) override final;
+
+    // size of the blocks that are used from other datasets
+    std::size_t GetSharedSize() const { return shared_size; }
+
+  private:
+    std::shared_ptr<ContiguousBlockAllocator> allocator;
+    std::array<char *, storage::DataLayout::NUM_BLOCKS> block_memory;
+    // allocators of the datasets that own the shared blocks
+    std::vector<std::shared_ptr<ContiguousBlockAllocator>> block_owners;
+    std::size_t shared_size;
+};
+
+} // namespace datafacade
+} // namespace engine
+} // namespace osrm
+
+#endif // OSRM_ENGINE_DATAFACADE_BLOCK_SHARING_ALLOCATOR_HPP_
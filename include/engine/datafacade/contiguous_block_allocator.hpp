@@ -18,6 +18,16 @@ class ContiguousBlockAllocator
     // interface to give access to the datafacades
     virtual storage::DataLayout &GetLayout() = 0;
     virtual char *GetMemory() = 0;
+
+    // blocks that depend on the metric, by default they are part of the same memory
+    virtual storage::DataLayout &GetMetricLayout() { return GetLayout(); }
+    virtual char *GetMetricMemory() { return GetMemory(); }
+
+    // blocks that might be shared with other datasets, by default they are part of the memory
+    virtual char *GetBlockMemory(storage::DataLayout::BlockID block)
+    {
+        return GetLayout().GetBlockPtr<char>(GetMemory(), block);
+    }
 };
 
 } // namespace datafacade
@@ -8,7 +8,10 @@
 #include "engine/algorithm.hpp"
 #include "engine/approach.hpp"
 #include "engine/geospatial_query.hpp"
+#include "engine/phantom_node_cache.hpp"
+#include "engine/unpacking_cache.hpp"
 
+#include "customizer/cch_topology.hpp"
 #include "customizer/edge_based_graph.hpp"
 
 #include "extractor/datasources.hpp"
@@ -79,44 +82,69 @@ class ContiguousInternalMemoryAlgorithmDataFacade<CH> : public datafacade::Algor
     // allocator that keeps the allocation data
     std::shared_ptr<ContiguousBlockAllocator> allocator;
 
+    static storage::DataLayout::BlockID GetEdgeFilterBlockID(const std::size_t exclude_index)
+    {
+        return static_cast<storage::DataLayout::BlockID>(storage::DataLayout::CH_EDGE_FILTER_0 +
+                                                         exclude_index);
+    }
+
     void InitializeGraphPointer(storage::DataLayout &data_layout,
                                 char *memory_block,
-                                const std::size_t exclude_index)
+                                const storage::DataLayout::BlockID node_list_block_id,
+                                const storage::DataLayout::BlockID edge_list_block_id,
+                                const storage::DataLayout::BlockID filter_block_id)
     {
-        auto graph_nodes_ptr = data_layout.GetBlockPtr<GraphNode>(
-            memory_block, storage::DataLayout::CH_GRAPH_NODE_LIST);
+        auto graph_nodes_ptr = data_layout.GetBlockPtr<GraphNode>(memory_block, node_list_block_id);
 
-        auto graph_edges_ptr = data_layout.GetBlockPtr<GraphEdge>(
-            memory_block, storage::DataLayout::CH_GRAPH_EDGE_LIST);
-
-        auto filter_block_id = static_cast<storage::DataLayout::BlockID>(
-            storage::DataLayout::CH_EDGE_FILTER_0 + exclude_index);
+        auto graph_edges_ptr = data_layout.GetBlockPtr<GraphEdge>(memory_block, edge_list_block_id);
 
         auto edge_filter_ptr = data_layout.GetBlockPtr<unsigned>(memory_block, filter_block_id);
 
-        util::vector_view<GraphNode> node_list(
-            graph_nodes_ptr, data_layout.num_entries[storage::DataLayout::CH_GRAPH_NODE_LIST]);
-        util::vector_view<GraphEdge> edge_list(
-            graph_edges_ptr, data_layout.num_entries[storage::DataLayout::CH_GRAPH_EDGE_LIST]);
+        util::vector_view<GraphNode> node_list(graph_nodes_ptr,
+                                               data_layout.num_entries[node_list_block_id]);
+        util::vector_view<GraphEdge> edge_list(graph_edges_ptr,
+                                               data_layout.num_entries[edge_list_block_id]);
 
         util::vector_view<bool> edge_filter(edge_filter_ptr,
                                             data_layout.num_entries[filter_block_id]);
         m_query_graph = QueryGraph({node_list, edge_list}, edge_filter);
     }
 
+  protected:
+    // Reads a graph in the CH format from other blocks, used by the CCH facade
+    ContiguousInternalMemoryAlgorithmDataFacade(
+        std::shared_ptr<ContiguousBlockAllocator> allocator_,
+        const storage::DataLayout::BlockID node_list_block_id,
+        const storage::DataLayout::BlockID edge_list_block_id,
+        const storage::DataLayout::BlockID filter_block_id)
+        : allocator(std::move(allocator_))
+    {
+        InitializeGraphPointer(allocator->GetLayout(),
+                               allocator->GetMemory(),
+                               node_list_block_id,
+                               edge_list_block_id,
+                               filter_block_id);
+    }
+
   public:
     ContiguousInternalMemoryAlgorithmDataFacade(
         std::shared_ptr<ContiguousBlockAllocator> allocator_, std::size_t exclude_index)
-        : allocator(std::move(allocator_))
+        : ContiguousInternalMemoryAlgorithmDataFacade(std::move(allocator_),
+                                                      storage::DataLayout::CH_GRAPH_NODE_LIST,
+                                                      storage::DataLayout::CH_GRAPH_EDGE_LIST,
+                                                      GetEdgeFilterBlockID(exclude_index))
     {
-        InitializeInternalPointers(allocator->GetLayout(), allocator->GetMemory(), exclude_index);
     }
 
     void InitializeInternalPointers(storage::DataLayout &data_layout,
                                     char *memory_block,
                                     const std::size_t exclude_index)
     {
-        InitializeGraphPointer(data_layout, memory_block, exclude_index);
+        InitializeGraphPointer(data_layout,
+                               memory_block,
+                               storage::DataLayout::CH_GRAPH_NODE_LIST,
+                               storage::DataLayout::CH_GRAPH_EDGE_LIST,
+                               GetEdgeFilterBlockID(exclude_index));
     }
 
     // search graph access
@@ -185,6 +213,7 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
 
     extractor::ClassData exclude_mask;
     std::string m_timestamp;
+    storage::DatasetFingerprint m_dataset_fingerprint;
     extractor::ProfileProperties *m_profile_properties;
     extractor::Datasources *m_datasources;
 
@@ -218,6 +247,15 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
     // allocator that keeps the allocation data
     std::shared_ptr<ContiguousBlockAllocator> allocator;
 
+    // shared by all facades of an engine, might be empty
+    std::shared_ptr<PhantomNodeCache> phantom_node_cache;
+
+    // Blocks that other datasets might share, see BlockSharingAllocator
+    template <typename T> T *GetShareableBlockPtr(const storage::DataLayout::BlockID block) const
+    {
+        return reinterpret_cast<T *>(allocator->GetBlockMemory(block));
+    }
+
     void InitializeProfilePropertiesPointer(storage::DataLayout &data_layout,
                                             char *memory_block,
                                             const std::size_t exclude_index)
@@ -238,6 +276,17 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
                   m_timestamp.begin());
     }
 
+    void InitializeDatasetFingerprint(storage::DataLayout &data_layout,
+                                      char *memory_block,
+                                      storage::DataLayout &metric_layout,
+                                      char *metric_block)
+    {
+        m_dataset_fingerprint.topology = *data_layout.GetBlockPtr<std::uint64_t>(
+            memory_block, storage::DataLayout::TOPOLOGY_FINGERPRINT);
+        m_dataset_fingerprint.metric = *metric_layout.GetBlockPtr<std::uint64_t>(
+            metric_block, storage::DataLayout::METRIC_FINGERPRINT);
+    }
+
     void InitializeChecksumPointer(storage::DataLayout &data_layout, char *memory_block)
     {
         m_check_sum =
@@ -259,10 +308,9 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
                                   "Is any data loaded into shared memory?" + SOURCE_REF);
         }
 
-        auto tree_nodes_ptr =
-            data_layout.GetBlockPtr<RTreeNode>(memory_block, storage::DataLayout::R_SEARCH_TREE);
-        auto tree_level_sizes_ptr = data_layout.GetBlockPtr<std::uint64_t>(
-            memory_block, storage::DataLayout::R_SEARCH_TREE_LEVELS);
+        auto tree_nodes_ptr = GetShareableBlockPtr<RTreeNode>(storage::DataLayout::R_SEARCH_TREE);
+        auto tree_level_sizes_ptr =
+            GetShareableBlockPtr<std::uint64_t>(storage::DataLayout::R_SEARCH_TREE_LEVELS);
         m_static_rtree.reset(
             new SharedRTree(tree_nodes_ptr,
                             data_layout.num_entries[storage::DataLayout::R_SEARCH_TREE],
@@ -270,19 +318,19 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
                             data_layout.num_entries[storage::DataLayout::R_SEARCH_TREE_LEVELS],
                             file_index_path,
                             m_coordinate_list));
-        m_geospatial_query.reset(
-            new SharedGeospatialQuery(*m_static_rtree, m_coordinate_list, *this));
+        m_geospatial_query.reset(new SharedGeospatialQuery(
+            *m_static_rtree, m_coordinate_list, *this, phantom_node_cache.get()));
     }
 
-    void InitializeNodeInformationPointers(storage::DataLayout &layout, char *memory_ptr)
+    void InitializeNodeInformationPointers(storage::DataLayout &layout)
     {
         const auto coordinate_list_ptr =
-            layout.GetBlockPtr<util::Coordinate>(memory_ptr, storage::DataLayout::COORDINATE_LIST);
+            GetShareableBlockPtr<util::Coordinate>(storage::DataLayout::COORDINATE_LIST);
         m_coordinate_list.reset(coordinate_list_ptr,
                                 layout.num_entries[storage::DataLayout::COORDINATE_LIST]);
 
-        const auto osmnodeid_ptr = layout.GetBlockPtr<extractor::PackedOSMIDsView::block_type>(
-            memory_ptr, storage::DataLayout::OSM_NODE_ID_LIST);
+        const auto osmnodeid_ptr = GetShareableBlockPtr<extractor::PackedOSMIDsView::block_type>(
+            storage::DataLayout::OSM_NODE_ID_LIST);
         m_osmnodeid_list = extractor::PackedOSMIDsView(
             util::vector_view<extractor::PackedOSMIDsView::block_type>(
                 osmnodeid_ptr, layout.num_entries[storage::DataLayout::OSM_NODE_ID_LIST]),
@@ -346,10 +394,9 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
                                             std::move(post_turn_bearings));
     }
 
-    void InitializeNamePointers(storage::DataLayout &data_layout, char *memory_block)
+    void InitializeNamePointers(storage::DataLayout &data_layout)
     {
-        auto name_data_ptr =
-            data_layout.GetBlockPtr<char>(memory_block, storage::DataLayout::NAME_CHAR_DATA);
+        auto name_data_ptr = GetShareableBlockPtr<char>(storage::DataLayout::NAME_CHAR_DATA);
         const auto name_data_size = data_layout.num_entries[storage::DataLayout::NAME_CHAR_DATA];
         m_name_table.reset(name_data_ptr, name_data_ptr + name_data_size);
     }
@@ -378,79 +425,81 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
         m_lane_tupel_id_pairs = std::move(lane_tupel_id_pair);
     }
 
-    void InitializeTurnPenalties(storage::DataLayout &data_layout, char *memory_block)
+    void InitializeTurnPenalties(storage::DataLayout &metric_layout, char *metric_block)
     {
-        auto turn_weight_penalties_ptr = data_layout.GetBlockPtr<TurnPenalty>(
-            memory_block, storage::DataLayout::TURN_WEIGHT_PENALTIES);
+        auto turn_weight_penalties_ptr = metric_layout.GetBlockPtr<TurnPenalty>(
+            metric_block, storage::DataLayout::TURN_WEIGHT_PENALTIES);
         m_turn_weight_penalties = util::vector_view<TurnPenalty>(
             turn_weight_penalties_ptr,
-            data_layout.num_entries[storage::DataLayout::TURN_WEIGHT_PENALTIES]);
-        auto turn_duration_penalties_ptr = data_layout.GetBlockPtr<TurnPenalty>(
-            memory_block, storage::DataLayout::TURN_DURATION_PENALTIES);
+            metric_layout.num_entries[storage::DataLayout::TURN_WEIGHT_PENALTIES]);
+        auto turn_duration_penalties_ptr = metric_layout.GetBlockPtr<TurnPenalty>(
+            metric_block, storage::DataLayout::TURN_DURATION_PENALTIES);
         m_turn_duration_penalties = util::vector_view<TurnPenalty>(
             turn_duration_penalties_ptr,
-            data_layout.num_entries[storage::DataLayout::TURN_DURATION_PENALTIES]);
+            metric_layout.num_entries[storage::DataLayout::TURN_DURATION_PENALTIES]);
     }
 
-    void InitializeGeometryPointers(storage::DataLayout &data_layout, char *memory_block)
+    void InitializeGeometryPointers(storage::DataLayout &data_layout,
+                                    storage::DataLayout &metric_layout,
+                                    char *metric_block)
     {
         auto geometries_index_ptr =
-            data_layout.GetBlockPtr<unsigned>(memory_block, storage::DataLayout::GEOMETRIES_INDEX);
+            GetShareableBlockPtr<unsigned>(storage::DataLayout::GEOMETRIES_INDEX);
         util::vector_view<unsigned> geometry_begin_indices(
             geometries_index_ptr, data_layout.num_entries[storage::DataLayout::GEOMETRIES_INDEX]);
 
         auto num_entries = data_layout.num_entries[storage::DataLayout::GEOMETRIES_NODE_LIST];
-        auto geometries_node_list_ptr = data_layout.GetBlockPtr<NodeID>(
-            memory_block, storage::DataLayout::GEOMETRIES_NODE_LIST);
+        auto geometries_node_list_ptr =
+            GetShareableBlockPtr<NodeID>(storage::DataLayout::GEOMETRIES_NODE_LIST);
         util::vector_view<NodeID> geometry_node_list(geometries_node_list_ptr, num_entries);
 
         auto geometries_fwd_weight_list_ptr =
-            data_layout.GetBlockPtr<extractor::SegmentDataView::SegmentWeightVector::block_type>(
-                memory_block, storage::DataLayout::GEOMETRIES_FWD_WEIGHT_LIST);
+            metric_layout.GetBlockPtr<extractor::SegmentDataView::SegmentWeightVector::block_type>(
+                metric_block, storage::DataLayout::GEOMETRIES_FWD_WEIGHT_LIST);
         extractor::SegmentDataView::SegmentWeightVector geometry_fwd_weight_list(
             util::vector_view<extractor::SegmentDataView::SegmentWeightVector::block_type>(
                 geometries_fwd_weight_list_ptr,
-                data_layout.num_entries[storage::DataLayout::GEOMETRIES_FWD_WEIGHT_LIST]),
+                metric_layout.num_entries[storage::DataLayout::GEOMETRIES_FWD_WEIGHT_LIST]),
             num_entries);
 
         auto geometries_rev_weight_list_ptr =
-            data_layout.GetBlockPtr<extractor::SegmentDataView::SegmentWeightVector::block_type>(
-                memory_block, storage::DataLayout::GEOMETRIES_REV_WEIGHT_LIST);
+            metric_layout.GetBlockPtr<extractor::SegmentDataView::SegmentWeightVector::block_type>(
+                metric_block, storage::DataLayout::GEOMETRIES_REV_WEIGHT_LIST);
         extractor::SegmentDataView::SegmentWeightVector geometry_rev_weight_list(
             util::vector_view<extractor::SegmentDataView::SegmentWeightVector::block_type>(
                 geometries_rev_weight_list_ptr,
-                data_layout.num_entries[storage::DataLayout::GEOMETRIES_REV_WEIGHT_LIST]),
+                metric_layout.num_entries[storage::DataLayout::GEOMETRIES_REV_WEIGHT_LIST]),
             num_entries);
 
-        auto geometries_fwd_duration_list_ptr =
-            data_layout.GetBlockPtr<extractor::SegmentDataView::SegmentDurationVector::block_type>(
-                memory_block, storage::DataLayout::GEOMETRIES_FWD_DURATION_LIST);
+        auto geometries_fwd_duration_list_ptr = metric_layout
+            .GetBlockPtr<extractor::SegmentDataView::SegmentDurationVector::block_type>(
+                metric_block, storage::DataLayout::GEOMETRIES_FWD_DURATION_LIST);
         extractor::SegmentDataView::SegmentDurationVector geometry_fwd_duration_list(
             util::vector_view<extractor::SegmentDataView::SegmentDurationVector::block_type>(
                 geometries_fwd_duration_list_ptr,
-                data_layout.num_entries[storage::DataLayout::GEOMETRIES_FWD_DURATION_LIST]),
+                metric_layout.num_entries[storage::DataLayout::GEOMETRIES_FWD_DURATION_LIST]),
             num_entries);
 
-        auto geometries_rev_duration_list_ptr =
-            data_layout.GetBlockPtr<extractor::SegmentDataView::SegmentDurationVector::block_type>(
-                memory_block, storage::DataLayout::GEOMETRIES_REV_DURATION_LIST);
+        auto geometries_rev_duration_list_ptr = metric_layout
+            .GetBlockPtr<extractor::SegmentDataView::SegmentDurationVector::block_type>(
+                metric_block, storage::DataLayout::GEOMETRIES_REV_DURATION_LIST);
         extractor::SegmentDataView::SegmentDurationVector geometry_rev_duration_list(
             util::vector_view<extractor::SegmentDataView::SegmentDurationVector::block_type>(
                 geometries_rev_duration_list_ptr,
-                data_layout.num_entries[storage::DataLayout::GEOMETRIES_REV_DURATION_LIST]),
+                metric_layout.num_entries[storage::DataLayout::GEOMETRIES_REV_DURATION_LIST]),
             num_entries);
 
-        auto geometries_fwd_datasources_list_ptr = data_layout.GetBlockPtr<DatasourceID>(
-            memory_block, storage::DataLayout::GEOMETRIES_FWD_DATASOURCES_LIST);
+        auto geometries_fwd_datasources_list_ptr = metric_layout.GetBlockPtr<DatasourceID>(
+            metric_block, storage::DataLayout::GEOMETRIES_FWD_DATASOURCES_LIST);
         util::vector_view<DatasourceID> geometry_fwd_datasources_list(
             geometries_fwd_datasources_list_ptr,
-            data_layout.num_entries[storage::DataLayout::GEOMETRIES_FWD_DATASOURCES_LIST]);
+            metric_layout.num_entries[storage::DataLayout::GEOMETRIES_FWD_DATASOURCES_LIST]);
 
-        auto geometries_rev_datasources_list_ptr = data_layout.GetBlockPtr<DatasourceID>(
-            memory_block, storage::DataLayout::GEOMETRIES_REV_DATASOURCES_LIST);
+        auto geometries_rev_datasources_list_ptr = metric_layout.GetBlockPtr<DatasourceID>(
+            metric_block, storage::DataLayout::GEOMETRIES_REV_DATASOURCES_LIST);
         util::vector_view<DatasourceID> geometry_rev_datasources_list(
             geometries_rev_datasources_list_ptr,
-            data_layout.num_entries[storage::DataLayout::GEOMETRIES_REV_DATASOURCES_LIST]);
+            metric_layout.num_entries[storage::DataLayout::GEOMETRIES_REV_DATASOURCES_LIST]);
 
         segment_data = extractor::SegmentDataView{std::move(geometry_begin_indices),
                                                   std::move(geometry_node_list),
@@ -461,8 +510,8 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
                                                   std::move(geometry_fwd_datasources_list),
                                                   std::move(geometry_rev_datasources_list)};
 
-        m_datasources = data_layout.GetBlockPtr<extractor::Datasources>(
-            memory_block, storage::DataLayout::DATASOURCES_NAMES);
+        m_datasources = metric_layout.GetBlockPtr<extractor::Datasources>(
+            metric_block, storage::DataLayout::DATASOURCES_NAMES);
     }
 
     void InitializeIntersectionClassPointers(storage::DataLayout &data_layout, char *memory_block)
@@ -501,16 +550,19 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
 
     void InitializeInternalPointers(storage::DataLayout &data_layout,
                                     char *memory_block,
+                                    storage::DataLayout &metric_layout,
+                                    char *metric_block,
                                     const std::size_t exclude_index)
     {
         InitializeChecksumPointer(data_layout, memory_block);
-        InitializeNodeInformationPointers(data_layout, memory_block);
+        InitializeNodeInformationPointers(data_layout);
         InitializeEdgeBasedNodeDataInformationPointers(data_layout, memory_block);
         InitializeEdgeInformationPointers(data_layout, memory_block);
-        InitializeTurnPenalties(data_layout, memory_block);
-        InitializeGeometryPointers(data_layout, memory_block);
+        InitializeTurnPenalties(metric_layout, metric_block);
+        InitializeGeometryPointers(data_layout, metric_layout, metric_block);
         InitializeTimestampPointer(data_layout, memory_block);
-        InitializeNamePointers(data_layout, memory_block);
+        InitializeDatasetFingerprint(data_layout, memory_block, metric_layout, metric_block);
+        InitializeNamePointers(data_layout);
         InitializeTurnLaneDescriptionsPointers(data_layout, memory_block);
         InitializeProfilePropertiesPointer(data_layout, memory_block, exclude_index);
         InitializeRTreePointers(data_layout, memory_block);
@@ -521,10 +573,15 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
     // allows switching between process_memory/shared_memory datafacade, based on the type of
     // allocator
     ContiguousInternalMemoryDataFacadeBase(std::shared_ptr<ContiguousBlockAllocator> allocator_,
-                                           const std::size_t exclude_index)
-        : allocator(std::move(allocator_))
+                                           const std::size_t exclude_index,
+                                           std::shared_ptr<PhantomNodeCache> phantom_node_cache_)
+        : allocator(std::move(allocator_)), phantom_node_cache(std::move(phantom_node_cache_))
     {
-        InitializeInternalPointers(allocator->GetLayout(), allocator->GetMemory(), exclude_index);
+        InitializeInternalPointers(allocator->GetLayout(),
+                                   allocator->GetMemory(),
+                                   allocator->GetMetricLayout(),
+                                   allocator->GetMetricMemory(),
+                                   exclude_index);
     }
 
     // node and edge information access
@@ -697,6 +754,19 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
             input_coordinate, max_results, max_distance, bearing, bearing_range, approach);
     }
 
+    std::vector<std::vector<PhantomNodeWithDistance>>
+    NearestPhantomNodes(const std::vector<util::Coordinate> &input_coordinates,
+                        const unsigned max_results,
+                        const std::vector<boost::optional<double>> &max_distances,
+                        const std::vector<boost::optional<Approach>> &approaches) const
+        override final
+    {
+        BOOST_ASSERT(m_geospatial_query.get());
+
+        return m_geospatial_query->NearestPhantomNodes(
+            input_coordinates, max_results, max_distances, approaches);
+    }
+
     std::pair<PhantomNode, PhantomNode>
     NearestPhantomNodeWithAlternativeFromBigComponent(const util::Coordinate input_coordinate,
                                                       const Approach approach) const override final
@@ -818,6 +888,11 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
 
     std::string GetTimestamp() const override final { return m_timestamp; }
 
+    storage::DatasetFingerprint GetDatasetFingerprint() const override final
+    {
+        return m_dataset_fingerprint;
+    }
+
     bool GetContinueStraightDefault() const override final
     {
         return m_profile_properties->continue_straight_at_waypoint;
@@ -901,12 +976,25 @@ class ContiguousInternalMemoryDataFacade<CH>
 {
   public:
     ContiguousInternalMemoryDataFacade(std::shared_ptr<ContiguousBlockAllocator> allocator,
-                                       const std::size_t exclude_index)
-        : ContiguousInternalMemoryDataFacadeBase(allocator, exclude_index),
+                                       const std::size_t exclude_index,
+                                       std::shared_ptr<PhantomNodeCache> phantom_node_cache)
+        : ContiguousInternalMemoryDataFacadeBase(allocator, exclude_index, phantom_node_cache),
           ContiguousInternalMemoryAlgorithmDataFacade<CH>(allocator, exclude_index)
 
     {
     }
+
+  protected:
+    ContiguousInternalMemoryDataFacade(std::shared_ptr<ContiguousBlockAllocator> allocator,
+                                       std::shared_ptr<PhantomNodeCache> phantom_node_cache,
+                                       const storage::DataLayout::BlockID node_list_block_id,
+                                       const storage::DataLayout::BlockID edge_list_block_id,
+                                       const storage::DataLayout::BlockID filter_block_id)
+        : ContiguousInternalMemoryDataFacadeBase(allocator, 0, phantom_node_cache),
+          ContiguousInternalMemoryAlgorithmDataFacade<CH>(
+              allocator, node_list_block_id, edge_list_block_id, filter_block_id)
+    {
+    }
 };
 
 template <> class ContiguousInternalMemoryAlgorithmDataFacade<MLD> : public AlgorithmDataFacade<MLD>
@@ -923,15 +1011,16 @@ template <> class ContiguousInternalMemoryAlgorithmDataFacade<MLD> : public Algo
 
     void InitializeInternalPointers(storage::DataLayout &data_layout,
                                     char *memory_block,
+                                    storage::DataLayout &metric_layout,
+                                    char *metric_block,
                                     const std::size_t exclude_index)
     {
-        InitializeMLDDataPointers(data_layout, memory_block, exclude_index);
-        InitializeGraphPointer(data_layout, memory_block);
+        InitializeMLDDataPointers(data_layout, memory_block);
+        InitializeCellMetricPointers(metric_layout, metric_block, exclude_index);
+        InitializeGraphPointer(data_layout, memory_block, metric_layout, metric_block);
     }
 
-    void InitializeMLDDataPointers(storage::DataLayout &data_layout,
-                                   char *memory_block,
-                                   const std::size_t exclude_index)
+    void InitializeMLDDataPointers(storage::DataLayout &data_layout, char *memory_block)
     {
         if (data_layout.GetBlockSize(storage::DataLayout::MLD_PARTITION) > 0)
         {
@@ -958,29 +1047,6 @@ template <> class ContiguousInternalMemoryAlgorithmDataFacade<MLD> : public Algo
                 partition::MultiLevelPartitionView{level_data, partition, cell_to_children};
         }
 
-        const auto weights_block_id = static_cast<storage::DataLayout::BlockID>(
-            storage::DataLayout::MLD_CELL_WEIGHTS_0 + exclude_index);
-        const auto durations_block_id = static_cast<storage::DataLayout::BlockID>(
-            storage::DataLayout::MLD_CELL_DURATIONS_0 + exclude_index);
-
-        if (data_layout.GetBlockSize(weights_block_id) > 0)
-        {
-            auto mld_cell_weights_ptr =
-                data_layout.GetBlockPtr<EdgeWeight>(memory_block, weights_block_id);
-            auto mld_cell_durations_ptr =
-                data_layout.GetBlockPtr<EdgeDuration>(memory_block, durations_block_id);
-            auto weight_entries_count =
-                data_layout.GetBlockEntries(storage::DataLayout::MLD_CELL_WEIGHTS_0);
-            auto duration_entries_count =
-                data_layout.GetBlockEntries(storage::DataLayout::MLD_CELL_DURATIONS_0);
-            BOOST_ASSERT(weight_entries_count == duration_entries_count);
-            util::vector_view<EdgeWeight> weights(mld_cell_weights_ptr, weight_entries_count);
-            util::vector_view<EdgeDuration> durations(mld_cell_durations_ptr,
-                                                      duration_entries_count);
-
-            mld_cell_metric = customizer::CellMetricView{std::move(weights), std::move(durations)};
-        }
-
         if (data_layout.GetBlockSize(storage::DataLayout::MLD_CELLS) > 0)
         {
 
@@ -1016,13 +1082,45 @@ template <> class ContiguousInternalMemoryAlgorithmDataFacade<MLD> : public Algo
                                                           std::move(level_offsets)};
         }
     }
-    void InitializeGraphPointer(storage::DataLayout &data_layout, char *memory_block)
+
+    void InitializeCellMetricPointers(storage::DataLayout &metric_layout,
+                                      char *metric_block,
+                                      const std::size_t exclude_index)
+    {
+        const auto weights_block_id = static_cast<storage::DataLayout::BlockID>(
+            storage::DataLayout::MLD_CELL_WEIGHTS_0 + exclude_index);
+        const auto durations_block_id = static_cast<storage::DataLayout::BlockID>(
+            storage::DataLayout::MLD_CELL_DURATIONS_0 + exclude_index);
+
+        if (metric_layout.GetBlockSize(weights_block_id) > 0)
+        {
+            auto mld_cell_weights_ptr =
+                metric_layout.GetBlockPtr<EdgeWeight>(metric_block, weights_block_id);
+            auto mld_cell_durations_ptr =
+                metric_layout.GetBlockPtr<EdgeDuration>(metric_block, durations_block_id);
+            auto weight_entries_count =
+                metric_layout.GetBlockEntries(storage::DataLayout::MLD_CELL_WEIGHTS_0);
+            auto duration_entries_count =
+                metric_layout.GetBlockEntries(storage::DataLayout::MLD_CELL_DURATIONS_0);
+            BOOST_ASSERT(weight_entries_count == duration_entries_count);
+            util::vector_view<EdgeWeight> weights(mld_cell_weights_ptr, weight_entries_count);
+            util::vector_view<EdgeDuration> durations(mld_cell_durations_ptr,
+                                                      duration_entries_count);
+
+            mld_cell_metric = customizer::CellMetricView{std::move(weights), std::move(durations)};
+        }
+    }
+
+    void InitializeGraphPointer(storage::DataLayout &data_layout,
+                                char *memory_block,
+                                storage::DataLayout &metric_layout,
+                                char *metric_block)
     {
         auto graph_nodes_ptr = data_layout.GetBlockPtr<GraphNode>(
             memory_block, storage::DataLayout::MLD_GRAPH_NODE_LIST);
 
-        auto graph_edges_ptr = data_layout.GetBlockPtr<GraphEdge>(
-            memory_block, storage::DataLayout::MLD_GRAPH_EDGE_LIST);
+        auto graph_edges_ptr = metric_layout.GetBlockPtr<GraphEdge>(
+            metric_block, storage::DataLayout::MLD_GRAPH_EDGE_LIST);
 
         auto graph_node_to_offset_ptr = data_layout.GetBlockPtr<QueryGraph::EdgeOffset>(
             memory_block, storage::DataLayout::MLD_GRAPH_NODE_TO_OFFSET);
@@ -1030,7 +1128,7 @@ template <> class ContiguousInternalMemoryAlgorithmDataFacade<MLD> : public Algo
         util::vector_view<GraphNode> node_list(
             graph_nodes_ptr, data_layout.num_entries[storage::DataLayout::MLD_GRAPH_NODE_LIST]);
         util::vector_view<GraphEdge> edge_list(
-            graph_edges_ptr, data_layout.num_entries[storage::DataLayout::MLD_GRAPH_EDGE_LIST]);
+            graph_edges_ptr, metric_layout.num_entries[storage::DataLayout::MLD_GRAPH_EDGE_LIST]);
         util::vector_view<QueryGraph::EdgeOffset> node_to_offset(
             graph_node_to_offset_ptr,
             data_layout.num_entries[storage::DataLayout::MLD_GRAPH_NODE_TO_OFFSET]);
@@ -1042,12 +1140,18 @@ template <> class ContiguousInternalMemoryAlgorithmDataFacade<MLD> : public Algo
     // allocator that keeps the allocation data
     std::shared_ptr<ContiguousBlockAllocator> allocator;
 
+    const std::uint32_t unpacking_cache_owner;
+
   public:
     ContiguousInternalMemoryAlgorithmDataFacade(
         std::shared_ptr<ContiguousBlockAllocator> allocator_, const std::size_t exclude_index)
-        : allocator(std::move(allocator_))
+        : allocator(std::move(allocator_)), unpacking_cache_owner(UnpackingCache::NewOwner())
     {
-        InitializeInternalPointers(allocator->GetLayout(), allocator->GetMemory(), exclude_index);
+        InitializeInternalPointers(allocator->GetLayout(),
+                                   allocator->GetMemory(),
+                                   allocator->GetMetricLayout(),
+                                   allocator->GetMetricMemory(),
+                                   exclude_index);
     }
 
     const partition::MultiLevelPartitionView &GetMultiLevelPartition() const override
@@ -1091,6 +1195,8 @@ template <> class ContiguousInternalMemoryAlgorithmDataFacade<MLD> : public Algo
     {
         return query_graph.FindEdge(from, to);
     }
+
+    std::uint32_t GetUnpackingCacheOwner() const override final { return unpacking_cache_owner; }
 };
 
 template <>
@@ -1101,13 +1207,63 @@ class ContiguousInternalMemoryDataFacade<MLD> final
   private:
   public:
     ContiguousInternalMemoryDataFacade(std::shared_ptr<ContiguousBlockAllocator> allocator,
-                                       const std::size_t exclude_index)
-        : ContiguousInternalMemoryDataFacadeBase(allocator, exclude_index),
+                                       const std::size_t exclude_index,
+                                       std::shared_ptr<PhantomNodeCache> phantom_node_cache)
+        : ContiguousInternalMemoryDataFacadeBase(allocator, exclude_index, phantom_node_cache),
           ContiguousInternalMemoryAlgorithmDataFacade<MLD>(allocator, exclude_index)
 
     {
     }
 };
+
+template <> class ContiguousInternalMemoryAlgorithmDataFacade<CCH> : public AlgorithmDataFacade<CCH>
+{
+    util::vector_view<customizer::EliminationTreeNode> elimination_tree;
+
+    // allocator that keeps the allocation data
+    std::shared_ptr<ContiguousBlockAllocator> allocator;
+
+  public:
+    ContiguousInternalMemoryAlgorithmDataFacade(
+        std::shared_ptr<ContiguousBlockAllocator> allocator_)
+        : allocator(std::move(allocator_))
+    {
+        auto &data_layout = allocator->GetLayout();
+        auto elimination_tree_ptr = data_layout.GetBlockPtr<customizer::EliminationTreeNode>(
+            allocator->GetMemory(), storage::DataLayout::CCH_ELIMINATION_TREE);
+        elimination_tree = util::vector_view<customizer::EliminationTreeNode>(
+            elimination_tree_ptr,
+            data_layout.num_entries[storage::DataLayout::CCH_ELIMINATION_TREE]);
+    }
+
+    NodeID GetEliminationTreeParent(const NodeID node) const override final
+    {
+        return elimination_tree[node].parent;
+    }
+
+    NodeID GetRank(const NodeID node) const override final { return elimination_tree[node].rank; }
+};
+
+// The CCH is queried like a CH, it only adds the elimination tree. Exclude flags are not
+// supported, so there is a single edge filter that disables the arcs without a path.
+template <>
+class ContiguousInternalMemoryDataFacade<CCH> final
+    : public ContiguousInternalMemoryDataFacade<CH>,
+      public ContiguousInternalMemoryAlgorithmDataFacade<CCH>
+{
+  public:
+    ContiguousInternalMemoryDataFacade(std::shared_ptr<ContiguousBlockAllocator> allocator,
+                                       const std::size_t /*exclude_index*/,
+                                       std::shared_ptr<PhantomNodeCache> phantom_node_cache)
+        : ContiguousInternalMemoryDataFacade<CH>(allocator,
+                                                 phantom_node_cache,
+                                                 storage::DataLayout::CCH_GRAPH_NODE_LIST,
+                                                 storage::DataLayout::CCH_GRAPH_EDGE_LIST,
+                                                 storage::DataLayout::CCH_EDGE_FILTER),
+          ContiguousInternalMemoryAlgorithmDataFacade<CCH>(allocator)
+    {
+    }
+};
 }
 }
 }
@@ -16,6 +16,8 @@
 #include "extractor/query_node.hpp"
 #include "extractor/travel_mode.hpp"
 
+#include "storage/dataset_fingerprint.hpp"
+
 #include "util/exception.hpp"
 #include "util/guidance/bearing_class.hpp"
 #include "util/guidance/entry_class.hpp"
@@ -28,6 +30,8 @@
 
 #include "osrm/coordinate.hpp"
 
+#include <boost/optional.hpp>
+
 #include <cstddef>
 
 #include <string>
@@ -135,6 +139,13 @@ class BaseDataFacade
                         const double max_distance,
                         const Approach approach) const = 0;
 
+    // Nearest phantom nodes of many coordinates, radiuses and approaches are optional
+    virtual std::vector<std::vector<PhantomNodeWithDistance>>
+    NearestPhantomNodes(const std::vector<util::Coordinate> &input_coordinates,
+                        const unsigned max_results,
+                        const std::vector<boost::optional<double>> &max_distances,
+                        const std::vector<boost::optional<Approach>> &approaches) const = 0;
+
     virtual std::pair<PhantomNode, PhantomNode>
     NearestPhantomNodeWithAlternativeFromBigComponent(const util::Coordinate input_coordinate,
                                                       const Approach approach) const = 0;
@@ -173,6 +184,9 @@ class BaseDataFacade
 
     virtual std::string GetTimestamp() const = 0;
 
+    // Identifies the files the dataset and its metric were loaded from
+    virtual storage::DatasetFingerprint GetDatasetFingerprint() const = 0;
+
     virtual bool GetContinueStraightDefault() const = 0;
 
     virtual double GetMapMatchingMaxSpeed() const = 0;
@@ -0,0 +1,47 @@
+#ifndef OSRM_ENGINE_DATAFACADE_METRIC_BUFFER_ALLOCATOR_HPP_
+#define OSRM_ENGINE_DATAFACADE_METRIC_BUFFER_ALLOCATOR_HPP_
+
+#include "engine/datafacade/contiguous_block_allocator.hpp"
+
+#include <memory>
+
+namespace osrm
+{
+namespace engine
+{
+namespace datafacade
+{
+
+/**
+ * This allocator holds a private copy of all blocks that change
+ * when the metric of a MLD dataset is updated. All other blocks
+ * are shared with the topology allocator, so a new metric only
+ * costs the memory of the weights and durations.
+ * The copy is taken from the metric blocks of another allocator
+ * and can be customized in place before any facade uses it.
+ */
+class MetricBufferAllocator : public ContiguousBlockAllocator
+{
+  public:
+    MetricBufferAllocator(std::shared_ptr<ContiguousBlockAllocator> topology,
+                          ContiguousBlockAllocator &metric_source);
+    ~MetricBufferAllocator() override final;
+
+    // interface to give access to the datafacades
+    storage::DataLayout &GetLayout() override final;
+    char *GetMemory() override final;
+    storage::DataLayout &GetMetricLayout() override final;
+    char *GetMetricMemory() override final;
+    char *GetBlockMemory(storage::DataLayout::BlockID block) override final;
+
+  private:
+    std::shared_ptr<ContiguousBlockAllocator> topology;
+    std::unique_ptr<char[]> metric_memory;
+    std::unique_ptr<storage::DataLayout> metric_layout;
+};
+
+} // namespace datafacade
+} // namespace engine
+} // namespace osrm
+
+#endif // OSRM_ENGINE_DATAFACADE_METRIC_BUFFER_ALLOCATOR_HPP_
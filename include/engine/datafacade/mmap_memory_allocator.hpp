@@ -0,0 +1,58 @@
+#ifndef OSRM_ENGINE_DATAFACADE_MMAP_MEMORY_ALLOCATOR_HPP_
+#define OSRM_ENGINE_DATAFACADE_MMAP_MEMORY_ALLOCATOR_HPP_
+
+#include "engine/datafacade/contiguous_block_allocator.hpp"
+#include "engine/engine_config.hpp"
+#include "storage/storage_config.hpp"
+
+#include <boost/filesystem/path.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace osrm
+{
+namespace engine
+{
+namespace datafacade
+{
+
+/**
+ * This allocator memory-maps a dataset image file instead of
+ * copying the dataset into process memory. The image contains the
+ * same aligned layout as the process and shared memory blocks, so
+ * the datafacades use its pages in place and processes mapping the
+ * same image share them through the page cache.
+ *
+ * The .osrm.* files can't be used in place, so the image is written
+ * from them once. It records the path, size and modification time of
+ * every input file and is reused only as long as all of them match.
+ * The mapping is private: pages are never written back to the image.
+ */
+class MMapMemoryAllocator : public ContiguousBlockAllocator
+{
+  public:
+    using MemoryAdvice = EngineConfig::MemoryAdvice;
+
+    MMapMemoryAllocator(const storage::StorageConfig &config,
+                        const boost::filesystem::path &memory_file,
+                        const std::unordered_map<std::string, MemoryAdvice> &advice);
+    ~MMapMemoryAllocator() override final;
+
+    // interface to give access to the datafacades
+    storage::DataLayout &GetLayout() override final;
+    char *GetMemory() override final;
+
+  private:
+    boost::iostreams::mapped_file mapped_memory_file;
+    std::unique_ptr<storage::DataLayout> internal_layout;
+    char *internal_memory;
+};
+
+} // namespace datafacade
+} // namespace engine
+} // namespace osrm
+
+#endif // OSRM_ENGINE_DATAFACADE_MMAP_MEMORY_ALLOCATOR_HPP_
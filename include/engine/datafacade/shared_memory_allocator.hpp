@@ -19,19 +19,25 @@ namespace datafacade
 * This allocator uses an IPC shared memory block as the data location.
 * Many SharedMemoryDataFacade objects can be created that point to the same shared
 * memory block.
+* The metric blocks are read from a second region if osrm-datastore replaced them
+* with --only-metric.
 */
 class SharedMemoryAllocator : public ContiguousBlockAllocator
 {
   public:
-    explicit SharedMemoryAllocator(storage::SharedDataType data_region);
+    explicit SharedMemoryAllocator(storage::SharedDataType data_region,
+                                   storage::SharedDataType metric_region = storage::REGION_NONE);
     ~SharedMemoryAllocator() override final;
 
     // interface to give access to the datafacades
     storage::DataLayout &GetLayout() override final;
     char *GetMemory() override final;
+    storage::DataLayout &GetMetricLayout() override final;
+    char *GetMetricMemory() override final;
 
   private:
     std::unique_ptr<storage::SharedMemory> m_large_memory;
+    std::unique_ptr<storage::SharedMemory> m_metric_memory;
 };
 
 } // namespace datafacade
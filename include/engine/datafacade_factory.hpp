@@ -7,6 +7,7 @@
 #include "engine/algorithm.hpp"
 #include "engine/api/base_parameters.hpp"
 #include "engine/api/tile_parameters.hpp"
+#include "engine/phantom_node_cache.hpp"
 
 #include "util/integer_range.hpp"
 
@@ -30,8 +31,9 @@ template <template <typename A> class FacadeT, typename AlgorithmT> class DataFa
     DataFacadeFactory() = default;
 
     template <typename AllocatorT>
-    DataFacadeFactory(std::shared_ptr<AllocatorT> allocator)
-        : DataFacadeFactory(allocator, has_exclude_flags)
+    DataFacadeFactory(std::shared_ptr<AllocatorT> allocator,
+                      std::shared_ptr<PhantomNodeCache> phantom_node_cache)
+        : DataFacadeFactory(allocator, std::move(phantom_node_cache), has_exclude_flags)
     {
     }
 
@@ -43,11 +45,13 @@ template <template <typename A> class FacadeT, typename AlgorithmT> class DataFa
   private:
     // Algorithm with exclude flags
     template <typename AllocatorT>
-    DataFacadeFactory(std::shared_ptr<AllocatorT> allocator, std::true_type)
+    DataFacadeFactory(std::shared_ptr<AllocatorT> allocator,
+                      std::shared_ptr<PhantomNodeCache> phantom_node_cache,
+                      std::true_type)
     {
         for (const auto index : util::irange<std::size_t>(0, facades.size()))
         {
-            facades[index] = std::make_shared<const Facade>(allocator, index);
+            facades[index] = std::make_shared<const Facade>(allocator, index, phantom_node_cache);
         }
 
         properties = allocator->GetLayout().template GetBlockPtr<extractor::ProfileProperties>(
@@ -65,9 +69,11 @@ template <template <typename A> class FacadeT, typename AlgorithmT> class DataFa
 
     // Algorithm without exclude flags
     template <typename AllocatorT>
-    DataFacadeFactory(std::shared_ptr<AllocatorT> allocator, std::false_type)
+    DataFacadeFactory(std::shared_ptr<AllocatorT> allocator,
+                      std::shared_ptr<PhantomNodeCache> phantom_node_cache,
+                      std::false_type)
     {
-        facades[0] = std::make_shared<const Facade>(allocator, 0);
+        facades[0] = std::make_shared<const Facade>(allocator, 0, std::move(phantom_node_cache));
     }
 
     std::shared_ptr<const Facade> Get(const api::TileParameters &, std::false_type) const
@@ -3,10 +3,19 @@
 
 #include "engine/data_watchdog.hpp"
 #include "engine/datafacade.hpp"
+#include "engine/datafacade/block_sharing_allocator.hpp"
 #include "engine/datafacade/contiguous_internalmem_datafacade.hpp"
+#include "engine/datafacade/metric_buffer_allocator.hpp"
+#include "engine/datafacade/mmap_memory_allocator.hpp"
 #include "engine/datafacade/process_memory_allocator.hpp"
 #include "engine/datafacade_factory.hpp"
 
+#include "updater/metric_updater.hpp"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
 namespace osrm
 {
 namespace engine
@@ -23,6 +32,9 @@ template <typename AlgorithmT, template <typename A> class FacadeT> class DataFa
 
     virtual std::shared_ptr<const Facade> Get(const api::BaseParameters &) const = 0;
     virtual std::shared_ptr<const Facade> Get(const api::TileParameters &) const = 0;
+
+    // Changes whenever the provider switches to another dataset
+    virtual unsigned GetTimestamp() const { return 0; }
 };
 
 template <typename AlgorithmT, template <typename A> class FacadeT>
@@ -31,8 +43,26 @@ class ImmutableProvider final : public DataFacadeProvider<AlgorithmT, FacadeT>
   public:
     using Facade = typename DataFacadeProvider<AlgorithmT, FacadeT>::Facade;
 
-    ImmutableProvider(const storage::StorageConfig &config)
-        : facade_factory(std::make_shared<datafacade::ProcessMemoryAllocator>(config))
+    ImmutableProvider(const storage::StorageConfig &config,
+                      const bool share_blocks,
+                      std::shared_ptr<PhantomNodeCache> phantom_node_cache)
+        : facade_factory(
+              ShareBlocks(std::make_shared<datafacade::ProcessMemoryAllocator>(config),
+                          share_blocks),
+              std::move(phantom_node_cache))
+    {
+    }
+
+    ImmutableProvider(const storage::StorageConfig &config,
+                      const boost::filesystem::path &memory_file,
+                      const std::unordered_map<std::string, EngineConfig::MemoryAdvice> &advice,
+                      const bool share_blocks,
+                      std::shared_ptr<PhantomNodeCache> phantom_node_cache)
+        : facade_factory(
+              ShareBlocks(
+                  std::make_shared<datafacade::MMapMemoryAllocator>(config, memory_file, advice),
+                  share_blocks),
+              std::move(phantom_node_cache))
     {
     }
 
@@ -46,9 +76,99 @@ class ImmutableProvider final : public DataFacadeProvider<AlgorithmT, FacadeT>
     }
 
   private:
+    static std::shared_ptr<datafacade::ContiguousBlockAllocator>
+    ShareBlocks(std::shared_ptr<datafacade::ContiguousBlockAllocator> allocator,
+                const bool share_blocks)
+    {
+        if (share_blocks)
+        {
+            return std::make_shared<datafacade::BlockSharingAllocator>(std::move(allocator));
+        }
+        return allocator;
+    }
+
     DataFacadeFactory<FacadeT, AlgorithmT> facade_factory;
 };
 
+// Loads the dataset like the ImmutableProvider, but segment speeds can be applied to it while
+// queries run. Each update customizes a copy of the metric blocks, the topology stays shared.
+// Queries that already hold a facade finish on the previous metric.
+template <typename AlgorithmT, template <typename A> class FacadeT>
+class LiveProvider final : public DataFacadeProvider<AlgorithmT, FacadeT>
+{
+  public:
+    using Facade = typename DataFacadeProvider<AlgorithmT, FacadeT>::Facade;
+    using FacadeFactory = DataFacadeFactory<FacadeT, AlgorithmT>;
+
+    LiveProvider(const storage::StorageConfig &config,
+                 std::shared_ptr<PhantomNodeCache> phantom_node_cache)
+        : LiveProvider(std::make_shared<datafacade::ProcessMemoryAllocator>(config),
+                       std::move(phantom_node_cache))
+    {
+    }
+
+    LiveProvider(const storage::StorageConfig &config,
+                 const boost::filesystem::path &memory_file,
+                 const std::unordered_map<std::string, EngineConfig::MemoryAdvice> &advice,
+                 std::shared_ptr<PhantomNodeCache> phantom_node_cache)
+        : LiveProvider(
+              std::make_shared<datafacade::MMapMemoryAllocator>(config, memory_file, advice),
+              std::move(phantom_node_cache))
+    {
+    }
+
+    std::shared_ptr<const Facade> Get(const api::TileParameters &params) const override final
+    {
+        return std::atomic_load(&facade_factory)->Get(params);
+    }
+    std::shared_ptr<const Facade> Get(const api::BaseParameters &params) const override final
+    {
+        return std::atomic_load(&facade_factory)->Get(params);
+    }
+    unsigned GetTimestamp() const override final { return timestamp; }
+
+    // Updates are applied one after another, queries use the new metric once all its cells
+    // are customized
+    updater::MetricUpdate Update(const updater::SegmentLookupTable &segment_speeds)
+    {
+        std::lock_guard<std::mutex> lock(update_mutex);
+
+        auto metric =
+            std::make_shared<datafacade::MetricBufferAllocator>(topology, *current_metric);
+        const auto update = updater::updateMetric(topology->GetLayout(),
+                                                  topology->GetMemory(),
+                                                  metric->GetMetricLayout(),
+                                                  metric->GetMetricMemory(),
+                                                  segment_speeds);
+        if (update.segments > 0)
+        {
+            std::atomic_store(&facade_factory,
+                              std::make_shared<const FacadeFactory>(metric, phantom_node_cache));
+            current_metric = std::move(metric);
+            ++timestamp;
+        }
+
+        return update;
+    }
+
+  private:
+    LiveProvider(std::shared_ptr<datafacade::ContiguousBlockAllocator> topology_,
+                 std::shared_ptr<PhantomNodeCache> phantom_node_cache_)
+        : topology(std::move(topology_)), current_metric(topology),
+          phantom_node_cache(std::move(phantom_node_cache_)),
+          facade_factory(std::make_shared<const FacadeFactory>(topology, phantom_node_cache)),
+          timestamp(0)
+    {
+    }
+
+    std::shared_ptr<datafacade::ContiguousBlockAllocator> topology;
+    std::shared_ptr<datafacade::ContiguousBlockAllocator> current_metric;
+    std::shared_ptr<PhantomNodeCache> phantom_node_cache;
+    std::shared_ptr<const FacadeFactory> facade_factory;
+    std::atomic<unsigned> timestamp;
+    std::mutex update_mutex;
+};
+
 template <typename AlgorithmT, template <typename A> class FacadeT>
 class WatchingProvider : public DataFacadeProvider<AlgorithmT, FacadeT>
 {
@@ -57,6 +177,11 @@ class WatchingProvider : public DataFacadeProvider<AlgorithmT, FacadeT>
   public:
     using Facade = typename DataFacadeProvider<AlgorithmT, FacadeT>::Facade;
 
+    WatchingProvider(std::shared_ptr<PhantomNodeCache> phantom_node_cache)
+        : watchdog(std::move(phantom_node_cache))
+    {
+    }
+
     std::shared_ptr<const Facade> Get(const api::TileParameters &params) const override final
     {
         return watchdog.Get(params);
@@ -65,6 +190,7 @@ class WatchingProvider : public DataFacadeProvider<AlgorithmT, FacadeT>
     {
         return watchdog.Get(params);
     }
+    unsigned GetTimestamp() const override final { return watchdog.GetTimestamp(); }
 };
 }
 
@@ -74,6 +200,7 @@ template <typename AlgorithmT>
 using WatchingProvider = detail::WatchingProvider<AlgorithmT, DataFacade>;
 template <typename AlgorithmT>
 using ImmutableProvider = detail::ImmutableProvider<AlgorithmT, DataFacade>;
+template <typename AlgorithmT> using LiveProvider = detail::LiveProvider<AlgorithmT, DataFacade>;
 }
 }
 
@@ -1,6 +1,7 @@
 #ifndef ENGINE_HPP
 #define ENGINE_HPP
 
+#include "engine/api/base_result.hpp"
 #include "engine/api/match_parameters.hpp"
 #include "engine/api/nearest_parameters.hpp"
 #include "engine/api/route_parameters.hpp"
@@ -11,20 +12,27 @@
 #include "engine/datafacade/contiguous_block_allocator.hpp"
 #include "engine/datafacade_provider.hpp"
 #include "engine/engine_config.hpp"
+#include "engine/match_session_store.hpp"
+#include "engine/phantom_node_cache.hpp"
 #include "engine/plugins/match.hpp"
 #include "engine/plugins/nearest.hpp"
 #include "engine/plugins/table.hpp"
 #include "engine/plugins/tile.hpp"
 #include "engine/plugins/trip.hpp"
 #include "engine/plugins/viaroute.hpp"
+#include "engine/response_cache.hpp"
 #include "engine/routing_algorithms.hpp"
 #include "engine/status.hpp"
+#include "engine/tile_archive.hpp"
+#include "updater/csv_source.hpp"
 #include "util/exception.hpp"
 #include "util/exception_utils.hpp"
 #include "util/fingerprint.hpp"
 #include "util/json_container.hpp"
 
+#include <chrono>
 #include <memory>
+#include <mutex>
 #include <string>
 
 namespace osrm
@@ -36,42 +44,106 @@ class EngineInterface
 {
   public:
     virtual ~EngineInterface() = default;
-    virtual Status Route(const api::RouteParameters &parameters,
-                         util::json::Object &result) const = 0;
-    virtual Status Table(const api::TableParameters &parameters,
-                         util::json::Object &result) const = 0;
+    virtual Status Route(const api::RouteParameters &parameters, api::ResultT &result) const = 0;
+    virtual Status Table(const api::TableParameters &parameters, api::ResultT &result) const = 0;
     virtual Status Nearest(const api::NearestParameters &parameters,
-                           util::json::Object &result) const = 0;
-    virtual Status Trip(const api::TripParameters &parameters,
-                        util::json::Object &result) const = 0;
-    virtual Status Match(const api::MatchParameters &parameters,
-                         util::json::Object &result) const = 0;
+                           api::ResultT &result) const = 0;
+    virtual Status Trip(const api::TripParameters &parameters, api::ResultT &result) const = 0;
+    virtual Status Match(const api::MatchParameters &parameters, api::ResultT &result) const = 0;
     virtual Status Tile(const api::TileParameters &parameters, std::string &result) const = 0;
+    virtual void Metrics(util::json::Object &result) const = 0;
+    virtual Status UpdateSegmentSpeeds(const std::string &segment_speeds,
+                                       util::json::Object &result) const = 0;
 };
 
 template <typename Algorithm> class Engine final : public EngineInterface
 {
   public:
     explicit Engine(const EngineConfig &config)
-        : route_plugin(config.max_locations_viaroute, config.max_alternatives),            //
-          table_plugin(config.max_locations_distance_table),                               //
-          nearest_plugin(config.max_results_nearest),                                      //
+        : heaps(makeSearchEngineData<Algorithm>(config)),                                  //
+          route_plugin(config.max_locations_viaroute, config.max_alternatives),            //
+          table_plugin(config.max_locations_distance_table,                                //
+                       config.max_threads_distance_table),                                 //
+          nearest_plugin(config.max_results_nearest, config.max_batch_size_nearest),                                      //
           trip_plugin(config.max_locations_trip),                                          //
-          match_plugin(config.max_locations_map_matching, config.max_radius_map_matching), //
+          match_plugin(config.max_locations_map_matching,                                  //
+                       config.max_radius_map_matching,                                     //
+                       config.max_match_session_points),                                   //
           tile_plugin()                                                                    //
 
     {
+        if (config.response_cache_size > 0)
+        {
+            response_cache = std::make_unique<ResponseCache>(config.response_cache_size);
+        }
+
+        if (config.max_match_sessions > 0)
+        {
+            match_sessions = std::make_unique<MatchSessionStore>(
+                config.max_match_sessions, std::chrono::seconds(config.match_session_timeout));
+        }
+
+        if (config.phantom_node_cache_size > 0)
+        {
+            phantom_node_cache = std::make_shared<PhantomNodeCache>(config.phantom_node_cache_size);
+        }
+
         if (config.use_shared_memory)
         {
             util::Log(logDEBUG) << "Using shared memory with algorithm "
                                 << routing_algorithms::name<Algorithm>();
-            facade_provider = std::make_unique<WatchingProvider<Algorithm>>();
+            facade_provider = std::make_unique<WatchingProvider<Algorithm>>(phantom_node_cache);
+        }
+        else if (config.live_traffic_updates)
+        {
+            util::Log(logDEBUG) << "Using internal memory with live traffic updates and algorithm "
+                                << routing_algorithms::name<Algorithm>();
+            auto provider =
+                config.memory_file.empty()
+                    ? std::make_unique<LiveProvider<Algorithm>>(config.storage_config,
+                                                                phantom_node_cache)
+                    : std::make_unique<LiveProvider<Algorithm>>(config.storage_config,
+                                                                config.memory_file,
+                                                                config.memory_file_advice,
+                                                                phantom_node_cache);
+            live_provider = provider.get();
+            facade_provider = std::move(provider);
+        }
+        else if (!config.memory_file.empty())
+        {
+            util::Log(logDEBUG) << "Using memory mapped file " << config.memory_file.string()
+                                << " with algorithm " << routing_algorithms::name<Algorithm>();
+            facade_provider = std::make_unique<ImmutableProvider<Algorithm>>(
+                config.storage_config,
+                config.memory_file,
+                config.memory_file_advice,
+                config.share_blocks,
+                phantom_node_cache);
         }
         else
         {
             util::Log(logDEBUG) << "Using internal memory with algorithm "
                                 << routing_algorithms::name<Algorithm>();
-            facade_provider = std::make_unique<ImmutableProvider<Algorithm>>(config.storage_config);
+            facade_provider = std::make_unique<ImmutableProvider<Algorithm>>(
+                config.storage_config, config.share_blocks, phantom_node_cache);
+        }
+
+        if (!config.tile_archive.empty())
+        {
+            auto archive = std::make_unique<TileArchive>(config.tile_archive);
+            const auto facade = facade_provider->Get(api::TileParameters{0, 0, 0});
+            if (archive->GetDatasetFingerprint() == facade->GetDatasetFingerprint())
+            {
+                util::Log() << "Serving " << archive->GetNumberOfTiles() << " tiles from "
+                            << config.tile_archive.string();
+                tile_archive = std::move(archive);
+                tile_archive_timestamp = facade_provider->GetTimestamp();
+            }
+            else
+            {
+                util::Log(logWARNING) << "Tile archive " << config.tile_archive.string()
+                                      << " was rendered from another dataset and is not used";
+            }
         }
     }
 
@@ -82,49 +154,161 @@ template <typename Algorithm> class Engine final : public EngineInterface
     Engine &operator=(const Engine &) = delete;
     virtual ~Engine() = default;
 
-    Status Route(const api::RouteParameters &params,
-                 util::json::Object &result) const override final
+    Status Route(const api::RouteParameters &params, api::ResultT &result) const override final
     {
-        return route_plugin.HandleRequest(GetAlgorithms(params), params, result);
+        return CachedRequest(params, result, [&] {
+            return route_plugin.HandleRequest(GetAlgorithms(params), params, result);
+        });
     }
 
-    Status Table(const api::TableParameters &params,
-                 util::json::Object &result) const override final
+    Status Table(const api::TableParameters &params, api::ResultT &result) const override final
     {
-        return table_plugin.HandleRequest(GetAlgorithms(params), params, result);
+        return CachedRequest(params, result, [&] {
+            return table_plugin.HandleRequest(GetAlgorithms(params), params, result);
+        });
     }
 
     Status Nearest(const api::NearestParameters &params,
-                   util::json::Object &result) const override final
+                   api::ResultT &result) const override final
     {
-        return nearest_plugin.HandleRequest(GetAlgorithms(params), params, result);
+        return CachedRequest(params, result, [&] {
+            return nearest_plugin.HandleRequest(GetAlgorithms(params), params, result);
+        });
     }
 
-    Status Trip(const api::TripParameters &params, util::json::Object &result) const override final
+    Status Trip(const api::TripParameters &params, api::ResultT &result) const override final
     {
         return trip_plugin.HandleRequest(GetAlgorithms(params), params, result);
     }
 
-    Status Match(const api::MatchParameters &params,
-                 util::json::Object &result) const override final
+    Status Match(const api::MatchParameters &params, api::ResultT &result) const override final
     {
-        return match_plugin.HandleRequest(GetAlgorithms(params), params, result);
+        // the plugin refuses session ids if sessions are disabled
+        if (params.session.empty() || !match_sessions)
+        {
+            return match_plugin.HandleRequest(GetAlgorithms(params), params, result);
+        }
+
+        const auto facade = facade_provider->Get(params);
+        const auto session = match_sessions->Get(params.session);
+        // requests of the same session are handled one after another
+        std::lock_guard<std::mutex> lock(session->mutex);
+        return match_plugin.HandleRequest(RoutingAlgorithms<Algorithm>{heaps, facade},
+                                          params,
+                                          session->UseFacade(facade),
+                                          result);
     }
 
     Status Tile(const api::TileParameters &params, std::string &result) const override final
     {
+        // the archive holds the weights of the dataset at the time the tiles were rendered
+        if (tile_archive && facade_provider->GetTimestamp() == tile_archive_timestamp &&
+            tile_archive->Get(params.z, params.x, params.y, result))
+        {
+            return Status::Ok;
+        }
         return tile_plugin.HandleRequest(GetAlgorithms(params), params, result);
     }
 
+    void Metrics(util::json::Object &result) const override final
+    {
+        if (response_cache)
+        {
+            result.values["response_cache"] = response_cache->GetMetrics();
+        }
+        if (phantom_node_cache)
+        {
+            result.values["phantom_node_cache"] = phantom_node_cache->GetMetrics();
+        }
+        if (auto *unpacking_cache = getUnpackingCache(heaps))
+        {
+            result.values["unpacking_cache"] = unpacking_cache->GetMetrics();
+        }
+        if (match_sessions)
+        {
+            result.values["match_sessions"] = match_sessions->GetMetrics();
+        }
+        if (tile_archive)
+        {
+            result.values["tile_archive"] = tile_archive->GetMetrics();
+        }
+    }
+
+    Status UpdateSegmentSpeeds(const std::string &segment_speeds,
+                               util::json::Object &result) const override final
+    {
+        if (!live_provider)
+        {
+            result.values["code"] = "NotImplemented";
+            result.values["message"] = "Live traffic updates are not enabled";
+            return Status::Error;
+        }
+
+        try
+        {
+            const auto update = live_provider->Update(
+                updater::csv::parseSegmentValues("request body", segment_speeds));
+            result.values["code"] = "Ok";
+            result.values["segments"] = util::json::Number(update.segments);
+            result.values["edges"] = util::json::Number(update.edges);
+            result.values["cells"] = util::json::Number(update.cells);
+            return Status::Ok;
+        }
+        catch (const util::exception &e)
+        {
+            result.values["code"] = "InvalidValue";
+            result.values["message"] = e.what();
+            return Status::Error;
+        }
+    }
+
     static bool CheckCompatibility(const EngineConfig &config);
 
   private:
+    // Answers from the response cache if possible, caches successful responses otherwise
+    template <typename ParametersT, typename HandlerT>
+    Status CachedRequest(const ParametersT &params,
+                         api::ResultT &result,
+                         const HandlerT &handle_request) const
+    {
+        if (!response_cache)
+        {
+            return handle_request();
+        }
+
+        // read before the facade is requested: a response may end up cached under the timestamp
+        // of the previous dataset, but those entries are dropped once the new one is seen
+        const auto timestamp = facade_provider->GetTimestamp();
+        // rendered and unrendered responses are cached separately
+        auto key = MakeResponseCacheKey(params);
+        key.push_back(static_cast<char>(result.which()));
+        if (response_cache->Get(key, timestamp, result))
+        {
+            return Status::Ok;
+        }
+
+        const auto status = handle_request();
+        if (status == Status::Ok)
+        {
+            response_cache->Put(key, timestamp, result);
+        }
+        return status;
+    }
+
     template <typename ParametersT> auto GetAlgorithms(const ParametersT &params) const
     {
         return RoutingAlgorithms<Algorithm>{heaps, facade_provider->Get(params)};
     }
+    std::shared_ptr<PhantomNodeCache> phantom_node_cache;
     std::unique_ptr<DataFacadeProvider<Algorithm>> facade_provider;
+    // set if facade_provider accepts live traffic updates
+    LiveProvider<Algorithm> *live_provider = nullptr;
     mutable SearchEngineData<Algorithm> heaps;
+    std::unique_ptr<ResponseCache> response_cache;
+    std::unique_ptr<MatchSessionStore> match_sessions;
+    std::unique_ptr<TileArchive> tile_archive;
+    // tiles of the archive are not served once the provider switched to another dataset
+    unsigned tile_archive_timestamp = 0;
 
     const plugins::ViaRoutePlugin route_plugin;
     const plugins::TablePlugin table_plugin;
@@ -201,6 +385,33 @@ bool Engine<routing_algorithms::mld::Algorithm>::CheckCompatibility(const Engine
         return size > 0;
     }
 }
+
+template <>
+bool Engine<routing_algorithms::cch::Algorithm>::CheckCompatibility(const EngineConfig &config)
+{
+    if (config.use_shared_memory)
+    {
+        storage::SharedMonitor<storage::SharedDataTimestamp> barrier;
+        using mutex_type = typename decltype(barrier)::mutex_type;
+        boost::interprocess::scoped_lock<mutex_type> current_region_lock(barrier.get_mutex());
+
+        auto mem = storage::makeSharedMemory(barrier.data().region);
+        auto layout = reinterpret_cast<storage::DataLayout *>(mem->Ptr());
+        return layout->GetBlockSize(storage::DataLayout::CCH_GRAPH_NODE_LIST) > 4 &&
+               layout->GetBlockSize(storage::DataLayout::CCH_GRAPH_EDGE_LIST) > 4 &&
+               layout->GetBlockSize(storage::DataLayout::CCH_ELIMINATION_TREE) > 0;
+    }
+    else
+    {
+        if (!boost::filesystem::exists(config.storage_config.GetPath(".osrm.cch")))
+            return false;
+        storage::io::FileReader in(config.storage_config.GetPath(".osrm.cch"),
+                                   storage::io::FileReader::VerifyFingerprint);
+
+        auto size = in.GetSize();
+        return size > 0;
+    }
+}
 }
 }
 
@@ -32,7 +32,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <boost/filesystem/path.hpp>
 
+#include <istream>
 #include <string>
+#include <unordered_map>
 
 namespace osrm
 {
@@ -53,9 +55,51 @@ namespace engine
  *  - Match
  *  - Nearest
  *
+ * The searches of a single table request run on up to `max_threads_distance_table` threads.
+ *
+ * Successful route, table and nearest responses can be kept in a least recently used cache of
+ * `response_cache_size` bytes, 0 disables the cache. Cached responses are dropped when a new
+ * dataset is loaded into shared memory.
+ *
+ * The phantom nodes that coordinates snap to can be cached as well, `phantom_node_cache_size`
+ * limits the number of cached snapping results and 0 disables that cache.
+ *
+ * MLD queries can cache the base graph paths of the overlay edges they unpack in up to
+ * `unpacking_cache_size` bytes, 0 disables that cache.
+ *
+ * Match requests with a session id extend the trace of that session. Up to `max_match_sessions`
+ * sessions are kept, 0 disables sessions. A session expires `match_session_timeout` seconds after
+ * its last request and keeps the last `max_match_session_points` points of its trace.
+ *
  * In addition, shared memory can be used for datasets loaded with osrm-datastore.
  *
- * You can chose between three algorithms:
+ * Without shared memory the dataset is copied into process memory, unless a `memory_file` is set:
+ * then the dataset is kept in that file and memory-mapped, so that it is loaded on demand and its
+ * pages are shared between processes through the page cache. `memory_file_advice` sets the
+ * access pattern hint for a block by its name in `storage::block_id_to_name`, or for all blocks
+ * by `all`.
+ *
+ * With `live_traffic_updates` the segment speeds of a MLD dataset in process memory or in a
+ * memory file can be updated while queries run, see OSRM::UpdateSegmentSpeeds.
+ *
+ * With `share_blocks` the blocks that don't depend on the profile, like names, coordinates and
+ * geometries, are kept only once if another engine of the process loaded identical blocks before.
+ * This has no effect with shared memory or live traffic updates.
+ *
+ * With `tile_archive` tile requests are answered from the tiles that osrm-tiles rendered ahead
+ * of time, tiles that are not in the archive are rendered as usual. The archive is only used for
+ * the dataset it was rendered from and not after a new dataset or metric was loaded.
+ *
+ * The query heaps can find the heap entry of a node in different ways:
+ *  - HeapStorage::HashMap
+ *      Hash map, uses little memory but needs a hash lookup for every edge relaxation.
+ *  - HeapStorage::Array
+ *      Array over all nodes, the fastest lookups but every heap of every thread needs memory
+ * proportional to the number of nodes in the graph.
+ *  - HeapStorage::TwoLevel
+ *      Array for the first `heap_dense_nodes` node IDs, hash map for all others.
+ *
+ * You can chose between four algorithms:
  *  - Algorithm::CH
  *      Contraction Hierarchies, extremely fast queries but slow pre-processing. The default right
  * now.
@@ -65,6 +109,9 @@ namespace engine
  * queries.
  *  - Algorithm::MLD
  *      Multi Level Dijkstra, moderately fast in both pre-processing and query.
+ *  - Algorithm::CCH
+ *      Customizable Contraction Hierarchies, the contraction order is taken from the MLD
+ * partition and weights are updated by osrm-customize --cch. Fast queries and fast updates.
  *
  * \see OSRM, StorageConfig
  */
@@ -76,21 +123,57 @@ struct EngineConfig final
     {
         CH,
         CoreCH, // Deprecated, will be removed in v6.0
-        MLD
+        MLD,
+        CCH
+    };
+
+    enum class HeapStorage
+    {
+        HashMap,
+        Array,
+        TwoLevel
+    };
+
+    enum class MemoryAdvice
+    {
+        Normal,
+        Random,
+        Sequential,
+        WillNeed,
+        Populate // WillNeed and fault in all pages at startup
     };
 
     storage::StorageConfig storage_config;
     int max_locations_trip = -1;
     int max_locations_viaroute = -1;
     int max_locations_distance_table = -1;
+    unsigned max_threads_distance_table = 1;
     int max_locations_map_matching = -1;
     double max_radius_map_matching = -1.0;
     int max_results_nearest = -1;
+    int max_batch_size_nearest = -1;
     int max_alternatives = 3; // set an arbitrary upper bound; can be adjusted by user
     bool use_shared_memory = true;
     Algorithm algorithm = Algorithm::CH;
+    HeapStorage query_heap_storage = HeapStorage::HashMap;
+    HeapStorage many_to_many_heap_storage = HeapStorage::HashMap;
+    std::size_t heap_dense_nodes = 1 << 20;
+    std::size_t response_cache_size = 0;
+    std::size_t phantom_node_cache_size = 0;
+    std::size_t unpacking_cache_size = 0;
+    std::size_t max_match_sessions = 0;
+    unsigned match_session_timeout = 300;
+    std::size_t max_match_session_points = 100;
+    boost::filesystem::path memory_file;
+    std::unordered_map<std::string, MemoryAdvice> memory_file_advice;
+    bool live_traffic_updates = false;
+    bool share_blocks = false;
+    boost::filesystem::path tile_archive;
     std::string verbosity;
 };
+
+// Reads CH, CoreCH, MLD or CCH in any case, e.g. for command line options
+std::istream &operator>>(std::istream &in, EngineConfig::Algorithm &algorithm);
 }
 }
 
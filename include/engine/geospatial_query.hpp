@@ -3,17 +3,23 @@
 
 #include "engine/approach.hpp"
 #include "engine/phantom_node.hpp"
+#include "engine/phantom_node_cache.hpp"
 #include "util/bearing.hpp"
 #include "util/coordinate_calculation.hpp"
+#include "util/hilbert_value.hpp"
 #include "util/rectangle.hpp"
 #include "util/typedefs.hpp"
 #include "util/web_mercator.hpp"
 
 #include "osrm/coordinate.hpp"
 
+#include <boost/optional.hpp>
+
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <memory>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -29,7 +35,7 @@ inline std::pair<bool, bool> boolPairAnd(const std::pair<bool, bool> &A,
 
 // Implements complex queries on top of an RTree and builds PhantomNodes from it.
 //
-// Only holds a weak reference on the RTree and coordinates!
+// Only holds a weak reference on the RTree, coordinates and the phantom node cache!
 template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
 {
     using EdgeData = typename RTreeT::EdgeData;
@@ -37,8 +43,12 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
     using CandidateSegment = typename RTreeT::CandidateSegment;
 
   public:
-    GeospatialQuery(RTreeT &rtree_, const CoordinateList &coordinates_, DataFacadeT &datafacade_)
-        : rtree(rtree_), coordinates(coordinates_), datafacade(datafacade_)
+    GeospatialQuery(RTreeT &rtree_,
+                    const CoordinateList &coordinates_,
+                    DataFacadeT &datafacade_,
+                    PhantomNodeCache *cache_ = nullptr)
+        : rtree(rtree_), coordinates(coordinates_), datafacade(datafacade_), cache(cache_),
+          cache_owner(cache_ ? cache_->NewOwner() : 0)
     {
     }
 
@@ -54,6 +64,14 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                                const double max_distance,
                                const Approach approach) const
     {
+        const auto key =
+            MakeCacheKey(CachedQuery::InRange, input_coordinate, approach, 0, max_distance);
+        std::vector<PhantomNodeWithDistance> cached;
+        if (LookUp(key, cached))
+        {
+            return cached;
+        }
+
         auto results = rtree.Nearest(
             input_coordinate,
             [this, approach, &input_coordinate](const CandidateSegment &segment) {
@@ -65,7 +83,7 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                 return CheckSegmentDistance(input_coordinate, segment, max_distance);
             });
 
-        return MakePhantomNodes(input_coordinate, results);
+        return Store(key, MakePhantomNodes(input_coordinate, results));
     }
 
     // Returns nearest PhantomNodes in the given bearing range within max_distance.
@@ -77,6 +95,19 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                                const int bearing_range,
                                const Approach approach) const
     {
+        const auto key = MakeCacheKey(CachedQuery::InRangeWithBearing,
+                                      input_coordinate,
+                                      approach,
+                                      0,
+                                      max_distance,
+                                      bearing,
+                                      bearing_range);
+        std::vector<PhantomNodeWithDistance> cached;
+        if (LookUp(key, cached))
+        {
+            return cached;
+        }
+
         auto results = rtree.Nearest(
             input_coordinate,
             [this, approach, &input_coordinate, bearing, bearing_range, max_distance](
@@ -93,7 +124,7 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                 return CheckSegmentDistance(input_coordinate, segment, max_distance);
             });
 
-        return MakePhantomNodes(input_coordinate, results);
+        return Store(key, MakePhantomNodes(input_coordinate, results));
     }
 
     // Returns max_results nearest PhantomNodes in the given bearing range.
@@ -105,6 +136,19 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                         const int bearing_range,
                         const Approach approach) const
     {
+        const auto key = MakeCacheKey(CachedQuery::NearestWithBearing,
+                                      input_coordinate,
+                                      approach,
+                                      max_results,
+                                      0,
+                                      bearing,
+                                      bearing_range);
+        std::vector<PhantomNodeWithDistance> cached;
+        if (LookUp(key, cached))
+        {
+            return cached;
+        }
+
         auto results = rtree.Nearest(
             input_coordinate,
             [this, approach, &input_coordinate, bearing, bearing_range](
@@ -119,7 +163,7 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                 return num_results >= max_results;
             });
 
-        return MakePhantomNodes(input_coordinate, results);
+        return Store(key, MakePhantomNodes(input_coordinate, results));
     }
 
     // Returns max_results nearest PhantomNodes in the given bearing range within the maximum
@@ -133,6 +177,19 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                         const int bearing_range,
                         const Approach approach) const
     {
+        const auto key = MakeCacheKey(CachedQuery::NearestInRangeWithBearing,
+                                      input_coordinate,
+                                      approach,
+                                      max_results,
+                                      max_distance,
+                                      bearing,
+                                      bearing_range);
+        std::vector<PhantomNodeWithDistance> cached;
+        if (LookUp(key, cached))
+        {
+            return cached;
+        }
+
         auto results = rtree.Nearest(
             input_coordinate,
             [this, approach, &input_coordinate, bearing, bearing_range](
@@ -149,7 +206,7 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                        CheckSegmentDistance(input_coordinate, segment, max_distance);
             });
 
-        return MakePhantomNodes(input_coordinate, results);
+        return Store(key, MakePhantomNodes(input_coordinate, results));
     }
 
     // Returns max_results nearest PhantomNodes.
@@ -159,6 +216,14 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                         const unsigned max_results,
                         const Approach approach) const
     {
+        const auto key =
+            MakeCacheKey(CachedQuery::Nearest, input_coordinate, approach, max_results);
+        std::vector<PhantomNodeWithDistance> cached;
+        if (LookUp(key, cached))
+        {
+            return cached;
+        }
+
         auto results = rtree.Nearest(
             input_coordinate,
             [this, approach, &input_coordinate](const CandidateSegment &segment) {
@@ -169,7 +234,7 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                 return num_results >= max_results;
             });
 
-        return MakePhantomNodes(input_coordinate, results);
+        return Store(key, MakePhantomNodes(input_coordinate, results));
     }
 
     // Returns max_results nearest PhantomNodes in the given max distance.
@@ -180,6 +245,17 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                         const double max_distance,
                         const Approach approach) const
     {
+        const auto key = MakeCacheKey(CachedQuery::NearestInRange,
+                                      input_coordinate,
+                                      approach,
+                                      max_results,
+                                      max_distance);
+        std::vector<PhantomNodeWithDistance> cached;
+        if (LookUp(key, cached))
+        {
+            return cached;
+        }
+
         auto results = rtree.Nearest(
             input_coordinate,
             [this, approach, &input_coordinate](const CandidateSegment &segment) {
@@ -192,7 +268,74 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                        CheckSegmentDistance(input_coordinate, segment, max_distance);
             });
 
-        return MakePhantomNodes(input_coordinate, results);
+        return Store(key, MakePhantomNodes(input_coordinate, results));
+    }
+
+    // Returns max_results nearest PhantomNodes of every coordinate, within its max distance if
+    // it has one. The coordinates are searched in the order of the Hilbert curve, every group of
+    // neighbouring coordinates shares the upper levels of the RTree and the leaves it visits.
+    // Does not filter by small/big component and does not use the cache!
+    std::vector<std::vector<PhantomNodeWithDistance>>
+    NearestPhantomNodes(const std::vector<util::Coordinate> &input_coordinates,
+                        const unsigned max_results,
+                        const std::vector<boost::optional<double>> &max_distances,
+                        const std::vector<boost::optional<Approach>> &approaches) const
+    {
+        BOOST_ASSERT(max_distances.empty() || max_distances.size() == input_coordinates.size());
+        BOOST_ASSERT(approaches.empty() || approaches.size() == input_coordinates.size());
+
+        std::vector<std::pair<std::uint64_t, std::size_t>> hilbert_order;
+        hilbert_order.reserve(input_coordinates.size());
+        for (std::size_t index = 0; index < input_coordinates.size(); ++index)
+        {
+            hilbert_order.emplace_back(util::GetHilbertCode(input_coordinates[index]), index);
+        }
+        std::sort(hilbert_order.begin(), hilbert_order.end());
+
+        std::vector<std::vector<PhantomNodeWithDistance>> phantom_nodes(input_coordinates.size());
+        std::vector<util::Coordinate> group_coordinates;
+        for (std::size_t group_begin = 0; group_begin < hilbert_order.size();
+             group_begin += QUERY_GROUP_SIZE)
+        {
+            const auto group_end = std::min(group_begin + QUERY_GROUP_SIZE, hilbert_order.size());
+
+            group_coordinates.clear();
+            for (auto position = group_begin; position < group_end; ++position)
+            {
+                group_coordinates.push_back(input_coordinates[hilbert_order[position].second]);
+            }
+            auto group = rtree.MakeQueryGroup(group_coordinates.begin(), group_coordinates.end());
+
+            for (auto position = group_begin; position < group_end; ++position)
+            {
+                const auto index = hilbert_order[position].second;
+                const auto &input_coordinate = input_coordinates[index];
+                const auto approach = approaches.empty() || !approaches[index]
+                                          ? Approach::UNRESTRICTED
+                                          : *approaches[index];
+                const auto max_distance =
+                    max_distances.empty() ? boost::optional<double>{} : max_distances[index];
+
+                auto results = rtree.Nearest(
+                    group,
+                    input_coordinate,
+                    [this, approach, &input_coordinate](const CandidateSegment &segment) {
+                        return boolPairAnd(
+                            boolPairAnd(HasValidEdge(segment), CheckSegmentExclude(segment)),
+                            CheckApproach(input_coordinate, segment, approach));
+                    },
+                    [this, max_distance, max_results, &input_coordinate](
+                        const std::size_t num_results, const CandidateSegment &segment) {
+                        return num_results >= max_results ||
+                               (max_distance &&
+                                CheckSegmentDistance(input_coordinate, segment, *max_distance));
+                    });
+
+                phantom_nodes[index] = MakePhantomNodes(input_coordinate, results);
+            }
+        }
+
+        return phantom_nodes;
     }
 
     // Returns the nearest phantom node. If this phantom node is not from a big component
@@ -202,6 +345,17 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                                                       const double max_distance,
                                                       const Approach approach) const
     {
+        const auto key = MakeCacheKey(CachedQuery::BigComponentInRange,
+                                      input_coordinate,
+                                      approach,
+                                      0,
+                                      max_distance);
+        std::vector<PhantomNodeWithDistance> cached;
+        if (LookUp(key, cached))
+        {
+            return MakePair(cached);
+        }
+
         bool has_small_component = false;
         bool has_big_component = false;
         auto results = rtree.Nearest(
@@ -234,12 +388,14 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
 
         if (results.size() == 0)
         {
-            return std::make_pair(PhantomNode{}, PhantomNode{});
+            return StorePair(key, std::make_pair(PhantomNode{}, PhantomNode{}));
         }
 
         BOOST_ASSERT(results.size() == 1 || results.size() == 2);
-        return std::make_pair(MakePhantomNode(input_coordinate, results.front()).phantom_node,
-                              MakePhantomNode(input_coordinate, results.back()).phantom_node);
+        return StorePair(
+            key,
+            std::make_pair(MakePhantomNode(input_coordinate, results.front()).phantom_node,
+                           MakePhantomNode(input_coordinate, results.back()).phantom_node));
     }
 
     // Returns the nearest phantom node. If this phantom node is not from a big component
@@ -248,6 +404,13 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
     NearestPhantomNodeWithAlternativeFromBigComponent(const util::Coordinate input_coordinate,
                                                       const Approach approach) const
     {
+        const auto key = MakeCacheKey(CachedQuery::BigComponent, input_coordinate, approach);
+        std::vector<PhantomNodeWithDistance> cached;
+        if (LookUp(key, cached))
+        {
+            return MakePair(cached);
+        }
+
         bool has_small_component = false;
         bool has_big_component = false;
         auto results = rtree.Nearest(
@@ -279,12 +442,14 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
 
         if (results.size() == 0)
         {
-            return std::make_pair(PhantomNode{}, PhantomNode{});
+            return StorePair(key, std::make_pair(PhantomNode{}, PhantomNode{}));
         }
 
         BOOST_ASSERT(results.size() == 1 || results.size() == 2);
-        return std::make_pair(MakePhantomNode(input_coordinate, results.front()).phantom_node,
-                              MakePhantomNode(input_coordinate, results.back()).phantom_node);
+        return StorePair(
+            key,
+            std::make_pair(MakePhantomNode(input_coordinate, results.front()).phantom_node,
+                           MakePhantomNode(input_coordinate, results.back()).phantom_node));
     }
 
     // Returns the nearest phantom node. If this phantom node is not from a big component
@@ -295,6 +460,19 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                                                       const int bearing_range,
                                                       const Approach approach) const
     {
+        const auto key = MakeCacheKey(CachedQuery::BigComponentWithBearing,
+                                      input_coordinate,
+                                      approach,
+                                      0,
+                                      0,
+                                      bearing,
+                                      bearing_range);
+        std::vector<PhantomNodeWithDistance> cached;
+        if (LookUp(key, cached))
+        {
+            return MakePair(cached);
+        }
+
         bool has_small_component = false;
         bool has_big_component = false;
         auto results = rtree.Nearest(
@@ -336,12 +514,14 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
 
         if (results.size() == 0)
         {
-            return std::make_pair(PhantomNode{}, PhantomNode{});
+            return StorePair(key, std::make_pair(PhantomNode{}, PhantomNode{}));
         }
 
         BOOST_ASSERT(results.size() > 0);
-        return std::make_pair(MakePhantomNode(input_coordinate, results.front()).phantom_node,
-                              MakePhantomNode(input_coordinate, results.back()).phantom_node);
+        return StorePair(
+            key,
+            std::make_pair(MakePhantomNode(input_coordinate, results.front()).phantom_node,
+                           MakePhantomNode(input_coordinate, results.back()).phantom_node));
     }
 
     // Returns the nearest phantom node. If this phantom node is not from a big component
@@ -353,6 +533,19 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                                                       const int bearing_range,
                                                       const Approach approach) const
     {
+        const auto key = MakeCacheKey(CachedQuery::BigComponentInRangeWithBearing,
+                                      input_coordinate,
+                                      approach,
+                                      0,
+                                      max_distance,
+                                      bearing,
+                                      bearing_range);
+        std::vector<PhantomNodeWithDistance> cached;
+        if (LookUp(key, cached))
+        {
+            return MakePair(cached);
+        }
+
         bool has_small_component = false;
         bool has_big_component = false;
         auto results = rtree.Nearest(
@@ -396,15 +589,89 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
 
         if (results.size() == 0)
         {
-            return std::make_pair(PhantomNode{}, PhantomNode{});
+            return StorePair(key, std::make_pair(PhantomNode{}, PhantomNode{}));
         }
 
         BOOST_ASSERT(results.size() > 0);
-        return std::make_pair(MakePhantomNode(input_coordinate, results.front()).phantom_node,
-                              MakePhantomNode(input_coordinate, results.back()).phantom_node);
+        return StorePair(
+            key,
+            std::make_pair(MakePhantomNode(input_coordinate, results.front()).phantom_node,
+                           MakePhantomNode(input_coordinate, results.back()).phantom_node));
     }
 
   private:
+    // Number of neighbouring coordinates of a batch that are searched together
+    static constexpr std::size_t QUERY_GROUP_SIZE = 32;
+
+    enum class CachedQuery : std::uint8_t
+    {
+        InRange,
+        InRangeWithBearing,
+        Nearest,
+        NearestWithBearing,
+        NearestInRange,
+        NearestInRangeWithBearing,
+        BigComponent,
+        BigComponentInRange,
+        BigComponentWithBearing,
+        BigComponentInRangeWithBearing
+    };
+
+    PhantomNodeCache::Key MakeCacheKey(const CachedQuery query,
+                                       const util::Coordinate input_coordinate,
+                                       const Approach approach,
+                                       const unsigned max_results = 0,
+                                       const double max_distance = 0,
+                                       const int bearing = 0,
+                                       const int bearing_range = 0) const
+    {
+        PhantomNodeCache::Key key;
+        key.owner = cache_owner;
+        key.query = static_cast<std::uint8_t>(query);
+        key.approach = static_cast<std::uint8_t>(approach);
+        key.lon = static_cast<std::int32_t>(input_coordinate.lon);
+        key.lat = static_cast<std::int32_t>(input_coordinate.lat);
+        key.max_results = max_results;
+        key.max_distance = max_distance;
+        key.bearing = bearing;
+        key.bearing_range = bearing_range;
+        return key;
+    }
+
+    bool LookUp(const PhantomNodeCache::Key &key,
+                std::vector<PhantomNodeWithDistance> &cached) const
+    {
+        return cache && cache->Get(key, cached);
+    }
+
+    std::vector<PhantomNodeWithDistance> Store(const PhantomNodeCache::Key &key,
+                                               std::vector<PhantomNodeWithDistance> results) const
+    {
+        if (cache)
+        {
+            cache->Put(key, results);
+        }
+        return results;
+    }
+
+    // Pairs of phantom nodes are cached as two entries without distance
+    std::pair<PhantomNode, PhantomNode> StorePair(const PhantomNodeCache::Key &key,
+                                                  std::pair<PhantomNode, PhantomNode> result) const
+    {
+        if (cache)
+        {
+            cache->Put(key, {{result.first, 0.}, {result.second, 0.}});
+        }
+        return result;
+    }
+
+    static std::pair<PhantomNode, PhantomNode>
+    MakePair(const std::vector<PhantomNodeWithDistance> &cached)
+    {
+        BOOST_ASSERT(cached.size() == 2);
+        return std::make_pair(cached.front().phantom_node, cached.back().phantom_node);
+    }
+
     std::vector<PhantomNodeWithDistance>
     MakePhantomNodes(const util::Coordinate input_coordinate,
                      const std::vector<EdgeData> &results) const
@@ -661,6 +928,8 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
     const RTreeT &rtree;
     const CoordinateList &coordinates;
     DataFacadeT &datafacade;
+    PhantomNodeCache *cache;
+    const std::uint32_t cache_owner;
 };
 }
 }
@@ -9,6 +9,7 @@
 #include <cmath>
 
 #include <limits>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -62,16 +63,25 @@ template <class CandidateLists> struct HiddenMarkovModel
 
     HiddenMarkovModel(const CandidateLists &candidates_list,
                       const std::vector<std::vector<double>> &emission_log_probabilities)
-        : breakage(candidates_list.size()), candidates_list(candidates_list),
-          emission_log_probabilities(emission_log_probabilities)
+        : candidates_list(candidates_list), emission_log_probabilities(emission_log_probabilities)
     {
-        viterbi.resize(candidates_list.size());
-        viterbi_reachable.resize(candidates_list.size());
-        parents.resize(candidates_list.size());
-        path_distances.resize(candidates_list.size());
-        pruned.resize(candidates_list.size());
-        breakage.resize(candidates_list.size());
-        for (const auto i : util::irange<std::size_t>(0UL, candidates_list.size()))
+        Extend();
+    }
+
+    // Adds the points that were appended to the candidate lists since the last call
+    void Extend()
+    {
+        const auto begin = viterbi.size();
+        const auto end = candidates_list.size();
+        BOOST_ASSERT(begin <= end);
+
+        viterbi.resize(end);
+        viterbi_reachable.resize(end);
+        parents.resize(end);
+        path_distances.resize(end);
+        pruned.resize(end);
+        breakage.resize(end);
+        for (const auto i : util::irange(begin, end))
         {
             const auto &num_candidates = candidates_list[i].size();
             // add empty vectors
@@ -85,7 +95,37 @@ template <class CandidateLists> struct HiddenMarkovModel
             }
         }
 
-        Clear(0);
+        Clear(begin);
+    }
+
+    // Removes the first `count` points. Parents among the removed points are replaced by the
+    // candidate itself, so that paths end at the first remaining point.
+    void Erase(std::size_t count)
+    {
+        BOOST_ASSERT(count <= viterbi.size());
+
+        viterbi.erase(viterbi.begin(), viterbi.begin() + count);
+        viterbi_reachable.erase(viterbi_reachable.begin(), viterbi_reachable.begin() + count);
+        parents.erase(parents.begin(), parents.begin() + count);
+        path_distances.erase(path_distances.begin(), path_distances.begin() + count);
+        pruned.erase(pruned.begin(), pruned.begin() + count);
+        breakage.erase(breakage.begin(), breakage.begin() + count);
+
+        for (const auto t : util::irange<std::size_t>(0UL, parents.size()))
+        {
+            for (const auto s : util::irange<std::size_t>(0UL, parents[t].size()))
+            {
+                auto &parent = parents[t][s];
+                if (parent.first < count)
+                {
+                    parent = std::make_pair(t, s);
+                }
+                else
+                {
+                    parent.first -= count;
+                }
+            }
+        }
     }
 
     void Clear(std::size_t initial_timestamp)
@@ -124,15 +164,14 @@ template <class CandidateLists> struct HiddenMarkovModel
             ++initial_timestamp;
         } while (initial_timestamp < num_points && breakage[initial_timestamp - 1]);
 
-        if (initial_timestamp >= num_points)
-        {
-            return INVALID_STATE;
-        }
-
         BOOST_ASSERT(initial_timestamp > 0);
         --initial_timestamp;
 
-        BOOST_ASSERT(breakage[initial_timestamp] == false);
+        // the last point is a valid start as well, points may still be appended to the trace
+        if (breakage[initial_timestamp])
+        {
+            return INVALID_STATE;
+        }
 
         return initial_timestamp;
     }
@@ -0,0 +1,83 @@
+#ifndef OSRM_ENGINE_MATCH_SESSION_STORE_HPP
+#define OSRM_ENGINE_MATCH_SESSION_STORE_HPP
+
+#include "engine/routing_algorithms/map_matching.hpp"
+
+#include "util/json_container.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace osrm
+{
+namespace engine
+{
+
+// Matching state of a trace that is extended by a series of match requests
+struct MatchSession
+{
+    // Returns the state of the session. The candidates of the state are nodes of the facade that
+    // found them, the state starts over if the session is extended on another facade. Requires
+    // the mutex to be held.
+    routing_algorithms::MapMatchingState &UseFacade(const std::shared_ptr<const void> &facade);
+
+    // held while a request extends the session
+    std::mutex mutex;
+
+  private:
+    std::weak_ptr<const void> facade;
+    std::unique_ptr<routing_algorithms::MapMatchingState> state;
+};
+
+/**
+ * Match sessions by their ids.
+ *
+ * Sessions that were not used for `timeout` expire. At most `max_sessions` sessions are kept, the
+ * least recently used one is dropped to make room for a new one.
+ */
+class MatchSessionStore
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    MatchSessionStore(std::size_t max_sessions, std::chrono::seconds timeout);
+
+    // Returns the session of `id`, a new one if there is none
+    std::shared_ptr<MatchSession> Get(const std::string &id,
+                                      const Clock::time_point now = Clock::now());
+
+    // Sessions and the number of created, expired and evicted sessions
+    util::json::Object GetMetrics() const;
+
+  private:
+    struct Entry
+    {
+        std::string id;
+        std::shared_ptr<MatchSession> session;
+        Clock::time_point last_used;
+    };
+    using EntryList = std::list<Entry>;
+
+    // Needs the lock
+    void Expire(const Clock::time_point now);
+
+    const std::size_t max_sessions;
+    const Clock::duration timeout;
+
+    mutable std::mutex mutex;
+    EntryList entries; // most recently used first
+    std::unordered_map<std::string, EntryList::iterator> index;
+
+    std::uint64_t created = 0;
+    std::uint64_t expired = 0;
+    std::uint64_t evicted = 0;
+};
+}
+}
+
+#endif
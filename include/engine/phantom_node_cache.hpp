@@ -0,0 +1,77 @@
+#ifndef OSRM_ENGINE_PHANTOM_NODE_CACHE_HPP
+#define OSRM_ENGINE_PHANTOM_NODE_CACHE_HPP
+
+#include "engine/phantom_node.hpp"
+
+#include "util/json_container.hpp"
+#include "util/sharded_lru_cache.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+
+// All arguments of a nearest phantom node query, unused filters are left at their defaults.
+struct PhantomNodeCacheKey
+{
+    std::uint32_t owner = 0; // the geospatial query that computed the result
+    std::uint8_t query = 0;  // which of the queries was run
+    std::uint8_t approach = 0;
+    std::int32_t lon = 0;
+    std::int32_t lat = 0;
+    unsigned max_results = 0;
+    double max_distance = 0;
+    int bearing = 0;
+    int bearing_range = 0;
+
+    bool operator==(const PhantomNodeCacheKey &other) const
+    {
+        return owner == other.owner && query == other.query && approach == other.approach &&
+               lon == other.lon && lat == other.lat && max_results == other.max_results &&
+               max_distance == other.max_distance && bearing == other.bearing &&
+               bearing_range == other.bearing_range;
+    }
+};
+
+struct PhantomNodeCacheKeyHash
+{
+    std::size_t operator()(const PhantomNodeCacheKey &key) const;
+};
+
+/**
+ * Caches the snapped phantom nodes of coordinates that are queried over and over, e.g. depots.
+ *
+ * The cache is shared by the geospatial queries of all facades of an engine. Every query
+ * registers as its own owner, so results of different datasets and exclude flags never mix.
+ * Entries of facades that are gone are not looked up anymore and get evicted eventually.
+ */
+class PhantomNodeCache
+{
+  public:
+    using Key = PhantomNodeCacheKey;
+    using Value = std::vector<PhantomNodeWithDistance>;
+
+    explicit PhantomNodeCache(std::size_t max_entries);
+
+    // Returns an owner id that was never handed out before
+    std::uint32_t NewOwner() { return next_owner++; }
+
+    bool Get(const Key &key, Value &value) { return cache.Get(key, value); }
+    void Put(const Key &key, const Value &value) { cache.Put(key, value); }
+
+    // Entries, hits, misses and hit rate
+    util::json::Object GetMetrics() const;
+
+  private:
+    util::ShardedLRUCache<Key, Value, PhantomNodeCacheKeyHash> cache;
+
+    std::atomic<std::uint32_t> next_owner{0};
+};
+}
+}
+
+#endif
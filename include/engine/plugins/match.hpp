@@ -24,19 +24,35 @@ class MatchPlugin : public BasePlugin
     using CandidateLists = routing_algorithms::CandidateLists;
     static const constexpr double RADIUS_MULTIPLIER = 3;
 
-    MatchPlugin(const int max_locations_map_matching, const double max_radius_map_matching)
+    MatchPlugin(const int max_locations_map_matching,
+                const double max_radius_map_matching,
+                const std::size_t max_match_session_points)
         : max_locations_map_matching(max_locations_map_matching),
-          max_radius_map_matching(max_radius_map_matching)
+          max_radius_map_matching(max_radius_map_matching),
+          max_match_session_points(max_match_session_points)
     {
     }
 
     Status HandleRequest(const RoutingAlgorithmsInterface &algorithms,
                          const api::MatchParameters &parameters,
-                         util::json::Object &json_result) const;
+                         api::ResultT &json_result) const;
+
+    // Appends the coordinates to the trace of a match session and responds with the matchings of
+    // the new coordinates
+    Status HandleRequest(const RoutingAlgorithmsInterface &algorithms,
+                         const api::MatchParameters &parameters,
+                         routing_algorithms::MapMatchingState &session_state,
+                         api::ResultT &json_result) const;
 
   private:
+    // Checks the limits and values that all requests have to meet
+    bool CheckParameters(const RoutingAlgorithmsInterface &algorithms,
+                         const api::MatchParameters &parameters,
+                         api::ResultT &json_result) const;
+
     const int max_locations_map_matching;
     const double max_radius_map_matching;
+    const std::size_t max_match_session_points;
 };
 }
 }
@@ -17,14 +17,20 @@ namespace plugins
 class NearestPlugin final : public BasePlugin
 {
   public:
-    explicit NearestPlugin(const int max_results);
+    NearestPlugin(const int max_results, const int max_batch_size);
 
     Status HandleRequest(const RoutingAlgorithmsInterface &algorithms,
                          const api::NearestParameters &params,
-                         util::json::Object &result) const;
+                         api::ResultT &result) const;
 
   private:
+    // Snaps every coordinate to its nearest segment and writes packed arrays
+    Status HandleBatch(const datafacade::BaseDataFacade &facade,
+                       const api::NearestParameters &params,
+                       api::ResultT &result) const;
+
     const int max_results;
+    const int max_batch_size;
 };
 }
 }
@@ -2,6 +2,7 @@
 #define BASE_PLUGIN_HPP
 
 #include "engine/api/base_parameters.hpp"
+#include "engine/api/base_result.hpp"
 #include "engine/datafacade/datafacade_base.hpp"
 #include "engine/phantom_node.hpp"
 #include "engine/routing_algorithms.hpp"
@@ -11,6 +12,7 @@
 #include "util/coordinate_calculation.hpp"
 #include "util/integer_range.hpp"
 #include "util/json_container.hpp"
+#include "util/json_writer.hpp"
 
 #include <algorithm>
 #include <iterator>
@@ -39,7 +41,7 @@ class BasePlugin
 
     bool CheckAlgorithms(const api::BaseParameters &params,
                          const RoutingAlgorithmsInterface &algorithms,
-                         util::json::Object &result) const
+                         api::ResultT &result) const
     {
         if (algorithms.IsValid())
         {
@@ -71,6 +73,24 @@ class BasePlugin
         return Status::Error;
     }
 
+    template <typename WriterT>
+    Status Error(const std::string &code, const std::string &message, WriterT &writer) const
+    {
+        writer.StartObject();
+        writer.Key("code");
+        writer.String(code);
+        writer.Key("message");
+        writer.String(message);
+        writer.EndObject();
+        return Status::Error;
+    }
+
+    Status Error(const std::string &code, const std::string &message, api::ResultT &result) const
+    {
+        api::VisitResult(result, [&](auto &output) { Error(code, message, output); });
+        return Status::Error;
+    }
+
     // Decides whether to use the phantom node from a big or small component if both are found.
     // Returns true if all phantom nodes are in the same component after snapping.
     std::vector<PhantomNode>
@@ -18,14 +18,15 @@ namespace plugins
 class TablePlugin final : public BasePlugin
 {
   public:
-    explicit TablePlugin(const int max_locations_distance_table);
+    TablePlugin(const int max_locations_distance_table, const unsigned max_threads_distance_table);
 
     Status HandleRequest(const RoutingAlgorithmsInterface &algorithms,
                          const api::TableParameters &params,
-                         util::json::Object &result) const;
+                         api::ResultT &result) const;
 
   private:
     const int max_locations_distance_table;
+    const unsigned max_threads_distance_table;
 };
 }
 }
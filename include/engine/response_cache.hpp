@@ -0,0 +1,73 @@
+#ifndef OSRM_ENGINE_RESPONSE_CACHE_HPP
+#define OSRM_ENGINE_RESPONSE_CACHE_HPP
+
+#include "engine/api/base_result.hpp"
+#include "engine/api/nearest_parameters.hpp"
+#include "engine/api/route_parameters.hpp"
+#include "engine/api/table_parameters.hpp"
+
+#include "util/json_container.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace osrm
+{
+namespace engine
+{
+
+// Keys of the response cache. Two requests have the same key iff all their parameters are equal,
+// coordinates are compared in the fixed point precision the engine uses.
+std::string MakeResponseCacheKey(const api::RouteParameters &parameters);
+std::string MakeResponseCacheKey(const api::TableParameters &parameters);
+std::string MakeResponseCacheKey(const api::NearestParameters &parameters);
+
+/**
+ * Least recently used cache of successful responses.
+ *
+ * The memory used by the responses is estimated and limited to `max_bytes`. Every entry belongs
+ * to the dataset identified by `dataset_timestamp`: when a lookup or insert sees a newer dataset
+ * all responses of the old one are dropped.
+ */
+class ResponseCache
+{
+  public:
+    explicit ResponseCache(std::size_t max_bytes);
+
+    // Copies the cached response of `key` into `result`, returns false if there is none
+    bool Get(const std::string &key, unsigned dataset_timestamp, api::ResultT &result);
+    void Put(const std::string &key, unsigned dataset_timestamp, const api::ResultT &result);
+
+    // Entries, estimated size, hits, misses, hit rate and dataset invalidations
+    util::json::Object GetMetrics() const;
+
+  private:
+    using Entry = std::pair<std::string, std::shared_ptr<const api::ResultT>>;
+    using EntryList = std::list<Entry>;
+
+    // Needs the lock, returns false if the timestamp belongs to an older dataset
+    bool UseDataset(unsigned dataset_timestamp);
+    void EvictUntil(std::size_t bytes);
+
+    const std::size_t max_bytes;
+
+    mutable std::mutex mutex;
+    EntryList entries; // most recently used first
+    std::unordered_map<std::string, std::pair<EntryList::iterator, std::size_t>> index;
+    std::size_t bytes = 0;
+    unsigned current_timestamp = 0;
+
+    std::atomic<std::uint64_t> hits{0};
+    std::atomic<std::uint64_t> misses{0};
+    std::atomic<std::uint64_t> invalidations{0};
+};
+}
+}
+
+#endif
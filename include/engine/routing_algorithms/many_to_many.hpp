@@ -7,6 +7,11 @@
 
 #include "util/typedefs.hpp"
 
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -21,17 +26,37 @@ namespace
 struct NodeBucket
 {
     NodeID middle_node;
+    NodeID parent_node;    // predecessor of middle_node towards the target, used for unpacking
+    bool from_clique_arc;  // MLD only: the edge to parent_node is an overlay shortcut
     unsigned column_index; // a column in the weight/duration matrix
     EdgeWeight weight;
     EdgeDuration duration;
 
-    NodeBucket(NodeID middle_node, unsigned column_index, EdgeWeight weight, EdgeDuration duration)
-        : middle_node(middle_node), column_index(column_index), weight(weight), duration(duration)
+    NodeBucket(NodeID middle_node,
+               NodeID parent_node,
+               bool from_clique_arc,
+               unsigned column_index,
+               EdgeWeight weight,
+               EdgeDuration duration)
+        : middle_node(middle_node), parent_node(parent_node), from_clique_arc(from_clique_arc),
+          column_index(column_index), weight(weight), duration(duration)
     {
     }
 
-    // partial order comparison
-    bool operator<(const NodeBucket &rhs) const { return middle_node < rhs.middle_node; }
+    NodeBucket(NodeID middle_node,
+               NodeID parent_node,
+               unsigned column_index,
+               EdgeWeight weight,
+               EdgeDuration duration)
+        : NodeBucket(middle_node, parent_node, false, column_index, weight, duration)
+    {
+    }
+
+    // partial order comparison, a node is settled at most once per column
+    bool operator<(const NodeBucket &rhs) const
+    {
+        return std::tie(middle_node, column_index) < std::tie(rhs.middle_node, rhs.column_index);
+    }
 
     // functor for equal_range
     struct Compare
@@ -46,15 +71,103 @@ struct NodeBucket
             return lhs < rhs.middle_node;
         }
     };
+
+    // functor for equal_range of a single column
+    struct ColumnCompare
+    {
+        unsigned column_index;
+
+        explicit ColumnCompare(unsigned column_index) : column_index(column_index) {}
+
+        bool operator()(const NodeBucket &lhs, const NodeID &rhs) const
+        {
+            return std::tie(lhs.middle_node, lhs.column_index) < std::tie(rhs, column_index);
+        }
+
+        bool operator()(const NodeID &lhs, const NodeBucket &rhs) const
+        {
+            return std::tie(lhs, column_index) < std::tie(rhs.middle_node, rhs.column_index);
+        }
+    };
 };
+
+// Bucket that stores the backward search space of `column_index` at `node`
+inline const NodeBucket &findBucket(const std::vector<NodeBucket> &search_space_with_buckets,
+                                    const NodeID node,
+                                    const unsigned column_index)
+{
+    const auto bucket = std::lower_bound(search_space_with_buckets.begin(),
+                                         search_space_with_buckets.end(),
+                                         node,
+                                         NodeBucket::ColumnCompare(column_index));
+    BOOST_ASSERT(bucket != search_space_with_buckets.end());
+    BOOST_ASSERT(bucket->middle_node == node && bucket->column_index == column_index);
+    return *bucket;
+}
+
+// Concatenates the buckets found by the backward searches of all columns, frees the columns
+inline std::vector<NodeBucket>
+joinColumnBuckets(std::vector<std::vector<NodeBucket>> &column_buckets)
+{
+    std::size_t number_of_buckets = 0;
+    for (const auto &buckets : column_buckets)
+        number_of_buckets += buckets.size();
+
+    std::vector<NodeBucket> search_space_with_buckets;
+    search_space_with_buckets.reserve(number_of_buckets);
+    for (auto &buckets : column_buckets)
+    {
+        search_space_with_buckets.insert(
+            search_space_with_buckets.end(), buckets.begin(), buckets.end());
+        std::vector<NodeBucket>().swap(buckets);
+    }
+
+    return search_space_with_buckets;
+}
+
+// Lowest weight a search from the given source phantoms starts with. It is negative if a source
+// has an offset, then the searches towards the sources have to go beyond the weight upper bound.
+inline EdgeWeight getMinimalSourceWeight(const std::vector<PhantomNode> &phantom_nodes,
+                                         const std::vector<std::size_t> &source_indices)
+{
+    EdgeWeight min_weight = 0;
+    for (const auto index : source_indices)
+    {
+        const auto &phantom_node = phantom_nodes[index];
+        if (phantom_node.IsValidForwardSource())
+            min_weight = std::min(min_weight, -phantom_node.GetForwardWeightPlusOffset());
+        if (phantom_node.IsValidReverseSource())
+            min_weight = std::min(min_weight, -phantom_node.GetReverseWeightPlusOffset());
+    }
+    return min_weight;
+}
+
+// Weight at which a search can stop if the searches in the other direction start with
+// `other_min_weight` at least
+inline EdgeWeight getSearchWeightBound(const EdgeWeight weight_upper_bound,
+                                       const EdgeWeight other_min_weight)
+{
+    if (weight_upper_bound == INVALID_EDGE_WEIGHT)
+        return INVALID_EDGE_WEIGHT;
+    return weight_upper_bound - other_min_weight;
+}
 }
 
+// Returns the row-major durations matrix and, if `calculate_distance` is set, the distances
+// matrix in meters. Distances are found by unpacking the shortest path of every entry, so they
+// are only computed if requested. Otherwise the distances vector is empty.
+// The searches of the single rows and columns run on up to `max_threads` TBB threads.
+// Paths with a weight of `weight_upper_bound` or more are not searched for and left empty.
 template <typename Algorithm>
-std::vector<EdgeDuration> manyToManySearch(SearchEngineData<Algorithm> &engine_working_data,
-                                           const DataFacade<Algorithm> &facade,
-                                           const std::vector<PhantomNode> &phantom_nodes,
-                                           const std::vector<std::size_t> &source_indices,
-                                           const std::vector<std::size_t> &target_indices);
+std::pair<std::vector<EdgeDuration>, std::vector<EdgeDistance>>
+manyToManySearch(SearchEngineData<Algorithm> &engine_working_data,
+                 const DataFacade<Algorithm> &facade,
+                 const std::vector<PhantomNode> &phantom_nodes,
+                 const std::vector<std::size_t> &source_indices,
+                 const std::vector<std::size_t> &target_indices,
+                 const bool calculate_distance,
+                 const unsigned max_threads,
+                 const EdgeWeight weight_upper_bound = INVALID_EDGE_WEIGHT);
 
 } // namespace routing_algorithms
 } // namespace engine
@@ -3,9 +3,12 @@
 
 #include "engine/algorithm.hpp"
 #include "engine/datafacade.hpp"
+#include "engine/map_matching/hidden_markov_model.hpp"
 #include "engine/map_matching/sub_matching.hpp"
 #include "engine/search_engine_data.hpp"
 
+#include <boost/optional.hpp>
+
 #include <vector>
 
 namespace osrm
@@ -20,6 +23,48 @@ using CandidateLists = std::vector<CandidateList>;
 using SubMatchingList = std::vector<map_matching::SubMatching>;
 static const constexpr double DEFAULT_GPS_PRECISION = 5;
 
+// Position of the forward pass of the Viterbi algorithm in a trace
+struct ViterbiFrontier
+{
+    // points with a transition from their predecessor, the last one is extended next
+    std::vector<std::size_t> prev_unbroken_timestamps;
+    // first point of a breakage, the trace is split there if the breakage can't be recovered
+    std::size_t breakage_begin = map_matching::INVALID_STATE;
+    // first points of the sub matchings after splits
+    std::vector<std::size_t> split_points;
+    // first point that the forward pass hasn't seen yet
+    std::size_t next_timestamp = 0;
+};
+
+// Matching state of a trace that grows between calls of mapMatching, used by match sessions.
+// Only the last points of the trace are kept, all indices are relative to the first kept point.
+struct MapMatchingState
+{
+    MapMatchingState() : model(candidates_list, emission_log_probabilities) {}
+    MapMatchingState(const MapMatchingState &) = delete;
+    MapMatchingState &operator=(const MapMatchingState &) = delete;
+
+    // Appends a point with its filtered candidates. Either all points have timestamps or none.
+    void AddPoint(CandidateList candidates,
+                  const util::Coordinate coordinate,
+                  const boost::optional<unsigned> timestamp,
+                  const boost::optional<double> gps_precision);
+
+    // Drops the oldest points down to half of `max_points` once there are more than `max_points`,
+    // so that the cost is amortised over the added points. Points that the forward pass still
+    // extends are never dropped.
+    void Shrink(const std::size_t max_points);
+
+    std::size_t GetNumberOfPoints() const { return candidates_list.size(); }
+
+    CandidateLists candidates_list;
+    std::vector<util::Coordinate> trace_coordinates;
+    std::vector<unsigned> trace_timestamps;
+    std::vector<std::vector<double>> emission_log_probabilities;
+    map_matching::HiddenMarkovModel<CandidateLists> model;
+    ViterbiFrontier frontier;
+};
+
 //[1] "Hidden Markov Map Matching Through Noise and Sparseness";
 //     P. Newson and J. Krumm; 2009; ACM GIS
 template <typename Algorithm>
@@ -31,6 +76,15 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
                             const std::vector<boost::optional<double>> &trace_gps_precision,
                             const bool allow_splitting);
 
+// Extends the matching of `state` by the points added since the last call. Only the sub matchings
+// of these points are returned, each one starts at the last matched point before them if there
+// is one. The matchings of earlier points are not revised.
+template <typename Algorithm>
+SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
+                            const DataFacade<Algorithm> &facade,
+                            MapMatchingState &state,
+                            const bool allow_splitting);
+
 } // namespace routing_algorithms
 } // namespace engine
 } // namespace osrm
@@ -0,0 +1,68 @@
+#ifndef OSRM_ENGINE_ROUTING_BASE_CCH_HPP
+#define OSRM_ENGINE_ROUTING_BASE_CCH_HPP
+
+#include "engine/algorithm.hpp"
+#include "engine/datafacade.hpp"
+#include "engine/routing_algorithms/routing_base.hpp"
+#include "engine/routing_algorithms/routing_base_ch.hpp"
+#include "engine/search_engine_data.hpp"
+
+#include "util/typedefs.hpp"
+
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+
+namespace routing_algorithms
+{
+
+namespace cch
+{
+
+// The search graph of a CCH is a CH graph, so paths are unpacked like CH paths
+template <typename RandomIter>
+void unpackPath(const DataFacade<Algorithm> &facade,
+                RandomIter packed_path_begin,
+                RandomIter packed_path_end,
+                const PhantomNodes &phantom_nodes,
+                std::vector<PathData> &unpacked_path)
+{
+    ch::unpackPath(facade, packed_path_begin, packed_path_end, phantom_nodes, unpacked_path);
+}
+
+// Elimination tree search, a replacement of ch::search with the same interface.
+//
+// All nodes that can be reached over upward edges from a node are its ancestors in the
+// elimination tree. Instead of running two Dijkstra searches the nodes on the tree paths from
+// the start nodes to the root are settled in the order of their ranks, no priority queue is
+// needed and the search can't stop too early. The heaps only keep the weights and parents, so
+// that the packed path can be retrieved like in a CH.
+void search(SearchEngineData<Algorithm> &engine_working_data,
+            const DataFacade<Algorithm> &facade,
+            SearchEngineData<Algorithm>::QueryHeap &forward_heap,
+            SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
+            std::int32_t &weight,
+            std::vector<NodeID> &packed_leg,
+            const bool force_loop_forward,
+            const bool force_loop_reverse,
+            const PhantomNodes &phantom_nodes,
+            const int duration_upper_bound = INVALID_EDGE_WEIGHT);
+
+// Requires the heaps for be empty
+double getNetworkDistance(SearchEngineData<Algorithm> &engine_working_data,
+                          const DataFacade<Algorithm> &facade,
+                          SearchEngineData<Algorithm>::QueryHeap &forward_heap,
+                          SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
+                          const PhantomNode &source_phantom,
+                          const PhantomNode &target_phantom,
+                          int duration_upper_bound = INVALID_EDGE_WEIGHT);
+
+} // namespace cch
+} // namespace routing_algorithms
+} // namespace engine
+} // namespace osrm
+
+#endif // OSRM_ENGINE_ROUTING_BASE_CCH_HPP
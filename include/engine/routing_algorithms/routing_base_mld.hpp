@@ -11,6 +11,7 @@
 #include <boost/assert.hpp>
 
 #include <algorithm>
+#include <cstdint>
 #include <iterator>
 #include <limits>
 #include <tuple>
@@ -65,6 +66,18 @@ inline bool checkParentCellRestriction(CellID cell, LevelID, CellID parent)
 {
     return cell == parent;
 }
+
+// Unpacked overlay edges are cached per facade, see getUnpackingCache
+template <typename Algorithm>
+inline std::uint32_t getUnpackingCacheOwner(const DataFacade<Algorithm> &)
+{
+    return 0;
+}
+
+inline std::uint32_t getUnpackingCacheOwner(const DataFacade<Algorithm> &facade)
+{
+    return facade.GetUnpackingCacheOwner();
+}
 }
 
 // Heaps only record for each node its predecessor ("parent") on the shortest path.
@@ -372,6 +385,25 @@ UnpackedPath search(SearchEngineData<Algorithm> &engine_working_data,
             CellID parent_cell_id = partition.GetCell(level, source);
             BOOST_ASSERT(parent_cell_id == partition.GetCell(level, target));
 
+            auto *unpacking_cache = getUnpackingCache(engine_working_data);
+            const UnpackingCache::Key key{getUnpackingCacheOwner(facade),
+                                          level,
+                                          parent_cell_id,
+                                          source,
+                                          target,
+                                          force_loop_forward,
+                                          force_loop_reverse};
+            UnpackingCache::Value cached;
+            if (unpacking_cache && unpacking_cache->Get(key, cached))
+            {
+                unpacked_nodes.insert(
+                    unpacked_nodes.end(), std::next(cached.nodes.begin()), cached.nodes.end());
+                unpacked_edges.insert(
+                    unpacked_edges.end(), cached.edges.begin(), cached.edges.end());
+                continue;
+            }
+            const auto unpacking_start = UnpackingCache::Clock::now();
+
             LevelID sublevel = level - 1;
 
             // Here heaps can be reused, let's go deeper!
@@ -401,6 +433,13 @@ UnpackedPath search(SearchEngineData<Algorithm> &engine_working_data,
             unpacked_nodes.insert(
                 unpacked_nodes.end(), std::next(subpath_nodes.begin()), subpath_nodes.end());
             unpacked_edges.insert(unpacked_edges.end(), subpath_edges.begin(), subpath_edges.end());
+
+            if (unpacking_cache)
+            {
+                unpacking_cache->Put(key,
+                                     {std::move(subpath_nodes), std::move(subpath_edges)},
+                                     UnpackingCache::Clock::now() - unpacking_start);
+            }
         }
     }
 
@@ -2,11 +2,15 @@
 #define SEARCH_ENGINE_DATA_HPP
 
 #include "engine/algorithm.hpp"
+#include "engine/engine_config.hpp"
+#include "engine/unpacking_cache.hpp"
 #include "util/query_heap.hpp"
 #include "util/typedefs.hpp"
 
 #include <boost/thread/tss.hpp>
 
+#include <memory>
+
 namespace osrm
 {
 namespace engine
@@ -16,11 +20,51 @@ namespace engine
 // - CH algorithms use CH heaps
 // - CoreCH algorithms use CH
 // - MLD algorithms use MLD heaps
+// - CCH algorithms use CH heaps
 
 template <typename Algorithm> struct SearchEngineData
 {
 };
 
+// Selects how many node IDs the query heaps keep in a dense array, see util::TwoLevelStorage
+struct SearchEngineHeapStorage
+{
+    SearchEngineHeapStorage() = default;
+    explicit SearchEngineHeapStorage(const EngineConfig &config)
+        : query_heap(config.query_heap_storage),
+          many_to_many_heap(config.many_to_many_heap_storage), dense_nodes(config.heap_dense_nodes)
+    {
+    }
+
+    std::size_t QueryHeapDenseSize(std::size_t number_of_nodes) const
+    {
+        return DenseSize(query_heap, number_of_nodes);
+    }
+
+    std::size_t ManyToManyHeapDenseSize(std::size_t number_of_nodes) const
+    {
+        return DenseSize(many_to_many_heap, number_of_nodes);
+    }
+
+    EngineConfig::HeapStorage query_heap = EngineConfig::HeapStorage::HashMap;
+    EngineConfig::HeapStorage many_to_many_heap = EngineConfig::HeapStorage::HashMap;
+    std::size_t dense_nodes = 0;
+
+  private:
+    std::size_t DenseSize(EngineConfig::HeapStorage storage, std::size_t number_of_nodes) const
+    {
+        switch (storage)
+        {
+        case EngineConfig::HeapStorage::Array:
+            return number_of_nodes;
+        case EngineConfig::HeapStorage::TwoLevel:
+            return std::min(dense_nodes, number_of_nodes);
+        default:
+            return 0;
+        }
+    }
+};
+
 struct HeapData
 {
     NodeID parent;
@@ -36,13 +80,19 @@ struct ManyToManyHeapData : HeapData
 template <> struct SearchEngineData<routing_algorithms::ch::Algorithm>
 {
     using QueryHeap = util::
-        QueryHeap<NodeID, NodeID, EdgeWeight, HeapData, util::UnorderedMapStorage<NodeID, int>>;
+        QueryHeap<NodeID, NodeID, EdgeWeight, HeapData, util::TwoLevelStorage<NodeID, int>>;
 
     using ManyToManyQueryHeap = util::QueryHeap<NodeID,
                                                 NodeID,
                                                 EdgeWeight,
                                                 ManyToManyHeapData,
-                                                util::UnorderedMapStorage<NodeID, int>>;
+                                                util::TwoLevelStorage<NodeID, int>>;
+
+    SearchEngineData() = default;
+    explicit SearchEngineData(const SearchEngineHeapStorage &heap_storage)
+        : heap_storage(heap_storage)
+    {
+    }
 
     using SearchEngineHeapPtr = boost::thread_specific_ptr<QueryHeap>;
     using ManyToManyHeapPtr = boost::thread_specific_ptr<ManyToManyQueryHeap>;
@@ -62,6 +112,19 @@ template <> struct SearchEngineData<routing_algorithms::ch::Algorithm>
     void InitializeOrClearThirdThreadLocalStorage(unsigned number_of_nodes);
 
     void InitializeOrClearManyToManyThreadLocalStorage(unsigned number_of_nodes);
+
+    SearchEngineHeapStorage heap_storage;
+};
+
+template <>
+struct SearchEngineData<routing_algorithms::cch::Algorithm>
+    : SearchEngineData<routing_algorithms::ch::Algorithm>
+{
+    SearchEngineData() = default;
+    explicit SearchEngineData(const SearchEngineHeapStorage &heap_storage)
+        : SearchEngineData<routing_algorithms::ch::Algorithm>(heap_storage)
+    {
+    }
 };
 
 struct MultiLayerDijkstraHeapData
@@ -91,13 +154,24 @@ template <> struct SearchEngineData<routing_algorithms::mld::Algorithm>
                                       NodeID,
                                       EdgeWeight,
                                       MultiLayerDijkstraHeapData,
-                                      util::UnorderedMapStorage<NodeID, int>>;
+                                      util::TwoLevelStorage<NodeID, int>>;
 
     using ManyToManyQueryHeap = util::QueryHeap<NodeID,
                                                 NodeID,
                                                 EdgeWeight,
                                                 ManyToManyMultiLayerDijkstraHeapData,
-                                                util::UnorderedMapStorage<NodeID, int>>;
+                                                util::TwoLevelStorage<NodeID, int>>;
+
+    SearchEngineData() = default;
+    explicit SearchEngineData(const SearchEngineHeapStorage &heap_storage)
+        : heap_storage(heap_storage)
+    {
+    }
+    SearchEngineData(const SearchEngineHeapStorage &heap_storage,
+                     std::shared_ptr<UnpackingCache> unpacking_cache)
+        : heap_storage(heap_storage), unpacking_cache(std::move(unpacking_cache))
+    {
+    }
 
     using SearchEngineHeapPtr = boost::thread_specific_ptr<QueryHeap>;
     using ManyToManyHeapPtr = boost::thread_specific_ptr<ManyToManyQueryHeap>;
@@ -109,7 +183,42 @@ template <> struct SearchEngineData<routing_algorithms::mld::Algorithm>
     void InitializeOrClearFirstThreadLocalStorage(unsigned number_of_nodes);
 
     void InitializeOrClearManyToManyThreadLocalStorage(unsigned number_of_nodes);
+
+    SearchEngineHeapStorage heap_storage;
+
+    // shared by all threads, nullptr if disabled
+    std::shared_ptr<UnpackingCache> unpacking_cache;
 };
+
+// The unpacking cache of the engine, only MLD queries unpack overlay edges
+template <typename Algorithm>
+inline UnpackingCache *getUnpackingCache(const SearchEngineData<Algorithm> &)
+{
+    return nullptr;
+}
+
+inline UnpackingCache *
+getUnpackingCache(const SearchEngineData<routing_algorithms::mld::Algorithm> &engine_working_data)
+{
+    return engine_working_data.unpacking_cache.get();
+}
+
+template <typename Algorithm>
+inline SearchEngineData<Algorithm> makeSearchEngineData(const EngineConfig &config)
+{
+    return SearchEngineData<Algorithm>{SearchEngineHeapStorage{config}};
+}
+
+template <>
+inline SearchEngineData<routing_algorithms::mld::Algorithm>
+makeSearchEngineData<routing_algorithms::mld::Algorithm>(const EngineConfig &config)
+{
+    return SearchEngineData<routing_algorithms::mld::Algorithm>{
+        SearchEngineHeapStorage{config},
+        config.unpacking_cache_size > 0
+            ? std::make_shared<UnpackingCache>(config.unpacking_cache_size)
+            : nullptr};
+}
 }
 }
 
@@ -0,0 +1,91 @@
+#ifndef OSRM_ENGINE_TILE_ARCHIVE_HPP
+#define OSRM_ENGINE_TILE_ARCHIVE_HPP
+
+#include "storage/dataset_fingerprint.hpp"
+#include "storage/io.hpp"
+
+#include "util/json_container.hpp"
+#include "util/vector_view.hpp"
+
+#include <boost/filesystem/path.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+
+struct TileArchiveEntry
+{
+    std::uint64_t key;
+    std::uint64_t offset;
+    std::uint64_t size;
+};
+
+/**
+ * Vector tiles that were rendered ahead of time by osrm-tiles.
+ *
+ * The archive is a flat file with the fingerprint, the concatenated tiles, an index of the tiles
+ * sorted by zoom, x and y and the fingerprint of the dataset files the tiles were rendered from.
+ * The tiles are memory mapped, only the index is read into memory.
+ */
+class TileArchive
+{
+  public:
+    explicit TileArchive(const boost::filesystem::path &path);
+
+    // Copies the tile into `pbf_buffer`, returns false if the archive doesn't contain it
+    bool Get(unsigned z, unsigned x, unsigned y, std::string &pbf_buffer) const;
+
+    // Files of the dataset and the metric the tiles were rendered from
+    const storage::DatasetFingerprint &GetDatasetFingerprint() const
+    {
+        return dataset_fingerprint;
+    }
+    std::size_t GetNumberOfTiles() const { return index.size(); }
+
+    // Tiles, hits and misses
+    util::json::Object GetMetrics() const;
+
+    static std::uint64_t MakeKey(unsigned z, unsigned x, unsigned y);
+
+  private:
+    boost::iostreams::mapped_file_source region;
+    util::vector_view<const char> tiles;
+    std::vector<TileArchiveEntry> index;
+    storage::DatasetFingerprint dataset_fingerprint;
+
+    mutable std::atomic<std::uint64_t> hits{0};
+    mutable std::atomic<std::uint64_t> misses{0};
+};
+
+/**
+ * Writes the tiles of a TileArchive, tiles can be added in any order.
+ */
+class TileArchiveWriter
+{
+  public:
+    TileArchiveWriter(const boost::filesystem::path &path,
+                      storage::DatasetFingerprint dataset_fingerprint);
+
+    void Add(unsigned z, unsigned x, unsigned y, const std::string &pbf_buffer);
+
+    // Writes the index, no tiles can be added afterwards
+    void Finish();
+
+  private:
+    storage::io::FileWriter writer;
+    std::vector<TileArchiveEntry> index;
+    storage::DatasetFingerprint dataset_fingerprint;
+    std::uint64_t tiles_size;
+};
+}
+}
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef OSRM_ENGINE_UNPACKING_CACHE_HPP
+#define OSRM_ENGINE_UNPACKING_CACHE_HPP
+
+#include "util/json_container.hpp"
+#include "util/sharded_lru_cache.hpp"
+#include "util/typedefs.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+
+// An overlay edge of an MLD query: the clique arc from source to target in a cell
+struct UnpackingCacheKey
+{
+    std::uint32_t owner = 0; // the facade the edge was unpacked on
+    LevelID level = 0;
+    CellID cell = 0;
+    NodeID source = SPECIAL_NODEID;
+    NodeID target = SPECIAL_NODEID;
+    bool force_loop_forward = false;
+    bool force_loop_reverse = false;
+
+    bool operator==(const UnpackingCacheKey &other) const
+    {
+        return owner == other.owner && level == other.level && cell == other.cell &&
+               source == other.source && target == other.target &&
+               force_loop_forward == other.force_loop_forward &&
+               force_loop_reverse == other.force_loop_reverse;
+    }
+};
+
+struct UnpackingCacheKeyHash
+{
+    std::size_t operator()(const UnpackingCacheKey &key) const;
+};
+
+// Base graph path of an overlay edge, including its source and target node
+struct UnpackedOverlayEdge
+{
+    std::vector<NodeID> nodes;
+    std::vector<EdgeID> edges;
+};
+
+/**
+ * Caches the unpacked base graph paths of MLD overlay edges, which otherwise need a search in
+ * the cell of the edge every time a route uses it.
+ *
+ * The cache is shared by the queries of all threads. Every facade registers as its own owner, so
+ * paths unpacked with an earlier metric (a new dataset or a live update customizing the cells
+ * again) or different exclude flags are never used. Entries of facades that are gone get evicted
+ * eventually. The size limit applies to the estimated memory of the entries.
+ */
+class UnpackingCache
+{
+  public:
+    using Key = UnpackingCacheKey;
+    using Value = UnpackedOverlayEdge;
+    using Clock = std::chrono::steady_clock;
+
+    explicit UnpackingCache(std::size_t max_bytes);
+
+    // Returns an owner id that was never handed out before in this process
+    static std::uint32_t NewOwner();
+
+    bool Get(const Key &key, Value &value);
+    // `unpacking_time` is the time it took to unpack the edge on a miss
+    void Put(const Key &key, const Value &value, const Clock::duration unpacking_time);
+
+    // Entries, estimated size, hits, misses, hit rate and the mean time of lookups that hit and
+    // of unpacking searches after a miss
+    util::json::Object GetMetrics() const;
+
+  private:
+    struct EstimateSize
+    {
+        std::size_t operator()(const Value &value) const;
+    };
+
+    util::ShardedLRUCache<Key, Value, UnpackingCacheKeyHash, EstimateSize> cache;
+
+    std::atomic<std::uint64_t> hit_nanoseconds{0};
+    std::atomic<std::uint64_t> unpacked{0};
+    std::atomic<std::uint64_t> unpacking_nanoseconds{0};
+};
+}
+}
+
+#endif
@@ -12,10 +12,11 @@ namespace extractor
 
 class Datasources
 {
-    static constexpr const std::uint8_t MAX_NUM_SOURES = 255;
     static constexpr const std::uint8_t MAX_LENGTH_NAME = 255;
 
   public:
+    static constexpr const std::uint8_t MAX_NUM_SOURES = 255;
+
     Datasources()
     {
         std::fill(lengths.begin(), lengths.end(), 0);
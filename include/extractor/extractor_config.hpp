@@ -42,6 +42,17 @@ namespace extractor
 
 struct ExtractorConfig final : storage::IOConfig
 {
+    // Node location index used to look up the locations of way nodes for location-dependent data:
+    //  - FlexMem keeps the locations in memory
+    //  - DenseFile and SparseFile memory-map a temporary file in location_index_path, a dense
+    //    array indexed by node ID or a sorted list of (ID, location) pairs
+    enum class LocationIndexType
+    {
+        FlexMem,
+        DenseFile,
+        SparseFile
+    };
+
     ExtractorConfig() noexcept : IOConfig(
                                      {
                                          "",
@@ -70,7 +81,8 @@ struct ExtractorConfig final : storage::IOConfig
                                       ".osrm.cnbg_to_ebg"}),
                                  requested_num_threads(0),
                                  parse_conditionals(false),
-                                 use_locations_cache(true)
+                                 use_locations_cache(true),
+                                 location_index_type(LocationIndexType::FlexMem)
     {
     }
 
@@ -91,6 +103,9 @@ struct ExtractorConfig final : storage::IOConfig
     bool use_metadata;
     bool parse_conditionals;
     bool use_locations_cache;
+    LocationIndexType location_index_type;
+    // directory of file based location indexes, the directory of the output files if empty
+    boost::filesystem::path location_index_path;
 };
 }
 }
@@ -0,0 +1,71 @@
+#ifndef OSRM_EXTRACTOR_NATIVE_TURN_FUNCTION_HPP
+#define OSRM_EXTRACTOR_NATIVE_TURN_FUNCTION_HPP
+
+#include "extractor/extraction_turn.hpp"
+
+#include <cmath>
+#include <limits>
+
+namespace osrm
+{
+namespace extractor
+{
+
+/**
+ * C++ implementation of the process_turn function of the car profile. Profiles select it with
+ * `native_turn_function = 'car'` in setup(), turns are then not passed to Lua.
+ *
+ * The parameters are read from the profile table like car.lua reads them: `turn_penalty`,
+ * `turn_bias`, `properties.u_turn_penalty`, `properties.traffic_light_penalty` and
+ * `properties.weight_name`.
+ */
+struct CarTurnFunction
+{
+    enum class WeightType
+    {
+        Duration,
+        Distance,
+        Routability
+    };
+
+    void operator()(ExtractionTurn &turn) const
+    {
+        // sigmoid that maxes out at turn_penalty over the space of 0-180 degrees
+        const double bias = turn.is_left_hand_driving ? 1. / turn_bias : turn_bias;
+
+        if (turn.has_traffic_light)
+            turn.duration = traffic_light_penalty;
+
+        if (turn.number_of_roads > 2 || turn.source_mode != turn.target_mode || turn.is_u_turn)
+        {
+            if (turn.angle >= 0)
+                turn.duration +=
+                    turn_penalty / (1 + std::exp(-((13 / bias) * turn.angle / 180 - 6.5 * bias)));
+            else
+                turn.duration +=
+                    turn_penalty / (1 + std::exp(-((13 * bias) * -turn.angle / 180 - 6.5 / bias)));
+
+            if (turn.is_u_turn)
+                turn.duration += u_turn_penalty;
+        }
+
+        // distance based routing has no penalties based on turn angle
+        turn.weight = weight_type == WeightType::Distance ? 0 : turn.duration;
+
+        // penalize turns from non-local access only segments onto local access only tags
+        if (weight_type == WeightType::Routability && !turn.source_restricted &&
+            turn.target_restricted)
+            turn.weight = max_turn_weight;
+    }
+
+    double turn_penalty;
+    double turn_bias;
+    double u_turn_penalty;
+    double traffic_light_penalty;
+    WeightType weight_type;
+    double max_turn_weight;
+};
+}
+}
+
+#endif
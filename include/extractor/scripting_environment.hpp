@@ -58,6 +58,9 @@ class ScriptingEnvironment
     virtual std::vector<std::string> GetRestrictions() = 0;
     virtual std::vector<std::string> GetRelations() = 0;
     virtual void ProcessTurn(ExtractionTurn &turn) = 0;
+    // Same as calling ProcessTurn for every turn, with a single call to the profile if it can
+    // handle batches of turns
+    virtual void ProcessTurns(std::vector<ExtractionTurn> &turns) = 0;
     virtual void ProcessSegment(ExtractionSegment &segment) = 0;
 
     virtual void
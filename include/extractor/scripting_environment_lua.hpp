@@ -3,14 +3,19 @@
 
 #include "extractor/extraction_relation.hpp"
 #include "extractor/location_dependent_data.hpp"
+#include "extractor/native_turn_function.hpp"
 #include "extractor/raster_source.hpp"
 #include "extractor/scripting_environment.hpp"
 
+#include <boost/optional.hpp>
+
 #include <tbb/enumerable_thread_specific.h>
 
 #include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include <sol2/sol.hpp>
 
@@ -33,6 +38,11 @@ struct LuaScriptingContext final
     void ProcessWay(const osmium::Way &,
                     ExtractionWay &result,
                     const ExtractionRelationContainer &relations);
+    // Like ProcessWay, but reuses the result of a previous way with the same tags if the profile
+    // declares that process_way only depends on them
+    void ProcessWayCached(const osmium::Way &,
+                          ExtractionWay &result,
+                          const ExtractionRelationContainer &relations);
 
     ProfileProperties properties;
     RasterContainer raster_sources;
@@ -44,6 +54,7 @@ struct LuaScriptingContext final
     bool has_segment_function;
 
     sol::function turn_function;
+    sol::function turns_function;
     sol::function way_function;
     sol::function node_function;
     sol::function segment_function;
@@ -51,6 +62,21 @@ struct LuaScriptingContext final
     int api_version;
     sol::table profile_table;
 
+    // replaces the Lua turn functions if the profile selects it
+    boost::optional<CarTurnFunction> native_turn_function;
+
+    // Tags the results of process_way depend on, declared by the profile's process_way_cache
+    enum class WayCacheMode
+    {
+        Disabled,
+        AllTags,
+        ListedTags
+    };
+    WayCacheMode way_cache_mode = WayCacheMode::Disabled;
+    std::vector<std::string> way_cache_tags;
+    std::unordered_map<std::string, ExtractionWay> way_cache;
+    std::string way_cache_key;
+
     // Reference to immutable location dependent data and locations memo
     const LocationDependentData &location_dependent_data;
     LocationDependentData::point_t last_location_point;
@@ -83,6 +109,7 @@ class Sol2ScriptingEnvironment final : public ScriptingEnvironment
     std::vector<std::string> GetRestrictions() override;
     std::vector<std::string> GetRelations() override;
     void ProcessTurn(ExtractionTurn &turn) override;
+    void ProcessTurns(std::vector<ExtractionTurn> &turns) override;
     void ProcessSegment(ExtractionSegment &segment) override;
 
     void
@@ -22,6 +22,7 @@
 #include <boost/optional.hpp>
 
 #include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <iterator>
 #include <string>
@@ -56,6 +57,17 @@ template <> v8::Local<v8::Value> inline render(const osrm::json::Object &result)
     return value;
 }
 
+template <> v8::Local<v8::Value> inline render(const osrm::engine::api::ResultT &result)
+{
+    if (result.is<osrm::util::cbor::Buffer>())
+    {
+        const auto &bytes = result.get<osrm::util::cbor::Buffer>().bytes;
+        return Nan::CopyBuffer(bytes.data(), bytes.size()).ToLocalChecked();
+    }
+
+    return render(result.get<osrm::json::Object>());
+}
+
 inline void ParseResult(const osrm::Status &result_status, osrm::json::Object &result)
 {
     const auto code_iter = result.values.find("code");
@@ -78,6 +90,68 @@ inline void ParseResult(const osrm::Status &result_status, osrm::json::Object &r
 
 inline void ParseResult(const osrm::Status & /*result_status*/, const std::string & /*unused*/) {}
 
+// Reads the code of an error written by a cbor::Writer: a map with code and message
+inline std::string readCBORErrorCode(const std::vector<char> &bytes)
+{
+    auto iter = bytes.begin();
+    const auto read_byte = [&]() -> std::uint8_t {
+        if (iter == bytes.end())
+            throw std::logic_error("Invalid CBOR response");
+        return static_cast<std::uint8_t>(*iter++);
+    };
+    const auto read_text = [&]() {
+        const auto head = read_byte();
+        if (head >> 5 != 3)
+            throw std::logic_error("Invalid CBOR response");
+        std::uint64_t length = head & 0x1f;
+        if (length >= 24)
+        {
+            const auto number_of_bytes = 1 << (length - 24);
+            length = 0;
+            for (int i = 0; i < number_of_bytes; ++i)
+                length = (length << 8) | read_byte();
+        }
+        if (static_cast<std::uint64_t>(std::distance(iter, bytes.end())) < length)
+            throw std::logic_error("Invalid CBOR response");
+        std::string text(iter, iter + length);
+        iter += length;
+        return text;
+    };
+
+    if (read_byte() != 0xbf || read_text() != "code")
+        throw std::logic_error("Invalid CBOR response");
+    return read_text();
+}
+
+inline void ParseResult(const osrm::Status &result_status, osrm::engine::api::ResultT &result)
+{
+    if (result.is<osrm::json::Object>())
+    {
+        ParseResult(result_status, result.get<osrm::json::Object>());
+    }
+    else if (result_status == osrm::Status::Error)
+    {
+        throw std::logic_error(
+            readCBORErrorCode(result.get<osrm::util::cbor::Buffer>().bytes).c_str());
+    }
+}
+
+// Selects the output of a request by the format parameter, tiles are always binary
+template <typename ParamType>
+inline void initializeResult(const ParamType &params, osrm::engine::api::ResultT &result)
+{
+    if (params.format == osrm::engine::api::BaseParameters::OutputFormatType::CBOR)
+    {
+        result = osrm::util::cbor::Buffer();
+    }
+    else
+    {
+        result = osrm::json::Object();
+    }
+}
+
+inline void initializeResult(const osrm::TileParameters &, std::string &) {}
+
 inline engine_config_ptr argumentsToEngineConfig(const Nan::FunctionCallbackInfo<v8::Value> &args)
 {
     Nan::HandleScope scope;
@@ -164,16 +238,54 @@ inline engine_config_ptr argumentsToEngineConfig(const Nan::FunctionCallbackInfo
         {
             engine_config->algorithm = osrm::EngineConfig::Algorithm::MLD;
         }
+        else if (*v8::String::Utf8Value(algorithm_str) == std::string("CCH"))
+        {
+            engine_config->algorithm = osrm::EngineConfig::Algorithm::CCH;
+        }
         else
         {
-            Nan::ThrowError("algorithm option must be one of 'CH', 'CoreCH', or 'MLD'.");
+            Nan::ThrowError("algorithm option must be one of 'CH', 'CoreCH', 'MLD', or 'CCH'.");
             return engine_config_ptr();
         }
     }
     else if (!algorithm->IsUndefined())
     {
-        Nan::ThrowError("algorithm option must be a string and one of 'CH', 'CoreCH', or 'MLD'.");
+        Nan::ThrowError("algorithm option must be a string and one of 'CH', 'CoreCH', 'MLD', or 'CCH'.");
+        return engine_config_ptr();
+    }
+
+    auto memory_file = params->Get(Nan::New("memory_file").ToLocalChecked());
+    if (memory_file.IsEmpty())
+        return engine_config_ptr();
+
+    if (!memory_file->IsUndefined())
+    {
+        if (path->IsUndefined())
+        {
+            Nan::ThrowError("memory_file option requires a path to the .osrm files");
+            return engine_config_ptr();
+        }
+        if (!memory_file->IsString())
+        {
+            Nan::ThrowError("memory_file option must be a string");
+            return engine_config_ptr();
+        }
+        engine_config->memory_file =
+            *v8::String::Utf8Value(Nan::To<v8::String>(memory_file).ToLocalChecked());
+    }
+
+    auto share_blocks = params->Get(Nan::New("share_blocks").ToLocalChecked());
+    if (share_blocks.IsEmpty())
         return engine_config_ptr();
+
+    if (!share_blocks->IsUndefined())
+    {
+        if (!share_blocks->IsBoolean())
+        {
+            Nan::ThrowError("share_blocks option must be a boolean");
+            return engine_config_ptr();
+        }
+        engine_config->share_blocks = Nan::To<bool>(share_blocks).FromJust();
     }
 
     // Set EngineConfig system-wide limits on construction, if requested
@@ -185,9 +297,15 @@ inline engine_config_ptr argumentsToEngineConfig(const Nan::FunctionCallbackInfo
     auto max_locations_map_matching =
         params->Get(Nan::New("max_locations_map_matching").ToLocalChecked());
     auto max_results_nearest = params->Get(Nan::New("max_results_nearest").ToLocalChecked());
+    auto max_batch_size_nearest =
+        params->Get(Nan::New("max_batch_size_nearest").ToLocalChecked());
     auto max_alternatives = params->Get(Nan::New("max_alternatives").ToLocalChecked());
     auto max_radius_map_matching =
         params->Get(Nan::New("max_radius_map_matching").ToLocalChecked());
+    auto max_match_sessions = params->Get(Nan::New("max_match_sessions").ToLocalChecked());
+    auto match_session_timeout = params->Get(Nan::New("match_session_timeout").ToLocalChecked());
+    auto max_match_session_points =
+        params->Get(Nan::New("max_match_session_points").ToLocalChecked());
 
     if (!max_locations_trip->IsUndefined() && !max_locations_trip->IsNumber())
     {
@@ -214,11 +332,31 @@ inline engine_config_ptr argumentsToEngineConfig(const Nan::FunctionCallbackInfo
         Nan::ThrowError("max_results_nearest must be an integral number");
         return engine_config_ptr();
     }
+    if (!max_batch_size_nearest->IsUndefined() && !max_batch_size_nearest->IsNumber())
+    {
+        Nan::ThrowError("max_batch_size_nearest must be an integral number");
+        return engine_config_ptr();
+    }
     if (!max_alternatives->IsUndefined() && !max_alternatives->IsNumber())
     {
         Nan::ThrowError("max_alternatives must be an integral number");
         return engine_config_ptr();
     }
+    if (!max_match_sessions->IsUndefined() && !max_match_sessions->IsNumber())
+    {
+        Nan::ThrowError("max_match_sessions must be an integral number");
+        return engine_config_ptr();
+    }
+    if (!match_session_timeout->IsUndefined() && !match_session_timeout->IsNumber())
+    {
+        Nan::ThrowError("match_session_timeout must be an integral number");
+        return engine_config_ptr();
+    }
+    if (!max_match_session_points->IsUndefined() && !max_match_session_points->IsNumber())
+    {
+        Nan::ThrowError("max_match_session_points must be an integral number");
+        return engine_config_ptr();
+    }
 
     if (max_locations_trip->IsNumber())
         engine_config->max_locations_trip = static_cast<int>(max_locations_trip->NumberValue());
@@ -233,11 +371,23 @@ inline engine_config_ptr argumentsToEngineConfig(const Nan::FunctionCallbackInfo
             static_cast<int>(max_locations_map_matching->NumberValue());
     if (max_results_nearest->IsNumber())
         engine_config->max_results_nearest = static_cast<int>(max_results_nearest->NumberValue());
+    if (max_batch_size_nearest->IsNumber())
+        engine_config->max_batch_size_nearest =
+            static_cast<int>(max_batch_size_nearest->NumberValue());
     if (max_alternatives->IsNumber())
         engine_config->max_alternatives = static_cast<int>(max_alternatives->NumberValue());
     if (max_radius_map_matching->IsNumber())
         engine_config->max_radius_map_matching =
             static_cast<double>(max_radius_map_matching->NumberValue());
+    if (max_match_sessions->IsNumber())
+        engine_config->max_match_sessions =
+            static_cast<std::size_t>(max_match_sessions->NumberValue());
+    if (match_session_timeout->IsNumber())
+        engine_config->match_session_timeout =
+            static_cast<unsigned>(match_session_timeout->NumberValue());
+    if (max_match_session_points->IsNumber())
+        engine_config->max_match_session_points =
+            static_cast<std::size_t>(max_match_session_points->NumberValue());
 
     return engine_config;
 }
@@ -302,7 +452,8 @@ parseCoordinateArray(const v8::Local<v8::Array> &coordinates_array)
 template <typename ParamType>
 inline bool argumentsToParameter(const Nan::FunctionCallbackInfo<v8::Value> &args,
                                  ParamType &params,
-                                 bool requires_multiple_coordinates)
+                                 bool requires_multiple_coordinates,
+                                 bool allows_any_coordinates = false)
 {
     Nan::HandleScope scope;
 
@@ -337,7 +488,8 @@ inline bool argumentsToParameter(const Nan::FunctionCallbackInfo<v8::Value> &arg
             Nan::ThrowError("At least two coordinates must be provided");
             return false;
         }
-        else if (!requires_multiple_coordinates && coordinates_array->Length() != 1)
+        else if (!requires_multiple_coordinates && !allows_any_coordinates &&
+                 coordinates_array->Length() != 1)
         {
             Nan::ThrowError("Exactly one coordinate pair must be provided");
             return false;
@@ -623,6 +775,35 @@ inline bool argumentsToParameter(const Nan::FunctionCallbackInfo<v8::Value> &arg
         }
     }
 
+    if (obj->Has(Nan::New("format").ToLocalChecked()))
+    {
+        v8::Local<v8::Value> format = obj->Get(Nan::New("format").ToLocalChecked());
+        if (format.IsEmpty())
+            return false;
+
+        if (!format->IsString())
+        {
+            Nan::ThrowError("format must be a string: [json, cbor]");
+            return false;
+        }
+        const Nan::Utf8String format_utf8str(format);
+        std::string format_str{*format_utf8str, *format_utf8str + format_utf8str.length()};
+
+        if (format_str == "json")
+        {
+            params->format = osrm::engine::api::BaseParameters::OutputFormatType::JSON;
+        }
+        else if (format_str == "cbor")
+        {
+            params->format = osrm::engine::api::BaseParameters::OutputFormatType::CBOR;
+        }
+        else
+        {
+            Nan::ThrowError("'format' param must be one of [json, cbor]");
+            return false;
+        }
+    }
+
     return true;
 }
 
@@ -905,7 +1086,15 @@ argumentsToNearestParameter(const Nan::FunctionCallbackInfo<v8::Value> &args,
                             bool requires_multiple_coordinates)
 {
     nearest_parameters_ptr params = std::make_unique<osrm::NearestParameters>();
-    bool has_base_params = argumentsToParameter(args, params, requires_multiple_coordinates);
+
+    // a batch snaps any number of coordinates
+    const bool is_batch = args.Length() > 0 && args[0]->IsObject() &&
+                          Nan::To<v8::Object>(args[0])
+                              .ToLocalChecked()
+                              ->Get(Nan::New("batch").ToLocalChecked())
+                              ->IsTrue();
+    bool has_base_params =
+        argumentsToParameter(args, params, requires_multiple_coordinates, is_batch);
     if (!has_base_params)
         return nearest_parameters_ptr();
 
@@ -936,6 +1125,21 @@ argumentsToNearestParameter(const Nan::FunctionCallbackInfo<v8::Value> &args,
         }
     }
 
+    if (obj->Has(Nan::New("batch").ToLocalChecked()))
+    {
+        v8::Local<v8::Value> batch = obj->Get(Nan::New("batch").ToLocalChecked());
+        if (batch.IsEmpty())
+            return nearest_parameters_ptr();
+
+        if (!batch->IsBoolean())
+        {
+            Nan::ThrowError("batch must be of type Boolean");
+            return nearest_parameters_ptr();
+        }
+
+        params->batch = batch->BooleanValue();
+    }
+
     return params;
 }
 
@@ -1030,6 +1234,46 @@ argumentsToTableParameter(const Nan::FunctionCallbackInfo<v8::Value> &args,
         }
     }
 
+    if (obj->Has(Nan::New("annotations").ToLocalChecked()))
+    {
+        v8::Local<v8::Value> annotations = obj->Get(Nan::New("annotations").ToLocalChecked());
+        if (annotations.IsEmpty())
+            return table_parameters_ptr();
+
+        if (!annotations->IsArray())
+        {
+            Nan::ThrowError(
+                "Annotations must be an array containing 'duration' or 'distance', or both");
+            return table_parameters_ptr();
+        }
+
+        params->annotations = osrm::TableParameters::AnnotationsType::None;
+
+        v8::Local<v8::Array> annotations_array = v8::Local<v8::Array>::Cast(annotations);
+        for (std::size_t i = 0; i < annotations_array->Length(); ++i)
+        {
+            const Nan::Utf8String annotations_utf8str(annotations_array->Get(i));
+            std::string annotations_str{*annotations_utf8str,
+                                        *annotations_utf8str + annotations_utf8str.length()};
+
+            if (annotations_str == "duration")
+            {
+                params->annotations =
+                    params->annotations | osrm::TableParameters::AnnotationsType::Duration;
+            }
+            else if (annotations_str == "distance")
+            {
+                params->annotations =
+                    params->annotations | osrm::TableParameters::AnnotationsType::Distance;
+            }
+            else
+            {
+                Nan::ThrowError("this 'annotations' param is not supported");
+                return table_parameters_ptr();
+            }
+        }
+    }
+
     return params;
 }
 
@@ -1133,6 +1377,19 @@ argumentsToMatchParameter(const Nan::FunctionCallbackInfo<v8::Value> &args,
                           bool requires_multiple_coordinates)
 {
     match_parameters_ptr params = std::make_unique<osrm::MatchParameters>();
+
+    // a session can be extended by a single coordinate
+    if (args.Length() > 0 && args[0]->IsObject())
+    {
+        v8::Local<v8::Object> obj = Nan::To<v8::Object>(args[0]).ToLocalChecked();
+        v8::Local<v8::Value> coordinates = obj->Get(Nan::New("coordinates").ToLocalChecked());
+        if (obj->Has(Nan::New("session").ToLocalChecked()) && !coordinates.IsEmpty() &&
+            coordinates->IsArray() && v8::Local<v8::Array>::Cast(coordinates)->Length() == 1)
+        {
+            requires_multiple_coordinates = false;
+        }
+    }
+
     bool has_base_params = argumentsToParameter(args, params, requires_multiple_coordinates);
     if (!has_base_params)
         return match_parameters_ptr();
@@ -1220,6 +1477,23 @@ argumentsToMatchParameter(const Nan::FunctionCallbackInfo<v8::Value> &args,
         params->tidy = tidy->BooleanValue();
     }
 
+    if (obj->Has(Nan::New("session").ToLocalChecked()))
+    {
+        v8::Local<v8::Value> session = obj->Get(Nan::New("session").ToLocalChecked());
+        if (session.IsEmpty())
+            return match_parameters_ptr();
+
+        if (!session->IsString())
+        {
+            Nan::ThrowError("session must be a string");
+            return match_parameters_ptr();
+        }
+
+        const Nan::Utf8String session_utf8str(session);
+        params->session =
+            std::string{*session_utf8str, *session_utf8str + session_utf8str.length()};
+    }
+
     bool parsedSuccessfully = parseCommonParameters(obj, params);
     if (!parsedSuccessfully)
     {
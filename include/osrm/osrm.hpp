@@ -28,6 +28,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef OSRM_HPP
 #define OSRM_HPP
 
+#include "engine/api/base_result.hpp"
 #include "osrm/osrm_fwd.hpp"
 #include "osrm/status.hpp"
 
@@ -58,6 +59,8 @@ using engine::api::TileParameters;
  *  - Tile: vector tiles with internal graph representation
  *
  *  All services take service-specific parameters, fill a JSON object, and return a status code.
+ *  Passing a ResultT that holds a std::vector<char> instead writes the JSON text straight into
+ *  the buffer, without building the object first.
  */
 class OSRM final
 {
@@ -84,6 +87,7 @@ class OSRM final
      * \see Status, RouteParameters and json::Object
      */
     Status Route(const RouteParameters &parameters, json::Object &result) const;
+    Status Route(const RouteParameters &parameters, engine::api::ResultT &result) const;
 
     /**
      * Distance tables for coordinates.
@@ -93,6 +97,7 @@ class OSRM final
      * \see Status, TableParameters and json::Object
      */
     Status Table(const TableParameters &parameters, json::Object &result) const;
+    Status Table(const TableParameters &parameters, engine::api::ResultT &result) const;
 
     /**
      * Nearest street segment for coordinate.
@@ -102,6 +107,7 @@ class OSRM final
      * \see Status, NearestParameters and json::Object
      */
     Status Nearest(const NearestParameters &parameters, json::Object &result) const;
+    Status Nearest(const NearestParameters &parameters, engine::api::ResultT &result) const;
 
     /**
      * Trip: shortest round trip between coordinates.
@@ -111,6 +117,7 @@ class OSRM final
      * \see Status, TripParameters and json::Object
      */
     Status Trip(const TripParameters &parameters, json::Object &result) const;
+    Status Trip(const TripParameters &parameters, engine::api::ResultT &result) const;
 
     /**
      * Match: snaps noisy coordinate traces to the road network
@@ -120,6 +127,7 @@ class OSRM final
      * \see Status, MatchParameters and json::Object
      */
     Status Match(const MatchParameters &parameters, json::Object &result) const;
+    Status Match(const MatchParameters &parameters, engine::api::ResultT &result) const;
 
     /**
      * Tile: vector tiles with internal graph representation
@@ -130,6 +138,25 @@ class OSRM final
      */
     Status Tile(const TileParameters &parameters, std::string &result) const;
 
+    /**
+     * Metrics: counters of the engine, e.g. the hit rate of the response cache
+     *
+     * \param result JSON object the counters are added to
+     * \see EngineConfig
+     */
+    void Metrics(json::Object &result) const;
+
+    /**
+     * UpdateSegmentSpeeds: applies segment speeds to the metric while queries run
+     *
+     * \param segment_speeds CSV lines in the format of the osrm-contract/osrm-customize
+     *                       --segment-speed-file option
+     * \param result JSON object with the number of updated segments, edges and cells
+     * \return Status indicating success, fails if EngineConfig::live_traffic_updates is not set
+     * \see EngineConfig
+     */
+    Status UpdateSegmentSpeeds(const std::string &segment_speeds, json::Object &result) const;
+
   private:
     std::unique_ptr<engine::EngineInterface> engine_;
 };
@@ -375,8 +375,10 @@ template <storage::Ownership Ownership> class CellStorageImpl
                          destination_boundary.empty() ? nullptr : destination_boundary.data()};
     }
 
-    template <typename = std::enable_if<Ownership == storage::Ownership::Container>>
-    Cell GetCell(customizer::CellMetric &metric, LevelID level, CellID id) const
+    // Views are writable as well, so a metric in memory can be customized in place
+    Cell GetCell(customizer::detail::CellMetricImpl<Ownership> &metric,
+                 LevelID level,
+                 CellID id) const
     {
         const auto level_index = LevelIDToIndex(level);
         BOOST_ASSERT(level_index < level_to_cell_offset.size());
@@ -386,8 +388,8 @@ template <storage::Ownership Ownership> class CellStorageImpl
         return Cell{cells[cell_index],
                     metric.weights.data(),
                     metric.durations.data(),
-                    source_boundary.data(),
-                    destination_boundary.data()};
+                    source_boundary.empty() ? nullptr : source_boundary.data(),
+                    destination_boundary.empty() ? nullptr : destination_boundary.data()};
     }
 
     friend void serialization::read<Ownership>(storage::io::FileReader &reader,
@@ -28,6 +28,13 @@ struct TableParametersGrammar final : public BaseParametersGrammar<Iterator, Sig
 
     TableParametersGrammar() : BaseGrammar(root_rule)
     {
+        using AnnotationsType = engine::api::TableParameters::AnnotationsType;
+
+        const auto add_annotation = [](engine::api::TableParameters &table_parameters,
+                                       AnnotationsType table_param) {
+            table_parameters.annotations = table_parameters.annotations | table_param;
+        };
+
 #ifdef BOOST_HAS_LONG_LONG
         if (std::is_same<std::size_t, unsigned long long>::value)
             size_t_ = qi::ulong_long;
@@ -48,9 +55,18 @@ struct TableParametersGrammar final : public BaseParametersGrammar<Iterator, Sig
             (qi::lit("all") |
              (size_t_ % ';')[ph::bind(&engine::api::TableParameters::sources, qi::_r1) = qi::_1]);
 
-        table_rule = destinations_rule(qi::_r1) | sources_rule(qi::_r1);
+        annotations_type.add("duration", AnnotationsType::Duration)("distance",
+                                                                    AnnotationsType::Distance);
+
+        // an explicit list replaces the default durations-only matrix
+        annotations_rule =
+            qi::lit("annotations=")[ph::bind(&engine::api::TableParameters::annotations,
+                                             qi::_r1) = AnnotationsType::None] >
+            (annotations_type[ph::bind(add_annotation, qi::_r1, qi::_1)] % ',');
 
-        root_rule = BaseGrammar::query_rule(qi::_r1) > -qi::lit(".json") >
+        table_rule = destinations_rule(qi::_r1) | sources_rule(qi::_r1) | annotations_rule(qi::_r1);
+
+        root_rule = BaseGrammar::query_rule(qi::_r1) > -BaseGrammar::format_rule(qi::_r1) >
                     -('?' > (table_rule(qi::_r1) | BaseGrammar::base_rule(qi::_r1)) % '&');
     }
 
@@ -59,7 +75,10 @@ struct TableParametersGrammar final : public BaseParametersGrammar<Iterator, Sig
     qi::rule<Iterator, Signature> table_rule;
     qi::rule<Iterator, Signature> sources_rule;
     qi::rule<Iterator, Signature> destinations_rule;
+    qi::rule<Iterator, Signature> annotations_rule;
     qi::rule<Iterator, std::size_t()> size_t_;
+
+    qi::symbols<char, engine::api::TableParameters::AnnotationsType> annotations_type;
 };
 }
 }
@@ -32,12 +32,41 @@ namespace server
 {
 
 class RequestHandler;
+class WorkerPool;
+
+struct ConnectionConfig
+{
+    // seconds an idle connection is kept open for the next request, 0 disables keep-alive
+    unsigned keepalive_timeout = 5;
+    // max. number of requests answered on one connection
+    unsigned keepalive_max_requests = 512;
+    // seconds a client has to send a complete request
+    unsigned request_timeout = 30;
+    // max. bytes in the body of POST /update and nearest requests, other requests take no body
+    std::size_t max_body_size = RequestParser::DEFAULT_MAX_BODY_SIZE;
+    // POST /update is answered on the connection
+    bool accept_updates = true;
+    // queries of the services and /metrics are answered on the connection
+    bool accept_queries = true;
+};
 
 /// Represents a single connection from a client.
+///
+/// The connection is kept open after a reply if the client asked for it (HTTP/1.1 by default,
+/// HTTP/1.0 with 'Connection: keep-alive'). Requests that were pipelined on the socket are
+/// answered in order. The connection is closed after `keepalive_max_requests` replies or if
+/// no new request arrives within `keepalive_timeout` seconds after a reply. A timeout of 0
+/// disables keep-alive. A request that isn't complete `request_timeout` seconds after the
+/// connection was opened or after its first bytes arrived closes the connection.
+///
+/// Requests are handled on the WorkerPool; the I/O thread only parses and writes.
 class Connection : public std::enable_shared_from_this<Connection>
 {
   public:
-    explicit Connection(boost::asio::io_service &io_service, RequestHandler &handler);
+    explicit Connection(boost::asio::io_service &io_service,
+                        RequestHandler &handler,
+                        WorkerPool &worker_pool,
+                        const ConnectionConfig &config);
     Connection(const Connection &) = delete;
     Connection &operator=(const Connection &) = delete;
 
@@ -47,19 +76,53 @@ class Connection : public std::enable_shared_from_this<Connection>
     void start();
 
   private:
+    /// Schedule a read from the socket that is cancelled at the read deadline.
+    void start_read();
+
     void handle_read(const boost::system::error_code &e, std::size_t bytes_transferred);
 
+    /// Parse buffered input and reply if a complete request was received.
+    void process_input(char *begin, char *end);
+
+    /// Add the connection headers and compress the content of the current reply.
+    void prepare_reply();
+
+    void write_reply();
+
     /// Handle completion of a write operation.
     void handle_write(const boost::system::error_code &e);
 
+    /// Cancel the pending read if the client didn't send a request in time.
+    void handle_timeout(const boost::system::error_code &e, const unsigned wait_id);
+
+    void handle_shutdown();
+
+    bool wants_keep_alive() const;
+
     std::vector<char> compress_buffers(const std::vector<char> &uncompressed_data,
                                        const http::compression_type compression_type);
 
     boost::asio::io_service::strand strand;
     boost::asio::ip::tcp::socket TCP_socket;
+    boost::asio::deadline_timer timer;
     RequestHandler &request_handler;
+    WorkerPool &worker_pool;
     RequestParser request_parser;
     boost::array<char, 8192> incoming_data_buffer;
+    // unparsed bytes of pipelined requests inside incoming_data_buffer
+    char *pipelined_begin;
+    char *pipelined_end;
+    http::compression_type current_compression;
+    const ConnectionConfig config;
+    unsigned remaining_requests;
+    bool keep_alive;
+    // the pending read is cancelled at this time
+    boost::posix_time::ptime read_deadline;
+    // the connection is idle between two requests, the next read starts a request
+    bool waiting_for_request;
+    bool read_pending;
+    // identifies the latest wait of the timer, earlier ones may complete after it was re-armed
+    unsigned timer_wait_id;
     http::request current_request;
     http::reply current_reply;
     std::vector<char> compressed_output;
@@ -21,7 +21,10 @@ class reply
     {
         ok = 200,
         bad_request = 400,
-        internal_server_error = 500
+        not_found = 404,
+        payload_too_large = 413,
+        internal_server_error = 500,
+        service_unavailable = 503
     } status;
 
     std::vector<header> headers;
@@ -14,11 +14,27 @@ namespace http
 
 struct request
 {
+    std::string method;
     std::string uri;
     std::string referrer;
     std::string agent;
+    std::string connection;
+    std::string accept;
+    unsigned http_version_major = 1;
+    unsigned http_version_minor = 0;
     boost::asio::ip::address endpoint;
+    // only read if the request has a Content-Length header, e.g. the CSV of a POST /update
+    std::string body;
 };
+
+// Segment speeds for live traffic updates are sent to /update, or /update/{dataset} to update a
+// named dataset
+inline bool is_update_uri(const std::string &uri)
+{
+    const std::string update_prefix = "/update";
+    return uri.compare(0, update_prefix.size(), update_prefix) == 0 &&
+           (uri.size() == update_prefix.size() || uri[update_prefix.size()] == '/');
+}
 }
 }
 }
@@ -28,6 +28,9 @@ class RequestHandler
 
     void HandleRequest(const http::request &current_request, http::reply &current_reply);
 
+    // Adds the counters of the registered service handler
+    void GetMetrics(util::json::Object &metrics) const;
+
   private:
     std::unique_ptr<ServiceHandlerInterface> service_handler;
 };
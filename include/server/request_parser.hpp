@@ -4,6 +4,7 @@
 #include "server/http/compression_type.hpp"
 #include "server/http/header.hpp"
 
+#include <cstddef>
 #include <tuple>
 
 namespace osrm
@@ -19,16 +20,24 @@ struct request;
 class RequestParser
 {
   public:
-    RequestParser();
+    // Only POST /update and nearest requests take a body, a larger body is rejected
+    static constexpr std::size_t DEFAULT_MAX_BODY_SIZE = 1024 * 1024;
+
+    explicit RequestParser(const std::size_t max_body_size = DEFAULT_MAX_BODY_SIZE,
+                           const bool accept_updates = true);
 
     enum class RequestStatus : char
     {
         valid,
         invalid,
+        too_large,
         indeterminate
     };
 
-    std::tuple<RequestStatus, http::compression_type>
+    // Consumes input until a request is complete or the input is exhausted. The returned
+    // pointer marks the first unconsumed character, which is the start of the next
+    // pipelined request if the client sent more than one.
+    std::tuple<RequestStatus, http::compression_type, char *>
     parse(http::request &current_request, char *begin, char *end);
 
   private:
@@ -64,10 +73,14 @@ class RequestParser
         space_before_header_value,
         header_value,
         expecting_newline_2,
-        expecting_newline_3
+        expecting_newline_3,
+        body
     } state;
 
     http::header current_header;
+    std::size_t max_body_size;
+    bool accept_updates;
+    std::size_t content_length;
     http::compression_type selected_compression;
 };
 }
@@ -4,6 +4,7 @@
 #include "server/connection.hpp"
 #include "server/request_handler.hpp"
 #include "server/service_handler.hpp"
+#include "server/worker_pool.hpp"
 
 #include "util/integer_range.hpp"
 #include "util/log.hpp"
@@ -33,39 +34,51 @@ class Server
 {
   public:
     // Note: returns a shared instead of a unique ptr as it is captured in a lambda somewhere else
-    static std::shared_ptr<Server>
-    CreateServer(std::string &ip_address, int ip_port, unsigned requested_num_threads)
+    static std::shared_ptr<Server> CreateServer(std::string &ip_address,
+                                                int ip_port,
+                                                unsigned requested_num_io_threads,
+                                                WorkerPoolConfig worker_config,
+                                                const ConnectionConfig &connection_config,
+                                                const std::string &update_ip_address = "",
+                                                const int update_port = 0)
     {
         util::Log() << "http 1.1 compression handled by zlib version " << zlibVersion();
         const unsigned hardware_threads = std::max(1u, std::thread::hardware_concurrency());
-        const unsigned real_num_threads = std::min(hardware_threads, requested_num_threads);
-        return std::make_shared<Server>(ip_address, ip_port, real_num_threads);
+        const unsigned real_num_io_threads = std::min(hardware_threads, requested_num_io_threads);
+        worker_config.num_threads = std::max(1u, std::min(hardware_threads, worker_config.num_threads));
+        return std::make_shared<Server>(ip_address,
+                                        ip_port,
+                                        real_num_io_threads,
+                                        worker_config,
+                                        connection_config,
+                                        update_ip_address,
+                                        update_port);
     }
 
-    explicit Server(const std::string &address, const int port, const unsigned thread_pool_size)
-        : thread_pool_size(thread_pool_size), acceptor(io_service),
-          new_connection(std::make_shared<Connection>(io_service, request_handler))
+    // With an update_port POST /update is only answered on that port, and only POST /update
+    explicit Server(const std::string &address,
+                    const int port,
+                    const unsigned thread_pool_size,
+                    const WorkerPoolConfig &worker_config,
+                    const ConnectionConfig &connection_config,
+                    const std::string &update_address = "",
+                    const int update_port = 0)
+        : thread_pool_size(thread_pool_size), connection_config(connection_config),
+          update_connection_config(connection_config), acceptor(io_service),
+          update_acceptor(io_service), worker_pool(worker_config)
     {
-        const auto port_string = std::to_string(port);
-
-        boost::asio::ip::tcp::resolver resolver(io_service);
-        boost::asio::ip::tcp::resolver::query query(address, port_string);
-        boost::asio::ip::tcp::endpoint endpoint = *resolver.resolve(query);
-
-        acceptor.open(endpoint.protocol());
-#ifdef SO_REUSEPORT
-        const int option = 1;
-        setsockopt(acceptor.native_handle(), SOL_SOCKET, SO_REUSEPORT, &option, sizeof(option));
-#endif
-        acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
-        acceptor.bind(endpoint);
-        acceptor.listen();
+        if (update_port != 0)
+        {
+            this->connection_config.accept_updates = false;
+            update_connection_config.accept_queries = false;
+            Listen(update_acceptor, update_address, update_port);
+            util::Log() << "Listening for updates on: " << update_acceptor.local_endpoint();
+            Accept(update_acceptor, update_connection_config);
+        }
 
+        Listen(acceptor, address, port);
         util::Log() << "Listening on: " << acceptor.local_endpoint();
-
-        acceptor.async_accept(
-            new_connection->socket(),
-            boost::bind(&Server::HandleAccept, this, boost::asio::placeholders::error));
+        Accept(acceptor, this->connection_config);
     }
 
     void Run()
@@ -83,7 +96,11 @@ class Server
         }
     }
 
-    void Stop() { io_service.stop(); }
+    void Stop()
+    {
+        io_service.stop();
+        worker_pool.Stop();
+    }
 
     void RegisterServiceHandler(std::unique_ptr<ServiceHandlerInterface> service_handler_)
     {
@@ -91,23 +108,51 @@ class Server
     }
 
   private:
-    void HandleAccept(const boost::system::error_code &e)
+    void Listen(boost::asio::ip::tcp::acceptor &listening_acceptor,
+                const std::string &address,
+                const int port)
     {
-        if (!e)
-        {
-            new_connection->start();
-            new_connection = std::make_shared<Connection>(io_service, request_handler);
-            acceptor.async_accept(
-                new_connection->socket(),
-                boost::bind(&Server::HandleAccept, this, boost::asio::placeholders::error));
-        }
+        const auto port_string = std::to_string(port);
+
+        boost::asio::ip::tcp::resolver resolver(io_service);
+        boost::asio::ip::tcp::resolver::query query(address, port_string);
+        boost::asio::ip::tcp::endpoint endpoint = *resolver.resolve(query);
+
+        listening_acceptor.open(endpoint.protocol());
+#ifdef SO_REUSEPORT
+        const int option = 1;
+        setsockopt(
+            listening_acceptor.native_handle(), SOL_SOCKET, SO_REUSEPORT, &option, sizeof(option));
+#endif
+        listening_acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
+        listening_acceptor.bind(endpoint);
+        listening_acceptor.listen();
+    }
+
+    void Accept(boost::asio::ip::tcp::acceptor &listening_acceptor, const ConnectionConfig &config)
+    {
+        auto new_connection =
+            std::make_shared<Connection>(io_service, request_handler, worker_pool, config);
+        listening_acceptor.async_accept(
+            new_connection->socket(),
+            [this, &listening_acceptor, &config, new_connection](
+                const boost::system::error_code &error) {
+                if (!error)
+                {
+                    new_connection->start();
+                    Accept(listening_acceptor, config);
+                }
+            });
     }
 
     unsigned thread_pool_size;
+    ConnectionConfig connection_config;
+    ConnectionConfig update_connection_config;
     boost::asio::io_service io_service;
     boost::asio::ip::tcp::acceptor acceptor;
-    std::shared_ptr<Connection> new_connection;
+    boost::asio::ip::tcp::acceptor update_acceptor;
     RequestHandler request_handler;
+    WorkerPool worker_pool;
 };
 }
 }
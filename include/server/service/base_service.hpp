@@ -1,8 +1,11 @@
 #ifndef SERVER_SERVICE_BASE_SERVICE_HPP
 #define SERVER_SERVICE_BASE_SERVICE_HPP
 
+#include "engine/api/base_parameters.hpp"
+#include "engine/api/base_result.hpp"
 #include "engine/status.hpp"
 #include "osrm/osrm.hpp"
+#include "util/cbor_writer.hpp"
 #include "util/coordinate.hpp"
 
 #include <mapbox/variant.hpp>
@@ -20,7 +23,11 @@ namespace service
 class BaseService
 {
   public:
-    using ResultT = mapbox::util::variant<util::json::Object, std::string>;
+    // JSON responses either as object or already rendered, tiles as protobuf string and CBOR
+    // responses. The alternative result holds when RunQuery is called is the format the client
+    // accepts, a format suffix in the URL takes precedence.
+    using ResultT = mapbox::util::
+        variant<util::json::Object, std::string, std::vector<char>, util::cbor::Buffer>;
 
     BaseService(OSRM &routing_machine) : routing_machine(routing_machine) {}
     virtual ~BaseService() = default;
@@ -31,6 +38,33 @@ class BaseService
     virtual unsigned GetVersion() = 0;
 
   protected:
+    using OutputFormatType = engine::api::BaseParameters::OutputFormatType;
+
+    static OutputFormatType GetAcceptedFormat(const ResultT &result)
+    {
+        return result.is<util::cbor::Buffer>() ? OutputFormatType::CBOR : OutputFormatType::JSON;
+    }
+
+    // Calls run_query with an engine result of the format and moves the written response into
+    // result, it goes into the reply without a copy
+    template <typename RunQueryT>
+    static engine::Status
+    RunWithFormat(const OutputFormatType format, ResultT &result, RunQueryT &&run_query)
+    {
+        if (format == OutputFormatType::CBOR)
+        {
+            engine::api::ResultT engine_result = util::cbor::Buffer();
+            const auto status = run_query(engine_result);
+            result = std::move(engine_result.get<util::cbor::Buffer>());
+            return status;
+        }
+
+        engine::api::ResultT engine_result = std::vector<char>();
+        const auto status = run_query(engine_result);
+        result = std::move(engine_result.get<std::vector<char>>());
+        return status;
+    }
+
     OSRM &routing_machine;
 };
 }
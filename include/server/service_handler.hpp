@@ -5,6 +5,8 @@
 
 #include "osrm/osrm.hpp"
 
+#include <memory>
+#include <string>
 #include <unordered_map>
 
 namespace osrm
@@ -29,6 +31,12 @@ class ServiceHandlerInterface
     virtual ~ServiceHandlerInterface() {}
     virtual engine::Status RunQuery(api::ParsedURL parsed_url,
                                     service::BaseService::ResultT &result) = 0;
+    // Adds the counters of the handler to the /metrics response
+    virtual void GetMetrics(util::json::Object &) const {}
+    // Applies the segment speeds of a POST /update request, `dataset` is empty for the default
+    virtual engine::Status UpdateSegmentSpeeds(const std::string &dataset,
+                                               const std::string &segment_speeds,
+                                               util::json::Object &result) = 0;
 };
 
 class ServiceHandler final : public ServiceHandlerInterface
@@ -38,11 +46,38 @@ class ServiceHandler final : public ServiceHandlerInterface
     using ResultT = service::BaseService::ResultT;
 
     virtual engine::Status RunQuery(api::ParsedURL parsed_url, ResultT &result) override;
+    void GetMetrics(util::json::Object &metrics) const override;
+    engine::Status UpdateSegmentSpeeds(const std::string &dataset,
+                                       const std::string &segment_speeds,
+                                       util::json::Object &result) override;
 
   private:
     std::unordered_map<std::string, std::unique_ptr<service::BaseService>> service_map;
     OSRM routing_machine;
 };
+
+// Serves several datasets from one process, e.g. one for every profile. Requests are answered by
+// the dataset named by the profile of the URL, the default dataset answers all other profiles.
+class DatasetServiceHandler final : public ServiceHandlerInterface
+{
+  public:
+    using ResultT = service::BaseService::ResultT;
+    using Datasets = std::unordered_map<std::string, std::unique_ptr<ServiceHandlerInterface>>;
+
+    // The dataset with an empty name is the default dataset, it is optional
+    DatasetServiceHandler(Datasets datasets);
+
+    engine::Status RunQuery(api::ParsedURL parsed_url, ResultT &result) override;
+    void GetMetrics(util::json::Object &metrics) const override;
+    engine::Status UpdateSegmentSpeeds(const std::string &dataset,
+                                       const std::string &segment_speeds,
+                                       util::json::Object &result) override;
+
+  private:
+    ServiceHandlerInterface *GetDataset(const std::string &name) const;
+
+    Datasets datasets;
+};
 }
 }
 
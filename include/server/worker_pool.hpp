@@ -0,0 +1,95 @@
+#ifndef SERVER_WORKER_POOL_HPP
+#define SERVER_WORKER_POOL_HPP
+
+#include "util/json_container.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace osrm
+{
+namespace server
+{
+
+struct WorkerPoolConfig
+{
+    // threads serving all services without a dedicated queue
+    unsigned num_threads = 1;
+    // max. number of requests waiting in a queue before new ones are rejected
+    std::size_t max_queue_size = 1024;
+    // services that get their own queue and threads, e.g. {"table", 2}
+    std::unordered_map<std::string, unsigned> service_threads;
+};
+
+/// Runs routing requests on threads separate from the asio I/O threads.
+///
+/// Every queue is bounded: Post returns false instead of queueing if it is full, so the
+/// caller can reject the request right away. A service can get a dedicated queue so long
+/// running requests of one service cannot delay requests of another.
+class WorkerPool
+{
+  public:
+    using Task = std::function<void()>;
+
+    explicit WorkerPool(const WorkerPoolConfig &config);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    /// Queues the task on the queue of `service`. Returns false if that queue is full.
+    bool Post(const std::string &service, Task task);
+
+    /// Stops all workers, tasks that are still queued are dropped.
+    void Stop();
+
+    /// Queue depth, rejected requests and time spent waiting in the queue per queue.
+    util::json::Object GetMetrics() const;
+
+  private:
+    struct Queue
+    {
+        Queue(std::string name, std::size_t max_size) : name(std::move(name)), max_size(max_size)
+        {
+        }
+
+        struct Entry
+        {
+            Task task;
+            std::chrono::steady_clock::time_point enqueued;
+        };
+
+        const std::string name;
+        const std::size_t max_size;
+
+        mutable std::mutex mutex;
+        std::condition_variable has_work;
+        std::deque<Entry> entries;
+        std::vector<std::thread> threads;
+
+        std::atomic<std::uint64_t> processed{0};
+        std::atomic<std::uint64_t> rejected{0};
+        std::atomic<std::uint64_t> total_wait_us{0};
+        std::atomic<std::uint64_t> max_wait_us{0};
+    };
+
+    void Work(Queue &queue);
+
+    std::atomic<bool> stopped;
+    std::unique_ptr<Queue> default_queue;
+    std::unordered_map<std::string, std::unique_ptr<Queue>> service_queues;
+};
+}
+}
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef OSRM_STORAGE_DATASET_FINGERPRINT_HPP
+#define OSRM_STORAGE_DATASET_FINGERPRINT_HPP
+
+#include "storage/storage_config.hpp"
+
+#include <cstdint>
+
+namespace osrm
+{
+namespace storage
+{
+
+// Identifies the files of a dataset by their names, sizes and modification times.
+// `topology` covers the files written by osrm-extract and osrm-partition, `metric` the ones
+// that osrm-customize, osrm-contract and the segment speed updates write for new weights.
+struct DatasetFingerprint
+{
+    std::uint64_t topology;
+    std::uint64_t metric;
+
+    bool operator==(const DatasetFingerprint &other) const
+    {
+        return topology == other.topology && metric == other.metric;
+    }
+    bool operator!=(const DatasetFingerprint &other) const { return !(*this == other); }
+};
+
+DatasetFingerprint getDatasetFingerprint(const StorageConfig &config);
+}
+}
+
+#endif
@@ -8,6 +8,7 @@
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/path.hpp>
 #include <string>
+#include <vector>
 
 namespace osrm
 {
@@ -24,6 +25,8 @@ struct IOConfig
     }
 
     bool IsValid() const;
+    // Paths of all required and optional input files
+    std::vector<boost::filesystem::path> GetInputPaths() const;
     boost::filesystem::path GetPath(const std::string &fileName) const
     {
         if (!IsConfigured(fileName, required_input_files) &&
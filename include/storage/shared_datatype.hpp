@@ -7,6 +7,7 @@
 
 #include <boost/assert.hpp>
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
 
@@ -47,6 +48,8 @@ const constexpr char *block_id_to_name[] = {"NAME_CHAR_DATA",
                                             "GEOMETRIES_REV_DATASOURCES_LIST",
                                             "HSGR_CHECKSUM",
                                             "TIMESTAMP",
+                                            "TOPOLOGY_FINGERPRINT",
+                                            "METRIC_FINGERPRINT",
                                             "FILE_INDEX_PATH",
                                             "DATASOURCES_NAMES",
                                             "PROPERTIES",
@@ -88,7 +91,11 @@ const constexpr char *block_id_to_name[] = {"NAME_CHAR_DATA",
                                             "MLD_CELL_LEVEL_OFFSETS",
                                             "MLD_GRAPH_NODE_LIST",
                                             "MLD_GRAPH_EDGE_LIST",
-                                            "MLD_GRAPH_NODE_TO_OFFSET"};
+                                            "MLD_GRAPH_NODE_TO_OFFSET",
+                                            "CCH_GRAPH_NODE_LIST",
+                                            "CCH_GRAPH_EDGE_LIST",
+                                            "CCH_EDGE_FILTER",
+                                            "CCH_ELIMINATION_TREE"};
 
 struct DataLayout
 {
@@ -123,6 +130,8 @@ struct DataLayout
         GEOMETRIES_REV_DATASOURCES_LIST,
         HSGR_CHECKSUM,
         TIMESTAMP,
+        TOPOLOGY_FINGERPRINT,
+        METRIC_FINGERPRINT,
         FILE_INDEX_PATH,
         DATASOURCES_NAMES,
         PROPERTIES,
@@ -165,6 +174,10 @@ struct DataLayout
         MLD_GRAPH_NODE_LIST,
         MLD_GRAPH_EDGE_LIST,
         MLD_GRAPH_NODE_TO_OFFSET,
+        CCH_GRAPH_NODE_LIST,
+        CCH_GRAPH_EDGE_LIST,
+        CCH_EDGE_FILTER,
+        CCH_ELIMINATION_TREE,
         NUM_BLOCKS
     };
 
@@ -262,21 +275,58 @@ struct DataLayout
     }
 };
 
+// Blocks that change when the weights of a dataset are updated with osrm-customize.
+// They can be replaced without loading the rest of the dataset again.
+const constexpr DataLayout::BlockID metric_blocks[] = {
+    DataLayout::GEOMETRIES_FWD_WEIGHT_LIST,      DataLayout::GEOMETRIES_REV_WEIGHT_LIST,
+    DataLayout::GEOMETRIES_FWD_DURATION_LIST,    DataLayout::GEOMETRIES_REV_DURATION_LIST,
+    DataLayout::GEOMETRIES_FWD_DATASOURCES_LIST, DataLayout::GEOMETRIES_REV_DATASOURCES_LIST,
+    DataLayout::DATASOURCES_NAMES,               DataLayout::TURN_WEIGHT_PENALTIES,
+    DataLayout::TURN_DURATION_PENALTIES,         DataLayout::MLD_GRAPH_EDGE_LIST,
+    DataLayout::MLD_CELL_WEIGHTS_0,              DataLayout::MLD_CELL_WEIGHTS_1,
+    DataLayout::MLD_CELL_WEIGHTS_2,              DataLayout::MLD_CELL_WEIGHTS_3,
+    DataLayout::MLD_CELL_WEIGHTS_4,              DataLayout::MLD_CELL_WEIGHTS_5,
+    DataLayout::MLD_CELL_WEIGHTS_6,              DataLayout::MLD_CELL_WEIGHTS_7,
+    DataLayout::MLD_CELL_DURATIONS_0,            DataLayout::MLD_CELL_DURATIONS_1,
+    DataLayout::MLD_CELL_DURATIONS_2,            DataLayout::MLD_CELL_DURATIONS_3,
+    DataLayout::MLD_CELL_DURATIONS_4,            DataLayout::MLD_CELL_DURATIONS_5,
+    DataLayout::MLD_CELL_DURATIONS_6,            DataLayout::MLD_CELL_DURATIONS_7,
+    DataLayout::METRIC_FINGERPRINT};
+
+// Keeps the entry sizes of all blocks so the aligned offsets can be computed,
+// but only reserves space for the metric blocks
+inline DataLayout makeMetricLayout(const DataLayout &layout)
+{
+    DataLayout metric_layout = layout;
+    std::fill(metric_layout.num_entries.begin(), metric_layout.num_entries.end(), 0);
+    for (const auto block : metric_blocks)
+    {
+        metric_layout.num_entries[block] = layout.num_entries[block];
+    }
+    return metric_layout;
+}
+
 enum SharedDataType
 {
     REGION_NONE,
     REGION_1,
-    REGION_2
+    REGION_2,
+    METRIC_REGION_1,
+    METRIC_REGION_2
 };
 
 struct SharedDataTimestamp
 {
-    explicit SharedDataTimestamp(SharedDataType region, unsigned timestamp)
-        : region(region), timestamp(timestamp)
+    explicit SharedDataTimestamp(SharedDataType region,
+                                 unsigned timestamp,
+                                 SharedDataType metric_region = REGION_NONE)
+        : region(region), metric_region(metric_region), timestamp(timestamp)
     {
     }
 
     SharedDataType region;
+    // region with the metric blocks that replace the ones in region, REGION_NONE if unused
+    SharedDataType metric_region;
     unsigned timestamp;
 
     static constexpr const char *name = "osrm-region";
@@ -290,6 +340,10 @@ inline std::string regionToString(const SharedDataType region)
         return "REGION_1";
     case REGION_2:
         return "REGION_2";
+    case METRIC_REGION_1:
+        return "METRIC_REGION_1";
+    case METRIC_REGION_2:
+        return "METRIC_REGION_2";
     case REGION_NONE:
         return "REGION_NONE";
     default:
@@ -44,10 +44,15 @@ class Storage
   public:
     Storage(StorageConfig config);
 
-    int Run(int max_wait);
+    // With only_metric the metric blocks of the dataset in shared memory are replaced
+    int Run(int max_wait, bool only_metric = false);
 
     void PopulateLayout(DataLayout &layout);
     void PopulateData(const DataLayout &layout, char *memory_ptr);
+    // Reads only the metric blocks into a memory of the layout created by makeMetricLayout
+    void PopulateMetricData(const DataLayout &layout,
+                            const DataLayout &metric_layout,
+                            char *memory_ptr);
 
   private:
     StorageConfig config;
@@ -69,7 +69,8 @@ struct StorageConfig final : IOConfig
                     ".osrm.mldgr",
                     ".osrm.tld",
                     ".osrm.tls",
-                    ".osrm.partition"},
+                    ".osrm.partition",
+                    ".osrm.cch"},
                    {})
     {
     }
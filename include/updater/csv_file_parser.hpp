@@ -59,26 +59,12 @@ template <typename Key, typename Value> struct CSVFilesParser
                                   }
                               });
 
-            // With flattened map-ish view of all the files, make a stable sort on key and source
-            // and unique them on key to keep only the value with the largest file index
-            // and the largest line number in a file.
-            // The operands order is swapped to make descending ordering on (key, source)
-            tbb::parallel_sort(begin(lookup), end(lookup), [](const auto &lhs, const auto &rhs) {
-                return std::tie(rhs.first, rhs.second.source) <
-                       std::tie(lhs.first, lhs.second.source);
-            });
-
-            // Unique only on key to take the source precedence into account and remove duplicates.
-            const auto it =
-                std::unique(begin(lookup), end(lookup), [](const auto &lhs, const auto &rhs) {
-                    return lhs.first == rhs.first;
-                });
-            lookup.erase(it, end(lookup));
+            auto result = MakeLookupTable(std::move(lookup));
 
             util::Log() << "In total loaded " << csv_filenames.size() << " file(s) with a total of "
-                        << lookup.size() << " unique values";
+                        << result.lookup.size() << " unique values";
 
-            return LookupTable<Key, Value>{lookup};
+            return result;
         }
         catch (const tbb::captured_exception &e)
         {
@@ -86,12 +72,36 @@ template <typename Key, typename Value> struct CSVFilesParser
         }
     }
 
+    // Parses CSV data that is already in memory, name is only used in error messages
+    auto operator()(const std::string &name, const char *first, const char *last) const
+    {
+        return MakeLookupTable(ParseCSV(name, start_index, first, last));
+    }
+
   private:
+    // With flattened map-ish view of all the files, make a stable sort on key and source
+    // and unique them on key to keep only the value with the largest file index
+    // and the largest line number in a file.
+    LookupTable<Key, Value> MakeLookupTable(std::vector<std::pair<Key, Value>> lookup) const
+    {
+        // The operands order is swapped to make descending ordering on (key, source)
+        tbb::parallel_sort(begin(lookup), end(lookup), [](const auto &lhs, const auto &rhs) {
+            return std::tie(rhs.first, rhs.second.source) < std::tie(lhs.first, lhs.second.source);
+        });
+
+        // Unique only on key to take the source precedence into account and remove duplicates.
+        const auto it =
+            std::unique(begin(lookup), end(lookup), [](const auto &lhs, const auto &rhs) {
+                return lhs.first == rhs.first;
+            });
+        lookup.erase(it, end(lookup));
+
+        return LookupTable<Key, Value>{lookup};
+    }
+
     // Parse a single CSV file and return result as a vector<Key, Value>
     auto ParseCSVFile(const std::string &filename, std::size_t file_id) const
     {
-        namespace qi = boost::spirit::qi;
-
         std::vector<std::pair<Key, Value>> result;
         try
         {
@@ -99,26 +109,7 @@ template <typename Key, typename Value> struct CSVFilesParser
                 return result;
 
             boost::iostreams::mapped_file_source mmap(filename);
-            auto first = mmap.begin(), last = mmap.end();
-
-            BOOST_ASSERT(file_id <= std::numeric_limits<std::uint8_t>::max());
-            ValueRule value_source =
-                value_rule[qi::_val = qi::_1, bind(&Value::source, qi::_val) = file_id];
-            qi::rule<Iterator, std::pair<Key, Value>()> csv_line =
-                (key_rule >> ',' >> value_source) >> -(',' >> *(qi::char_ - qi::eol));
-            const auto ok = qi::parse(first, last, -(csv_line % qi::eol) >> *qi::eol, result);
-
-            if (!ok || first != last)
-            {
-                auto begin_of_line = first - 1;
-                while (begin_of_line >= mmap.begin() && *begin_of_line != '\n')
-                    --begin_of_line;
-                auto line_number = std::count(mmap.begin(), first, '\n') + 1;
-                const auto message = boost::format("CSV file %1% malformed on line %2%:\n %3%\n") %
-                                     filename % std::to_string(line_number) %
-                                     std::string(begin_of_line + 1, std::find(first, last, '\n'));
-                throw util::exception(message.str() + SOURCE_REF);
-            }
+            result = ParseCSV(filename, file_id, mmap.begin(), mmap.end());
 
             util::Log() << "Loaded " << filename << " with " << result.size() << "values";
 
@@ -132,6 +123,37 @@ template <typename Key, typename Value> struct CSVFilesParser
         }
     }
 
+    // Parse CSV lines between first and last and return result as a vector<Key, Value>
+    std::vector<std::pair<Key, Value>>
+    ParseCSV(const std::string &name, std::size_t file_id, Iterator first, Iterator last) const
+    {
+        namespace qi = boost::spirit::qi;
+
+        std::vector<std::pair<Key, Value>> result;
+        const auto data_begin = first;
+
+        BOOST_ASSERT(file_id <= std::numeric_limits<std::uint8_t>::max());
+        ValueRule value_source =
+            value_rule[qi::_val = qi::_1, bind(&Value::source, qi::_val) = file_id];
+        qi::rule<Iterator, std::pair<Key, Value>()> csv_line =
+            (key_rule >> ',' >> value_source) >> -(',' >> *(qi::char_ - qi::eol));
+        const auto ok = qi::parse(first, last, -(csv_line % qi::eol) >> *qi::eol, result);
+
+        if (!ok || first != last)
+        {
+            auto begin_of_line = first - 1;
+            while (begin_of_line >= data_begin && *begin_of_line != '\n')
+                --begin_of_line;
+            auto line_number = std::count(data_begin, first, '\n') + 1;
+            const auto message = boost::format("CSV file %1% malformed on line %2%:\n %3%\n") %
+                                 name % std::to_string(line_number) %
+                                 std::string(begin_of_line + 1, std::find(first, last, '\n'));
+            throw util::exception(message.str() + SOURCE_REF);
+        }
+
+        return result;
+    }
+
     const std::size_t start_index;
     const KeyRule key_rule;
     const ValueRule value_rule;
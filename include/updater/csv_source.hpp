@@ -10,6 +10,8 @@ namespace updater
 namespace csv
 {
 SegmentLookupTable readSegmentValues(const std::vector<std::string> &paths);
+// Parses segment speeds from CSV data in memory, e.g. the body of a request
+SegmentLookupTable parseSegmentValues(const std::string &name, const std::string &data);
 TurnLookupTable readTurnValues(const std::vector<std::string> &paths);
 }
 }
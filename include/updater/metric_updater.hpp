@@ -0,0 +1,47 @@
+#ifndef OSRM_UPDATER_METRIC_UPDATER_HPP
+#define OSRM_UPDATER_METRIC_UPDATER_HPP
+
+#include "updater/source.hpp"
+
+#include "extractor/datasources.hpp"
+#include "storage/shared_datatype.hpp"
+
+#include "util/typedefs.hpp"
+
+#include <cstddef>
+
+namespace osrm
+{
+namespace updater
+{
+
+struct MetricUpdate
+{
+    // directed geometries with at least one changed segment
+    std::size_t segments = 0;
+    // edges of the multi-level graph with a changed weight or duration
+    std::size_t edges = 0;
+    // customized cells, summed over all levels
+    std::size_t cells = 0;
+};
+
+// Name of the datasource of all segments changed by live updates
+const constexpr char LIVE_DATASOURCE_NAME[] = "live traffic";
+
+// Returns the datasource of live updates, the first free datasource after the ones of the dataset
+// is named on the first update. Throws if all datasources are in use.
+DatasourceID getLiveDatasource(extractor::Datasources &datasources);
+
+// Applies segment speeds to a MLD dataset in memory and customizes the cells that contain
+// changed edges again. Only the metric blocks in metric_memory are written, all other blocks
+// are read from memory. Changed segments get the live datasource, whatever source the lookup
+// table names. Turn penalties are not updated.
+MetricUpdate updateMetric(const storage::DataLayout &layout,
+                          char *memory,
+                          const storage::DataLayout &metric_layout,
+                          char *metric_memory,
+                          const SegmentLookupTable &segment_speed_lookup);
+}
+}
+
+#endif
@@ -5,6 +5,7 @@
 
 #include <boost/optional.hpp>
 
+#include <algorithm>
 #include <vector>
 
 namespace osrm
@@ -0,0 +1,82 @@
+#ifndef OSRM_UPDATER_SPEED_CONVERSION_HPP
+#define OSRM_UPDATER_SPEED_CONVERSION_HPP
+
+#include "updater/source.hpp"
+
+#include "util/log.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/numeric/conversion/cast.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace osrm
+{
+namespace updater
+{
+
+// Returns duration in deci-seconds
+inline SegmentDuration convertToDuration(double speed_in_kmh, double distance_in_meters)
+{
+    if (speed_in_kmh <= 0.)
+        return INVALID_SEGMENT_DURATION;
+
+    const auto speed_in_ms = speed_in_kmh / 3.6;
+    const auto duration = distance_in_meters / speed_in_ms;
+    auto segment_duration = std::max<SegmentDuration>(
+        1, boost::numeric_cast<SegmentDuration>(std::round(duration * 10.)));
+    if (segment_duration >= INVALID_SEGMENT_DURATION)
+    {
+        util::Log(logWARNING) << "Clamping segment duration " << segment_duration << " to "
+                              << MAX_SEGMENT_DURATION;
+        segment_duration = MAX_SEGMENT_DURATION;
+    }
+    return segment_duration;
+}
+
+// Converts the rate of a SpeedSource to a segment weight:
+// if value.rate is not set, we fall back to duration
+//    this happens when there is no 4th column in the input CSV
+// if value.rate is set but NaN, we keep the existing weight
+//    this happens when there is an empty 4th column in the input CSV
+// otherwise, we use the value as the new rate
+inline SegmentWeight convertToWeight(const SegmentWeight existing_weight,
+                                     const SpeedSource &value,
+                                     double distance_in_meters,
+                                     double weight_multiplier)
+{
+    double rate = std::numeric_limits<double>::quiet_NaN();
+
+    if (!value.rate)
+    {
+        rate = value.speed / 3.6;
+    }
+    else
+    {
+        rate = *value.rate;
+        if (!std::isfinite(rate))
+        {
+            return existing_weight;
+        }
+    }
+
+    if (rate <= 0.)
+        return INVALID_SEGMENT_WEIGHT;
+
+    const auto weight = distance_in_meters / rate;
+    auto segment_weight = std::max<SegmentWeight>(
+        1, boost::numeric_cast<SegmentWeight>(std::round(weight * weight_multiplier)));
+    if (segment_weight >= INVALID_SEGMENT_WEIGHT)
+    {
+        util::Log(logWARNING) << "Clamping segment weight " << segment_weight << " to "
+                              << MAX_SEGMENT_WEIGHT;
+        segment_weight = MAX_SEGMENT_WEIGHT;
+    }
+    return segment_weight;
+}
+}
+}
+
+#endif
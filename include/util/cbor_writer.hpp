@@ -0,0 +1,230 @@
+#ifndef CBOR_WRITER_HPP
+#define CBOR_WRITER_HPP
+
+#include "util/coordinate.hpp"
+
+#include "osrm/json_container.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+namespace cbor
+{
+
+// Response encoded as CBOR (RFC 7049)
+struct Buffer
+{
+    std::vector<char> bytes;
+};
+
+/**
+ * Writes the same responses as json::Writer in the binary CBOR encoding (RFC 7049).
+ *
+ * Objects and arrays are written with indefinite length, numbers without fraction as integers
+ * and all others as 64 bit floats. The packed arrays are written as typed arrays (RFC 8746), a
+ * tagged byte string of little endian values that decoders can use without a conversion.
+ */
+class Writer
+{
+  public:
+    explicit Writer(std::vector<char> &out_) : out(out_) {}
+
+    void StartObject() { out.push_back(static_cast<char>(0xbf)); }
+    void EndObject() { out.push_back(static_cast<char>(0xff)); }
+    void StartArray() { out.push_back(static_cast<char>(0x9f)); }
+    void EndArray() { out.push_back(static_cast<char>(0xff)); }
+
+    void Key(const char *key) { WriteText(key, std::strlen(key)); }
+    void String(const std::string &string) { WriteText(string.data(), string.size()); }
+
+    void Number(const double number)
+    {
+        // integers are written in as few bytes as possible
+        if (number == std::trunc(number) && std::abs(number) < 9007199254740992.)
+        {
+            if (number >= 0)
+            {
+                WriteHead(MAJOR_UNSIGNED, static_cast<std::uint64_t>(number));
+            }
+            else
+            {
+                WriteHead(MAJOR_NEGATIVE, static_cast<std::uint64_t>(-1 - number));
+            }
+            return;
+        }
+
+        std::uint64_t bits;
+        std::memcpy(&bits, &number, sizeof(bits));
+        out.push_back(static_cast<char>(0xfb));
+        for (int shift = 56; shift >= 0; shift -= 8)
+        {
+            out.push_back(static_cast<char>(bits >> shift));
+        }
+    }
+
+    void Bool(const bool value) { out.push_back(static_cast<char>(value ? 0xf5 : 0xf4)); }
+    void Null() { out.push_back(static_cast<char>(0xf6)); }
+
+    // Array of get(*iter) as float64 typed array, NaN for missing values
+    template <typename Iter, typename GetFn> void NumberArray(Iter begin, Iter end, GetFn &&get)
+    {
+        WriteTypedArray(TAG_FLOAT64_LE, std::distance(begin, end), [&](auto write) {
+            for (; begin != end; ++begin)
+            {
+                const double number = get(*begin);
+                std::uint64_t bits;
+                std::memcpy(&bits, &number, sizeof(bits));
+                write(bits);
+            }
+        });
+    }
+
+    // Array of get(*iter) as uint64 typed array
+    template <typename Iter, typename GetFn> void IntegerArray(Iter begin, Iter end, GetFn &&get)
+    {
+        WriteTypedArray(TAG_UINT64_LE, std::distance(begin, end), [&](auto write) {
+            for (; begin != end; ++begin)
+            {
+                write(static_cast<std::uint64_t>(get(*begin)));
+            }
+        });
+    }
+
+    // Coordinates as a flat float64 typed array [lon, lat, lon, lat, ...]
+    template <typename Iter> void CoordinateArray(Iter begin, Iter end)
+    {
+        WriteTypedArray(TAG_FLOAT64_LE, 2 * std::distance(begin, end), [&](auto write) {
+            for (; begin != end; ++begin)
+            {
+                for (const double number : {static_cast<double>(toFloating(begin->lon)),
+                                            static_cast<double>(toFloating(begin->lat))})
+                {
+                    std::uint64_t bits;
+                    std::memcpy(&bits, &number, sizeof(bits));
+                    write(bits);
+                }
+            }
+        });
+    }
+
+    // Writes a (small) tree as a single value
+    void Value(const json::Value &value)
+    {
+        mapbox::util::apply_visitor(ValueWriter{*this}, value);
+    }
+
+  private:
+    static constexpr std::uint8_t MAJOR_UNSIGNED = 0;
+    static constexpr std::uint8_t MAJOR_NEGATIVE = 1;
+    static constexpr std::uint8_t MAJOR_BYTES = 2;
+    static constexpr std::uint8_t MAJOR_TEXT = 3;
+    static constexpr std::uint8_t MAJOR_ARRAY = 4;
+    static constexpr std::uint8_t MAJOR_MAP = 5;
+    static constexpr std::uint8_t MAJOR_TAG = 6;
+
+    static constexpr std::uint64_t TAG_UINT64_LE = 71;
+    static constexpr std::uint64_t TAG_FLOAT64_LE = 86;
+
+    struct ValueWriter
+    {
+        void operator()(const json::String &string) const { writer.String(string.value); }
+        void operator()(const json::Number &number) const { writer.Number(number.value); }
+        void operator()(const json::True &) const { writer.Bool(true); }
+        void operator()(const json::False &) const { writer.Bool(false); }
+        void operator()(const json::Null &) const { writer.Null(); }
+
+        void operator()(const json::Object &object) const
+        {
+            writer.WriteHead(MAJOR_MAP, object.values.size());
+            for (const auto &key_and_value : object.values)
+            {
+                writer.String(key_and_value.first);
+                mapbox::util::apply_visitor(*this, key_and_value.second);
+            }
+        }
+
+        void operator()(const json::Array &array) const
+        {
+            writer.WriteHead(MAJOR_ARRAY, array.values.size());
+            for (const auto &value : array.values)
+            {
+                mapbox::util::apply_visitor(*this, value);
+            }
+        }
+
+        Writer &writer;
+    };
+
+    // Major type and argument, the argument is written big endian in as few bytes as possible
+    void WriteHead(const std::uint8_t major, const std::uint64_t argument)
+    {
+        const auto type = static_cast<std::uint8_t>(major << 5);
+        if (argument < 24)
+        {
+            out.push_back(static_cast<char>(type | argument));
+            return;
+        }
+
+        int number_of_bytes = 8;
+        std::uint8_t additional = 27;
+        if (argument <= std::numeric_limits<std::uint8_t>::max())
+        {
+            number_of_bytes = 1;
+            additional = 24;
+        }
+        else if (argument <= std::numeric_limits<std::uint16_t>::max())
+        {
+            number_of_bytes = 2;
+            additional = 25;
+        }
+        else if (argument <= std::numeric_limits<std::uint32_t>::max())
+        {
+            number_of_bytes = 4;
+            additional = 26;
+        }
+
+        out.push_back(static_cast<char>(type | additional));
+        for (int shift = 8 * (number_of_bytes - 1); shift >= 0; shift -= 8)
+        {
+            out.push_back(static_cast<char>(argument >> shift));
+        }
+    }
+
+    void WriteText(const char *text, const std::size_t size)
+    {
+        WriteHead(MAJOR_TEXT, size);
+        out.insert(out.end(), text, text + size);
+    }
+
+    // Tagged byte string of size 64 bit values, write is called with a function that appends
+    // one value in little endian order
+    template <typename WriteValuesFn>
+    void WriteTypedArray(const std::uint64_t tag, const std::size_t size, WriteValuesFn &&write)
+    {
+        WriteHead(MAJOR_TAG, tag);
+        WriteHead(MAJOR_BYTES, size * sizeof(std::uint64_t));
+        write([this](const std::uint64_t value) {
+            for (int shift = 0; shift < 64; shift += 8)
+            {
+                out.push_back(static_cast<char>(value >> shift));
+            }
+        });
+    }
+
+    std::vector<char> &out;
+};
+
+} // namespace cbor
+} // namespace util
+} // namespace osrm
+
+#endif // CBOR_WRITER_HPP
@@ -9,9 +9,10 @@ namespace osrm
 namespace util
 {
 
-inline std::vector<std::vector<bool>>
+template <typename NodeDataT>
+std::vector<std::vector<bool>>
 excludeFlagsToNodeFilter(const NodeID number_of_nodes,
-                         const extractor::EdgeBasedNodeDataContainer &node_data,
+                         const NodeDataT &node_data,
                          const extractor::ProfileProperties &properties)
 {
     std::vector<std::vector<bool>> filters;
@@ -0,0 +1,188 @@
+#ifndef JSON_WRITER_HPP
+#define JSON_WRITER_HPP
+
+#include "util/cast.hpp"
+#include "util/coordinate.hpp"
+#include "util/json_renderer.hpp"
+#include "util/string_util.hpp"
+
+#include "osrm/json_container.hpp"
+
+#include <boost/assert.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+namespace json
+{
+
+// Writes JSON text straight into a buffer, without building an Object tree first.
+//
+// The output has the same formatting as render(std::vector<char> &, const Object &): numbers
+// are written with up to 6 decimal places, strings are escaped and keys are written verbatim.
+// Objects and arrays must be closed in the reverse order they were started, every value in an
+// object has to be preceded by its Key.
+class Writer
+{
+  public:
+    explicit Writer(std::vector<char> &out_) : out(out_) {}
+
+    void StartObject()
+    {
+        Separate();
+        out.push_back('{');
+        is_first.push_back(true);
+    }
+
+    void EndObject()
+    {
+        BOOST_ASSERT(!is_first.empty() && !has_key);
+        is_first.pop_back();
+        out.push_back('}');
+    }
+
+    void StartArray()
+    {
+        Separate();
+        out.push_back('[');
+        is_first.push_back(true);
+    }
+
+    void EndArray()
+    {
+        BOOST_ASSERT(!is_first.empty());
+        is_first.pop_back();
+        out.push_back(']');
+    }
+
+    void Key(const char *key)
+    {
+        BOOST_ASSERT(!is_first.empty() && !has_key);
+        Separate();
+        out.push_back('\"');
+        out.insert(out.end(), key, key + std::strlen(key));
+        out.push_back('\"');
+        out.push_back(':');
+        has_key = true;
+    }
+
+    void String(const std::string &string)
+    {
+        Separate();
+        out.push_back('\"');
+        const auto escaped = escape_JSON(string);
+        out.insert(out.end(), escaped.begin(), escaped.end());
+        out.push_back('\"');
+    }
+
+    void Number(const double number)
+    {
+        Separate();
+        const auto number_string = cast::to_string_with_precision(number);
+        out.insert(out.end(), number_string.begin(), number_string.end());
+    }
+
+    void Bool(const bool value)
+    {
+        Separate();
+        const char *text = value ? "true" : "false";
+        out.insert(out.end(), text, text + std::strlen(text));
+    }
+
+    void Null()
+    {
+        Separate();
+        const char text[] = "null";
+        out.insert(out.end(), text, text + sizeof(text) - 1);
+    }
+
+    // Array of get(*iter), NaN is written as null
+    template <typename Iter, typename GetFn> void NumberArray(Iter begin, Iter end, GetFn &&get)
+    {
+        StartArray();
+        for (; begin != end; ++begin)
+        {
+            const double number = get(*begin);
+            if (std::isnan(number))
+            {
+                Null();
+            }
+            else
+            {
+                Number(number);
+            }
+        }
+        EndArray();
+    }
+
+    // Array of get(*iter), integers are written as numbers as well
+    template <typename Iter, typename GetFn> void IntegerArray(Iter begin, Iter end, GetFn &&get)
+    {
+        StartArray();
+        for (; begin != end; ++begin)
+        {
+            Number(static_cast<double>(get(*begin)));
+        }
+        EndArray();
+    }
+
+    // Coordinates as [[lon, lat], ...]
+    template <typename Iter> void CoordinateArray(Iter begin, Iter end)
+    {
+        StartArray();
+        for (; begin != end; ++begin)
+        {
+            StartArray();
+            Number(static_cast<double>(toFloating(begin->lon)));
+            Number(static_cast<double>(toFloating(begin->lat)));
+            EndArray();
+        }
+        EndArray();
+    }
+
+    // Renders a (small) tree as a single value
+    void Value(const util::json::Value &value)
+    {
+        Separate();
+        mapbox::util::apply_visitor(ArrayRenderer(out), value);
+    }
+
+  private:
+    // Writes the comma in front of all but the first element of an array or object
+    void Separate()
+    {
+        if (has_key)
+        {
+            has_key = false;
+            return;
+        }
+
+        if (!is_first.empty())
+        {
+            if (is_first.back())
+            {
+                is_first.back() = false;
+            }
+            else
+            {
+                out.push_back(',');
+            }
+        }
+    }
+
+    std::vector<char> &out;
+    std::vector<bool> is_first;
+    bool has_key = false;
+};
+
+} // namespace json
+} // namespace util
+} // namespace osrm
+
+#endif // JSON_WRITER_HPP
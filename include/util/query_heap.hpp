@@ -8,6 +8,7 @@
 #include <limits>
 #include <map>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -21,13 +22,13 @@ template <typename NodeID, typename Key> class GenerationArrayStorage
 
   public:
     explicit GenerationArrayStorage(std::size_t size)
-        : positions(size, 0), generation(1), generations(size, 0)
+        : generation(1), generations(size, 0), positions(size, 0)
     {
     }
 
     Key &operator[](NodeID node)
     {
-        generation[node] = generation;
+        generations[node] = generation;
         return positions[node];
     }
 
@@ -126,6 +127,52 @@ template <typename NodeID, typename Key> class UnorderedMapStorage
     std::unordered_map<NodeID, Key> nodes;
 };
 
+// Keeps the positions of node IDs below `dense_size` in a GenerationArrayStorage and all other
+// positions in a hash map. This bounds the memory of the dense array while the nodes that are
+// touched most (e.g. the overlay nodes which the MLD partitioner numbers first) avoid hashing.
+// A `dense_size` of 0 makes this a pure hash map, `dense_size == size` a pure array.
+template <typename NodeID, typename Key> class TwoLevelStorage
+{
+  public:
+    explicit TwoLevelStorage(std::size_t size) : TwoLevelStorage(size, size) {}
+
+    TwoLevelStorage(std::size_t size, std::size_t dense_size)
+        : dense_size(std::min(size, dense_size)), dense(this->dense_size), sparse(size)
+    {
+    }
+
+    Key &operator[](const NodeID node)
+    {
+        if (node < dense_size)
+        {
+            return dense[node];
+        }
+        return sparse[node];
+    }
+
+    Key peek_index(const NodeID node) const
+    {
+        if (node < dense_size)
+        {
+            return dense.peek_index(node);
+        }
+        return sparse.peek_index(node);
+    }
+
+    void Clear()
+    {
+        dense.Clear();
+        sparse.Clear();
+    }
+
+    std::size_t DenseSize() const { return dense_size; }
+
+  private:
+    std::size_t dense_size;
+    GenerationArrayStorage<NodeID, Key> dense;
+    UnorderedMapStorage<NodeID, Key> sparse;
+};
+
 template <typename NodeID,
           typename Key,
           typename Weight,
@@ -136,8 +183,17 @@ class QueryHeap
   public:
     using WeightType = Weight;
     using DataType = Data;
+    using StorageType = IndexStorage;
+
+    // additional arguments are passed on to the index storage
+    template <typename... StorageArgs>
+    explicit QueryHeap(std::size_t maxID, StorageArgs &&... storage_args)
+        : node_index(maxID, std::forward<StorageArgs>(storage_args)...)
+    {
+        Clear();
+    }
 
-    explicit QueryHeap(std::size_t maxID) : node_index(maxID) { Clear(); }
+    const IndexStorage &GetIndexStorage() const { return node_index; }
 
     void Clear()
     {
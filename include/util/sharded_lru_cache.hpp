@@ -0,0 +1,150 @@
+#ifndef OSRM_UTIL_SHARDED_LRU_CACHE_HPP
+#define OSRM_UTIL_SHARDED_LRU_CACHE_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace osrm
+{
+namespace util
+{
+
+// Every entry counts as 1, the capacity of the cache is a number of entries
+struct UnitSize
+{
+    template <typename Value> std::size_t operator()(const Value &) const { return 1; }
+};
+
+/**
+ * A least recently used cache that can be used by many threads at once.
+ *
+ * Entries are spread over shards by their hash, every shard is an LRU list with its own lock that
+ * holds at most 1/16 of the capacity. `SizeFn` returns the size of a value in the unit of the
+ * capacity, e.g. its estimated number of bytes. Values that don't fit into a shard are not cached.
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>, typename SizeFn = UnitSize>
+class ShardedLRUCache
+{
+  public:
+    static constexpr std::size_t NUMBER_OF_SHARDS = 16;
+
+    explicit ShardedLRUCache(std::size_t capacity)
+        : capacity(capacity),
+          capacity_per_shard(std::max<std::size_t>(1, capacity / NUMBER_OF_SHARDS))
+    {
+    }
+
+    // Copies the value of the key and marks it as most recently used
+    bool Get(const Key &key, Value &value)
+    {
+        auto &shard = GetShard(key);
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+
+            const auto iter = shard.index.find(key);
+            if (iter != shard.index.end())
+            {
+                shard.entries.splice(shard.entries.begin(), shard.entries, iter->second);
+                value = iter->second->second;
+                ++hits;
+                return true;
+            }
+        }
+
+        ++misses;
+        return false;
+    }
+
+    // Evicts the least recently used entries of the shard until the value fits, an existing
+    // value of the key is kept
+    void Put(const Key &key, const Value &value)
+    {
+        const auto value_size = SizeFn()(value);
+        if (value_size > capacity_per_shard)
+        {
+            return;
+        }
+
+        auto &shard = GetShard(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        if (shard.index.count(key) > 0)
+        {
+            return;
+        }
+
+        while (shard.size + value_size > capacity_per_shard)
+        {
+            shard.size -= SizeFn()(shard.entries.back().second);
+            shard.index.erase(shard.entries.back().first);
+            shard.entries.pop_back();
+        }
+
+        shard.entries.emplace_front(key, value);
+        shard.index.emplace(key, shard.entries.begin());
+        shard.size += value_size;
+    }
+
+    std::size_t GetCapacity() const { return capacity; }
+
+    std::size_t GetNumberOfEntries() const
+    {
+        std::size_t number_of_entries = 0;
+        for (auto &shard : shards)
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            number_of_entries += shard.index.size();
+        }
+        return number_of_entries;
+    }
+
+    // Sum of the sizes of all values
+    std::size_t GetSize() const
+    {
+        std::size_t size = 0;
+        for (auto &shard : shards)
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            size += shard.size;
+        }
+        return size;
+    }
+
+    std::uint64_t GetHits() const { return hits.load(); }
+    std::uint64_t GetMisses() const { return misses.load(); }
+
+  private:
+    struct Shard
+    {
+        using EntryList = std::list<std::pair<Key, Value>>;
+
+        std::mutex mutex;
+        EntryList entries; // most recently used first
+        std::unordered_map<Key, typename EntryList::iterator, Hash> index;
+        std::size_t size = 0;
+    };
+
+    Shard &GetShard(const Key &key)
+    {
+        // the low bits of the hash pick the bucket inside of the shard
+        return shards[(Hash()(key) >> 16) % NUMBER_OF_SHARDS];
+    }
+
+    const std::size_t capacity;
+    const std::size_t capacity_per_shard;
+    mutable std::array<Shard, NUMBER_OF_SHARDS> shards;
+
+    std::atomic<std::uint64_t> hits{0};
+    std::atomic<std::uint64_t> misses{0};
+};
+}
+}
+
+#endif
@@ -29,10 +29,13 @@
 
 #include <algorithm>
 #include <array>
+#include <functional>
 #include <limits>
 #include <memory>
 #include <queue>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 // An extended alignment is implementation-defined, so use compiler attributes
@@ -173,6 +176,30 @@ class StaticRTree
         Rectangle minimum_bounding_rectangle;
     };
 
+    /**
+     * Shared state of the nearest queries of coordinates that are close to each other,
+     * see MakeQueryGroup.
+     *
+     * The frontier holds the tree nodes that don't intersect the bounding box of the
+     * coordinates and the leaves that do. Together they cover the whole tree, so a query can
+     * start from them instead of walking down from the root. The segments of the leaves are
+     * projected once and reused by all following queries of the group.
+     */
+    class QueryGroup
+    {
+        friend class StaticRTree;
+
+        struct ProjectedSegment
+        {
+            FloatCoordinate projected_u;
+            FloatCoordinate projected_v;
+        };
+
+        std::vector<std::pair<TreeIndex, Rectangle>> frontier;
+        // projected segments of the leaves by their offset
+        std::unordered_map<std::uint32_t, std::vector<ProjectedSegment>> leaves;
+    };
+
   private:
     /**
      * A lightweight wrapper for the Hilbert Code for each EdgeDataT object
@@ -604,13 +631,125 @@ class StaticRTree
                                    const FilterT filter,
                                    const TerminationT terminate) const
     {
-        std::vector<EdgeDataT> results;
         auto projected_coordinate = web_mercator::fromWGS84(input_coordinate);
         Coordinate fixed_projected_coordinate{projected_coordinate};
         // initialize queue with root element
         std::priority_queue<QueryCandidate> traversal_queue;
         traversal_queue.push(QueryCandidate{0, TreeIndex{}});
 
+        return Nearest(traversal_queue,
+                       fixed_projected_coordinate,
+                       projected_coordinate,
+                       filter,
+                       terminate,
+                       nullptr);
+    }
+
+    /**
+     * Collects the frontier of the queries for the coordinates [begin, end), see QueryGroup.
+     * Nodes that intersect the bounding box of the coordinates are expanded level by level,
+     * as long as the frontier stays small enough to be copied into every query.
+     */
+    template <typename IteratorT> QueryGroup MakeQueryGroup(IteratorT begin, IteratorT end) const
+    {
+        Rectangle bounding_box;
+        for (auto iter = begin; iter != end; ++iter)
+        {
+            const Coordinate fixed_projected_coordinate{web_mercator::fromWGS84(*iter)};
+            bounding_box.min_lon = std::min(bounding_box.min_lon, fixed_projected_coordinate.lon);
+            bounding_box.max_lon = std::max(bounding_box.max_lon, fixed_projected_coordinate.lon);
+            bounding_box.min_lat = std::min(bounding_box.min_lat, fixed_projected_coordinate.lat);
+            bounding_box.max_lat = std::max(bounding_box.max_lat, fixed_projected_coordinate.lat);
+        }
+
+        QueryGroup group;
+        std::vector<TreeIndex> expanded_nodes = {TreeIndex{}};
+        while (!expanded_nodes.empty())
+        {
+            if (group.frontier.size() + expanded_nodes.size() * BRANCHING_FACTOR >
+                MAX_FRONTIER_SIZE)
+            {
+                for (const auto &tree_index : expanded_nodes)
+                {
+                    group.frontier.emplace_back(tree_index, GetRectangle(tree_index));
+                }
+                break;
+            }
+
+            std::vector<TreeIndex> next_nodes;
+            for (const auto &parent : expanded_nodes)
+            {
+                if (is_leaf(parent))
+                {
+                    group.frontier.emplace_back(parent, GetRectangle(parent));
+                    continue;
+                }
+
+                for (const auto child_index : child_indexes(parent))
+                {
+                    const TreeIndex child(parent.level + 1,
+                                          child_index - m_tree_level_starts[parent.level + 1]);
+                    const auto &child_rectangle =
+                        m_search_tree[child_index].minimum_bounding_rectangle;
+                    if (child_rectangle.Intersects(bounding_box))
+                    {
+                        next_nodes.push_back(child);
+                    }
+                    else
+                    {
+                        group.frontier.emplace_back(child, child_rectangle);
+                    }
+                }
+            }
+            expanded_nodes = std::move(next_nodes);
+        }
+
+        return group;
+    }
+
+    // Same as above for a coordinate of the group, the results are the same as without it.
+    template <typename FilterT, typename TerminationT>
+    std::vector<EdgeDataT> Nearest(QueryGroup &group,
+                                   const Coordinate input_coordinate,
+                                   const FilterT filter,
+                                   const TerminationT terminate) const
+    {
+        auto projected_coordinate = web_mercator::fromWGS84(input_coordinate);
+        Coordinate fixed_projected_coordinate{projected_coordinate};
+        // initialize queue with the frontier of the group
+        std::vector<QueryCandidate> candidates;
+        candidates.reserve(group.frontier.size());
+        for (const auto &tree_index_and_rectangle : group.frontier)
+        {
+            candidates.emplace_back(
+                tree_index_and_rectangle.second.GetMinSquaredDist(fixed_projected_coordinate),
+                tree_index_and_rectangle.first);
+        }
+        std::priority_queue<QueryCandidate> traversal_queue(std::less<QueryCandidate>(),
+                                                            std::move(candidates));
+
+        return Nearest(traversal_queue,
+                       fixed_projected_coordinate,
+                       projected_coordinate,
+                       filter,
+                       terminate,
+                       &group);
+    }
+
+  private:
+    // Frontier of a QueryGroup that the nodes are not expanded beyond
+    static constexpr std::size_t MAX_FRONTIER_SIZE = 4 * BRANCHING_FACTOR;
+
+    template <typename FilterT, typename TerminationT>
+    std::vector<EdgeDataT> Nearest(std::priority_queue<QueryCandidate> &traversal_queue,
+                                   const Coordinate fixed_projected_coordinate,
+                                   const FloatCoordinate &projected_coordinate,
+                                   const FilterT filter,
+                                   const TerminationT terminate,
+                                   QueryGroup *group) const
+    {
+        std::vector<EdgeDataT> results;
+
         while (!traversal_queue.empty())
         {
             QueryCandidate current_query_node = traversal_queue.top();
@@ -624,7 +763,8 @@ class StaticRTree
                     ExploreLeafNode(current_tree_index,
                                     fixed_projected_coordinate,
                                     projected_coordinate,
-                                    traversal_queue);
+                                    traversal_queue,
+                                    group);
                 }
                 else
                 {
@@ -663,33 +803,50 @@ class StaticRTree
         return results;
     }
 
-  private:
     /**
      * Iterates over all the objects in a leaf node and inserts them into our
      * search priority queue.  The speed of this function is very much governed
      * by the value of LEAF_NODE_SIZE, as we'll calculate the euclidean distance
      * for every child of each leaf node visited.
+     * Within a QueryGroup the projected segments of the leaf are computed only once.
      */
     template <typename QueueT>
     void ExploreLeafNode(const TreeIndex &leaf_id,
                          const Coordinate &projected_input_coordinate_fixed,
                          const FloatCoordinate &projected_input_coordinate,
-                         QueueT &traversal_queue) const
+                         QueueT &traversal_queue,
+                         QueryGroup *group) const
     {
         // Check that we're actually looking at the bottom level of the tree
         BOOST_ASSERT(is_leaf(leaf_id));
 
-        for (const auto i : child_indexes(leaf_id))
+        const auto leaf_indexes = child_indexes(leaf_id);
+        const typename QueryGroup::ProjectedSegment *projected_segments = nullptr;
+        if (group)
         {
-            const auto &current_edge = m_objects[i];
+            auto &segments = group->leaves[leaf_id.offset];
+            if (segments.empty())
+            {
+                segments.reserve(leaf_indexes.size());
+                for (const auto i : leaf_indexes)
+                {
+                    segments.push_back(ProjectSegment(m_objects[i]));
+                }
+            }
+            projected_segments = segments.data();
+        }
 
-            const auto projected_u = web_mercator::fromWGS84(m_coordinate_list[current_edge.u]);
-            const auto projected_v = web_mercator::fromWGS84(m_coordinate_list[current_edge.v]);
+        for (const auto i : leaf_indexes)
+        {
+            const auto projected_segment = projected_segments
+                                               ? projected_segments[i - leaf_indexes.front()]
+                                               : ProjectSegment(m_objects[i]);
 
             FloatCoordinate projected_nearest;
             std::tie(std::ignore, projected_nearest) =
-                coordinate_calculation::projectPointOnSegment(
-                    projected_u, projected_v, projected_input_coordinate);
+                coordinate_calculation::projectPointOnSegment(projected_segment.projected_u,
+                                                              projected_segment.projected_v,
+                                                              projected_input_coordinate);
 
             const auto squared_distance = coordinate_calculation::squaredEuclideanDistance(
                 projected_input_coordinate_fixed, projected_nearest);
@@ -703,6 +860,18 @@ class StaticRTree
         }
     }
 
+    typename QueryGroup::ProjectedSegment ProjectSegment(const EdgeDataT &edge) const
+    {
+        return {web_mercator::fromWGS84(m_coordinate_list[edge.u]),
+                web_mercator::fromWGS84(m_coordinate_list[edge.v])};
+    }
+
+    const Rectangle &GetRectangle(const TreeIndex &tree_index) const
+    {
+        return m_search_tree[m_tree_level_starts[tree_index.level] + tree_index.offset]
+            .minimum_bounding_rectangle;
+    }
+
     /**
      * Iterates over all the children of a TreeNode and inserts them into the search
      * priority queue using their distance from the search coordinate as the
@@ -300,6 +300,13 @@ function setup()
       "route"
     },
 
+    -- process_way only reads way tags, ways with equal tags get the same result
+    process_way_cache = true,
+
+    -- computes the turn penalties of process_turn below in C++, to call the Lua
+    -- process_turn instead remove this line and return process_turn at the end of the file
+    native_turn_function = 'car',
+
     -- classify highway tags when necessary for turn weights
     highway_turn_classification = {
     },
@@ -475,6 +482,5 @@ end
 return {
   setup = setup,
   process_way = process_way,
-  process_node = process_node,
-  process_turn = process_turn
+  process_node = process_node
 }
@@ -22,16 +22,22 @@ int main(int argc, const char *argv[]) try
 {
     if (argc < 2)
     {
-        std::cerr << "Usage: " << argv[0] << " data.osrm\n";
+        std::cerr << "Usage: " << argv[0] << " data.osrm [CH|MLD|CCH]\n";
         return EXIT_FAILURE;
     }
 
     using namespace osrm;
 
+    const std::string algorithm = argc > 2 ? argv[2] : "CH";
+
     // Configure based on a .osrm base path, and no datasets in shared mem from osrm-datastore
     EngineConfig config;
     config.storage_config = {argv[1]};
     config.use_shared_memory = false;
+    if (algorithm == "MLD")
+        config.algorithm = EngineConfig::Algorithm::MLD;
+    else if (algorithm == "CCH")
+        config.algorithm = EngineConfig::Algorithm::CCH;
 
     // Routing machine with several services (such as Route, Table, Nearest, Trip, Match)
     OSRM osrm{config};
@@ -226,6 +232,7 @@ int main(int argc, const char *argv[]) try
               << " coordinate" << std::endl;
     std::cout << (TIMER_MSEC(routes) / NUM / params.coordinates.size()) << "ms/coordinate"
               << std::endl;
+    std::cout << (NUM / TIMER_SEC(routes)) << " traces/s with " << algorithm << std::endl;
 
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,147 @@
+#include "util/timing_util.hpp"
+
+#include "osrm/coordinate.hpp"
+#include "osrm/engine_config.hpp"
+#include "osrm/json_container.hpp"
+#include "osrm/osrm.hpp"
+#include "osrm/route_parameters.hpp"
+#include "osrm/status.hpp"
+
+#include <boost/lexical_cast.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace osrm;
+
+namespace
+{
+// Resident set size of the process in bytes
+std::size_t residentBytes()
+{
+    std::size_t pages = 0, resident_pages = 0;
+    std::ifstream statm("/proc/self/statm");
+    statm >> pages >> resident_pages;
+    return resident_pages * sysconf(_SC_PAGESIZE);
+}
+
+struct Result
+{
+    double p50_ms;
+    double p99_ms;
+    std::size_t thread_bytes;
+    std::size_t failed;
+};
+
+// Runs all queries on a fresh thread, so the thread local heaps are allocated by this run
+Result run(const OSRM &osrm, const std::vector<RouteParameters> &queries)
+{
+    Result result;
+    std::thread worker([&] {
+        const auto resident_before = residentBytes();
+
+        std::vector<double> latencies;
+        latencies.reserve(queries.size());
+        result.failed = 0;
+        for (const auto &params : queries)
+        {
+            json::Object response;
+            TIMER_START(query);
+            const auto rc = osrm.Route(params, response);
+            TIMER_STOP(query);
+            latencies.push_back(TIMER_MSEC(query));
+            result.failed += rc != Status::Ok;
+        }
+
+        const auto resident_after = residentBytes();
+        result.thread_bytes = resident_after > resident_before ? resident_after - resident_before : 0;
+
+        std::sort(latencies.begin(), latencies.end());
+        result.p50_ms = latencies[latencies.size() / 2];
+        result.p99_ms = latencies[latencies.size() * 99 / 100];
+    });
+    worker.join();
+    return result;
+}
+}
+
+int main(int argc, const char *argv[]) try
+{
+    if (argc < 3)
+    {
+        std::cerr << "Usage: " << argv[0]
+                  << " data.osrm <CH|MLD> [min_lon min_lat max_lon max_lat] [num_queries]\n";
+        return EXIT_FAILURE;
+    }
+
+    const std::string algorithm = argv[2];
+    // defaults to Monaco, use the bounding box of the extract to benchmark
+    double min_lon = 7.409, min_lat = 43.725, max_lon = 7.439, max_lat = 43.751;
+    if (argc >= 7)
+    {
+        min_lon = boost::lexical_cast<double>(argv[3]);
+        min_lat = boost::lexical_cast<double>(argv[4]);
+        max_lon = boost::lexical_cast<double>(argv[5]);
+        max_lat = boost::lexical_cast<double>(argv[6]);
+    }
+    const std::size_t num_queries = argc >= 8 ? boost::lexical_cast<std::size_t>(argv[7]) : 1000;
+
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> lon(min_lon, max_lon);
+    std::uniform_real_distribution<double> lat(min_lat, max_lat);
+
+    std::vector<RouteParameters> queries(num_queries);
+    for (auto &params : queries)
+    {
+        params.overview = RouteParameters::OverviewType::False;
+        params.steps = false;
+        for (auto i = 0; i < 2; ++i)
+        {
+            params.coordinates.push_back(util::FloatCoordinate{
+                util::FloatLongitude{lon(generator)}, util::FloatLatitude{lat(generator)}});
+        }
+    }
+
+    const std::vector<std::pair<std::string, EngineConfig::HeapStorage>> storages = {
+        {"HashMap", EngineConfig::HeapStorage::HashMap},
+        {"Array", EngineConfig::HeapStorage::Array},
+        {"TwoLevel", EngineConfig::HeapStorage::TwoLevel}};
+
+    for (const auto &storage : storages)
+    {
+        EngineConfig config;
+        config.storage_config = {argv[1]};
+        config.use_shared_memory = false;
+        config.algorithm =
+            algorithm == "MLD" ? EngineConfig::Algorithm::MLD : EngineConfig::Algorithm::CH;
+        config.query_heap_storage = storage.second;
+
+        OSRM osrm{config};
+
+        // the first run warms up the page cache so the first storage type is not penalized,
+        // its heaps are freed when its thread exits, so it also yields the memory per thread
+        const auto cold = run(osrm, queries);
+        const auto warm = run(osrm, queries);
+
+        std::cout << storage.first << ": p50 " << warm.p50_ms << "ms, p99 " << warm.p99_ms
+                  << "ms, heap memory per thread " << (cold.thread_bytes / 1024) << " kB, "
+                  << warm.failed << "/" << num_queries << " queries failed" << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
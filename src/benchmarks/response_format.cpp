@@ -0,0 +1,141 @@
+#include "util/json_renderer.hpp"
+#include "util/timing_util.hpp"
+
+#include "engine/api/base_result.hpp"
+
+#include "osrm/route_parameters.hpp"
+#include "osrm/table_parameters.hpp"
+
+#include "osrm/coordinate.hpp"
+#include "osrm/engine_config.hpp"
+#include "osrm/json_container.hpp"
+
+#include "osrm/osrm.hpp"
+#include "osrm/status.hpp"
+
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <cstdlib>
+
+using namespace osrm;
+
+namespace
+{
+
+// Runs the query NUM times for each output format and reports time and response size
+template <typename ParametersT, typename QueryFn>
+bool benchmark(const std::string &name, const ParametersT &params, QueryFn &&query)
+{
+    const auto NUM = 100;
+
+    std::size_t rendered_size = 0;
+    TIMER_START(rendered);
+    for (int i = 0; i < NUM; ++i)
+    {
+        engine::api::ResultT result = json::Object();
+        if (query(params, result) != Status::Ok)
+            return false;
+        std::vector<char> rendered;
+        util::json::render(rendered, result.get<json::Object>());
+        rendered_size = rendered.size();
+    }
+    TIMER_STOP(rendered);
+
+    std::size_t written_size = 0;
+    TIMER_START(written);
+    for (int i = 0; i < NUM; ++i)
+    {
+        engine::api::ResultT result = std::vector<char>();
+        if (query(params, result) != Status::Ok)
+            return false;
+        written_size = result.get<std::vector<char>>().size();
+    }
+    TIMER_STOP(written);
+
+    std::size_t cbor_size = 0;
+    TIMER_START(cbor);
+    for (int i = 0; i < NUM; ++i)
+    {
+        engine::api::ResultT result = util::cbor::Buffer();
+        if (query(params, result) != Status::Ok)
+            return false;
+        cbor_size = result.get<util::cbor::Buffer>().bytes.size();
+    }
+    TIMER_STOP(cbor);
+
+    std::cout << name << ":" << std::endl;
+    std::cout << "  json::Object + render: " << (TIMER_MSEC(rendered) / NUM) << "ms/req "
+              << rendered_size << " bytes" << std::endl;
+    std::cout << "  json::Writer:          " << (TIMER_MSEC(written) / NUM) << "ms/req "
+              << written_size << " bytes" << std::endl;
+    std::cout << "  cbor::Writer:          " << (TIMER_MSEC(cbor) / NUM) << "ms/req " << cbor_size
+              << " bytes" << std::endl;
+    return true;
+}
+}
+
+int main(int argc, const char *argv[]) try
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " data.osrm\n";
+        return EXIT_FAILURE;
+    }
+
+    // Configure based on a .osrm base path, and no datasets in shared mem from osrm-datastore
+    EngineConfig config;
+    config.storage_config = {argv[1]};
+    config.use_shared_memory = false;
+
+    OSRM osrm{config};
+
+    using osrm::util::FloatCoordinate;
+    using osrm::util::FloatLatitude;
+    using osrm::util::FloatLongitude;
+
+    // Grid of 10x10 coordinates in monaco
+    std::vector<FloatCoordinate> coordinates;
+    for (int x = 0; x < 10; ++x)
+    {
+        for (int y = 0; y < 10; ++y)
+        {
+            coordinates.push_back(FloatCoordinate{FloatLongitude{7.410 + 0.002 * x},
+                                                  FloatLatitude{43.727 + 0.001 * y}});
+        }
+    }
+
+    TableParameters table_params;
+    table_params.coordinates.assign(coordinates.begin(), coordinates.end());
+    table_params.annotations = TableParameters::AnnotationsType::All;
+
+    RouteParameters route_params;
+    route_params.coordinates.push_back(coordinates.front());
+    route_params.coordinates.push_back(coordinates.back());
+    route_params.steps = true;
+    route_params.annotations = true;
+    route_params.geometries = RouteParameters::GeometriesType::GeoJSON;
+    route_params.overview = RouteParameters::OverviewType::Full;
+
+    const auto table = [&](const TableParameters &params, engine::api::ResultT &result) {
+        return osrm.Table(params, result);
+    };
+    const auto route = [&](const RouteParameters &params, engine::api::ResultT &result) {
+        return osrm.Route(params, result);
+    };
+
+    if (!benchmark("table 100x100", table_params, table) ||
+        !benchmark("route with steps and annotations", route_params, route))
+    {
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
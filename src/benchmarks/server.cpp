@@ -0,0 +1,153 @@
+#include "server/api/parsed_url.hpp"
+#include "server/server.hpp"
+#include "server/service_handler.hpp"
+
+#include "util/json_container.hpp"
+#include "util/timing_util.hpp"
+
+#include "osrm/status.hpp"
+
+#include <boost/asio.hpp>
+
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+using namespace osrm;
+
+namespace
+{
+// Answers every request with a constant response so only the cost of the transport is measured
+class ConstantServiceHandler final : public server::ServiceHandlerInterface
+{
+  public:
+    engine::Status RunQuery(server::api::ParsedURL, server::ServiceHandler::ResultT &result) override
+    {
+        result = util::json::Object();
+        result.get<util::json::Object>().values["code"] = "Ok";
+        return engine::Status::Ok;
+    }
+
+    engine::Status UpdateSegmentSpeeds(const std::string &,
+                                       const std::string &,
+                                       util::json::Object &result) override
+    {
+        result.values["code"] = "NotImplemented";
+        return engine::Status::Error;
+    }
+};
+
+const std::string request_path = "/nearest/v1/driving/7.419758,43.731142";
+
+// Reads one reply of the given connection and returns the number of body bytes
+std::size_t readReply(boost::asio::ip::tcp::socket &socket, boost::asio::streambuf &buffer)
+{
+    const auto header_size = boost::asio::read_until(socket, buffer, "\r\n\r\n");
+    std::string headers(boost::asio::buffers_begin(buffer.data()),
+                        boost::asio::buffers_begin(buffer.data()) + header_size);
+    buffer.consume(header_size);
+
+    const auto length_begin = headers.find("Content-Length: ");
+    if (length_begin == std::string::npos)
+        throw std::runtime_error("reply without Content-Length");
+    const std::size_t content_length = std::stoul(headers.substr(length_begin + 16));
+
+    if (buffer.size() < content_length)
+        boost::asio::read(
+            socket, buffer, boost::asio::transfer_exactly(content_length - buffer.size()));
+    buffer.consume(content_length);
+
+    return content_length;
+}
+
+// A new TCP connection for every request, like osrm-routed used to force on its clients
+double runWithoutReuse(boost::asio::io_service &io_service,
+                       const boost::asio::ip::tcp::endpoint &endpoint,
+                       const unsigned num_requests)
+{
+    const std::string request = "GET " + request_path + " HTTP/1.1\r\nConnection: close\r\n\r\n";
+
+    TIMER_START(requests);
+    for (unsigned i = 0; i < num_requests; ++i)
+    {
+        boost::asio::ip::tcp::socket socket(io_service);
+        socket.connect(endpoint);
+        boost::asio::write(socket, boost::asio::buffer(request));
+        boost::asio::streambuf buffer;
+        readReply(socket, buffer);
+    }
+    TIMER_STOP(requests);
+
+    return num_requests / (TIMER_MSEC(requests) / 1000.);
+}
+
+// One persistent connection, optionally sending `pipeline_depth` requests before reading
+double runWithReuse(boost::asio::io_service &io_service,
+                    const boost::asio::ip::tcp::endpoint &endpoint,
+                    const unsigned num_requests,
+                    const unsigned pipeline_depth)
+{
+    const std::string request = "GET " + request_path + " HTTP/1.1\r\n\r\n";
+    std::string batch;
+    for (unsigned i = 0; i < pipeline_depth; ++i)
+        batch += request;
+
+    boost::asio::ip::tcp::socket socket(io_service);
+    socket.connect(endpoint);
+    socket.set_option(boost::asio::ip::tcp::no_delay(true));
+    boost::asio::streambuf buffer;
+
+    TIMER_START(requests);
+    for (unsigned i = 0; i < num_requests; i += pipeline_depth)
+    {
+        boost::asio::write(socket, boost::asio::buffer(batch));
+        for (unsigned j = 0; j < pipeline_depth; ++j)
+            readReply(socket, buffer);
+    }
+    TIMER_STOP(requests);
+
+    return num_requests / (TIMER_MSEC(requests) / 1000.);
+}
+}
+
+int main(int argc, const char *argv[]) try
+{
+    const int port = argc > 1 ? std::atoi(argv[1]) : 5001;
+    const unsigned num_requests = argc > 2 ? std::atoi(argv[2]) : 10000;
+
+    // the request handler would log every single request otherwise
+    setenv("DISABLE_ACCESS_LOGGING", "1", 1);
+
+    const unsigned keepalive_timeout = 5;
+    const unsigned keepalive_max_requests = num_requests + 1;
+    server::WorkerPoolConfig worker_config;
+    auto routing_server = std::make_shared<server::Server>(
+        "127.0.0.1", port, 1, worker_config, keepalive_timeout, keepalive_max_requests);
+    routing_server->RegisterServiceHandler(std::make_unique<ConstantServiceHandler>());
+    std::thread server_thread([&] { routing_server->Run(); });
+
+    boost::asio::io_service io_service;
+    const boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::address::from_string("127.0.0.1"),
+                                                  port);
+
+    std::cout << "new connection per request: " << runWithoutReuse(io_service, endpoint, num_requests)
+              << " requests/s" << std::endl;
+    std::cout << "keep-alive: " << runWithReuse(io_service, endpoint, num_requests, 1)
+              << " requests/s" << std::endl;
+    std::cout << "keep-alive, pipelined by 10: "
+              << runWithReuse(io_service, endpoint, num_requests, 10) << " requests/s"
+              << std::endl;
+
+    routing_server->Stop();
+    server_thread.join();
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
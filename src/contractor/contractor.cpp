@@ -27,6 +27,8 @@
 #include "util/timing_util.hpp"
 #include "util/typedefs.hpp"
 
+#include <boost/filesystem/operations.hpp>
+
 #include <algorithm>
 #include <bitset>
 #include <cstdint>
@@ -39,6 +41,54 @@ namespace osrm
 {
 namespace contractor
 {
+namespace
+{
+// Checksum of the nodes and edges of the edge-based graph, it doesn't change with the weights
+unsigned checksumTopology(const EdgeID number_of_edge_based_nodes,
+                          const std::vector<extractor::EdgeBasedEdge> &edge_based_edge_list)
+{
+    std::vector<NodeID> topology;
+    topology.reserve(2 * edge_based_edge_list.size() + 1);
+    topology.push_back(number_of_edge_based_nodes);
+    for (const auto &edge : edge_based_edge_list)
+    {
+        topology.push_back(edge.source);
+        topology.push_back(edge.target);
+    }
+
+    RangebasedCRC32 crc32_calculator;
+    return crc32_calculator(topology);
+}
+
+// Reads the contraction order of the last run, returns no levels if it doesn't fit the graph
+std::vector<std::vector<float>> readNodeLevels(const ContractorConfig &config,
+                                               const EdgeID number_of_edge_based_nodes,
+                                               const unsigned topology_checksum)
+{
+    const auto path = config.GetPath(".osrm.level");
+    if (!boost::filesystem::exists(path))
+    {
+        util::Log(logWARNING) << "No contraction order found, computing a new one";
+        return {};
+    }
+
+    unsigned checksum;
+    std::vector<std::vector<float>> node_levels;
+    files::readLevels(path, checksum, node_levels);
+    const auto wrong_size = [number_of_edge_based_nodes](const std::vector<float> &levels) {
+        return levels.size() != number_of_edge_based_nodes;
+    };
+    if (checksum != topology_checksum ||
+        std::any_of(node_levels.begin(), node_levels.end(), wrong_size))
+    {
+        util::Log(logWARNING) << "Edge-based graph changed since the contraction order was "
+                                 "computed, computing a new one";
+        return {};
+    }
+
+    return node_levels;
+}
+}
 
 int Contractor::Run()
 {
@@ -51,7 +101,8 @@ int Contractor::Run()
 
     if (config.use_cached_priority)
     {
-        util::Log(logWARNING) << "Using cached priorities is deprecated and they will be ignored.";
+        util::Log(logWARNING) << "Using cached priorities is deprecated and they will be ignored. "
+                                 "Use --reuse-order instead.";
     }
 
     TIMER_START(preparing);
@@ -91,6 +142,14 @@ int Contractor::Run()
 
     RangebasedCRC32 crc32_calculator;
     const unsigned checksum = crc32_calculator(edge_based_edge_list);
+    const unsigned topology_checksum =
+        checksumTopology(number_of_edge_based_nodes, edge_based_edge_list);
+
+    std::vector<std::vector<float>> node_levels;
+    if (config.reuse_order)
+    {
+        node_levels = readNodeLevels(config, number_of_edge_based_nodes, topology_checksum);
+    }
 
     QueryGraph query_graph;
     std::vector<std::vector<bool>> edge_filters;
@@ -98,12 +157,14 @@ int Contractor::Run()
     std::tie(query_graph, edge_filters) = contractExcludableGraph(
         toContractorGraph(number_of_edge_based_nodes, std::move(edge_based_edge_list)),
         std::move(node_weights),
-        std::move(node_filters));
+        std::move(node_filters),
+        node_levels);
     TIMER_STOP(contraction);
     util::Log() << "Contracted graph has " << query_graph.GetNumberOfEdges() << " edges.";
     util::Log() << "Contraction took " << TIMER_SEC(contraction) << " sec";
 
     files::writeGraph(config.GetPath(".osrm.hsgr"), checksum, query_graph, edge_filters);
+    files::writeLevels(config.GetPath(".osrm.level"), topology_checksum, node_levels);
 
     TIMER_STOP(preparing);
 
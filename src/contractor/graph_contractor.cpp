@@ -48,7 +48,8 @@ struct ContractorNodeData
                        std::vector<bool> contractable_,
                        std::vector<EdgeWeight> weights_)
         : is_core(std::move(uncontracted_nodes_)), contractable(std::move(contractable_)),
-          priorities(number_of_nodes), weights(std::move(weights_)), depths(number_of_nodes, 0)
+          priorities(number_of_nodes), weights(std::move(weights_)), depths(number_of_nodes, 0),
+          levels(number_of_nodes, 0)
     {
         if (contractable.empty())
         {
@@ -67,7 +68,8 @@ struct ContractorNodeData
             [&] { util::inplacePermutation(weights.begin(), weights.end(), old_to_new); },
             [&] { util::inplacePermutation(is_core.begin(), is_core.end(), old_to_new); },
             [&] { util::inplacePermutation(contractable.begin(), contractable.end(), old_to_new); },
-            [&] { util::inplacePermutation(depths.begin(), depths.end(), old_to_new); });
+            [&] { util::inplacePermutation(depths.begin(), depths.end(), old_to_new); },
+            [&] { util::inplacePermutation(levels.begin(), levels.end(), old_to_new); });
     }
 
     std::vector<bool> is_core;
@@ -75,6 +77,7 @@ struct ContractorNodeData
     std::vector<NodePriority> priorities;
     std::vector<EdgeWeight> weights;
     std::vector<NodeDepth> depths;
+    std::vector<NodeLevel> levels;
 };
 
 struct ContractionStats
@@ -562,9 +565,12 @@ std::vector<bool> contractGraph(ContractorGraph &graph,
                                 std::vector<bool> node_is_uncontracted_,
                                 std::vector<bool> node_is_contractable_,
                                 std::vector<EdgeWeight> node_weights_,
+                                std::vector<float> &node_levels,
                                 double core_factor)
 {
     BOOST_ASSERT(node_weights_.size() == graph.GetNumberOfNodes());
+    BOOST_ASSERT(node_levels.empty() || node_levels.size() == graph.GetNumberOfNodes());
+    const bool use_cached_levels = !node_levels.empty();
     util::XORFastHash<> fast_hash;
 
     // for the preperation we can use a big grain size, which is much faster (probably cache)
@@ -613,6 +619,16 @@ std::vector<bool> contractGraph(ContractorGraph &graph,
         }
     }
 
+    if (use_cached_levels)
+    {
+        // the levels are the priorities, there is no need to simulate contractions
+        util::Log() << "using the cached contraction order";
+        for (const auto &remaining : remaining_nodes)
+        {
+            node_data.priorities[remaining.id] = node_levels[remaining.id];
+        }
+    }
+    else
     {
         util::UnbufferedLog log;
         log << "initializing node priorities...";
@@ -693,6 +709,7 @@ std::vector<bool> contractGraph(ContractorGraph &graph,
              util::irange<std::size_t>(begin_independent_nodes_idx, end_independent_nodes_idx))
         {
             node_data.is_core[remaining_nodes[position].id] = false;
+            node_data.levels[remaining_nodes[position].id] = current_level;
         }
 
         tbb::parallel_for(
@@ -739,17 +756,22 @@ std::vector<bool> contractGraph(ContractorGraph &graph,
             data->inserted_edges.clear();
         }
 
-        tbb::parallel_for(
-            tbb::blocked_range<NodeID>(
-                begin_independent_nodes_idx, end_independent_nodes_idx, NeighboursGrainSize),
-            [&](const auto &range) {
-                ContractorThreadData *data = thread_data_list.GetThreadData();
-                for (auto position = range.begin(), end = range.end(); position != end; ++position)
-                {
-                    NodeID node = remaining_nodes[position].id;
-                    UpdateNodeNeighbours(node_data, data, graph, node);
-                }
-            });
+        // the cached priorities don't change
+        if (!use_cached_levels)
+        {
+            tbb::parallel_for(
+                tbb::blocked_range<NodeID>(
+                    begin_independent_nodes_idx, end_independent_nodes_idx, NeighboursGrainSize),
+                [&](const auto &range) {
+                    ContractorThreadData *data = thread_data_list.GetThreadData();
+                    for (auto position = range.begin(), end = range.end(); position != end;
+                         ++position)
+                    {
+                        NodeID node = remaining_nodes[position].id;
+                        UpdateNodeNeighbours(node_data, data, graph, node);
+                    }
+                });
+        }
 
         // remove contracted nodes from the pool
         BOOST_ASSERT(end_independent_nodes_idx - begin_independent_nodes_idx > 0);
@@ -760,9 +782,16 @@ std::vector<bool> contractGraph(ContractorGraph &graph,
         ++current_level;
     }
 
+    // uncontracted nodes come after all contracted nodes if the order is reused
+    for (const auto &remaining : remaining_nodes)
+    {
+        node_data.levels[remaining.id] = current_level;
+    }
+
     node_data.Renumber(new_to_old_node_id);
     RenumberGraph(graph, new_to_old_node_id);
 
+    node_levels = std::move(node_data.levels);
     return std::move(node_data.is_core);
 }
 
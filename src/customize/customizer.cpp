@@ -1,7 +1,12 @@
 #include "extractor/node_data_container.hpp"
 
+#include "contractor/crc32_processor.hpp"
+
+#include "customizer/cch_customizer.hpp"
+#include "customizer/cch_topology.hpp"
 #include "customizer/cell_customizer.hpp"
 #include "customizer/customizer.hpp"
+#include "customizer/dirty_cells.hpp"
 #include "customizer/edge_based_graph.hpp"
 #include "customizer/files.hpp"
 
@@ -18,6 +23,11 @@
 #include "util/log.hpp"
 #include "util/timing_util.hpp"
 
+#include <boost/filesystem/operations.hpp>
+#include <boost/optional.hpp>
+
+#include <initializer_list>
+
 namespace osrm
 {
 namespace customizer
@@ -111,6 +121,174 @@ std::vector<CellMetric> customizeFilteredMetrics(const MultiLevelEdgeBasedGraph
 
     return metrics;
 }
+
+// Marks the cells of all edges that differ from the previously customized graph. Returns false
+// if the graphs don't have the same nodes and edges, e.g. if the data was extracted again.
+bool markUpdatedCells(const MultiLevelEdgeBasedGraph &previous_graph,
+                      const MultiLevelEdgeBasedGraph &graph,
+                      DirtyCells &dirty_cells)
+{
+    if (previous_graph.GetNumberOfNodes() != graph.GetNumberOfNodes() ||
+        previous_graph.GetNumberOfEdges() != graph.GetNumberOfEdges())
+    {
+        return false;
+    }
+
+    for (auto node : util::irange(0u, graph.GetNumberOfNodes()))
+    {
+        if (previous_graph.BeginEdges(node) != graph.BeginEdges(node) ||
+            previous_graph.EndEdges(node) != graph.EndEdges(node))
+        {
+            return false;
+        }
+
+        for (auto edge : graph.GetAdjacentEdgeRange(node))
+        {
+            const auto target = graph.GetTarget(edge);
+            if (previous_graph.GetTarget(edge) != target)
+            {
+                return false;
+            }
+
+            const auto &previous_data = previous_graph.GetEdgeData(edge);
+            const auto &data = graph.GetEdgeData(edge);
+            if (previous_data.weight != data.weight || previous_data.duration != data.duration ||
+                previous_data.forward != data.forward || previous_data.backward != data.backward)
+            {
+                dirty_cells.MarkEdge(node, target);
+            }
+        }
+    }
+
+    return true;
+}
+
+// Updates the metrics of the previous customization, only cells with changed edges are
+// customized again. Returns none if there is no previous customization that fits the graph.
+boost::optional<std::vector<CellMetric>>
+customizeUpdatedMetrics(const CustomizationConfig &config,
+                        const partition::MultiLevelPartition &mlp,
+                        const MultiLevelEdgeBasedGraph &graph,
+                        const partition::CellStorage &storage,
+                        const CellCustomizer &customizer,
+                        const std::vector<std::vector<bool>> &node_filters)
+{
+    const auto metrics_path = config.GetPath(".osrm.cell_metrics");
+    const auto graph_path = config.GetPath(".osrm.mldgr");
+    if (!boost::filesystem::exists(metrics_path) || !boost::filesystem::exists(graph_path))
+    {
+        util::Log(logWARNING) << "No previous customization found, customizing all cells";
+        return boost::none;
+    }
+
+    MultiLevelEdgeBasedGraph previous_graph;
+    partition::files::readGraph(graph_path, previous_graph);
+
+    DirtyCells dirty_cells(mlp);
+    if (!markUpdatedCells(previous_graph, graph, dirty_cells))
+    {
+        util::Log(logWARNING)
+            << "Graph of the previous customization differs, customizing all cells";
+        return boost::none;
+    }
+    dirty_cells.Propagate();
+
+    std::vector<CellMetric> metrics;
+    files::readCellMetrics(metrics_path, metrics);
+
+    const auto empty_metric = storage.MakeMetric();
+    const auto fits_storage = [&empty_metric](const CellMetric &metric) {
+        return metric.weights.size() == empty_metric.weights.size() &&
+               metric.durations.size() == empty_metric.durations.size();
+    };
+    if (metrics.size() != node_filters.size() ||
+        !std::all_of(metrics.begin(), metrics.end(), fits_storage))
+    {
+        util::Log(logWARNING)
+            << "Metrics of the previous customization differ, customizing all cells";
+        return boost::none;
+    }
+
+    for (auto level : util::irange<LevelID>(1, mlp.GetNumberOfLevels()))
+    {
+        util::Log() << "Level " << static_cast<unsigned>(level) << " customizing "
+                    << dirty_cells.GetNumberOfDirtyCells(level) << " of "
+                    << mlp.GetNumberOfCells(level) << " cells";
+    }
+
+    for (auto index : util::irange<std::size_t>(0, metrics.size()))
+    {
+        customizer.Customize(graph, storage, node_filters[index], metrics[index], dirty_cells);
+    }
+
+    return metrics;
+}
+
+// Checksum of the partition and the nodes and edges of the graph, the CCH topology only
+// depends on these and not on the weights
+unsigned checksumTopology(const partition::MultiLevelPartition &mlp,
+                          const MultiLevelEdgeBasedGraph &graph)
+{
+    std::vector<std::uint32_t> topology;
+    topology.push_back(graph.GetNumberOfNodes());
+    for (auto node : util::irange(0u, graph.GetNumberOfNodes()))
+    {
+        for (auto level : util::irange<LevelID>(1, mlp.GetNumberOfLevels()))
+        {
+            topology.push_back(mlp.GetCell(level, node));
+        }
+        topology.push_back(graph.EndEdges(node) - graph.BeginEdges(node));
+        for (auto edge : graph.GetAdjacentEdgeRange(node))
+        {
+            topology.push_back(graph.GetTarget(edge));
+        }
+    }
+
+    contractor::RangebasedCRC32 crc32_calculator;
+    return crc32_calculator(topology);
+}
+
+// Reads the CCH topology of the last run, returns none if it doesn't fit the graph
+boost::optional<CCHTopology> readCCHTopology(const CustomizationConfig &config,
+                                             const NodeID number_of_nodes,
+                                             const unsigned topology_checksum)
+{
+    const auto path = config.GetPath(".osrm.cch_topology");
+    if (!boost::filesystem::exists(path))
+    {
+        util::Log(logWARNING) << "No CCH topology found, computing a new one";
+        return boost::none;
+    }
+
+    unsigned checksum;
+    CCHTopology topology;
+    files::readCCHTopology(path, checksum, topology);
+    if (checksum != topology_checksum || topology.GetNumberOfNodes() != number_of_nodes)
+    {
+        util::Log(logWARNING) << "Edge-based graph or partition changed since the CCH topology "
+                                 "was computed, computing a new one";
+        return boost::none;
+    }
+
+    return topology;
+}
+
+// Files of an earlier customization for an algorithm that is not customized now would be
+// loaded with the old weights
+void removeOutdatedFiles(const CustomizationConfig &config,
+                         const std::initializer_list<const char *> files)
+{
+    for (const auto file : files)
+    {
+        const auto path = config.GetPath(file);
+        if (boost::filesystem::exists(path))
+        {
+            util::Log(logWARNING) << "Removing " << path.string()
+                                  << " of an earlier customization";
+            boost::filesystem::remove(path);
+        }
+    }
+}
 }
 
 int Customizer::Run(const CustomizationConfig &config)
@@ -128,33 +306,86 @@ int Customizer::Run(const CustomizationConfig &config)
     partition::files::readCells(config.GetPath(".osrm.cells"), storage);
     TIMER_STOP(loading_data);
 
-    extractor::EdgeBasedNodeDataContainer node_data;
-    extractor::files::readNodeData(config.GetPath(".osrm.ebg_nodes"), node_data);
+    util::Log() << "Loading partition data took " << TIMER_SEC(loading_data) << " seconds";
 
-    extractor::ProfileProperties properties;
-    extractor::files::readProfileProperties(config.GetPath(".osrm.properties"), properties);
+    if (config.cch_only)
+    {
+        removeOutdatedFiles(config, {".osrm.cell_metrics", ".osrm.mldgr"});
+    }
+    else
+    {
+        extractor::EdgeBasedNodeDataContainer node_data;
+        extractor::files::readNodeData(config.GetPath(".osrm.ebg_nodes"), node_data);
 
-    util::Log() << "Loading partition data took " << TIMER_SEC(loading_data) << " seconds";
+        extractor::ProfileProperties properties;
+        extractor::files::readProfileProperties(config.GetPath(".osrm.properties"), properties);
 
-    TIMER_START(cell_customize);
-    auto filter = util::excludeFlagsToNodeFilter(graph.GetNumberOfNodes(), node_data, properties);
-    auto metrics = customizeFilteredMetrics(graph, storage, CellCustomizer{mlp}, filter);
-    TIMER_STOP(cell_customize);
-    util::Log() << "Cells customization took " << TIMER_SEC(cell_customize) << " seconds";
+        TIMER_START(cell_customize);
+        auto filter =
+            util::excludeFlagsToNodeFilter(graph.GetNumberOfNodes(), node_data, properties);
+        boost::optional<std::vector<CellMetric>> updated_metrics;
+        if (config.incremental)
+        {
+            updated_metrics =
+                customizeUpdatedMetrics(config, mlp, graph, storage, CellCustomizer{mlp}, filter);
+        }
+        auto metrics = updated_metrics
+                           ? std::move(*updated_metrics)
+                           : customizeFilteredMetrics(graph, storage, CellCustomizer{mlp}, filter);
+        TIMER_STOP(cell_customize);
+        util::Log() << "Cells customization took " << TIMER_SEC(cell_customize) << " seconds";
 
-    TIMER_START(writing_mld_data);
-    files::writeCellMetrics(config.GetPath(".osrm.cell_metrics"), metrics);
-    TIMER_STOP(writing_mld_data);
-    util::Log() << "MLD customization writing took " << TIMER_SEC(writing_mld_data) << " seconds";
+        TIMER_START(writing_mld_data);
+        files::writeCellMetrics(config.GetPath(".osrm.cell_metrics"), metrics);
+        TIMER_STOP(writing_mld_data);
+        util::Log() << "MLD customization writing took " << TIMER_SEC(writing_mld_data)
+                    << " seconds";
 
-    TIMER_START(writing_graph);
-    partition::files::writeGraph(config.GetPath(".osrm.mldgr"), graph);
-    TIMER_STOP(writing_graph);
-    util::Log() << "Graph writing took " << TIMER_SEC(writing_graph) << " seconds";
+        TIMER_START(writing_graph);
+        partition::files::writeGraph(config.GetPath(".osrm.mldgr"), graph);
+        TIMER_STOP(writing_graph);
+        util::Log() << "Graph writing took " << TIMER_SEC(writing_graph) << " seconds";
 
-    for (const auto &metric : metrics)
+        for (const auto &metric : metrics)
+        {
+            CellStorageStatistics(graph, mlp, storage, metric);
+        }
+    }
+
+    if (config.cch || config.cch_only)
+    {
+        // the topology only changes with the graph and the partition, it is computed once
+        // and only the metric is customized again for new weights
+        TIMER_START(cch_topology);
+        const auto topology_checksum = checksumTopology(mlp, graph);
+        auto topology = readCCHTopology(config, graph.GetNumberOfNodes(), topology_checksum);
+        if (!topology)
+        {
+            topology.emplace(mlp, graph);
+            files::writeCCHTopology(
+                config.GetPath(".osrm.cch_topology"), topology_checksum, *topology);
+        }
+        TIMER_STOP(cch_topology);
+        util::Log() << "CCH topology took " << TIMER_SEC(cch_topology) << " seconds: "
+                    << topology->GetNumberOfArcs() << " arcs, "
+                    << topology->GetNumberOfHeights() << " elimination tree levels";
+
+        TIMER_START(cch_customize);
+        const auto cch_metric = CCHCustomizer{*topology}.Customize(graph);
+        std::vector<bool> edge_filter;
+        const auto query_graph = makeQueryGraph(*topology, cch_metric, edge_filter);
+        TIMER_STOP(cch_customize);
+        util::Log() << "CCH customization took " << TIMER_SEC(cch_customize) << " seconds";
+
+        TIMER_START(writing_cch);
+        files::writeCCH(
+            config.GetPath(".osrm.cch"), query_graph, topology->GetEliminationTree(), edge_filter);
+        TIMER_STOP(writing_cch);
+        util::Log() << "CCH writing took " << TIMER_SEC(writing_cch) << " seconds";
+    }
+    else
     {
-        CellStorageStatistics(graph, mlp, storage, metric);
+        removeOutdatedFiles(config, {".osrm.cch"});
     }
 
     return 0;
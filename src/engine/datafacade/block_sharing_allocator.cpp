@@ -0,0 +1,156 @@
+#include "engine/datafacade/block_sharing_allocator.hpp"
+#include "util/log.hpp"
+
+#include "boost/assert.hpp"
+
+#include <boost/crc.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace osrm
+{
+namespace engine
+{
+namespace datafacade
+{
+
+using storage::DataLayout;
+
+const std::array<DataLayout::BlockID, 7> BlockSharingAllocator::shareable_blocks = {
+    {DataLayout::NAME_CHAR_DATA,
+     DataLayout::COORDINATE_LIST,
+     DataLayout::OSM_NODE_ID_LIST,
+     DataLayout::R_SEARCH_TREE,
+     DataLayout::R_SEARCH_TREE_LEVELS,
+     DataLayout::GEOMETRIES_INDEX,
+     DataLayout::GEOMETRIES_NODE_LIST}};
+
+namespace
+{
+// A block owned by the allocator of a dataset
+struct SharedBlock
+{
+    DataLayout::BlockID block;
+    std::uint64_t size;
+    std::uint32_t fingerprint;
+    std::weak_ptr<ContiguousBlockAllocator> owner;
+    char *memory;
+};
+
+std::mutex shared_blocks_mutex;
+std::vector<SharedBlock> shared_blocks;
+
+std::uint32_t getFingerprint(const char *memory, const std::uint64_t size)
+{
+    boost::crc_32_type crc;
+    crc.process_bytes(memory, size);
+    return crc.checksum();
+}
+
+// The pages that lie completely inside of the block, so its canaries stay intact
+void releasePages(char *begin, const std::size_t size)
+{
+#ifdef __linux__
+    const std::size_t page_size = boost::iostreams::mapped_file::alignment();
+    const auto first = reinterpret_cast<std::uintptr_t>(begin);
+    const auto page_begin = (first + page_size - 1) / page_size * page_size;
+    const auto page_end = (first + size) / page_size * page_size;
+    if (page_begin < page_end &&
+        madvise(reinterpret_cast<char *>(page_begin), page_end - page_begin, MADV_DONTNEED) != 0)
+    {
+        util::Log(logWARNING) << "madvise failed: " << std::strerror(errno);
+    }
+#else
+    (void)begin;
+    (void)size;
+#endif
+}
+}
+
+BlockSharingAllocator::BlockSharingAllocator(std::shared_ptr<ContiguousBlockAllocator> allocator_)
+    : allocator(std::move(allocator_)), block_memory(), shared_size(0)
+{
+    auto &layout = allocator->GetLayout();
+    const auto memory = allocator->GetMemory();
+
+    std::lock_guard<std::mutex> lock(shared_blocks_mutex);
+    shared_blocks.erase(std::remove_if(shared_blocks.begin(),
+                                       shared_blocks.end(),
+                                       [](const SharedBlock &shared_block) {
+                                           return shared_block.owner.expired();
+                                       }),
+                        shared_blocks.end());
+
+    for (const auto block : shareable_blocks)
+    {
+        const auto size = layout.GetBlockSize(block);
+        block_memory[block] = layout.GetBlockPtr<char>(memory, block);
+        if (size == 0)
+        {
+            continue;
+        }
+
+        const auto fingerprint = getFingerprint(block_memory[block], size);
+        std::shared_ptr<ContiguousBlockAllocator> owner;
+        // fingerprints can collide, so equal blocks are compared byte by byte
+        const auto shared_block = std::find_if(
+            shared_blocks.begin(), shared_blocks.end(), [&](const SharedBlock &candidate) {
+                return candidate.block == block && candidate.size == size &&
+                       candidate.fingerprint == fingerprint &&
+                       (owner = candidate.owner.lock()) &&
+                       std::memcmp(candidate.memory, block_memory[block], size) == 0;
+            });
+
+        if (shared_block == shared_blocks.end())
+        {
+            shared_blocks.push_back({block, size, fingerprint, allocator, block_memory[block]});
+            continue;
+        }
+
+        util::Log(logDEBUG) << "Sharing " << storage::block_id_to_name[block] << " ("
+                            << size / 1024 << " kB) with another dataset";
+        releasePages(block_memory[block], size);
+        block_memory[block] = shared_block->memory;
+        block_owners.push_back(std::move(owner));
+        shared_size += size;
+    }
+
+    if (shared_size > 0)
+    {
+        util::Log() << "Shared " << shared_size / (1024 * 1024) << " MB of the dataset with "
+                    << "other datasets";
+    }
+}
+
+BlockSharingAllocator::~BlockSharingAllocator() {}
+
+storage::DataLayout &BlockSharingAllocator::GetLayout() { return allocator->GetLayout(); }
+char *BlockSharingAllocator::GetMemory() { return allocator->GetMemory(); }
+
+storage::DataLayout &BlockSharingAllocator::GetMetricLayout()
+{
+    return allocator->GetMetricLayout();
+}
+char *BlockSharingAllocator::GetMetricMemory() { return allocator->GetMetricMemory(); }
+
+char *BlockSharingAllocator::GetBlockMemory(storage::DataLayout::BlockID block)
+{
+    if (block_memory[block] != nullptr)
+    {
+        return block_memory[block];
+    }
+    return allocator->GetBlockMemory(block);
+}
+
+} // namespace datafacade
+} // namespace engine
+} // namespace osrm
@@ -0,0 +1,56 @@
+#include "engine/datafacade/metric_buffer_allocator.hpp"
+#include "util/integer_range.hpp"
+
+#include "boost/assert.hpp"
+
+#include <cstring>
+
+namespace osrm
+{
+namespace engine
+{
+namespace datafacade
+{
+
+using storage::DataLayout;
+
+MetricBufferAllocator::MetricBufferAllocator(std::shared_ptr<ContiguousBlockAllocator> topology_,
+                                             ContiguousBlockAllocator &metric_source)
+    : topology(std::move(topology_))
+{
+    const auto &source_layout = metric_source.GetMetricLayout();
+    const auto source_memory = metric_source.GetMetricMemory();
+
+    metric_layout = std::make_unique<DataLayout>(storage::makeMetricLayout(source_layout));
+    metric_memory = std::make_unique<char[]>(metric_layout->GetSizeOfLayout());
+    for (const auto block : util::irange<std::size_t>(0, DataLayout::NUM_BLOCKS))
+    {
+        metric_layout->GetBlockPtr<char, true>(metric_memory.get(),
+                                               static_cast<DataLayout::BlockID>(block));
+    }
+
+    for (const auto block : storage::metric_blocks)
+    {
+        BOOST_ASSERT(metric_layout->GetBlockSize(block) == source_layout.GetBlockSize(block));
+        std::memcpy(metric_layout->GetBlockPtr<char>(metric_memory.get(), block),
+                    source_layout.GetBlockPtr<char>(source_memory, block),
+                    source_layout.GetBlockSize(block));
+    }
+}
+
+MetricBufferAllocator::~MetricBufferAllocator() {}
+
+storage::DataLayout &MetricBufferAllocator::GetLayout() { return topology->GetLayout(); }
+char *MetricBufferAllocator::GetMemory() { return topology->GetMemory(); }
+
+storage::DataLayout &MetricBufferAllocator::GetMetricLayout() { return *metric_layout.get(); }
+char *MetricBufferAllocator::GetMetricMemory() { return metric_memory.get(); }
+
+char *MetricBufferAllocator::GetBlockMemory(storage::DataLayout::BlockID block)
+{
+    return topology->GetBlockMemory(block);
+}
+
+} // namespace datafacade
+} // namespace engine
+} // namespace osrm
@@ -0,0 +1,253 @@
+#include "engine/datafacade/mmap_memory_allocator.hpp"
+#include "storage/storage.hpp"
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+#include "util/fingerprint.hpp"
+#include "util/log.hpp"
+
+#include "boost/assert.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace osrm
+{
+namespace engine
+{
+namespace datafacade
+{
+
+namespace
+{
+// Stored at the start of the image, followed by the description of the input files the image
+// was written from. The blocks follow at `data_offset`, which is a multiple of every block
+// alignment, so the layout computed for the mapping that wrote the image stays valid for every
+// later mapping of it.
+struct ImageHeader
+{
+    util::FingerPrint fingerprint;
+    std::uint64_t layout_size;
+    std::uint64_t memory_size;
+    std::uint64_t sources_size;
+    std::uint64_t data_offset;
+    storage::DataLayout layout;
+};
+
+const constexpr std::size_t IMAGE_PAGE_SIZE = 4096;
+
+std::uint64_t getDataOffset(const std::size_t sources_size)
+{
+    return (sizeof(ImageHeader) + sources_size + IMAGE_PAGE_SIZE - 1) / IMAGE_PAGE_SIZE *
+           IMAGE_PAGE_SIZE;
+}
+
+// The base path and the absolute path, size and modification time of every input file.
+// An image is only used for exactly these files.
+std::string describeSources(const storage::StorageConfig &config)
+{
+    std::ostringstream sources;
+    sources << boost::filesystem::absolute(config.base_path).string() << '\n';
+    for (const auto &path : config.GetInputPaths())
+    {
+        sources << boost::filesystem::absolute(path).string() << ' ';
+        if (boost::filesystem::exists(path))
+        {
+            sources << boost::filesystem::file_size(path) << ' '
+                    << boost::filesystem::last_write_time(path) << '\n';
+        }
+        else
+        {
+            sources << "missing\n";
+        }
+    }
+    return sources.str();
+}
+
+bool isImageUpToDate(const boost::filesystem::path &memory_file, const std::string &sources)
+{
+    if (!boost::filesystem::is_regular_file(memory_file))
+    {
+        return false;
+    }
+
+    ImageHeader header;
+    boost::filesystem::ifstream image(memory_file, std::ios::binary);
+    if (!image.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+        !header.fingerprint.IsValid() ||
+        !header.fingerprint.IsDataCompatible(util::FingerPrint::GetValid()) ||
+        header.layout_size != sizeof(storage::DataLayout) ||
+        header.sources_size != sources.size() ||
+        header.data_offset != getDataOffset(header.sources_size) ||
+        boost::filesystem::file_size(memory_file) != header.data_offset + header.memory_size)
+    {
+        return false;
+    }
+
+    std::string image_sources(header.sources_size, '\0');
+    return image.read(&image_sources[0], image_sources.size()) && image_sources == sources;
+}
+
+// Writes the image to a temporary file first so other processes never map a partial image
+void writeImage(const storage::StorageConfig &config,
+                const boost::filesystem::path &memory_file,
+                const std::string &sources)
+{
+    storage::Storage storage(config);
+
+    ImageHeader header;
+    header.fingerprint = util::FingerPrint::GetValid();
+    header.layout_size = sizeof(storage::DataLayout);
+    storage.PopulateLayout(header.layout);
+    header.memory_size = header.layout.GetSizeOfLayout();
+    header.sources_size = sources.size();
+    header.data_offset = getDataOffset(sources.size());
+
+    const auto temporary_file =
+        boost::filesystem::unique_path(memory_file.string() + ".%%%%-%%%%-%%%%");
+    try
+    {
+        boost::iostreams::mapped_file_params params(temporary_file.string());
+        params.flags = boost::iostreams::mapped_file::readwrite;
+        params.new_file_size = header.data_offset + header.memory_size;
+        boost::iostreams::mapped_file image(params);
+
+        storage.PopulateData(header.layout, image.data() + header.data_offset);
+        std::memcpy(image.data() + sizeof(header), sources.data(), sources.size());
+        std::memcpy(image.data(), &header, sizeof(header));
+        image.close();
+
+        boost::filesystem::rename(temporary_file, memory_file);
+    }
+    catch (...)
+    {
+        boost::system::error_code ignored;
+        boost::filesystem::remove(temporary_file, ignored);
+        throw;
+    }
+}
+
+void advise(char *begin, const std::size_t size, const EngineConfig::MemoryAdvice advice)
+{
+    const std::size_t page_size = boost::iostreams::mapped_file::alignment();
+
+#ifdef __linux__
+    // madvise needs a page aligned address
+    char *page_begin = begin - reinterpret_cast<std::uintptr_t>(begin) % page_size;
+    int flag = MADV_NORMAL;
+    switch (advice)
+    {
+    case EngineConfig::MemoryAdvice::Normal:
+        flag = MADV_NORMAL;
+        break;
+    case EngineConfig::MemoryAdvice::Random:
+        flag = MADV_RANDOM;
+        break;
+    case EngineConfig::MemoryAdvice::Sequential:
+        flag = MADV_SEQUENTIAL;
+        break;
+    case EngineConfig::MemoryAdvice::WillNeed:
+    case EngineConfig::MemoryAdvice::Populate:
+        flag = MADV_WILLNEED;
+        break;
+    }
+    if (madvise(page_begin, size + (begin - page_begin), flag) != 0)
+    {
+        util::Log(logWARNING) << "madvise failed: " << std::strerror(errno);
+    }
+#endif
+
+    // equivalent of MAP_POPULATE for a single block, reads one byte of every page
+    if (advice == EngineConfig::MemoryAdvice::Populate)
+    {
+        volatile char sink = 0;
+        for (std::size_t offset = 0; offset < size; offset += page_size)
+        {
+            sink += begin[offset];
+        }
+        (void)sink;
+    }
+}
+}
+
+MMapMemoryAllocator::MMapMemoryAllocator(
+    const storage::StorageConfig &config,
+    const boost::filesystem::path &memory_file,
+    const std::unordered_map<std::string, MemoryAdvice> &advice)
+{
+    std::array<MemoryAdvice, storage::DataLayout::NUM_BLOCKS> block_advice;
+    const auto all_advice = advice.find("all");
+    block_advice.fill(all_advice == advice.end() ? MemoryAdvice::Normal : all_advice->second);
+    for (const auto &name_and_advice : advice)
+    {
+        if (name_and_advice.first == "all")
+        {
+            continue;
+        }
+
+        const auto begin = std::begin(storage::block_id_to_name);
+        const auto end = std::end(storage::block_id_to_name);
+        const auto block = std::find_if(
+            begin, end, [&](const char *name) { return name_and_advice.first == name; });
+        if (block == end)
+        {
+            throw util::exception("Unknown block " + name_and_advice.first +
+                                  " in memory advice" + SOURCE_REF);
+        }
+        block_advice[block - begin] = name_and_advice.second;
+    }
+
+    const auto sources = describeSources(config);
+    if (!isImageUpToDate(memory_file, sources))
+    {
+        util::Log() << "Writing dataset image " << memory_file.string();
+        writeImage(config, memory_file, sources);
+    }
+
+    boost::iostreams::mapped_file_params params(memory_file.string());
+    params.flags = boost::iostreams::mapped_file::priv;
+    mapped_memory_file.open(params);
+
+    ImageHeader header;
+    std::memcpy(&header, mapped_memory_file.data(), sizeof(header));
+    internal_layout = std::make_unique<storage::DataLayout>(header.layout);
+    internal_memory = mapped_memory_file.data() + header.data_offset;
+    BOOST_ASSERT(mapped_memory_file.size() ==
+                 header.data_offset + internal_layout->GetSizeOfLayout());
+
+    for (auto block = 0; block < storage::DataLayout::NUM_BLOCKS; ++block)
+    {
+        const auto id = static_cast<storage::DataLayout::BlockID>(block);
+        const auto size = internal_layout->GetBlockSize(id);
+        if (block_advice[block] != MemoryAdvice::Normal && size > 0)
+        {
+            advise(static_cast<char *>(internal_layout->GetAlignedBlockPtr(internal_memory, id)),
+                   size,
+                   block_advice[block]);
+        }
+    }
+
+    util::Log() << "Mapped " << mapped_memory_file.size() << " bytes of dataset image "
+                << memory_file.string();
+}
+
+MMapMemoryAllocator::~MMapMemoryAllocator() {}
+
+storage::DataLayout &MMapMemoryAllocator::GetLayout() { return *internal_layout.get(); }
+char *MMapMemoryAllocator::GetMemory() { return internal_memory; }
+
+} // namespace datafacade
+} // namespace engine
+} // namespace osrm
@@ -10,12 +10,21 @@ namespace engine
 namespace datafacade
 {
 
-SharedMemoryAllocator::SharedMemoryAllocator(storage::SharedDataType data_region)
+SharedMemoryAllocator::SharedMemoryAllocator(storage::SharedDataType data_region,
+                                             storage::SharedDataType metric_region)
 {
     util::Log(logDEBUG) << "Loading new data for region " << regionToString(data_region);
 
     BOOST_ASSERT(storage::SharedMemory::RegionExists(data_region));
     m_large_memory = storage::makeSharedMemory(data_region);
+
+    if (metric_region != storage::REGION_NONE)
+    {
+        util::Log(logDEBUG) << "Loading new metric for region " << regionToString(metric_region);
+
+        BOOST_ASSERT(storage::SharedMemory::RegionExists(metric_region));
+        m_metric_memory = storage::makeSharedMemory(metric_region);
+    }
 }
 
 SharedMemoryAllocator::~SharedMemoryAllocator() {}
@@ -29,6 +38,23 @@ char *SharedMemoryAllocator::GetMemory()
     return reinterpret_cast<char *>(m_large_memory->Ptr()) + sizeof(storage::DataLayout);
 }
 
+storage::DataLayout &SharedMemoryAllocator::GetMetricLayout()
+{
+    if (!m_metric_memory)
+    {
+        return GetLayout();
+    }
+    return *reinterpret_cast<storage::DataLayout *>(m_metric_memory->Ptr());
+}
+char *SharedMemoryAllocator::GetMetricMemory()
+{
+    if (!m_metric_memory)
+    {
+        return GetMemory();
+    }
+    return reinterpret_cast<char *>(m_metric_memory->Ptr()) + sizeof(storage::DataLayout);
+}
+
 } // namespace datafacade
 } // namespace engine
 } // namespace osrm
@@ -1,5 +1,10 @@
 #include "engine/engine_config.hpp"
 
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+
+#include <boost/algorithm/string/case_conv.hpp>
+
 namespace osrm
 {
 namespace engine
@@ -21,9 +26,34 @@ bool EngineConfig::IsValid() const
                               unlimited_or_more_than(max_locations_trip, 2) &&
                               unlimited_or_more_than(max_locations_viaroute, 2) &&
                               unlimited_or_more_than(max_results_nearest, 0) &&
-                              max_alternatives >= 0;
+                              unlimited_or_more_than(max_batch_size_nearest, 0) &&
+                              max_alternatives >= 0 && max_threads_distance_table > 0 &&
+                              (max_match_sessions == 0 ||
+                               (match_session_timeout > 0 && max_match_session_points > 1));
+
+    // the metric of a dataset in shared memory belongs to osrm-datastore
+    const bool live_updates_valid =
+        !live_traffic_updates || (!use_shared_memory && algorithm == Algorithm::MLD);
+
+    return ((use_shared_memory && all_path_are_empty) || storage_config.IsValid()) &&
+           limits_valid && live_updates_valid;
+}
+
+std::istream &operator>>(std::istream &in, EngineConfig::Algorithm &algorithm)
+{
+    std::string token;
+    in >> token;
+    boost::to_lower(token);
 
-    return ((use_shared_memory && all_path_are_empty) || storage_config.IsValid()) && limits_valid;
+    if (token == "ch" || token == "corech")
+        algorithm = EngineConfig::Algorithm::CH;
+    else if (token == "mld")
+        algorithm = EngineConfig::Algorithm::MLD;
+    else if (token == "cch")
+        algorithm = EngineConfig::Algorithm::CCH;
+    else
+        throw util::RuntimeError(token, ErrorCode::UnknownAlgorithm, SOURCE_REF);
+    return in;
 }
 }
 }
@@ -0,0 +1,83 @@
+#include "engine/match_session_store.hpp"
+
+#include <boost/assert.hpp>
+
+#include <utility>
+
+namespace osrm
+{
+namespace engine
+{
+
+routing_algorithms::MapMatchingState &
+MatchSession::UseFacade(const std::shared_ptr<const void> &facade_)
+{
+    // an expired facade can't be confused with a new one at the same address
+    if (!state || facade.lock() != facade_)
+    {
+        facade = facade_;
+        state = std::make_unique<routing_algorithms::MapMatchingState>();
+    }
+    return *state;
+}
+
+MatchSessionStore::MatchSessionStore(std::size_t max_sessions, std::chrono::seconds timeout)
+    : max_sessions(max_sessions), timeout(timeout)
+{
+    BOOST_ASSERT(max_sessions > 0);
+}
+
+std::shared_ptr<MatchSession> MatchSessionStore::Get(const std::string &id,
+                                                     const Clock::time_point now)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Expire(now);
+
+    const auto iter = index.find(id);
+    if (iter != index.end())
+    {
+        // move the entry to the front of the list
+        entries.splice(entries.begin(), entries, iter->second);
+        iter->second->last_used = now;
+        return iter->second->session;
+    }
+
+    if (entries.size() >= max_sessions)
+    {
+        index.erase(entries.back().id);
+        entries.pop_back();
+        ++evicted;
+    }
+
+    auto session = std::make_shared<MatchSession>();
+    entries.push_front(Entry{id, session, now});
+    index.emplace(id, entries.begin());
+    ++created;
+    return session;
+}
+
+void MatchSessionStore::Expire(const Clock::time_point now)
+{
+    // the least recently used sessions are at the back
+    while (!entries.empty() && now - entries.back().last_used >= timeout)
+    {
+        index.erase(entries.back().id);
+        entries.pop_back();
+        ++expired;
+    }
+}
+
+util::json::Object MatchSessionStore::GetMetrics() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    util::json::Object metrics;
+    metrics.values["sessions"] = util::json::Number(index.size());
+    metrics.values["max_sessions"] = util::json::Number(max_sessions);
+    metrics.values["created"] = util::json::Number(created);
+    metrics.values["expired"] = util::json::Number(expired);
+    metrics.values["evicted"] = util::json::Number(evicted);
+    return metrics;
+}
+}
+}
@@ -0,0 +1,40 @@
+#include "engine/phantom_node_cache.hpp"
+
+#include "util/std_hash.hpp"
+
+namespace osrm
+{
+namespace engine
+{
+
+std::size_t PhantomNodeCacheKeyHash::operator()(const PhantomNodeCacheKey &key) const
+{
+    return hash_val(key.owner,
+                    key.query,
+                    key.approach,
+                    key.lon,
+                    key.lat,
+                    key.max_results,
+                    key.max_distance,
+                    key.bearing,
+                    key.bearing_range);
+}
+
+PhantomNodeCache::PhantomNodeCache(std::size_t max_entries) : cache(max_entries) {}
+
+util::json::Object PhantomNodeCache::GetMetrics() const
+{
+    const auto number_of_hits = cache.GetHits();
+    const auto number_of_lookups = number_of_hits + cache.GetMisses();
+
+    util::json::Object metrics;
+    metrics.values["entries"] = util::json::Number(cache.GetNumberOfEntries());
+    metrics.values["max_entries"] = util::json::Number(cache.GetCapacity());
+    metrics.values["hits"] = util::json::Number(number_of_hits);
+    metrics.values["misses"] = util::json::Number(number_of_lookups - number_of_hits);
+    metrics.values["hit_rate"] = util::json::Number(
+        number_of_lookups == 0 ? 0. : static_cast<double>(number_of_hits) / number_of_lookups);
+    return metrics;
+}
+}
+}
@@ -110,21 +110,80 @@ void filterCandidates(const std::vector<util::Coordinate> &coordinates,
     }
 }
 
-Status MatchPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
+// assuming radius is the standard deviation of a normal distribution
+// that models GPS noise (in this model), x3 should give us the correct
+// search radius with > 99% confidence
+std::vector<double> getSearchRadiuses(const std::vector<boost::optional<double>> &radiuses,
+                                      const std::size_t number_of_coordinates)
+{
+    std::vector<double> search_radiuses;
+    if (radiuses.empty())
+    {
+        search_radiuses.resize(number_of_coordinates,
+                               routing_algorithms::DEFAULT_GPS_PRECISION *
+                                   MatchPlugin::RADIUS_MULTIPLIER);
+    }
+    else
+    {
+        search_radiuses.resize(number_of_coordinates);
+        std::transform(radiuses.begin(),
+                       radiuses.end(),
+                       search_radiuses.begin(),
+                       [](const boost::optional<double> &maybe_radius) {
+                           if (maybe_radius)
+                           {
+                               return *maybe_radius * MatchPlugin::RADIUS_MULTIPLIER;
+                           }
+                           else
+                           {
+                               return routing_algorithms::DEFAULT_GPS_PRECISION *
+                                      MatchPlugin::RADIUS_MULTIPLIER;
+                           }
+
+                       });
+    }
+    return search_radiuses;
+}
+
+// FIXME we only run this to obtain the geometry
+// The clean way would be to get this directly from the map matching plugin
+InternalRouteResult routeSubMatching(const RoutingAlgorithmsInterface &algorithms,
+                                     const MatchPlugin::SubMatching &sub_matching)
+{
+    BOOST_ASSERT(sub_matching.nodes.size() > 1);
+
+    InternalRouteResult sub_route;
+    PhantomNodes current_phantom_node_pair;
+    for (unsigned i = 0; i < sub_matching.nodes.size() - 1; ++i)
+    {
+        current_phantom_node_pair.source_phantom = sub_matching.nodes[i];
+        current_phantom_node_pair.target_phantom = sub_matching.nodes[i + 1];
+        BOOST_ASSERT(current_phantom_node_pair.source_phantom.IsValid());
+        BOOST_ASSERT(current_phantom_node_pair.target_phantom.IsValid());
+        sub_route.segment_end_coordinates.emplace_back(current_phantom_node_pair);
+    }
+    // force uturns to be on
+    // we split the phantom nodes anyway and only have bi-directional phantom nodes for
+    // possible uturns
+    sub_route = algorithms.ShortestPathSearch(sub_route.segment_end_coordinates, {false});
+    BOOST_ASSERT(sub_route.shortest_path_weight != INVALID_EDGE_WEIGHT);
+    return sub_route;
+}
+
+bool MatchPlugin::CheckParameters(const RoutingAlgorithmsInterface &algorithms,
                                   const api::MatchParameters &parameters,
-                                  util::json::Object &json_result) const
+                                  api::ResultT &json_result) const
 {
     if (!algorithms.HasMapMatching())
     {
-        return Error("NotImplemented",
-                     "Map matching is not implemented for the chosen search algorithm.",
-                     json_result);
+        Error("NotImplemented",
+              "Map matching is not implemented for the chosen search algorithm.",
+              json_result);
+        return false;
     }
 
     if (!CheckAlgorithms(parameters, algorithms, json_result))
-        return Status::Error;
-
-    const auto &facade = algorithms.GetFacade();
+        return false;
 
     BOOST_ASSERT(parameters.IsValid());
 
@@ -132,12 +191,14 @@ Status MatchPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
     if (max_locations_map_matching > 0 &&
         static_cast<int>(parameters.coordinates.size()) > max_locations_map_matching)
     {
-        return Error("TooBig", "Too many trace coordinates", json_result);
+        Error("TooBig", "Too many trace coordinates", json_result);
+        return false;
     }
 
     if (!CheckAllCoordinates(parameters.coordinates))
     {
-        return Error("InvalidValue", "Invalid coordinate value.", json_result);
+        Error("InvalidValue", "Invalid coordinate value.", json_result);
+        return false;
     }
 
     if (max_radius_map_matching > 0 && std::any_of(parameters.radiuses.begin(),
@@ -148,7 +209,8 @@ Status MatchPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
                                                        return *radius > max_radius_map_matching;
                                                    }))
     {
-        return Error("TooBig", "Radius search size is too large for map matching.", json_result);
+        Error("TooBig", "Radius search size is too large for map matching.", json_result);
+        return false;
     }
 
     // Check for same or increasing timestamps. Impl. note: Incontrast to `sort(first,
@@ -158,10 +220,27 @@ Status MatchPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
 
     if (!time_increases_monotonically)
     {
-        return Error(
-            "InvalidValue", "Timestamps need to be monotonically increasing.", json_result);
+        Error("InvalidValue", "Timestamps need to be monotonically increasing.", json_result);
+        return false;
+    }
+
+    return true;
+}
+
+Status MatchPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
+                                  const api::MatchParameters &parameters,
+                                  api::ResultT &json_result) const
+{
+    if (!parameters.session.empty())
+    {
+        return Error("NotImplemented", "Match sessions are not enabled.", json_result);
     }
 
+    if (!CheckParameters(algorithms, parameters, json_result))
+        return Status::Error;
+
+    const auto &facade = algorithms.GetFacade();
+
     SubMatchingList sub_matchings;
     api::tidy::Result tidied;
     if (parameters.tidy)
@@ -185,33 +264,8 @@ Status MatchPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
                      json_result);
     }
 
-    // assuming radius is the standard deviation of a normal distribution
-    // that models GPS noise (in this model), x3 should give us the correct
-    // search radius with > 99% confidence
-    std::vector<double> search_radiuses;
-    if (tidied.parameters.radiuses.empty())
-    {
-        search_radiuses.resize(tidied.parameters.coordinates.size(),
-                               routing_algorithms::DEFAULT_GPS_PRECISION * RADIUS_MULTIPLIER);
-    }
-    else
-    {
-        search_radiuses.resize(tidied.parameters.coordinates.size());
-        std::transform(tidied.parameters.radiuses.begin(),
-                       tidied.parameters.radiuses.end(),
-                       search_radiuses.begin(),
-                       [](const boost::optional<double> &maybe_radius) {
-                           if (maybe_radius)
-                           {
-                               return *maybe_radius * RADIUS_MULTIPLIER;
-                           }
-                           else
-                           {
-                               return routing_algorithms::DEFAULT_GPS_PRECISION * RADIUS_MULTIPLIER;
-                           }
-
-                       });
-    }
+    const auto search_radiuses = getSearchRadiuses(tidied.parameters.radiuses,
+                                                   tidied.parameters.coordinates.size());
 
     auto candidates_lists = GetPhantomNodesInRange(facade, tidied.parameters, search_radiuses);
 
@@ -267,25 +321,7 @@ Status MatchPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
     std::vector<InternalRouteResult> sub_routes(sub_matchings.size());
     for (auto index : util::irange<std::size_t>(0UL, sub_matchings.size()))
     {
-        BOOST_ASSERT(sub_matchings[index].nodes.size() > 1);
-
-        // FIXME we only run this to obtain the geometry
-        // The clean way would be to get this directly from the map matching plugin
-        PhantomNodes current_phantom_node_pair;
-        for (unsigned i = 0; i < sub_matchings[index].nodes.size() - 1; ++i)
-        {
-            current_phantom_node_pair.source_phantom = sub_matchings[index].nodes[i];
-            current_phantom_node_pair.target_phantom = sub_matchings[index].nodes[i + 1];
-            BOOST_ASSERT(current_phantom_node_pair.source_phantom.IsValid());
-            BOOST_ASSERT(current_phantom_node_pair.target_phantom.IsValid());
-            sub_routes[index].segment_end_coordinates.emplace_back(current_phantom_node_pair);
-        }
-        // force uturns to be on
-        // we split the phantom nodes anyway and only have bi-directional phantom nodes for
-        // possible uturns
-        sub_routes[index] =
-            algorithms.ShortestPathSearch(sub_routes[index].segment_end_coordinates, {false});
-        BOOST_ASSERT(sub_routes[index].shortest_path_weight != INVALID_EDGE_WEIGHT);
+        sub_routes[index] = routeSubMatching(algorithms, sub_matchings[index]);
         if (!tidied.parameters.waypoints.empty())
         {
             std::vector<bool> waypoint_legs;
@@ -312,6 +348,101 @@ Status MatchPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
 
     return Status::Ok;
 }
+
+Status MatchPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
+                                  const api::MatchParameters &parameters,
+                                  routing_algorithms::MapMatchingState &session_state,
+                                  api::ResultT &json_result) const
+{
+    BOOST_ASSERT(!parameters.session.empty());
+
+    if (!CheckParameters(algorithms, parameters, json_result))
+        return Status::Error;
+
+    if (parameters.tidy || !parameters.waypoints.empty())
+    {
+        return Error("InvalidOptions",
+                     "The tidy and waypoints parameters are not supported by match sessions.",
+                     json_result);
+    }
+
+    const auto &facade = algorithms.GetFacade();
+
+    const bool session_has_points = session_state.GetNumberOfPoints() > 0;
+    const bool session_has_timestamps = !session_state.trace_timestamps.empty();
+    if (session_has_points && parameters.timestamps.empty() == session_has_timestamps)
+    {
+        return Error("InvalidValue",
+                     "Timestamps need to be given for all coordinates of a session or for none.",
+                     json_result);
+    }
+    if (session_has_timestamps &&
+        parameters.timestamps.front() < session_state.trace_timestamps.back())
+    {
+        return Error(
+            "InvalidValue", "Timestamps need to be monotonically increasing.", json_result);
+    }
+
+    const auto search_radiuses =
+        getSearchRadiuses(parameters.radiuses, parameters.coordinates.size());
+    auto new_candidates_lists = GetPhantomNodesInRange(facade, parameters, search_radiuses);
+
+    // the last point of the session decides whether a u-turn is possible at the first new one
+    std::vector<util::Coordinate> coordinates;
+    CandidateLists candidates_lists;
+    if (session_has_points)
+    {
+        coordinates.push_back(session_state.trace_coordinates.back());
+        candidates_lists.emplace_back();
+    }
+    const auto first_new_point = coordinates.size();
+    coordinates.insert(
+        coordinates.end(), parameters.coordinates.begin(), parameters.coordinates.end());
+    std::move(new_candidates_lists.begin(),
+              new_candidates_lists.end(),
+              std::back_inserter(candidates_lists));
+    filterCandidates(coordinates, candidates_lists);
+
+    session_state.Shrink(max_match_session_points);
+    for (const auto index : util::irange<std::size_t>(0UL, parameters.coordinates.size()))
+    {
+        session_state.AddPoint(
+            std::move(candidates_lists[first_new_point + index]),
+            parameters.coordinates[index],
+            parameters.timestamps.empty() ? boost::none
+                                          : boost::make_optional(parameters.timestamps[index]),
+            parameters.radiuses.empty() ? boost::none : parameters.radiuses[index]);
+    }
+
+    auto sub_matchings = algorithms.MapMatching(
+        session_state, parameters.gaps == api::MatchParameters::GapsType::Split);
+
+    // Point indices of the session are turned into coordinate indices of this request. Matchings
+    // start at the last matched point of the previous requests, that point has no tracepoint.
+    const auto first_request_point =
+        session_state.GetNumberOfPoints() - parameters.coordinates.size();
+    for (auto &sub_matching : sub_matchings)
+    {
+        for (auto &index : sub_matching.indices)
+        {
+            index = index >= first_request_point ? index - first_request_point
+                                                 : parameters.coordinates.size();
+        }
+    }
+
+    // points that can't be matched yet are no error, the next points may continue the trace
+    std::vector<InternalRouteResult> sub_routes(sub_matchings.size());
+    for (auto index : util::irange<std::size_t>(0UL, sub_matchings.size()))
+    {
+        sub_routes[index] = routeSubMatching(algorithms, sub_matchings[index]);
+    }
+
+    const auto tidied = api::tidy::keep_all(parameters);
+    api::MatchAPI match_api{facade, parameters, tidied};
+    match_api.MakeResponse(sub_matchings, sub_routes, json_result);
+
+    return Status::Ok;
+}
 }
 }
 }
@@ -4,6 +4,7 @@
 #include "engine/phantom_node.hpp"
 #include "util/integer_range.hpp"
 
+#include <algorithm>
 #include <cstddef>
 #include <string>
 
@@ -17,11 +18,14 @@ namespace engine
 namespace plugins
 {
 
-NearestPlugin::NearestPlugin(const int max_results_) : max_results{max_results_} {}
+NearestPlugin::NearestPlugin(const int max_results_, const int max_batch_size_)
+    : max_results{max_results_}, max_batch_size{max_batch_size_}
+{
+}
 
 Status NearestPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
                                     const api::NearestParameters &params,
-                                    util::json::Object &json_result) const
+                                    api::ResultT &json_result) const
 {
     BOOST_ASSERT(params.IsValid());
 
@@ -42,6 +46,11 @@ Status NearestPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms
     if (!CheckAllCoordinates(params.coordinates))
         return Error("InvalidOptions", "Coordinates are invalid", json_result);
 
+    if (params.batch)
+    {
+        return HandleBatch(facade, params, json_result);
+    }
+
     if (params.coordinates.size() != 1)
     {
         return Error("InvalidOptions", "Only one input coordinate is supported", json_result);
@@ -60,6 +69,43 @@ Status NearestPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms
 
     return Status::Ok;
 }
+
+Status NearestPlugin::HandleBatch(const datafacade::BaseDataFacade &facade,
+                                  const api::NearestParameters &params,
+                                  api::ResultT &result) const
+{
+    if (params.number_of_results != 1)
+    {
+        return Error("InvalidOptions",
+                     "Batches return only the nearest segment of every coordinate",
+                     result);
+    }
+
+    const auto is_set = [](const auto &value) { return static_cast<bool>(value); };
+    if (std::any_of(params.hints.begin(), params.hints.end(), is_set) ||
+        std::any_of(params.bearings.begin(), params.bearings.end(), is_set))
+    {
+        return Error("InvalidOptions", "Hints and bearings are not supported in batches", result);
+    }
+
+    if (max_batch_size > 0 &&
+        (boost::numeric_cast<std::int64_t>(params.coordinates.size()) > max_batch_size))
+    {
+        return Error("TooBig",
+                     "Number of entries " + std::to_string(params.coordinates.size()) +
+                         " is higher than current maximum (" + std::to_string(max_batch_size) +
+                         ")",
+                     result);
+    }
+
+    const auto phantom_nodes =
+        facade.NearestPhantomNodes(params.coordinates, 1, params.radiuses, params.approaches);
+
+    api::NearestAPI nearest_api(facade, params);
+    nearest_api.MakeBatchResponse(phantom_nodes, result);
+
+    return Status::Ok;
+}
 }
 }
 }
@@ -23,14 +23,16 @@ namespace engine
 namespace plugins
 {
 
-TablePlugin::TablePlugin(const int max_locations_distance_table)
-    : max_locations_distance_table(max_locations_distance_table)
+TablePlugin::TablePlugin(const int max_locations_distance_table,
+                         const unsigned max_threads_distance_table)
+    : max_locations_distance_table(max_locations_distance_table),
+      max_threads_distance_table(max_threads_distance_table)
 {
 }
 
 Status TablePlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
                                   const api::TableParameters &params,
-                                  util::json::Object &result) const
+                                  api::ResultT &result) const
 {
     if (!algorithms.HasManyToManySearch())
     {
@@ -81,16 +83,21 @@ Status TablePlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
     }
 
     auto snapped_phantoms = SnapPhantomNodes(phantom_nodes);
-    auto result_table =
-        algorithms.ManyToManySearch(snapped_phantoms, params.sources, params.destinations);
-
-    if (result_table.empty())
+    const bool request_distance =
+        params.annotations & api::TableParameters::AnnotationsType::Distance;
+    auto result_tables = algorithms.ManyToManySearch(snapped_phantoms,
+                                                     params.sources,
+                                                     params.destinations,
+                                                     request_distance,
+                                                     max_threads_distance_table);
+
+    if (result_tables.first.empty())
     {
         return Error("NoTable", "No table found", result);
     }
 
     api::TableAPI table_api{facade, params};
-    table_api.MakeResponse(result_table, snapped_phantoms, result);
+    table_api.MakeResponse(result_tables, snapped_phantoms, result);
 
     return Status::Ok;
 }
@@ -144,7 +144,7 @@ void ManipulateTableForFSE(const std::size_t source_id,
 
 Status TripPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
                                  const api::TripParameters &parameters,
-                                 util::json::Object &json_result) const
+                                 api::ResultT &json_result) const
 {
     if (!algorithms.HasShortestPathSearch())
     {
@@ -217,7 +217,7 @@ Status TripPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
 
     // compute the duration table of all phantom nodes
     auto result_table = util::DistTableWrapper<EdgeWeight>(
-        algorithms.ManyToManySearch(snapped_phantoms, {}, {}), number_of_locations);
+        algorithms.ManyToManySearch(snapped_phantoms, {}, {}, false, 1).first, number_of_locations);
 
     if (result_table.size() == 0)
     {
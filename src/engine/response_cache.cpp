@@ -0,0 +1,263 @@
+#include "engine/response_cache.hpp"
+
+#include "engine/hint.hpp"
+
+#include <boost/assert.hpp>
+
+#include <memory>
+#include <type_traits>
+
+namespace osrm
+{
+namespace engine
+{
+
+namespace
+{
+// Appends the binary representation of parameter values to a key
+class KeyWriter
+{
+  public:
+    explicit KeyWriter(char service) { key.push_back(service); }
+
+    template <typename T> void Write(const T &value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "only plain values can be written");
+        key.append(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+
+    void Write(const std::string &value)
+    {
+        Write(value.size());
+        key.append(value);
+    }
+
+    template <typename T> void Write(const boost::optional<T> &value)
+    {
+        Write(static_cast<bool>(value));
+        if (value)
+            Write(*value);
+    }
+
+    template <typename T> void Write(const std::vector<T> &values)
+    {
+        Write(values.size());
+        for (const auto &value : values)
+            Write(value);
+    }
+
+    void Write(const util::Coordinate &coordinate)
+    {
+        Write(static_cast<std::int32_t>(coordinate.lon));
+        Write(static_cast<std::int32_t>(coordinate.lat));
+    }
+
+    void Write(const Hint &hint) { Write(hint.ToBase64()); }
+
+    void Write(const api::BaseParameters &parameters)
+    {
+        Write(parameters.coordinates);
+        Write(parameters.hints);
+        Write(parameters.radiuses);
+        Write(parameters.bearings);
+        Write(parameters.approaches);
+        Write(parameters.exclude);
+        Write(parameters.generate_hints);
+    }
+
+    std::string key;
+};
+
+// Rough size of a JSON value in memory, used to limit the cache size
+struct EstimateSize
+{
+    std::size_t operator()(const util::json::String &string) const
+    {
+        return sizeof(util::json::Value) + string.value.capacity();
+    }
+
+    std::size_t operator()(const util::json::Object &object) const
+    {
+        std::size_t size = sizeof(util::json::Value);
+        for (const auto &key_and_value : object.values)
+        {
+            // key, hash node and value
+            size += key_and_value.first.capacity() + 2 * sizeof(void *) +
+                    mapbox::util::apply_visitor(*this, key_and_value.second);
+        }
+        return size;
+    }
+
+    std::size_t operator()(const util::json::Array &array) const
+    {
+        std::size_t size = sizeof(util::json::Value);
+        for (const auto &value : array.values)
+        {
+            size += mapbox::util::apply_visitor(*this, value);
+        }
+        return size;
+    }
+
+    // Already rendered responses
+    std::size_t operator()(const std::vector<char> &buffer) const
+    {
+        return sizeof(api::ResultT) + buffer.capacity();
+    }
+
+    std::size_t operator()(const util::cbor::Buffer &buffer) const
+    {
+        return sizeof(api::ResultT) + buffer.bytes.capacity();
+    }
+
+    template <typename T> std::size_t operator()(const T &) const
+    {
+        return sizeof(util::json::Value);
+    }
+};
+}
+
+std::string MakeResponseCacheKey(const api::RouteParameters &parameters)
+{
+    KeyWriter writer('r');
+    writer.Write(static_cast<const api::BaseParameters &>(parameters));
+    writer.Write(parameters.steps);
+    writer.Write(parameters.alternatives);
+    writer.Write(parameters.number_of_alternatives);
+    writer.Write(parameters.annotations);
+    writer.Write(parameters.annotations_type);
+    writer.Write(parameters.geometries);
+    writer.Write(parameters.overview);
+    writer.Write(parameters.continue_straight);
+    return std::move(writer.key);
+}
+
+std::string MakeResponseCacheKey(const api::TableParameters &parameters)
+{
+    KeyWriter writer('t');
+    writer.Write(static_cast<const api::BaseParameters &>(parameters));
+    writer.Write(parameters.sources);
+    writer.Write(parameters.destinations);
+    writer.Write(parameters.annotations);
+    return std::move(writer.key);
+}
+
+std::string MakeResponseCacheKey(const api::NearestParameters &parameters)
+{
+    KeyWriter writer('n');
+    writer.Write(static_cast<const api::BaseParameters &>(parameters));
+    writer.Write(parameters.number_of_results);
+    writer.Write(parameters.batch);
+    return std::move(writer.key);
+}
+
+ResponseCache::ResponseCache(std::size_t max_bytes) : max_bytes(max_bytes) {}
+
+bool ResponseCache::Get(const std::string &key,
+                        unsigned dataset_timestamp,
+                        api::ResultT &result)
+{
+    std::shared_ptr<const api::ResultT> response;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        const auto iter = UseDataset(dataset_timestamp) ? index.find(key) : index.end();
+        if (iter == index.end())
+        {
+            ++misses;
+            return false;
+        }
+
+        // move the entry to the front of the list
+        entries.splice(entries.begin(), entries, iter->second.first);
+        response = iter->second.first->second;
+    }
+
+    // copy outside of the lock, large responses take a while
+    result = *response;
+    ++hits;
+    return true;
+}
+
+void ResponseCache::Put(const std::string &key,
+                        unsigned dataset_timestamp,
+                        const api::ResultT &result)
+{
+    const auto size = key.capacity() + mapbox::util::apply_visitor(EstimateSize(), result);
+    if (size > max_bytes)
+    {
+        return;
+    }
+
+    auto response = std::make_shared<const api::ResultT>(result);
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (!UseDataset(dataset_timestamp) || index.count(key) > 0)
+    {
+        return;
+    }
+
+    EvictUntil(max_bytes - size);
+    entries.emplace_front(key, std::move(response));
+    index.emplace(key, std::make_pair(entries.begin(), size));
+    bytes += size;
+}
+
+bool ResponseCache::UseDataset(unsigned dataset_timestamp)
+{
+    if (dataset_timestamp < current_timestamp)
+    {
+        return false;
+    }
+
+    if (dataset_timestamp > current_timestamp)
+    {
+        if (!entries.empty())
+        {
+            ++invalidations;
+        }
+        entries.clear();
+        index.clear();
+        bytes = 0;
+        current_timestamp = dataset_timestamp;
+    }
+
+    return true;
+}
+
+void ResponseCache::EvictUntil(std::size_t max_size)
+{
+    while (bytes > max_size)
+    {
+        BOOST_ASSERT(!entries.empty());
+        const auto iter = index.find(entries.back().first);
+        BOOST_ASSERT(iter != index.end());
+        bytes -= iter->second.second;
+        index.erase(iter);
+        entries.pop_back();
+    }
+}
+
+util::json::Object ResponseCache::GetMetrics() const
+{
+    std::size_t number_of_entries, number_of_bytes;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        number_of_entries = index.size();
+        number_of_bytes = bytes;
+    }
+    const auto number_of_hits = hits.load();
+    const auto number_of_lookups = number_of_hits + misses.load();
+
+    util::json::Object metrics;
+    metrics.values["entries"] = util::json::Number(number_of_entries);
+    metrics.values["bytes"] = util::json::Number(number_of_bytes);
+    metrics.values["max_bytes"] = util::json::Number(max_bytes);
+    metrics.values["hits"] = util::json::Number(number_of_hits);
+    metrics.values["misses"] = util::json::Number(number_of_lookups - number_of_hits);
+    metrics.values["hit_rate"] = util::json::Number(
+        number_of_lookups == 0 ? 0. : static_cast<double>(number_of_hits) / number_of_lookups);
+    metrics.values["invalidations"] = util::json::Number(invalidations.load());
+    return metrics;
+}
+}
+}
@@ -1,6 +1,7 @@
 #include "engine/routing_algorithms/direct_shortest_path.hpp"
 
 #include "engine/routing_algorithms/routing_base.hpp"
+#include "engine/routing_algorithms/routing_base_cch.hpp"
 #include "engine/routing_algorithms/routing_base_ch.hpp"
 #include "engine/routing_algorithms/routing_base_mld.hpp"
 
@@ -11,16 +12,14 @@ namespace engine
 namespace routing_algorithms
 {
 
-/// This is a stripped down version of the general shortest path algorithm.
-/// The general algorithm always computes two queries for each leg. This is only
-/// necessary in case of vias, where the directions of the start node is constrained
-/// by the previous route.
-/// This variation is only an optimization for graphs with slow queries, for example
-/// not fully contracted graphs.
-template <>
-InternalRouteResult directShortestPathSearch(SearchEngineData<ch::Algorithm> &engine_working_data,
-                                             const DataFacade<ch::Algorithm> &facade,
-                                             const PhantomNodes &phantom_nodes)
+namespace
+{
+// CH and CCH share the graph format and only differ in the search
+template <typename Algorithm>
+InternalRouteResult
+contractedDirectShortestPathSearch(SearchEngineData<Algorithm> &engine_working_data,
+                                   const DataFacade<Algorithm> &facade,
+                                   const PhantomNodes &phantom_nodes)
 {
     engine_working_data.InitializeOrClearFirstThreadLocalStorage(facade.GetNumberOfNodes());
     auto &forward_heap = *engine_working_data.forward_heap_1;
@@ -63,6 +62,29 @@ InternalRouteResult directShortestPathSearch(SearchEngineData<ch::Algorithm> &en
 
     return extractRoute(facade, weight, phantom_nodes, unpacked_nodes, unpacked_edges);
 }
+}
+
+/// This is a stripped down version of the general shortest path algorithm.
+/// The general algorithm always computes two queries for each leg. This is only
+/// necessary in case of vias, where the directions of the start node is constrained
+/// by the previous route.
+/// This variation is only an optimization for graphs with slow queries, for example
+/// not fully contracted graphs.
+template <>
+InternalRouteResult directShortestPathSearch(SearchEngineData<ch::Algorithm> &engine_working_data,
+                                             const DataFacade<ch::Algorithm> &facade,
+                                             const PhantomNodes &phantom_nodes)
+{
+    return contractedDirectShortestPathSearch(engine_working_data, facade, phantom_nodes);
+}
+
+template <>
+InternalRouteResult directShortestPathSearch(SearchEngineData<cch::Algorithm> &engine_working_data,
+                                             const DataFacade<cch::Algorithm> &facade,
+                                             const PhantomNodes &phantom_nodes)
+{
+    return contractedDirectShortestPathSearch(engine_working_data, facade, phantom_nodes);
+}
 
 template <>
 InternalRouteResult directShortestPathSearch(SearchEngineData<mld::Algorithm> &engine_working_data,
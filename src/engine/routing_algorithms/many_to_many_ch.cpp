@@ -4,8 +4,14 @@
 #include <boost/assert.hpp>
 #include <boost/range/iterator_range_core.hpp>
 
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+#include <tbb/task_arena.h>
+
+#include <algorithm>
 #include <limits>
 #include <memory>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -91,6 +97,7 @@ void forwardRoutingStep(const DataFacade<Algorithm> &facade,
                         const std::vector<NodeBucket> &search_space_with_buckets,
                         std::vector<EdgeWeight> &weights_table,
                         std::vector<EdgeDuration> &durations_table,
+                        std::vector<NodeID> &middle_nodes_table,
                         const PhantomNode &phantom_node)
 {
     const auto node = query_heap.DeleteMin();
@@ -111,6 +118,7 @@ void forwardRoutingStep(const DataFacade<Algorithm> &facade,
 
         auto &current_weight = weights_table[row_idx * number_of_targets + column_idx];
         auto &current_duration = durations_table[row_idx * number_of_targets + column_idx];
+        auto &current_middle_node = middle_nodes_table[row_idx * number_of_targets + column_idx];
 
         // Check if new weight is better
         auto new_weight = source_weight + target_weight;
@@ -120,6 +128,8 @@ void forwardRoutingStep(const DataFacade<Algorithm> &facade,
         {
             if (addLoopWeight(facade, node, new_weight, new_duration))
             {
+                if (new_weight < current_weight)
+                    current_middle_node = node;
                 current_weight = std::min(current_weight, new_weight);
                 current_duration = std::min(current_duration, new_duration);
             }
@@ -128,6 +138,7 @@ void forwardRoutingStep(const DataFacade<Algorithm> &facade,
         {
             current_weight = new_weight;
             current_duration = new_duration;
+            current_middle_node = node;
         }
     }
 
@@ -145,34 +156,108 @@ void backwardRoutingStep(const DataFacade<Algorithm> &facade,
     const auto target_weight = query_heap.GetKey(node);
     const auto target_duration = query_heap.GetData(node).duration;
 
+    const auto parent_node = query_heap.GetData(node).parent;
+
     // Store settled nodes in search space bucket
-    search_space_with_buckets.emplace_back(node, column_idx, target_weight, target_duration);
+    search_space_with_buckets.emplace_back(
+        node, parent_node, column_idx, target_weight, target_duration);
 
     relaxOutgoingEdges<REVERSE_DIRECTION>(
         facade, node, target_weight, target_duration, query_heap, phantom_node);
 }
 
+// Unpacks the shortest paths of a row and measures their geometry. The source half of a path is
+// taken from the parents in the forward heap, the target half from the parents in the buckets.
+void calculateDistances(const DataFacade<Algorithm> &facade,
+                        const typename SearchEngineData<Algorithm>::ManyToManyQueryHeap &query_heap,
+                        const std::vector<NodeBucket> &search_space_with_buckets,
+                        const std::vector<PhantomNode> &phantom_nodes,
+                        const std::vector<std::size_t> &target_indices,
+                        const unsigned row_idx,
+                        const std::size_t source_index,
+                        const std::vector<NodeID> &middle_nodes_table,
+                        std::vector<EdgeDistance> &distances_table)
+{
+    const auto number_of_targets = target_indices.size();
+    const auto &source_phantom = phantom_nodes[source_index];
+
+    std::vector<NodeID> packed_path;
+    std::vector<PathData> unpacked_path;
+    for (unsigned column_idx = 0; column_idx < number_of_targets; ++column_idx)
+    {
+        const auto location = row_idx * number_of_targets + column_idx;
+        const auto middle_node = middle_nodes_table[location];
+        if (middle_node == SPECIAL_NODEID)
+            continue;
+
+        // Retrieve source -> middle, in reverse order since tracing back starts from middle
+        packed_path.clear();
+        for (auto node = middle_node;; node = query_heap.GetData(node).parent)
+        {
+            packed_path.push_back(node);
+            if (query_heap.GetData(node).parent == node)
+                break;
+        }
+        std::reverse(packed_path.begin(), packed_path.end());
+
+        // A negative weight at the middle node means the path was completed by a loop edge
+        const auto *bucket = &findBucket(search_space_with_buckets, middle_node, column_idx);
+        if (query_heap.GetKey(middle_node) + bucket->weight < 0)
+            packed_path.push_back(middle_node);
+
+        // Retrieve middle -> target, already in the correct order
+        while (bucket->parent_node != bucket->middle_node)
+        {
+            bucket = &findBucket(search_space_with_buckets, bucket->parent_node, column_idx);
+            packed_path.push_back(bucket->middle_node);
+        }
+
+        const auto &target_phantom = phantom_nodes[target_indices[column_idx]];
+        unpacked_path.clear();
+        unpackPath(facade,
+                   packed_path.begin(),
+                   packed_path.end(),
+                   {source_phantom, target_phantom},
+                   unpacked_path);
+        distances_table[location] =
+            getPathDistance(facade, unpacked_path, source_phantom, target_phantom);
+    }
+}
+
 } // namespace ch
 
 template <>
-std::vector<EdgeDuration> manyToManySearch(SearchEngineData<ch::Algorithm> &engine_working_data,
-                                           const DataFacade<ch::Algorithm> &facade,
-                                           const std::vector<PhantomNode> &phantom_nodes,
-                                           const std::vector<std::size_t> &source_indices,
-                                           const std::vector<std::size_t> &target_indices)
+std::pair<std::vector<EdgeDuration>, std::vector<EdgeDistance>>
+manyToManySearch(SearchEngineData<ch::Algorithm> &engine_working_data,
+                 const DataFacade<ch::Algorithm> &facade,
+                 const std::vector<PhantomNode> &phantom_nodes,
+                 const std::vector<std::size_t> &source_indices,
+                 const std::vector<std::size_t> &target_indices,
+                 const bool calculate_distance,
+                 const unsigned max_threads,
+                 const EdgeWeight weight_upper_bound)
 {
     const auto number_of_sources = source_indices.size();
     const auto number_of_targets = target_indices.size();
     const auto number_of_entries = number_of_sources * number_of_targets;
 
+    // The backward searches start at non-negative weights, the forward searches may not
+    const auto column_weight_bound = getSearchWeightBound(
+        weight_upper_bound, getMinimalSourceWeight(phantom_nodes, source_indices));
+    const auto row_weight_bound = weight_upper_bound;
+
     std::vector<EdgeWeight> weights_table(number_of_entries, INVALID_EDGE_WEIGHT);
     std::vector<EdgeDuration> durations_table(number_of_entries, MAXIMAL_EDGE_DURATION);
+    std::vector<NodeID> middle_nodes_table(number_of_entries, SPECIAL_NODEID);
+    std::vector<EdgeDistance> distances_table(calculate_distance ? number_of_entries : 0,
+                                              INVALID_EDGE_DISTANCE);
 
-    std::vector<NodeBucket> search_space_with_buckets;
+    // Columns and rows are searched independently, every search uses the heap of its thread
+    tbb::task_arena arena(std::max(1u, max_threads));
 
     // Populate buckets with paths from all accessible nodes to destinations via backward searches
-    for (std::uint32_t column_idx = 0; column_idx < target_indices.size(); ++column_idx)
-    {
+    std::vector<std::vector<NodeBucket>> column_buckets(number_of_targets);
+    const auto search_column = [&](const std::size_t column_idx) {
         const auto index = target_indices[column_idx];
         const auto &phantom = phantom_nodes[index];
 
@@ -182,18 +267,24 @@ std::vector<EdgeDuration> manyToManySearch(SearchEngineData<ch::Algorithm> &engi
         insertTargetInHeap(query_heap, phantom);
 
         // Explore search space
-        while (!query_heap.Empty())
+        while (!query_heap.Empty() && query_heap.MinKey() < column_weight_bound)
         {
-            backwardRoutingStep(facade, column_idx, query_heap, search_space_with_buckets, phantom);
+            backwardRoutingStep(
+                facade, column_idx, query_heap, column_buckets[column_idx], phantom);
         }
-    }
+    };
+    arena.execute(
+        [&] { tbb::parallel_for(std::size_t{0}, number_of_targets, search_column); });
+
+    auto search_space_with_buckets = joinColumnBuckets(column_buckets);
 
     // Order lookup buckets
-    std::sort(search_space_with_buckets.begin(), search_space_with_buckets.end());
+    arena.execute([&] {
+        tbb::parallel_sort(search_space_with_buckets.begin(), search_space_with_buckets.end());
+    });
 
-    // Find shortest paths from sources to all accessible nodes
-    for (std::uint32_t row_idx = 0; row_idx < source_indices.size(); ++row_idx)
-    {
+    // Find shortest paths from sources to all accessible nodes, every row writes its own entries
+    const auto search_row = [&](const std::size_t row_idx) {
         const auto index = source_indices[row_idx];
         const auto &phantom = phantom_nodes[index];
 
@@ -204,7 +295,7 @@ std::vector<EdgeDuration> manyToManySearch(SearchEngineData<ch::Algorithm> &engi
         insertSourceInHeap(query_heap, phantom);
 
         // Explore search space
-        while (!query_heap.Empty())
+        while (!query_heap.Empty() && query_heap.MinKey() < row_weight_bound)
         {
             forwardRoutingStep(facade,
                                row_idx,
@@ -213,11 +304,59 @@ std::vector<EdgeDuration> manyToManySearch(SearchEngineData<ch::Algorithm> &engi
                                search_space_with_buckets,
                                weights_table,
                                durations_table,
+                               middle_nodes_table,
                                phantom);
         }
-    }
 
-    return durations_table;
+        // Searches within the bounds can still meet at a weight above the upper bound
+        for (const auto location : util::irange<std::size_t>(row_idx * number_of_targets,
+                                                             (row_idx + 1) * number_of_targets))
+        {
+            if (weights_table[location] >= weight_upper_bound)
+            {
+                durations_table[location] = MAXIMAL_EDGE_DURATION;
+                middle_nodes_table[location] = SPECIAL_NODEID;
+            }
+        }
+
+        if (calculate_distance)
+        {
+            ch::calculateDistances(facade,
+                                   query_heap,
+                                   search_space_with_buckets,
+                                   phantom_nodes,
+                                   target_indices,
+                                   row_idx,
+                                   index,
+                                   middle_nodes_table,
+                                   distances_table);
+        }
+    };
+    arena.execute([&] { tbb::parallel_for(std::size_t{0}, number_of_sources, search_row); });
+
+    return std::make_pair(std::move(durations_table), std::move(distances_table));
+}
+
+// The CCH graph is a valid CH graph, so the CH bucket searches are used
+template <>
+std::pair<std::vector<EdgeDuration>, std::vector<EdgeDistance>>
+manyToManySearch(SearchEngineData<cch::Algorithm> &engine_working_data,
+                 const DataFacade<cch::Algorithm> &facade,
+                 const std::vector<PhantomNode> &phantom_nodes,
+                 const std::vector<std::size_t> &source_indices,
+                 const std::vector<std::size_t> &target_indices,
+                 const bool calculate_distance,
+                 const unsigned max_threads,
+                 const EdgeWeight weight_upper_bound)
+{
+    return manyToManySearch<ch::Algorithm>(engine_working_data,
+                                           facade,
+                                           phantom_nodes,
+                                           source_indices,
+                                           target_indices,
+                                           calculate_distance,
+                                           max_threads,
+                                           weight_upper_bound);
 }
 
 } // namespace routing_algorithms
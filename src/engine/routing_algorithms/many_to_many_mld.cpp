@@ -1,12 +1,19 @@
 #include "engine/routing_algorithms/many_to_many.hpp"
 #include "engine/routing_algorithms/routing_base.hpp"
+#include "engine/routing_algorithms/routing_base_mld.hpp"
 
 #include <boost/assert.hpp>
 #include <boost/range/iterator_range_core.hpp>
 
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+#include <tbb/task_arena.h>
+
+#include <algorithm>
 #include <limits>
 #include <memory>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -378,6 +385,7 @@ void forwardRoutingStep(const DataFacade<Algorithm> &facade,
                         const std::vector<NodeBucket> &search_space_with_buckets,
                         std::vector<EdgeWeight> &weights_table,
                         std::vector<EdgeDuration> &durations_table,
+                        std::vector<NodeID> &middle_nodes_table,
                         const PhantomNode &phantom_node)
 {
     const auto node = query_heap.DeleteMin();
@@ -404,6 +412,7 @@ void forwardRoutingStep(const DataFacade<Algorithm> &facade,
                                   : row_idx + column_idx * number_of_sources;
         auto &current_weight = weights_table[location];
         auto &current_duration = durations_table[location];
+        auto &current_middle_node = middle_nodes_table[location];
 
         // Check if new weight is better
         auto new_weight = source_weight + target_weight;
@@ -414,6 +423,7 @@ void forwardRoutingStep(const DataFacade<Algorithm> &facade,
         {
             current_weight = new_weight;
             current_duration = new_duration;
+            current_middle_node = node;
         }
     }
 
@@ -430,10 +440,16 @@ void backwardRoutingStep(const DataFacade<Algorithm> &facade,
 {
     const auto node = query_heap.DeleteMin();
     const auto target_weight = query_heap.GetKey(node);
-    const auto target_duration = query_heap.GetData(node).duration;
+    const auto &target_data = query_heap.GetData(node);
+    const auto target_duration = target_data.duration;
 
     // Store settled nodes in search space bucket
-    search_space_with_buckets.emplace_back(node, column_idx, target_weight, target_duration);
+    search_space_with_buckets.emplace_back(node,
+                                           target_data.parent,
+                                           target_data.from_clique_arc,
+                                           column_idx,
+                                           target_weight,
+                                           target_duration);
 
     const auto &partition = facade.GetMultiLevelPartition();
     const auto maximal_level = partition.GetNumberOfLevels() - 1;
@@ -442,25 +458,197 @@ void backwardRoutingStep(const DataFacade<Algorithm> &facade,
         facade, node, target_weight, target_duration, query_heap, phantom_node, maximal_level);
 }
 
+// An edge of a many-to-many path in travel direction. Overlay edges are unpacked within the cell
+// of `level` the settled node was relaxed in, which depends on the phantom of its search.
+struct ManyToManyPackedEdge
+{
+    NodeID from;
+    NodeID to;
+    bool from_clique_arc;
+    LevelID level;
+    CellID cell;
+};
+
+// Appends the edges from `node` to the root of its search tree, in the order they are traced
+template <bool DIRECTION, typename MultiLevelPartition, typename GetParent>
+void retrievePackedPathFromSearchSpace(const MultiLevelPartition &partition,
+                                       const PhantomNode &phantom_node,
+                                       NodeID node,
+                                       GetParent &&get_parent,
+                                       std::vector<ManyToManyPackedEdge> &packed_path)
+{
+    NodeID parent;
+    bool from_clique_arc;
+    for (std::tie(parent, from_clique_arc) = get_parent(node); parent != node;
+         node = parent, std::tie(parent, from_clique_arc) = get_parent(node))
+    {
+        // The parent is the settled node the edge was relaxed from
+        const auto level =
+            from_clique_arc ? getNodeQueryLevel(partition, parent, phantom_node) : LevelID{0};
+        const auto cell = from_clique_arc ? partition.GetCell(level, parent) : INVALID_CELL_ID;
+
+        if (DIRECTION == FORWARD_DIRECTION)
+            packed_path.push_back({parent, node, from_clique_arc, level, cell});
+        else
+            packed_path.push_back({node, parent, from_clique_arc, level, cell});
+    }
+}
+
+// Unpacks the shortest paths of a row and measures their geometry. One half of a path is taken
+// from the parents in the row heap, the other half from the parents stored in the buckets.
 template <bool DIRECTION>
-std::vector<EdgeDuration> manyToManySearch(SearchEngineData<Algorithm> &engine_working_data,
-                                           const DataFacade<Algorithm> &facade,
-                                           const std::vector<PhantomNode> &phantom_nodes,
-                                           const std::vector<std::size_t> &source_indices,
-                                           const std::vector<std::size_t> &target_indices)
+void calculateDistances(SearchEngineData<Algorithm> &engine_working_data,
+                        const DataFacade<Algorithm> &facade,
+                        const typename SearchEngineData<Algorithm>::ManyToManyQueryHeap &query_heap,
+                        const std::vector<NodeBucket> &search_space_with_buckets,
+                        const std::vector<PhantomNode> &phantom_nodes,
+                        const std::vector<std::size_t> &source_indices,
+                        const std::vector<std::size_t> &target_indices,
+                        const unsigned row_idx,
+                        const std::vector<NodeID> &middle_nodes_table,
+                        std::vector<EdgeDistance> &distances_table)
+{
+    const auto &partition = facade.GetMultiLevelPartition();
+    const auto number_of_sources = source_indices.size();
+    const auto number_of_targets = target_indices.size();
+    const auto &row_phantom = phantom_nodes[source_indices[row_idx]];
+
+    engine_working_data.InitializeOrClearFirstThreadLocalStorage(facade.GetNumberOfNodes());
+    auto &forward_heap = *engine_working_data.forward_heap_1;
+    auto &reverse_heap = *engine_working_data.reverse_heap_1;
+
+    std::vector<ManyToManyPackedEdge> row_path, column_path;
+    std::vector<NodeID> unpacked_nodes;
+    std::vector<EdgeID> unpacked_edges;
+    std::vector<PathData> unpacked_path;
+    for (unsigned column_idx = 0; column_idx < number_of_targets; ++column_idx)
+    {
+        const auto location = DIRECTION == FORWARD_DIRECTION
+                                  ? row_idx * number_of_targets + column_idx
+                                  : row_idx + column_idx * number_of_sources;
+        const auto middle_node = middle_nodes_table[location];
+        if (middle_node == SPECIAL_NODEID)
+            continue;
+
+        const auto &column_phantom = phantom_nodes[target_indices[column_idx]];
+
+        row_path.clear();
+        retrievePackedPathFromSearchSpace<DIRECTION>(
+            partition,
+            row_phantom,
+            middle_node,
+            [&](const NodeID node) {
+                const auto &data = query_heap.GetData(node);
+                return std::make_pair(data.parent, data.from_clique_arc);
+            },
+            row_path);
+
+        column_path.clear();
+        retrievePackedPathFromSearchSpace<!DIRECTION>(
+            partition,
+            column_phantom,
+            middle_node,
+            [&](const NodeID node) {
+                const auto &bucket = findBucket(search_space_with_buckets, node, column_idx);
+                return std::make_pair(bucket.parent_node, bucket.from_clique_arc);
+            },
+            column_path);
+
+        // Both halves are traced starting at the middle node, so the half that leads to it has
+        // to be reversed. For the reversed search the rows are the targets.
+        auto &source_path = DIRECTION == FORWARD_DIRECTION ? row_path : column_path;
+        const auto &target_path = DIRECTION == FORWARD_DIRECTION ? column_path : row_path;
+        std::reverse(source_path.begin(), source_path.end());
+        source_path.insert(source_path.end(), target_path.begin(), target_path.end());
+
+        unpacked_nodes.clear();
+        unpacked_edges.clear();
+        unpacked_nodes.push_back(source_path.empty() ? middle_node : source_path.front().from);
+        for (const auto &packed_edge : source_path)
+        {
+            if (!packed_edge.from_clique_arc)
+            {
+                unpacked_nodes.push_back(packed_edge.to);
+                unpacked_edges.push_back(facade.FindEdge(packed_edge.from, packed_edge.to));
+                continue;
+            }
+
+            forward_heap.Clear();
+            reverse_heap.Clear();
+            forward_heap.Insert(packed_edge.from, 0, {packed_edge.from});
+            reverse_heap.Insert(packed_edge.to, 0, {packed_edge.to});
+
+            std::vector<NodeID> subpath_nodes;
+            std::vector<EdgeID> subpath_edges;
+            std::tie(std::ignore, subpath_nodes, subpath_edges) =
+                search(engine_working_data,
+                       facade,
+                       forward_heap,
+                       reverse_heap,
+                       DO_NOT_FORCE_LOOPS,
+                       DO_NOT_FORCE_LOOPS,
+                       INVALID_EDGE_WEIGHT,
+                       packed_edge.level - 1,
+                       packed_edge.cell);
+            BOOST_ASSERT(subpath_nodes.size() > 1);
+            BOOST_ASSERT(subpath_nodes.front() == packed_edge.from);
+            BOOST_ASSERT(subpath_nodes.back() == packed_edge.to);
+            unpacked_nodes.insert(
+                unpacked_nodes.end(), std::next(subpath_nodes.begin()), subpath_nodes.end());
+            unpacked_edges.insert(unpacked_edges.end(), subpath_edges.begin(), subpath_edges.end());
+        }
+
+        const auto &source_phantom = DIRECTION == FORWARD_DIRECTION ? row_phantom : column_phantom;
+        const auto &target_phantom = DIRECTION == FORWARD_DIRECTION ? column_phantom : row_phantom;
+        unpacked_path.clear();
+        annotatePath(facade,
+                     {source_phantom, target_phantom},
+                     unpacked_nodes,
+                     unpacked_edges,
+                     unpacked_path);
+        distances_table[location] =
+            getPathDistance(facade, unpacked_path, source_phantom, target_phantom);
+    }
+}
+
+template <bool DIRECTION>
+std::pair<std::vector<EdgeDuration>, std::vector<EdgeDistance>>
+manyToManySearch(SearchEngineData<Algorithm> &engine_working_data,
+                 const DataFacade<Algorithm> &facade,
+                 const std::vector<PhantomNode> &phantom_nodes,
+                 const std::vector<std::size_t> &source_indices,
+                 const std::vector<std::size_t> &target_indices,
+                 const bool calculate_distance,
+                 const unsigned max_threads,
+                 const EdgeWeight weight_upper_bound)
 {
     const auto number_of_sources = source_indices.size();
     const auto number_of_targets = target_indices.size();
     const auto number_of_entries = number_of_sources * number_of_targets;
 
+    // Only searches from the sources start at negative weights, for the reversed search these
+    // are the columns
+    const auto column_weight_bound = getSearchWeightBound(
+        weight_upper_bound,
+        DIRECTION == FORWARD_DIRECTION ? getMinimalSourceWeight(phantom_nodes, source_indices)
+                                       : 0);
+    const auto row_weight_bound = getSearchWeightBound(
+        weight_upper_bound,
+        DIRECTION == FORWARD_DIRECTION ? 0
+                                       : getMinimalSourceWeight(phantom_nodes, target_indices));
+
     std::vector<EdgeWeight> weights_table(number_of_entries, INVALID_EDGE_WEIGHT);
     std::vector<EdgeDuration> durations_table(number_of_entries, MAXIMAL_EDGE_DURATION);
+    std::vector<NodeID> middle_nodes_table(number_of_entries, SPECIAL_NODEID);
+    std::vector<EdgeDistance> distances_table(calculate_distance ? number_of_entries : 0,
+                                              INVALID_EDGE_DISTANCE);
 
-    std::vector<NodeBucket> search_space_with_buckets;
+    // Columns and rows are searched independently, every search uses the heaps of its thread
+    tbb::task_arena arena(std::max(1u, max_threads));
 
     // Populate buckets with paths from all accessible nodes to destinations via backward searches
-    for (std::uint32_t column_idx = 0; column_idx < target_indices.size(); ++column_idx)
-    {
+    std::vector<std::vector<NodeBucket>> column_buckets(number_of_targets);
+    const auto search_column = [&](const std::size_t column_idx) {
         const auto index = target_indices[column_idx];
         const auto &phantom = phantom_nodes[index];
 
@@ -474,19 +662,24 @@ std::vector<EdgeDuration> manyToManySearch(SearchEngineData<Algorithm> &engine_w
             insertSourceInHeap(query_heap, phantom);
 
         // explore search space
-        while (!query_heap.Empty())
+        while (!query_heap.Empty() && query_heap.MinKey() < column_weight_bound)
         {
             backwardRoutingStep<DIRECTION>(
-                facade, column_idx, query_heap, search_space_with_buckets, phantom);
+                facade, column_idx, query_heap, column_buckets[column_idx], phantom);
         }
-    }
+    };
+    arena.execute(
+        [&] { tbb::parallel_for(std::size_t{0}, number_of_targets, search_column); });
+
+    auto search_space_with_buckets = joinColumnBuckets(column_buckets);
 
     // Order lookup buckets
-    std::sort(search_space_with_buckets.begin(), search_space_with_buckets.end());
+    arena.execute([&] {
+        tbb::parallel_sort(search_space_with_buckets.begin(), search_space_with_buckets.end());
+    });
 
-    // Find shortest paths from sources to all accessible nodes
-    for (std::uint32_t row_idx = 0; row_idx < source_indices.size(); ++row_idx)
-    {
+    // Find shortest paths from sources to all accessible nodes, every row writes its own entries
+    const auto search_row = [&](const std::size_t row_idx) {
         const auto index = source_indices[row_idx];
         const auto &phantom = phantom_nodes[index];
 
@@ -501,7 +694,7 @@ std::vector<EdgeDuration> manyToManySearch(SearchEngineData<Algorithm> &engine_w
             insertTargetInHeap(query_heap, phantom);
 
         // Explore search space
-        while (!query_heap.Empty())
+        while (!query_heap.Empty() && query_heap.MinKey() < row_weight_bound)
         {
             forwardRoutingStep<DIRECTION>(facade,
                                           row_idx,
@@ -511,11 +704,40 @@ std::vector<EdgeDuration> manyToManySearch(SearchEngineData<Algorithm> &engine_w
                                           search_space_with_buckets,
                                           weights_table,
                                           durations_table,
+                                          middle_nodes_table,
                                           phantom);
         }
-    }
 
-    return durations_table;
+        // Searches within the bounds can still meet at a weight above the upper bound
+        for (unsigned column_idx = 0; column_idx < number_of_targets; ++column_idx)
+        {
+            const auto location = DIRECTION == FORWARD_DIRECTION
+                                      ? row_idx * number_of_targets + column_idx
+                                      : row_idx + column_idx * number_of_sources;
+            if (weights_table[location] >= weight_upper_bound)
+            {
+                durations_table[location] = MAXIMAL_EDGE_DURATION;
+                middle_nodes_table[location] = SPECIAL_NODEID;
+            }
+        }
+
+        if (calculate_distance)
+        {
+            calculateDistances<DIRECTION>(engine_working_data,
+                                          facade,
+                                          query_heap,
+                                          search_space_with_buckets,
+                                          phantom_nodes,
+                                          source_indices,
+                                          target_indices,
+                                          row_idx,
+                                          middle_nodes_table,
+                                          distances_table);
+        }
+    };
+    arena.execute([&] { tbb::parallel_for(std::size_t{0}, number_of_sources, search_row); });
+
+    return std::make_pair(std::move(durations_table), std::move(distances_table));
 }
 
 } // namespace mld
@@ -532,33 +754,59 @@ std::vector<EdgeDuration> manyToManySearch(SearchEngineData<Algorithm> &engine_w
 //   when number of sources is less than targets. If number of targets is less than sources
 //   then search is performed on a reversed graph with phantom nodes with flipped roles and
 //   returning a transposed matrix.
+//
+// Distances need the paths to be unpacked and the search bounded by a weight upper bound, both
+// are implemented for the bidirectional search only. So one-to-many tasks that need either are
+// handled as many-to-many tasks.
 template <>
-std::vector<EdgeDuration> manyToManySearch(SearchEngineData<mld::Algorithm> &engine_working_data,
-                                           const DataFacade<mld::Algorithm> &facade,
-                                           const std::vector<PhantomNode> &phantom_nodes,
-                                           const std::vector<std::size_t> &source_indices,
-                                           const std::vector<std::size_t> &target_indices)
+std::pair<std::vector<EdgeDuration>, std::vector<EdgeDistance>>
+manyToManySearch(SearchEngineData<mld::Algorithm> &engine_working_data,
+                 const DataFacade<mld::Algorithm> &facade,
+                 const std::vector<PhantomNode> &phantom_nodes,
+                 const std::vector<std::size_t> &source_indices,
+                 const std::vector<std::size_t> &target_indices,
+                 const bool calculate_distance,
+                 const unsigned max_threads,
+                 const EdgeWeight weight_upper_bound)
 {
-    if (source_indices.size() == 1)
+    if (source_indices.size() == 1 && !calculate_distance &&
+        weight_upper_bound == INVALID_EDGE_WEIGHT)
     { // TODO: check if target_indices.size() == 1 and do a bi-directional search
-        return mld::oneToManySearch<FORWARD_DIRECTION>(
-            engine_working_data, facade, phantom_nodes, source_indices.front(), target_indices);
+        return std::make_pair(
+            mld::oneToManySearch<FORWARD_DIRECTION>(
+                engine_working_data, facade, phantom_nodes, source_indices.front(), target_indices),
+            std::vector<EdgeDistance>());
     }
 
-    if (target_indices.size() == 1)
+    if (target_indices.size() == 1 && !calculate_distance &&
+        weight_upper_bound == INVALID_EDGE_WEIGHT)
     {
-        return mld::oneToManySearch<REVERSE_DIRECTION>(
-            engine_working_data, facade, phantom_nodes, target_indices.front(), source_indices);
+        return std::make_pair(
+            mld::oneToManySearch<REVERSE_DIRECTION>(
+                engine_working_data, facade, phantom_nodes, target_indices.front(), source_indices),
+            std::vector<EdgeDistance>());
     }
 
     if (target_indices.size() < source_indices.size())
     {
-        return mld::manyToManySearch<REVERSE_DIRECTION>(
-            engine_working_data, facade, phantom_nodes, target_indices, source_indices);
+        return mld::manyToManySearch<REVERSE_DIRECTION>(engine_working_data,
+                                                        facade,
+                                                        phantom_nodes,
+                                                        target_indices,
+                                                        source_indices,
+                                                        calculate_distance,
+                                                        max_threads,
+                                                        weight_upper_bound);
     }
 
-    return mld::manyToManySearch<FORWARD_DIRECTION>(
-        engine_working_data, facade, phantom_nodes, source_indices, target_indices);
+    return mld::manyToManySearch<FORWARD_DIRECTION>(engine_working_data,
+                                                    facade,
+                                                    phantom_nodes,
+                                                    source_indices,
+                                                    target_indices,
+                                                    calculate_distance,
+                                                    max_threads,
+                                                    weight_upper_bound);
 }
 
 } // namespace routing_algorithms
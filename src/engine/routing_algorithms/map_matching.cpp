@@ -1,6 +1,5 @@
 #include "engine/routing_algorithms/map_matching.hpp"
-#include "engine/routing_algorithms/routing_base_ch.hpp"
-#include "engine/routing_algorithms/routing_base_mld.hpp"
+#include "engine/routing_algorithms/many_to_many.hpp"
 
 #include "engine/map_matching/hidden_markov_model.hpp"
 #include "engine/map_matching/matching_confidence.hpp"
@@ -46,26 +45,37 @@ unsigned getMedianSampleTime(const std::vector<unsigned> &timestamps)
     std::nth_element(first_elem, median, sample_times.end());
     return *median;
 }
+
+std::vector<double> getEmissionLogProbabilities(const CandidateList &candidates,
+                                                const boost::optional<double> &gps_precision)
+{
+    const map_matching::EmissionLogProbability emission_log_probability(
+        gps_precision ? *gps_precision : DEFAULT_GPS_PRECISION);
+
+    std::vector<double> emission_log_probabilities(candidates.size());
+    std::transform(candidates.begin(),
+                   candidates.end(),
+                   emission_log_probabilities.begin(),
+                   [&emission_log_probability](const PhantomNodeWithDistance &candidate) {
+                       return emission_log_probability(candidate.distance);
+                   });
+    return emission_log_probabilities;
 }
 
+// Runs the forward pass of the Viterbi algorithm from the frontier to the end of the trace
 template <typename Algorithm>
-SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
-                            const DataFacade<Algorithm> &facade,
-                            const CandidateLists &candidates_list,
-                            const std::vector<util::Coordinate> &trace_coordinates,
-                            const std::vector<unsigned> &trace_timestamps,
-                            const std::vector<boost::optional<double>> &trace_gps_precision,
-                            const bool allow_splitting)
+void computeViterbi(SearchEngineData<Algorithm> &engine_working_data,
+                    const DataFacade<Algorithm> &facade,
+                    HMM &model,
+                    const CandidateLists &candidates_list,
+                    const std::vector<util::Coordinate> &trace_coordinates,
+                    const std::vector<unsigned> &trace_timestamps,
+                    const std::vector<std::vector<double>> &emission_log_probabilities,
+                    const bool allow_splitting,
+                    ViterbiFrontier &frontier)
 {
-    map_matching::MatchingConfidence confidence;
-    map_matching::EmissionLogProbability default_emission_log_probability(DEFAULT_GPS_PRECISION);
     map_matching::TransitionLogProbability transition_log_probability(MATCHING_BETA);
 
-    SubMatchingList sub_matchings;
-
-    BOOST_ASSERT(candidates_list.size() == trace_coordinates.size());
-    BOOST_ASSERT(candidates_list.size() > 1);
-
     const bool use_timestamps = trace_timestamps.size() > 1;
 
     const auto median_sample_time = [&] {
@@ -80,69 +90,35 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
     }();
     const auto max_broken_time = median_sample_time * MAX_BROKEN_STATES;
 
-    std::vector<std::vector<double>> emission_log_probabilities(trace_coordinates.size());
-    if (trace_gps_precision.empty())
+    auto &prev_unbroken_timestamps = frontier.prev_unbroken_timestamps;
+    auto &breakage_begin = frontier.breakage_begin;
+    auto &split_points = frontier.split_points;
+
+    auto t = frontier.next_timestamp;
+    frontier.next_timestamp = candidates_list.size();
+    if (prev_unbroken_timestamps.empty())
     {
-        for (auto t = 0UL; t < candidates_list.size(); ++t)
+        if (t >= candidates_list.size())
         {
-            emission_log_probabilities[t].resize(candidates_list[t].size());
-            std::transform(candidates_list[t].begin(),
-                           candidates_list[t].end(),
-                           emission_log_probabilities[t].begin(),
-                           [&](const PhantomNodeWithDistance &candidate) {
-                               return default_emission_log_probability(candidate.distance);
-                           });
+            return;
         }
-    }
-    else
-    {
-        for (auto t = 0UL; t < candidates_list.size(); ++t)
+
+        std::size_t initial_timestamp = model.initialize(t);
+        if (initial_timestamp == map_matching::INVALID_STATE)
         {
-            emission_log_probabilities[t].resize(candidates_list[t].size());
-            if (trace_gps_precision[t])
-            {
-                map_matching::EmissionLogProbability emission_log_probability(
-                    *trace_gps_precision[t]);
-                std::transform(
-                    candidates_list[t].begin(),
-                    candidates_list[t].end(),
-                    emission_log_probabilities[t].begin(),
-                    [&emission_log_probability](const PhantomNodeWithDistance &candidate) {
-                        return emission_log_probability(candidate.distance);
-                    });
-            }
-            else
-            {
-                std::transform(candidates_list[t].begin(),
-                               candidates_list[t].end(),
-                               emission_log_probabilities[t].begin(),
-                               [&](const PhantomNodeWithDistance &candidate) {
-                                   return default_emission_log_probability(candidate.distance);
-                               });
-            }
+            return;
         }
-    }
 
-    HMM model(candidates_list, emission_log_probabilities);
-
-    std::size_t initial_timestamp = model.initialize(0);
-    if (initial_timestamp == map_matching::INVALID_STATE)
-    {
-        return sub_matchings;
+        prev_unbroken_timestamps.push_back(initial_timestamp);
+        t = initial_timestamp + 1;
     }
 
-    const auto nodes_number = facade.GetNumberOfNodes();
-    engine_working_data.InitializeOrClearFirstThreadLocalStorage(nodes_number);
+    std::vector<PhantomNode> step_phantom_nodes;
+    std::vector<std::size_t> step_sources;
+    std::vector<std::size_t> source_indices;
+    std::vector<std::size_t> target_indices;
 
-    auto &forward_heap = *engine_working_data.forward_heap_1;
-    auto &reverse_heap = *engine_working_data.reverse_heap_1;
-
-    std::size_t breakage_begin = map_matching::INVALID_STATE;
-    std::vector<std::size_t> split_points;
-    std::vector<std::size_t> prev_unbroken_timestamps;
-    prev_unbroken_timestamps.reserve(candidates_list.size());
-    prev_unbroken_timestamps.push_back(initial_timestamp);
-    for (auto t = initial_timestamp + 1; t < candidates_list.size(); ++t)
+    for (; t < candidates_list.size(); ++t)
     {
 
         const auto step_time = [&] {
@@ -203,13 +179,45 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
             const EdgeWeight weight_upper_bound =
                 ((haversine_distance + max_distance_delta) / 4.) * facade.GetWeightMultiplier();
 
-            // compute d_t for this timestamp and the next one
+            // One search per candidate finds the network distances of all transitions of this
+            // step, instead of one search per pair of candidates. Pruned candidates are skipped.
+            step_phantom_nodes.clear();
+            step_sources.clear();
+            source_indices.clear();
+            target_indices.clear();
             for (const auto s : util::irange<std::size_t>(0UL, prev_viterbi.size()))
             {
-                if (prev_pruned[s])
+                if (!prev_pruned[s])
                 {
-                    continue;
+                    step_sources.push_back(s);
+                    source_indices.push_back(step_phantom_nodes.size());
+                    step_phantom_nodes.push_back(prev_unbroken_timestamps_list[s].phantom_node);
                 }
+            }
+            for (const auto &candidate : current_timestamps_list)
+            {
+                target_indices.push_back(step_phantom_nodes.size());
+                step_phantom_nodes.push_back(candidate.phantom_node);
+            }
+
+            std::vector<EdgeDistance> network_distances;
+            if (!step_sources.empty())
+            {
+                std::tie(std::ignore, network_distances) =
+                    manyToManySearch(engine_working_data,
+                                     facade,
+                                     step_phantom_nodes,
+                                     source_indices,
+                                     target_indices,
+                                     true,
+                                     1,
+                                     weight_upper_bound);
+            }
+
+            // compute d_t for this timestamp and the next one
+            for (const auto row : util::irange<std::size_t>(0UL, step_sources.size()))
+            {
+                const auto s = step_sources[row];
 
                 for (const auto s_prime : util::irange<std::size_t>(0UL, current_viterbi.size()))
                 {
@@ -220,14 +228,13 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
                         continue;
                     }
 
-                    double network_distance =
-                        getNetworkDistance(engine_working_data,
-                                           facade,
-                                           forward_heap,
-                                           reverse_heap,
-                                           prev_unbroken_timestamps_list[s].phantom_node,
-                                           current_timestamps_list[s_prime].phantom_node,
-                                           weight_upper_bound);
+                    const auto path_distance =
+                        network_distances[row * current_viterbi.size() + s_prime];
+                    if (path_distance == INVALID_EDGE_DISTANCE)
+                    {
+                        continue;
+                    }
+                    const double network_distance = path_distance;
 
                     // get distance diff between loc1/2 and locs/s_prime
                     const auto d_t = std::abs(network_distance - haversine_distance);
@@ -285,6 +292,7 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
 
             // note: this preserves everything before split_index
             model.Clear(split_index);
+            prev_unbroken_timestamps.clear();
             std::size_t new_start = model.initialize(split_index);
             // no new start was found -> stop viterbi calculation
             if (new_start == map_matching::INVALID_STATE)
@@ -292,7 +300,6 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
                 break;
             }
 
-            prev_unbroken_timestamps.clear();
             prev_unbroken_timestamps.push_back(new_start);
             // Important: We potentially go back here!
             // However since t > new_start >= breakge_begin
@@ -302,19 +309,40 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
             // iteration will actually be on new_start+1
         }
     }
+}
+
+// Reconstructs the most likely paths of the sub matchings that end after `first_reported`.
+// Paths stop at the last point before `first_reported`.
+SubMatchingList getSubMatchings(HMM &model,
+                                const CandidateLists &candidates_list,
+                                const std::vector<util::Coordinate> &trace_coordinates,
+                                const ViterbiFrontier &frontier,
+                                const std::size_t first_reported)
+{
+    map_matching::MatchingConfidence confidence;
+
+    SubMatchingList sub_matchings;
 
-    if (!prev_unbroken_timestamps.empty())
+    auto sub_matching_ends = frontier.split_points;
+    if (!frontier.prev_unbroken_timestamps.empty())
     {
-        split_points.push_back(prev_unbroken_timestamps.back() + 1);
+        sub_matching_ends.push_back(frontier.prev_unbroken_timestamps.back() + 1);
     }
 
-    std::size_t sub_matching_begin = initial_timestamp;
-    for (const auto sub_matching_end : split_points)
+    // all points before the first start are breakages
+    std::size_t sub_matching_begin = 0;
+    for (const auto sub_matching_end : sub_matching_ends)
     {
+        if (sub_matching_end <= first_reported)
+        {
+            sub_matching_begin = sub_matching_end;
+            continue;
+        }
+
         map_matching::SubMatching matching;
 
         std::size_t parent_timestamp_index = sub_matching_end - 1;
-        while (parent_timestamp_index >= sub_matching_begin &&
+        while (parent_timestamp_index > sub_matching_begin &&
                model.breakage[parent_timestamp_index])
         {
             --parent_timestamp_index;
@@ -326,7 +354,7 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
         const auto sub_matching_last_timestamp = parent_timestamp_index;
 
         // matchings that only consist of one candidate are invalid
-        if (parent_timestamp_index - sub_matching_begin + 1 < 2)
+        if (parent_timestamp_index < sub_matching_begin + 1)
         {
             sub_matching_begin = sub_matching_end;
             continue;
@@ -341,7 +369,8 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
             std::distance(model.viterbi[parent_timestamp_index].begin(), max_element_iter);
 
         std::deque<std::pair<std::size_t, std::size_t>> reconstructed_indices;
-        while (parent_timestamp_index > sub_matching_begin)
+        while (parent_timestamp_index > sub_matching_begin &&
+               parent_timestamp_index >= first_reported)
         {
             reconstructed_indices.emplace_front(parent_timestamp_index, parent_candidate_index);
             model.viterbi_reachable[parent_timestamp_index][parent_candidate_index] = true;
@@ -368,7 +397,8 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
         {
             parent_timestamp_index = sub_matching_last_timestamp;
             parent_candidate_index = s_last;
-            while (parent_timestamp_index > sub_matching_begin)
+            while (parent_timestamp_index > sub_matching_begin &&
+                   parent_timestamp_index >= first_reported)
             {
                 if (model.viterbi_reachable[parent_timestamp_index][parent_candidate_index] ||
                     model.pruned[parent_timestamp_index][parent_candidate_index])
@@ -401,12 +431,13 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
             BOOST_ASSERT(routes_count > 0);
             // we don't count the current route in the "alternatives_count" parameter
             matching.alternatives_count.push_back(routes_count - 1);
-            matching_distance += model.path_distances[timestamp_index][location_index];
         }
+        // the path distance of a point is the one from its parent, the first point has none
         util::for_each_pair(
             reconstructed_indices,
-            [&trace_distance, &trace_coordinates](const std::pair<std::size_t, std::size_t> &prev,
-                                                  const std::pair<std::size_t, std::size_t> &curr) {
+            [&](const std::pair<std::size_t, std::size_t> &prev,
+                const std::pair<std::size_t, std::size_t> &curr) {
+                matching_distance += model.path_distances[curr.first][curr.second];
                 trace_distance += util::coordinate_calculation::haversineDistance(
                     trace_coordinates[prev.first], trace_coordinates[curr.first]);
             });
@@ -419,6 +450,133 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
 
     return sub_matchings;
 }
+}
+
+void MapMatchingState::AddPoint(CandidateList candidates,
+                                const util::Coordinate coordinate,
+                                const boost::optional<unsigned> timestamp,
+                                const boost::optional<double> gps_precision)
+{
+    BOOST_ASSERT(trace_coordinates.empty() ||
+                 static_cast<bool>(timestamp) ==
+                     (trace_timestamps.size() == trace_coordinates.size()));
+
+    emission_log_probabilities.push_back(getEmissionLogProbabilities(candidates, gps_precision));
+    candidates_list.push_back(std::move(candidates));
+    trace_coordinates.push_back(coordinate);
+    if (timestamp)
+    {
+        trace_timestamps.push_back(*timestamp);
+    }
+    model.Extend();
+}
+
+void MapMatchingState::Shrink(const std::size_t max_points)
+{
+    if (candidates_list.size() <= max_points)
+    {
+        return;
+    }
+
+    auto count = candidates_list.size() - max_points / 2;
+    // the forward pass continues at the last unbroken point
+    count = std::min(count, frontier.next_timestamp);
+    if (!frontier.prev_unbroken_timestamps.empty())
+    {
+        count = std::min(count, frontier.prev_unbroken_timestamps.back());
+    }
+    if (count == 0)
+    {
+        return;
+    }
+
+    candidates_list.erase(candidates_list.begin(), candidates_list.begin() + count);
+    trace_coordinates.erase(trace_coordinates.begin(), trace_coordinates.begin() + count);
+    if (!trace_timestamps.empty())
+    {
+        trace_timestamps.erase(trace_timestamps.begin(), trace_timestamps.begin() + count);
+    }
+    emission_log_probabilities.erase(emission_log_probabilities.begin(),
+                                     emission_log_probabilities.begin() + count);
+    model.Erase(count);
+
+    const auto shift = [count](std::vector<std::size_t> &timestamps) {
+        const auto erased = [count](const auto timestamp) { return timestamp < count; };
+        timestamps.erase(std::remove_if(timestamps.begin(), timestamps.end(), erased),
+                         timestamps.end());
+        for (auto &timestamp : timestamps)
+        {
+            timestamp -= count;
+        }
+    };
+    shift(frontier.prev_unbroken_timestamps);
+    shift(frontier.split_points);
+    // a split at a dropped point restarts the matching at the first kept one
+    if (frontier.breakage_begin != map_matching::INVALID_STATE)
+    {
+        frontier.breakage_begin = std::max(frontier.breakage_begin, count) - count;
+    }
+    frontier.next_timestamp -= count;
+}
+
+template <typename Algorithm>
+SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
+                            const DataFacade<Algorithm> &facade,
+                            const CandidateLists &candidates_list,
+                            const std::vector<util::Coordinate> &trace_coordinates,
+                            const std::vector<unsigned> &trace_timestamps,
+                            const std::vector<boost::optional<double>> &trace_gps_precision,
+                            const bool allow_splitting)
+{
+    BOOST_ASSERT(candidates_list.size() == trace_coordinates.size());
+    BOOST_ASSERT(candidates_list.size() > 1);
+
+    std::vector<std::vector<double>> emission_log_probabilities(trace_coordinates.size());
+    for (auto t = 0UL; t < candidates_list.size(); ++t)
+    {
+        emission_log_probabilities[t] = getEmissionLogProbabilities(
+            candidates_list[t],
+            trace_gps_precision.empty() ? boost::none : trace_gps_precision[t]);
+    }
+
+    HMM model(candidates_list, emission_log_probabilities);
+    ViterbiFrontier frontier;
+    computeViterbi(engine_working_data,
+                   facade,
+                   model,
+                   candidates_list,
+                   trace_coordinates,
+                   trace_timestamps,
+                   emission_log_probabilities,
+                   allow_splitting,
+                   frontier);
+
+    return getSubMatchings(model, candidates_list, trace_coordinates, frontier, 0);
+}
+
+template <typename Algorithm>
+SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
+                            const DataFacade<Algorithm> &facade,
+                            MapMatchingState &state,
+                            const bool allow_splitting)
+{
+    const auto first_new_timestamp = state.frontier.next_timestamp;
+    computeViterbi(engine_working_data,
+                   facade,
+                   state.model,
+                   state.candidates_list,
+                   state.trace_coordinates,
+                   state.trace_timestamps,
+                   state.emission_log_probabilities,
+                   allow_splitting,
+                   state.frontier);
+
+    return getSubMatchings(state.model,
+                           state.candidates_list,
+                           state.trace_coordinates,
+                           state.frontier,
+                           first_new_timestamp);
+}
 
 // CH
 template SubMatchingList
@@ -430,6 +588,11 @@ mapMatching(SearchEngineData<ch::Algorithm> &engine_working_data,
             const std::vector<boost::optional<double>> &trace_gps_precision,
             const bool allow_splitting);
 
+template SubMatchingList mapMatching(SearchEngineData<ch::Algorithm> &engine_working_data,
+                                     const DataFacade<ch::Algorithm> &facade,
+                                     MapMatchingState &state,
+                                     const bool allow_splitting);
+
 // MLD
 template SubMatchingList
 mapMatching(SearchEngineData<mld::Algorithm> &engine_working_data,
@@ -440,6 +603,26 @@ mapMatching(SearchEngineData<mld::Algorithm> &engine_working_data,
             const std::vector<boost::optional<double>> &trace_gps_precision,
             const bool allow_splitting);
 
+template SubMatchingList mapMatching(SearchEngineData<mld::Algorithm> &engine_working_data,
+                                     const DataFacade<mld::Algorithm> &facade,
+                                     MapMatchingState &state,
+                                     const bool allow_splitting);
+
+// CCH
+template SubMatchingList
+mapMatching(SearchEngineData<cch::Algorithm> &engine_working_data,
+            const DataFacade<cch::Algorithm> &facade,
+            const CandidateLists &candidates_list,
+            const std::vector<util::Coordinate> &trace_coordinates,
+            const std::vector<unsigned> &trace_timestamps,
+            const std::vector<boost::optional<double>> &trace_gps_precision,
+            const bool allow_splitting);
+
+template SubMatchingList mapMatching(SearchEngineData<cch::Algorithm> &engine_working_data,
+                                     const DataFacade<cch::Algorithm> &facade,
+                                     MapMatchingState &state,
+                                     const bool allow_splitting);
+
 } // namespace routing_algorithms
 } // namespace engine
 } // namespace osrm
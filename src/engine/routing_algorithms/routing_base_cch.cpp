@@ -0,0 +1,241 @@
+#include "engine/routing_algorithms/routing_base_cch.hpp"
+
+#include <algorithm>
+
+namespace osrm
+{
+namespace engine
+{
+namespace routing_algorithms
+{
+namespace cch
+{
+
+namespace
+{
+using QueryHeap = SearchEngineData<Algorithm>::QueryHeap;
+
+// Takes the start nodes out of the priority queue of the heap, so that their weights can still
+// be decreased. Adds the elimination tree paths of the start nodes to the search space.
+void initializeSearchSpace(const DataFacade<Algorithm> &facade,
+                           QueryHeap &heap,
+                           std::vector<NodeID> &search_space)
+{
+    struct StartNode
+    {
+        NodeID node;
+        EdgeWeight weight;
+        QueryHeap::DataType data;
+    };
+
+    std::vector<StartNode> start_nodes;
+    while (!heap.Empty())
+    {
+        const auto node = heap.Min();
+        start_nodes.push_back({node, heap.MinKey(), heap.GetData(node)});
+        heap.DeleteMin();
+    }
+
+    heap.Clear();
+    for (const auto &start_node : start_nodes)
+    {
+        heap.Insert(start_node.node, start_node.weight, start_node.data);
+
+        for (auto node = start_node.node; node != SPECIAL_NODEID;
+             node = facade.GetEliminationTreeParent(node))
+        {
+            search_space.push_back(node);
+        }
+    }
+}
+
+void routingStep(const DataFacade<Algorithm> &facade,
+                 QueryHeap &forward_heap,
+                 QueryHeap &reverse_heap,
+                 const NodeID node,
+                 NodeID &middle_node_id,
+                 EdgeWeight &upper_bound,
+                 const EdgeWeight min_edge_offset,
+                 const bool force_loop_forward,
+                 const bool force_loop_reverse)
+{
+    const auto in_forward_heap = forward_heap.WasInserted(node);
+    const auto in_reverse_heap = reverse_heap.WasInserted(node);
+
+    // the weights of a node are final once it is settled, all its predecessors have lower ranks
+    if (in_forward_heap && in_reverse_heap)
+    {
+        const EdgeWeight new_weight = forward_heap.GetKey(node) + reverse_heap.GetKey(node);
+        if (new_weight < upper_bound)
+        {
+            // if loops are forced, they are so at the source
+            if ((force_loop_forward && forward_heap.GetData(node).parent == node) ||
+                (force_loop_reverse && reverse_heap.GetData(node).parent == node) ||
+                // in this case we are looking at a bi-directional way where the source
+                // and target phantom are on the same edge based node
+                new_weight < 0)
+            {
+                // check whether there is a loop present at the node
+                for (const auto edge : facade.GetAdjacentEdgeRange(node))
+                {
+                    const auto &data = facade.GetEdgeData(edge);
+                    if (data.forward && facade.GetTarget(edge) == node)
+                    {
+                        const EdgeWeight loop_weight = new_weight + data.weight;
+                        if (loop_weight >= 0 && loop_weight < upper_bound)
+                        {
+                            middle_node_id = node;
+                            upper_bound = loop_weight;
+                        }
+                    }
+                }
+            }
+            else
+            {
+                BOOST_ASSERT(new_weight >= 0);
+
+                middle_node_id = node;
+                upper_bound = new_weight;
+            }
+        }
+    }
+
+    // the weights aren't monotone in the rank, so only the edges of this node are pruned
+    if (in_forward_heap)
+    {
+        const auto weight = forward_heap.GetKey(node);
+        if (weight + min_edge_offset <= upper_bound)
+        {
+            ch::relaxOutgoingEdges<FORWARD_DIRECTION>(facade, node, weight, forward_heap);
+        }
+    }
+    if (in_reverse_heap)
+    {
+        const auto weight = reverse_heap.GetKey(node);
+        if (weight + min_edge_offset <= upper_bound)
+        {
+            ch::relaxOutgoingEdges<REVERSE_DIRECTION>(facade, node, weight, reverse_heap);
+        }
+    }
+}
+}
+
+void search(SearchEngineData<Algorithm> & /*engine_working_data*/,
+            const DataFacade<Algorithm> &facade,
+            SearchEngineData<Algorithm>::QueryHeap &forward_heap,
+            SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
+            EdgeWeight &weight,
+            std::vector<NodeID> &packed_leg,
+            const bool force_loop_forward,
+            const bool force_loop_reverse,
+            const PhantomNodes & /*phantom_nodes*/,
+            const EdgeWeight weight_upper_bound)
+{
+    if (forward_heap.Empty() || reverse_heap.Empty())
+    {
+        weight = INVALID_EDGE_WEIGHT;
+        return;
+    }
+
+    NodeID middle = SPECIAL_NODEID;
+    weight = weight_upper_bound;
+
+    // get offset to account for offsets on phantom nodes on compressed edges
+    const auto min_edge_offset = std::min(0, forward_heap.MinKey());
+    BOOST_ASSERT(min_edge_offset <= 0);
+    // we only every insert negative offsets for nodes in the forward heap
+    BOOST_ASSERT(reverse_heap.MinKey() >= 0);
+
+    std::vector<NodeID> search_space;
+    initializeSearchSpace(facade, forward_heap, search_space);
+    initializeSearchSpace(facade, reverse_heap, search_space);
+    std::sort(search_space.begin(),
+              search_space.end(),
+              [&facade](const NodeID lhs, const NodeID rhs) {
+                  return facade.GetRank(lhs) < facade.GetRank(rhs);
+              });
+    search_space.erase(std::unique(search_space.begin(), search_space.end()), search_space.end());
+
+    for (const auto node : search_space)
+    {
+        routingStep(facade,
+                    forward_heap,
+                    reverse_heap,
+                    node,
+                    middle,
+                    weight,
+                    min_edge_offset,
+                    force_loop_forward,
+                    force_loop_reverse);
+    }
+    forward_heap.DeleteAll();
+    reverse_heap.DeleteAll();
+
+    // No path found for both target nodes?
+    if (weight_upper_bound <= weight || SPECIAL_NODEID == middle)
+    {
+        weight = INVALID_EDGE_WEIGHT;
+        return;
+    }
+
+    // Was a paths over one of the forward/reverse nodes not found?
+    BOOST_ASSERT_MSG((SPECIAL_NODEID != middle && INVALID_EDGE_WEIGHT != weight), "no path found");
+
+    // make sure to correctly unpack loops
+    if (weight != forward_heap.GetKey(middle) + reverse_heap.GetKey(middle))
+    {
+        // self loop makes up the full path
+        packed_leg.push_back(middle);
+        packed_leg.push_back(middle);
+    }
+    else
+    {
+        ch::retrievePackedPathFromHeap(forward_heap, reverse_heap, middle, packed_leg);
+    }
+}
+
+double getNetworkDistance(SearchEngineData<Algorithm> &engine_working_data,
+                          const DataFacade<Algorithm> &facade,
+                          SearchEngineData<Algorithm>::QueryHeap &forward_heap,
+                          SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
+                          const PhantomNode &source_phantom,
+                          const PhantomNode &target_phantom,
+                          EdgeWeight weight_upper_bound)
+{
+    forward_heap.Clear();
+    reverse_heap.Clear();
+
+    insertNodesInHeaps(forward_heap, reverse_heap, {source_phantom, target_phantom});
+
+    EdgeWeight weight = INVALID_EDGE_WEIGHT;
+    std::vector<NodeID> packed_path;
+    search(engine_working_data,
+           facade,
+           forward_heap,
+           reverse_heap,
+           weight,
+           packed_path,
+           DO_NOT_FORCE_LOOPS,
+           DO_NOT_FORCE_LOOPS,
+           {source_phantom, target_phantom},
+           weight_upper_bound);
+
+    if (weight == INVALID_EDGE_WEIGHT)
+    {
+        return std::numeric_limits<double>::max();
+    }
+
+    std::vector<PathData> unpacked_path;
+    unpackPath(facade,
+               packed_path.begin(),
+               packed_path.end(),
+               {source_phantom, target_phantom},
+               unpacked_path);
+
+    return getPathDistance(facade, unpacked_path, source_phantom, target_phantom);
+}
+} // namespace cch
+
+} // namespace routing_algorithms
+} // namespace engine
+} // namespace osrm
@@ -1,3 +1,4 @@
+#include "engine/routing_algorithms/routing_base_cch.hpp"
 #include "engine/routing_algorithms/routing_base_ch.hpp"
 #include "engine/routing_algorithms/routing_base_mld.hpp"
 #include "engine/routing_algorithms/shortest_path_impl.hpp"
@@ -21,6 +22,12 @@ shortestPathSearch(SearchEngineData<mld::Algorithm> &engine_working_data,
                    const std::vector<PhantomNodes> &phantom_nodes_vector,
                    const boost::optional<bool> continue_straight_at_waypoint);
 
+template InternalRouteResult
+shortestPathSearch(SearchEngineData<cch::Algorithm> &engine_working_data,
+                   const DataFacade<cch::Algorithm> &facade,
+                   const std::vector<PhantomNodes> &phantom_nodes_vector,
+                   const boost::optional<bool> continue_straight_at_waypoint);
+
 } // namespace routing_algorithms
 } // namespace engine
 } // namespace osrm
@@ -5,6 +5,28 @@ namespace osrm
 namespace engine
 {
 
+namespace
+{
+// The heaps are shared by all engines of a thread, e.g. the engines of several datasets. Node IDs
+// above the dense array are kept in the hash map, so a heap with a larger dense array serves every
+// dataset and is only re-created to grow it. The dense array ends up sized to the largest dataset
+// and switching between datasets doesn't allocate.
+template <typename HeapPtr>
+void InitializeOrClearHeap(HeapPtr &heap, unsigned number_of_nodes, std::size_t dense_size)
+{
+    using Heap = typename HeapPtr::element_type;
+
+    if (heap.get() && heap->GetIndexStorage().DenseSize() >= dense_size)
+    {
+        heap->Clear();
+    }
+    else
+    {
+        heap.reset(new Heap(number_of_nodes, dense_size));
+    }
+}
+}
+
 // CH heaps
 using CH = routing_algorithms::ch::Algorithm;
 SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::forward_heap_1;
@@ -17,77 +39,30 @@ SearchEngineData<CH>::ManyToManyHeapPtr SearchEngineData<CH>::many_to_many_heap;
 
 void SearchEngineData<CH>::InitializeOrClearFirstThreadLocalStorage(unsigned number_of_nodes)
 {
-    if (forward_heap_1.get())
-    {
-        forward_heap_1->Clear();
-    }
-    else
-    {
-        forward_heap_1.reset(new QueryHeap(number_of_nodes));
-    }
-
-    if (reverse_heap_1.get())
-    {
-        reverse_heap_1->Clear();
-    }
-    else
-    {
-        reverse_heap_1.reset(new QueryHeap(number_of_nodes));
-    }
+    const auto dense_size = heap_storage.QueryHeapDenseSize(number_of_nodes);
+    InitializeOrClearHeap(forward_heap_1, number_of_nodes, dense_size);
+    InitializeOrClearHeap(reverse_heap_1, number_of_nodes, dense_size);
 }
 
 void SearchEngineData<CH>::InitializeOrClearSecondThreadLocalStorage(unsigned number_of_nodes)
 {
-    if (forward_heap_2.get())
-    {
-        forward_heap_2->Clear();
-    }
-    else
-    {
-        forward_heap_2.reset(new QueryHeap(number_of_nodes));
-    }
-
-    if (reverse_heap_2.get())
-    {
-        reverse_heap_2->Clear();
-    }
-    else
-    {
-        reverse_heap_2.reset(new QueryHeap(number_of_nodes));
-    }
+    const auto dense_size = heap_storage.QueryHeapDenseSize(number_of_nodes);
+    InitializeOrClearHeap(forward_heap_2, number_of_nodes, dense_size);
+    InitializeOrClearHeap(reverse_heap_2, number_of_nodes, dense_size);
 }
 
 void SearchEngineData<CH>::InitializeOrClearThirdThreadLocalStorage(unsigned number_of_nodes)
 {
-    if (forward_heap_3.get())
-    {
-        forward_heap_3->Clear();
-    }
-    else
-    {
-        forward_heap_3.reset(new QueryHeap(number_of_nodes));
-    }
-
-    if (reverse_heap_3.get())
-    {
-        reverse_heap_3->Clear();
-    }
-    else
-    {
-        reverse_heap_3.reset(new QueryHeap(number_of_nodes));
-    }
+    const auto dense_size = heap_storage.QueryHeapDenseSize(number_of_nodes);
+    InitializeOrClearHeap(forward_heap_3, number_of_nodes, dense_size);
+    InitializeOrClearHeap(reverse_heap_3, number_of_nodes, dense_size);
 }
 
 void SearchEngineData<CH>::InitializeOrClearManyToManyThreadLocalStorage(unsigned number_of_nodes)
 {
-    if (many_to_many_heap.get())
-    {
-        many_to_many_heap->Clear();
-    }
-    else
-    {
-        many_to_many_heap.reset(new ManyToManyQueryHeap(number_of_nodes));
-    }
+    InitializeOrClearHeap(many_to_many_heap,
+                          number_of_nodes,
+                          heap_storage.ManyToManyHeapDenseSize(number_of_nodes));
 }
 
 // MLD
@@ -98,35 +73,16 @@ SearchEngineData<MLD>::ManyToManyHeapPtr SearchEngineData<MLD>::many_to_many_hea
 
 void SearchEngineData<MLD>::InitializeOrClearFirstThreadLocalStorage(unsigned number_of_nodes)
 {
-    if (forward_heap_1.get())
-    {
-        forward_heap_1->Clear();
-    }
-    else
-    {
-        forward_heap_1.reset(new QueryHeap(number_of_nodes));
-    }
-
-    if (reverse_heap_1.get())
-    {
-        reverse_heap_1->Clear();
-    }
-    else
-    {
-        reverse_heap_1.reset(new QueryHeap(number_of_nodes));
-    }
+    const auto dense_size = heap_storage.QueryHeapDenseSize(number_of_nodes);
+    InitializeOrClearHeap(forward_heap_1, number_of_nodes, dense_size);
+    InitializeOrClearHeap(reverse_heap_1, number_of_nodes, dense_size);
 }
 
 void SearchEngineData<MLD>::InitializeOrClearManyToManyThreadLocalStorage(unsigned number_of_nodes)
 {
-    if (many_to_many_heap.get())
-    {
-        many_to_many_heap->Clear();
-    }
-    else
-    {
-        many_to_many_heap.reset(new ManyToManyQueryHeap(number_of_nodes));
-    }
+    InitializeOrClearHeap(many_to_many_heap,
+                          number_of_nodes,
+                          heap_storage.ManyToManyHeapDenseSize(number_of_nodes));
 }
 }
 }
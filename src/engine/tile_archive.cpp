@@ -0,0 +1,132 @@
+#include "engine/tile_archive.hpp"
+
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+#include "util/fingerprint.hpp"
+#include "util/mmap_file.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+
+namespace osrm
+{
+namespace engine
+{
+
+namespace
+{
+// the tiles start after the fingerprint and their size
+const constexpr std::size_t TILES_OFFSET = sizeof(util::FingerPrint) + sizeof(std::uint64_t);
+
+// x and y of zoom levels up to 28 fit next to each other
+const constexpr unsigned MAX_ZOOM = 28;
+}
+
+std::uint64_t TileArchive::MakeKey(unsigned z, unsigned x, unsigned y)
+{
+    BOOST_ASSERT(z <= MAX_ZOOM);
+    return (static_cast<std::uint64_t>(z) << (2 * MAX_ZOOM)) |
+           (static_cast<std::uint64_t>(x) << MAX_ZOOM) | y;
+}
+
+TileArchive::TileArchive(const boost::filesystem::path &path)
+{
+    {
+        storage::io::FileReader reader(path, storage::io::FileReader::VerifyFingerprint);
+
+        const auto tiles_size = reader.ReadElementCount64();
+        reader.Skip<char>(tiles_size);
+
+        const auto number_of_tiles = reader.ReadElementCount64();
+        index.resize(number_of_tiles);
+        reader.ReadInto(index.data(), number_of_tiles);
+
+        reader.ReadInto(dataset_fingerprint);
+
+        tiles = util::mmapFile<char>(path, region);
+        if (tiles.size() < TILES_OFFSET + tiles_size)
+        {
+            throw util::exception("Tile archive " + path.string() + " is truncated" + SOURCE_REF);
+        }
+        tiles = util::vector_view<const char>(tiles.data() + TILES_OFFSET, tiles_size);
+    }
+
+    if (!std::is_sorted(index.begin(), index.end(), [](const auto &lhs, const auto &rhs) {
+            return lhs.key < rhs.key;
+        }))
+    {
+        throw util::exception("Index of tile archive " + path.string() + " is not sorted" +
+                              SOURCE_REF);
+    }
+
+    // Get copies the tiles without checking their bounds
+    if (std::any_of(index.begin(), index.end(), [this](const auto &entry) {
+            return entry.offset > tiles.size() || entry.size > tiles.size() - entry.offset;
+        }))
+    {
+        throw util::exception("Index of tile archive " + path.string() +
+                              " points outside of the tiles" + SOURCE_REF);
+    }
+}
+
+bool TileArchive::Get(unsigned z, unsigned x, unsigned y, std::string &pbf_buffer) const
+{
+    const auto key = MakeKey(z, x, y);
+    const auto entry = std::lower_bound(
+        index.begin(), index.end(), key, [](const TileArchiveEntry &entry, std::uint64_t key) {
+            return entry.key < key;
+        });
+
+    if (entry == index.end() || entry->key != key)
+    {
+        ++misses;
+        return false;
+    }
+
+    BOOST_ASSERT(entry->offset + entry->size <= tiles.size());
+    pbf_buffer.assign(tiles.data() + entry->offset, entry->size);
+    ++hits;
+    return true;
+}
+
+util::json::Object TileArchive::GetMetrics() const
+{
+    util::json::Object metrics;
+    metrics.values["tiles"] = util::json::Number(index.size());
+    metrics.values["hits"] = util::json::Number(hits.load());
+    metrics.values["misses"] = util::json::Number(misses.load());
+    return metrics;
+}
+
+TileArchiveWriter::TileArchiveWriter(const boost::filesystem::path &path,
+                                     storage::DatasetFingerprint dataset_fingerprint)
+    : writer(path, storage::io::FileWriter::GenerateFingerprint),
+      dataset_fingerprint(dataset_fingerprint), tiles_size(0)
+{
+    // the size of all tiles is written by Finish
+    writer.WriteElementCount64(0);
+}
+
+void TileArchiveWriter::Add(unsigned z, unsigned x, unsigned y, const std::string &pbf_buffer)
+{
+    writer.WriteFrom(pbf_buffer.data(), pbf_buffer.size());
+    index.push_back({TileArchive::MakeKey(z, x, y), tiles_size, pbf_buffer.size()});
+    tiles_size += pbf_buffer.size();
+}
+
+void TileArchiveWriter::Finish()
+{
+    std::sort(index.begin(), index.end(), [](const auto &lhs, const auto &rhs) {
+        return lhs.key < rhs.key;
+    });
+
+    writer.WriteElementCount64(index.size());
+    writer.WriteFrom(index.data(), index.size());
+    writer.WriteOne(dataset_fingerprint);
+
+    writer.SkipToBeginning();
+    writer.WriteElementCount64(tiles_size);
+}
+}
+}
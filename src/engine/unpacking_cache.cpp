@@ -0,0 +1,85 @@
+#include "engine/unpacking_cache.hpp"
+
+#include "util/std_hash.hpp"
+
+#include <utility>
+
+namespace osrm
+{
+namespace engine
+{
+
+std::size_t UnpackingCacheKeyHash::operator()(const UnpackingCacheKey &key) const
+{
+    return hash_val(key.owner,
+                    key.level,
+                    key.cell,
+                    key.source,
+                    key.target,
+                    key.force_loop_forward,
+                    key.force_loop_reverse);
+}
+
+UnpackingCache::UnpackingCache(std::size_t max_bytes) : cache(max_bytes) {}
+
+std::uint32_t UnpackingCache::NewOwner()
+{
+    static std::atomic<std::uint32_t> next_owner{0};
+    return next_owner++;
+}
+
+std::size_t UnpackingCache::EstimateSize::operator()(const Value &value) const
+{
+    // list node, index node and the two path vectors
+    return sizeof(std::pair<Key, Value>) + 4 * sizeof(void *) +
+           value.nodes.size() * sizeof(NodeID) + value.edges.size() * sizeof(EdgeID);
+}
+
+bool UnpackingCache::Get(const Key &key, Value &value)
+{
+    const auto start = Clock::now();
+    if (!cache.Get(key, value))
+    {
+        return false;
+    }
+
+    hit_nanoseconds +=
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+    return true;
+}
+
+void UnpackingCache::Put(const Key &key, const Value &value, const Clock::duration unpacking_time)
+{
+    ++unpacked;
+    unpacking_nanoseconds +=
+        std::chrono::duration_cast<std::chrono::nanoseconds>(unpacking_time).count();
+
+    cache.Put(key, value);
+}
+
+util::json::Object UnpackingCache::GetMetrics() const
+{
+    const auto number_of_hits = cache.GetHits();
+    const auto number_of_lookups = number_of_hits + cache.GetMisses();
+    const auto number_of_unpacked = unpacked.load();
+
+    const auto mean_microseconds = [](const std::uint64_t nanoseconds, const std::uint64_t count) {
+        return count == 0 ? 0. : nanoseconds / 1000. / count;
+    };
+
+    util::json::Object metrics;
+    metrics.values["entries"] = util::json::Number(cache.GetNumberOfEntries());
+    metrics.values["bytes"] = util::json::Number(cache.GetSize());
+    metrics.values["max_bytes"] = util::json::Number(cache.GetCapacity());
+    metrics.values["hits"] = util::json::Number(number_of_hits);
+    metrics.values["misses"] = util::json::Number(number_of_lookups - number_of_hits);
+    metrics.values["hit_rate"] = util::json::Number(
+        number_of_lookups == 0 ? 0. : static_cast<double>(number_of_hits) / number_of_lookups);
+    metrics.values["mean_hit_us"] =
+        util::json::Number(mean_microseconds(hit_nanoseconds.load(), number_of_hits));
+    metrics.values["mean_unpacking_us"] =
+        util::json::Number(mean_microseconds(unpacking_nanoseconds.load(), number_of_unpacked));
+    return metrics;
+}
+}
+}
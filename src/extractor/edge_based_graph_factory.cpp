@@ -542,13 +542,15 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
             IntersectionData continuous_data;
             std::vector<EdgeWithData> delayed_data;
             std::vector<Conditional> conditionals;
+            // turns of the edges in continuous_data and delayed_data, the penalties are added to
+            // the edges once the profile processed all turns of the buffer
+            std::vector<ExtractionTurn> continuous_turns;
+            std::vector<ExtractionTurn> delayed_turns;
         };
 
-        // Generate edges for either artificial nodes or the main graph
-        const auto generate_edge = [this,
-                                    &scripting_environment,
-                                    weight_multiplier,
-                                    &conditional_restriction_map](
+        // Generate edges for either artificial nodes or the main graph. The turn is appended to
+        // `turns`, weight and duration of the edge don't include the turn penalties yet.
+        const auto generate_edge = [this, &conditional_restriction_map](
             // what nodes will be used? In most cases this will be the id stored in the edge_data.
             // In case of duplicated nodes (e.g. due to via-way restrictions), one/both of these
             // might refer to a newly added edge based node
@@ -564,7 +566,8 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
             const auto &road_legs_on_the_right,
             const auto &road_legs_on_the_left,
             const auto entry_class_id,
-            const auto &edge_geometries) {
+            const auto &edge_geometries,
+            std::vector<ExtractionTurn> &turns) {
 
             const auto node_restricted = isRestricted(node_along_road_entering,
                                                       intersection_node,
@@ -601,7 +604,7 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
             // compute weight and duration penalties
             auto is_traffic_light = m_traffic_lights.count(intersection_node);
 
-            ExtractionTurn extracted_turn(
+            turns.emplace_back(
                 // general info
                 turn.angle,
                 road_legs_on_the_right.size() + road_legs_on_the_left.size() + 2 -
@@ -636,28 +639,16 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
                 road_legs_on_the_right,
                 road_legs_on_the_left);
 
-            scripting_environment.ProcessTurn(extracted_turn);
-
-            // turn penalties are limited to [-2^15, 2^15) which roughly translates to 54 minutes
-            // and fits signed 16bit deci-seconds
-            auto weight_penalty =
-                boost::numeric_cast<TurnPenalty>(extracted_turn.weight * weight_multiplier);
-            auto duration_penalty = boost::numeric_cast<TurnPenalty>(extracted_turn.duration * 10.);
-
             BOOST_ASSERT(SPECIAL_NODEID != nbe_to_ebn_mapping[node_based_edge_from]);
             BOOST_ASSERT(SPECIAL_NODEID != nbe_to_ebn_mapping[node_based_edge_to]);
 
-            // auto turn_id = m_edge_based_edge_list.size();
-            auto weight = boost::numeric_cast<EdgeWeight>(edge_data1.weight + weight_penalty);
-            auto duration = boost::numeric_cast<EdgeWeight>(edge_data1.duration + duration_penalty);
-
             EdgeBasedEdge edge_based_edge = {
                 edge_based_node_from,
                 edge_based_node_to,
                 SPECIAL_NODEID, // This will be updated once the main loop
                                 // completes!
-                weight,
-                duration,
+                edge_data1.weight,
+                edge_data1.duration,
                 true,
                 false};
 
@@ -681,9 +672,22 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
 
             // insert data into the designated buffer
             return std::make_pair(
-                EdgeWithData{
-                    edge_based_edge, turn_index_block, weight_penalty, duration_penalty, turn_data},
-                conditional);
+                EdgeWithData{edge_based_edge, turn_index_block, 0, 0, turn_data}, conditional);
+        };
+
+        // Adds the penalties of a turn the profile processed to its edge
+        const auto apply_turn_penalties = [weight_multiplier](const ExtractionTurn &turn,
+                                                              EdgeBasedEdge &edge,
+                                                              TurnPenalty &weight_penalty,
+                                                              TurnPenalty &duration_penalty) {
+            // turn penalties are limited to [-2^15, 2^15) which roughly translates to 54 minutes
+            // and fits signed 16bit deci-seconds
+            weight_penalty = boost::numeric_cast<TurnPenalty>(turn.weight * weight_multiplier);
+            duration_penalty = boost::numeric_cast<TurnPenalty>(turn.duration * 10.);
+
+            edge.data.weight = boost::numeric_cast<EdgeWeight>(edge.data.weight + weight_penalty);
+            edge.data.duration =
+                boost::numeric_cast<EdgeWeight>(edge.data.duration + duration_penalty);
         };
 
         // Second part of the pipeline is where the intersection analysis is done for each
@@ -914,7 +918,8 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
                                                   road_legs_on_the_right,
                                                   road_legs_on_the_left,
                                                   entry_class_id,
-                                                  edge_geometries);
+                                                  edge_geometries,
+                                                  buffer->continuous_turns);
 
                                 buffer->continuous_data.edges_list.push_back(
                                     edge_with_data_and_condition.first.edge);
@@ -979,7 +984,8 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
                                                           road_legs_on_the_right,
                                                           road_legs_on_the_left,
                                                           entry_class_id,
-                                                          edge_geometries);
+                                                          edge_geometries,
+                                                          buffer->delayed_turns);
 
                                         buffer->delayed_data.push_back(
                                             std::move(edge_with_data_and_condition.first));
@@ -1016,7 +1022,8 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
                                                           road_legs_on_the_right,
                                                           road_legs_on_the_left,
                                                           entry_class_id,
-                                                          edge_geometries);
+                                                          edge_geometries,
+                                                          buffer->delayed_turns);
 
                                         buffer->delayed_data.push_back(
                                             std::move(edge_with_data_and_condition.first));
@@ -1033,6 +1040,37 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
                     }
                 }
 
+                // all turns of the range are passed to the profile at once, this allows it to
+                // process them without a call into the scripting environment per turn
+                scripting_environment.ProcessTurns(buffer->continuous_turns);
+                scripting_environment.ProcessTurns(buffer->delayed_turns);
+
+                auto &data = buffer->continuous_data;
+                BOOST_ASSERT(buffer->continuous_turns.size() == data.edges_list.size());
+                for (const auto index : util::irange(std::size_t{0}, data.edges_list.size()))
+                {
+                    apply_turn_penalties(buffer->continuous_turns[index],
+                                         data.edges_list[index],
+                                         data.turn_weight_penalties[index],
+                                         data.turn_duration_penalties[index]);
+                }
+
+                BOOST_ASSERT(buffer->delayed_turns.size() == buffer->delayed_data.size());
+                for (const auto index : util::irange(std::size_t{0}, buffer->delayed_data.size()))
+                {
+                    auto &edge_with_data = buffer->delayed_data[index];
+                    apply_turn_penalties(buffer->delayed_turns[index],
+                                         edge_with_data.edge,
+                                         edge_with_data.turn_weight_penalty,
+                                         edge_with_data.turn_duration_penalty);
+                }
+
+                // the turns hold copies of the connected roads, don't keep them until the output
+                buffer->continuous_turns.clear();
+                buffer->continuous_turns.shrink_to_fit();
+                buffer->delayed_turns.clear();
+                buffer->delayed_turns.shrink_to_fit();
+
                 return buffer;
             });
 
@@ -22,6 +22,7 @@
 #include "util/graph_loader.hpp"
 #include "util/integer_range.hpp"
 #include "util/log.hpp"
+#include "util/meminfo.hpp"
 #include "util/name_table.hpp"
 #include "util/range_table.hpp"
 #include "util/timing_util.hpp"
@@ -43,8 +44,9 @@
 #include <boost/optional/optional.hpp>
 #include <boost/scope_exit.hpp>
 
-#include <osmium/handler/node_locations_for_ways.hpp>
+#include <osmium/index/map/dense_file_array.hpp>
 #include <osmium/index/map/flex_mem.hpp>
+#include <osmium/index/map/sparse_file_array.hpp>
 #include <osmium/io/any_input.hpp>
 #include <osmium/thread/pool.hpp>
 #include <osmium/visitor.hpp>
@@ -53,6 +55,13 @@
 #include <tbb/task_scheduler_init.h>
 
 #include <cstdlib>
+#include <fcntl.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 #include <algorithm>
 #include <atomic>
@@ -75,6 +84,80 @@ namespace extractor
 
 namespace
 {
+// Node location index for location-dependent data. File based indexes are memory-mapped from a
+// temporary file that is removed with the index.
+class LocationCache
+{
+  public:
+    using Index = osmium::index::map::Map<osmium::unsigned_object_id_type, osmium::Location>;
+
+    explicit LocationCache(const ExtractorConfig &config)
+    {
+        using IndexType = ExtractorConfig::LocationIndexType;
+        switch (config.location_index_type)
+        {
+        case IndexType::FlexMem:
+            index = std::make_unique<
+                osmium::index::map::FlexMem<osmium::unsigned_object_id_type, osmium::Location>>();
+            break;
+        case IndexType::DenseFile:
+            index = CreateFileIndex<osmium::index::map::DenseFileArray<
+                osmium::unsigned_object_id_type,
+                osmium::Location>>(config);
+            break;
+        case IndexType::SparseFile:
+            index = CreateFileIndex<osmium::index::map::SparseFileArray<
+                osmium::unsigned_object_id_type,
+                osmium::Location>>(config);
+            break;
+        }
+    }
+
+    ~LocationCache()
+    {
+        index.reset();
+        if (fd != -1)
+        {
+            ::close(fd);
+            boost::system::error_code error;
+            boost::filesystem::remove(path, error);
+        }
+    }
+
+    LocationCache(const LocationCache &) = delete;
+    LocationCache &operator=(const LocationCache &) = delete;
+
+    std::unique_ptr<Index> index;
+
+  private:
+    template <typename FileIndex>
+    std::unique_ptr<Index> CreateFileIndex(const ExtractorConfig &config)
+    {
+        const auto directory = config.location_index_path.empty()
+                                   ? config.GetPath(".osrm").parent_path()
+                                   : config.location_index_path;
+        path = boost::filesystem::absolute(directory) /
+               boost::filesystem::unique_path("osrm-locations-%%%%-%%%%-%%%%.tmp");
+        util::Log() << "Node location index file " << path.string();
+
+        // the file stays open until the index is released
+        int flags = O_CREAT | O_EXCL | O_RDWR;
+#ifdef _WIN32
+        flags |= O_BINARY;
+#endif
+        fd = ::open(path.string().c_str(), flags, 0644);
+        if (fd == -1)
+        {
+            throw util::exception("Could not create node location index file " + path.string() +
+                                  SOURCE_REF);
+        }
+        return std::make_unique<FileIndex>(fd);
+    }
+
+    boost::filesystem::path path;
+    int fd = -1;
+};
+
 // Converts the class name map into a fixed mapping of index to name
 void SetClassNames(const std::vector<std::string> &class_names,
                    ExtractorCallbacks::ClassesMap &classes_map,
@@ -439,16 +522,69 @@ Extractor::ParseOSMData(ScriptingEnvironment &scripting_environment,
     };
 
     // Node locations cache (assumes nodes are placed before ways)
-    using osmium_index_type =
-        osmium::index::map::FlexMem<osmium::unsigned_object_id_type, osmium::Location>;
-    using osmium_location_handler_type = osmium::handler::NodeLocationsForWays<osmium_index_type>;
+    const bool use_location_cache =
+        scripting_environment.HasLocationDependentData() && config.use_locations_cache;
+    boost::optional<LocationCache> location_cache;
+    if (use_location_cache)
+    {
+        location_cache.emplace(config);
+    }
+
+    // Node locations are stored in input order. Sparse indexes are sorted once the first way
+    // is reached, after that the index is only read.
+    osmium::unsigned_object_id_type last_node_id = 0;
+    bool must_sort = false;
+    bool has_ways = false;
+    tbb::filter_t<SharedBuffer, SharedBuffer> location_storer(
+        tbb::filter::serial_in_order, [&](SharedBuffer buffer) {
+            for (const auto &node : buffer->select<osmium::Node>())
+            {
+                if (has_ways)
+                {
+                    throw util::exception("Node " + std::to_string(node.id()) +
+                                          " follows ways, the node locations cache needs nodes "
+                                          "placed before ways" +
+                                          SOURCE_REF);
+                }
+                // like osmium::handler::NodeLocationsForWays we don't index negative IDs
+                if (node.id() < 0)
+                    continue;
 
-    osmium_index_type location_cache;
-    osmium_location_handler_type location_handler(location_cache);
+                const auto id = node.positive_id();
+                must_sort = must_sort || id < last_node_id;
+                last_node_id = id;
+                location_cache->index->set(id, node.location());
+            }
+
+            const auto ways = buffer->select<osmium::Way>();
+            if (!has_ways && ways.begin() != ways.end())
+            {
+                if (must_sort)
+                    location_cache->index->sort();
+                has_ways = true;
+            }
+            return buffer;
+        });
 
+    // The ways of different buffers look up their node locations in parallel
     tbb::filter_t<SharedBuffer, SharedBuffer> location_cacher(
-        tbb::filter::serial_in_order, [&location_handler](SharedBuffer buffer) {
-            osmium::apply(buffer->begin(), buffer->end(), location_handler);
+        tbb::filter::parallel, [&](SharedBuffer buffer) {
+            for (auto &way : buffer->select<osmium::Way>())
+            {
+                for (auto &node_ref : way.nodes())
+                {
+                    const auto location =
+                        node_ref.ref() < 0
+                            ? osmium::Location{}
+                            : location_cache->index->get_noexcept(node_ref.positive_ref());
+                    if (!location)
+                    {
+                        throw osmium::not_found{
+                            "location for one or more nodes not found in node location index"};
+                    }
+                    node_ref.set_location(location);
+                }
+            }
             return buffer;
         });
 
@@ -558,13 +694,21 @@ Extractor::ParseOSMData(ScriptingEnvironment &scripting_environment,
                                       osmium::osm_entity_bits::relation,
                                   read_meta);
 
-        const auto pipeline =
-            scripting_environment.HasLocationDependentData() && config.use_locations_cache
-                ? buffer_reader(reader) & location_cacher & buffer_transformer & buffer_storage
-                : buffer_reader(reader) & buffer_transformer & buffer_storage;
+        const auto pipeline = use_location_cache
+                                  ? buffer_reader(reader) & location_storer & location_cacher &
+                                        buffer_transformer & buffer_storage
+                                  : buffer_reader(reader) & buffer_transformer & buffer_storage;
         tbb::parallel_pipeline(num_threads, pipeline);
     }
 
+    if (location_cache)
+    {
+        util::Log() << "Node locations cache holds " << location_cache->index->size()
+                    << " entries in " << location_cache->index->used_memory() << " bytes";
+        util::DumpMemoryStats();
+        location_cache.reset();
+    }
+
     TIMER_STOP(parsing);
     util::Log() << "Parsing finished after " << TIMER_SEC(parsing) << " seconds";
 
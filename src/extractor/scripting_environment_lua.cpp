@@ -7,6 +7,7 @@
 #include "extractor/extraction_turn.hpp"
 #include "extractor/extraction_way.hpp"
 #include "extractor/internal_extractor_edge.hpp"
+#include "extractor/native_turn_function.hpp"
 #include "extractor/profile_properties.hpp"
 #include "extractor/query_node.hpp"
 #include "extractor/raster_source.hpp"
@@ -19,6 +20,9 @@
 
 #include <osmium/osm.hpp>
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
 #include <memory>
 #include <sstream>
 
@@ -508,15 +512,45 @@ void Sol2ScriptingEnvironment::InitContext(LuaScriptingContext &context)
 
         // store functions
         context.turn_function = function_table.value()["process_turn"];
+        context.turns_function = function_table.value()["process_turns"];
         context.node_function = function_table.value()["process_node"];
         context.way_function = function_table.value()["process_way"];
         context.segment_function = function_table.value()["process_segment"];
 
-        context.has_turn_penalty_function = context.turn_function.valid();
+        context.has_turn_penalty_function =
+            context.turn_function.valid() || context.turns_function.valid();
         context.has_node_function = context.node_function.valid();
         context.has_way_function = context.way_function.valid();
         context.has_segment_function = context.segment_function.valid();
 
+        // process_way_cache = true or a sequence of tag keys declares that process_way only reads
+        // the tags of a way, or only the listed ones
+        sol::object process_way_cache = context.profile_table["process_way_cache"];
+        if (process_way_cache.is<bool>())
+        {
+            context.way_cache_mode = process_way_cache.as<bool>()
+                                         ? LuaScriptingContext::WayCacheMode::AllTags
+                                         : LuaScriptingContext::WayCacheMode::Disabled;
+        }
+        else if (process_way_cache.is<sol::table>())
+        {
+            context.way_cache_mode = LuaScriptingContext::WayCacheMode::ListedTags;
+            for (auto &&pair : process_way_cache.as<sol::table>())
+            {
+                context.way_cache_tags.push_back(pair.second.as<std::string>());
+            }
+        }
+        else if (process_way_cache.valid())
+        {
+            throw util::exception("process_way_cache must be a boolean or a sequence of tag keys" +
+                                  SOURCE_REF);
+        }
+        // location tags of a way depend on its node locations
+        if (!location_dependent_data.empty())
+        {
+            context.way_cache_mode = LuaScriptingContext::WayCacheMode::Disabled;
+        }
+
         // read properties from 'profile.properties' table
         sol::table properties = context.profile_table["properties"];
         if (properties.valid())
@@ -561,6 +595,49 @@ void Sol2ScriptingEnvironment::InitContext(LuaScriptingContext &context)
             if (force_split_edges != sol::nullopt)
                 context.properties.force_split_edges = force_split_edges.value();
         }
+
+        // turn functions implemented in C++ replace process_turn and process_turns
+        sol::optional<std::string> native_turn_function =
+            context.profile_table["native_turn_function"];
+        if (native_turn_function != sol::nullopt)
+        {
+            if (*native_turn_function != "car")
+                throw util::exception("Unknown native turn function " + *native_turn_function +
+                                      ", only 'car' is supported." + SOURCE_REF);
+            if (context.turn_function.valid() || context.turns_function.valid())
+                throw util::exception("The profile defines native_turn_function and "
+                                      "process_turn or process_turns, return only one of them." +
+                                      SOURCE_REF);
+
+            const auto get_number = [](const sol::table &table, const std::string &name) {
+                const auto missing = [&name] {
+                    return util::exception("The car turn function needs the profile value " +
+                                           name + SOURCE_REF);
+                };
+                if (!table.valid())
+                    throw missing();
+                sol::optional<double> value = table[name];
+                if (value == sol::nullopt)
+                    throw missing();
+                return value.value();
+            };
+
+            CarTurnFunction car_turn_function;
+            car_turn_function.turn_penalty = get_number(context.profile_table, "turn_penalty");
+            car_turn_function.turn_bias = get_number(context.profile_table, "turn_bias");
+            car_turn_function.u_turn_penalty = get_number(properties, "u_turn_penalty");
+            car_turn_function.traffic_light_penalty =
+                get_number(properties, "traffic_light_penalty");
+            const auto weight_name = context.properties.GetWeightName();
+            car_turn_function.weight_type =
+                weight_name == "distance"
+                    ? CarTurnFunction::WeightType::Distance
+                    : weight_name == "routability" ? CarTurnFunction::WeightType::Routability
+                                                   : CarTurnFunction::WeightType::Duration;
+            car_turn_function.max_turn_weight = std::numeric_limits<TurnPenalty>::max();
+            context.native_turn_function = car_turn_function;
+            context.has_turn_penalty_function = true;
+        }
     };
 
     auto initialize_V3_extraction_turn = [&]() {
@@ -867,7 +944,7 @@ void Sol2ScriptingEnvironment::ProcessElements(
             result_way.clear();
             if (local_context.has_way_function)
             {
-                local_context.ProcessWay(way, result_way, relations);
+                local_context.ProcessWayCached(way, result_way, relations);
             }
             resulting_ways.push_back({way, std::move(result_way)});
         }
@@ -1024,6 +1101,20 @@ std::vector<std::string> Sol2ScriptingEnvironment::GetRelations()
     }
 }
 
+namespace
+{
+void finishTurn(const LuaScriptingContext &context, ExtractionTurn &turn)
+{
+    // Turn weight falls back to the duration value in deciseconds
+    // or uses the extracted unit-less weight value
+    if (context.properties.fallback_to_duration)
+        turn.weight = turn.duration;
+    else
+        // cap turn weight to max turn weight, which depend on weight precision
+        turn.weight = std::min(turn.weight, context.properties.GetMaxTurnWeight());
+}
+}
+
 void Sol2ScriptingEnvironment::ProcessTurn(ExtractionTurn &turn)
 {
     auto &context = GetSol2Context();
@@ -1033,17 +1124,23 @@ void Sol2ScriptingEnvironment::ProcessTurn(ExtractionTurn &turn)
     case 4:
     case 3:
     case 2:
-        if (context.has_turn_penalty_function)
+        if (context.native_turn_function)
+        {
+            (*context.native_turn_function)(turn);
+            finishTurn(context, turn);
+        }
+        else if (context.turn_function.valid())
         {
             context.turn_function(context.profile_table, turn);
-
-            // Turn weight falls back to the duration value in deciseconds
-            // or uses the extracted unit-less weight value
-            if (context.properties.fallback_to_duration)
-                turn.weight = turn.duration;
-            else
-                // cap turn weight to max turn weight, which depend on weight precision
-                turn.weight = std::min(turn.weight, context.properties.GetMaxTurnWeight());
+            finishTurn(context, turn);
+        }
+        else if (context.turns_function.valid())
+        {
+            std::vector<ExtractionTurn> turns{turn};
+            context.turns_function(context.profile_table, turns);
+            finishTurn(context, turns.front());
+            turn.weight = turns.front().weight;
+            turn.duration = turns.front().duration;
         }
 
         break;
@@ -1090,6 +1187,32 @@ void Sol2ScriptingEnvironment::ProcessTurn(ExtractionTurn &turn)
     }
 }
 
+void Sol2ScriptingEnvironment::ProcessTurns(std::vector<ExtractionTurn> &turns)
+{
+    auto &context = GetSol2Context();
+
+    if (context.api_version >= 2 && context.native_turn_function)
+    {
+        for (auto &turn : turns)
+        {
+            (*context.native_turn_function)(turn);
+            finishTurn(context, turn);
+        }
+    }
+    else if (context.api_version >= 2 && context.turns_function.valid())
+    {
+        // a single call into Lua for all turns
+        context.turns_function(context.profile_table, turns);
+        for (auto &turn : turns)
+            finishTurn(context, turn);
+    }
+    else
+    {
+        for (auto &turn : turns)
+            ProcessTurn(turn);
+    }
+}
+
 void Sol2ScriptingEnvironment::ProcessSegment(ExtractionSegment &segment)
 {
     auto &context = GetSol2Context();
@@ -1159,5 +1282,58 @@ void LuaScriptingContext::ProcessWay(const osmium::Way &way,
     }
 }
 
+void LuaScriptingContext::ProcessWayCached(const osmium::Way &way,
+                                           ExtractionWay &result,
+                                           const ExtractionRelationContainer &relations)
+{
+    // ways that are members of relations are processed with their relations
+    const ExtractionRelation::OsmIDTyped way_id{way.id(), osmium::item_type::way};
+    if (way_cache_mode == WayCacheMode::Disabled || !relations.GetRelations(way_id).empty())
+    {
+        ProcessWay(way, result, relations);
+        return;
+    }
+
+    way_cache_key.clear();
+    const auto append = [this](const char *key, const char *value) {
+        way_cache_key.append(key).push_back('\0');
+        if (value)
+            way_cache_key.append(value).push_back('\0');
+        else
+            way_cache_key.push_back('\1');
+    };
+    if (way_cache_mode == WayCacheMode::AllTags)
+    {
+        std::vector<const osmium::Tag *> tags;
+        for (const auto &tag : way.tags())
+            tags.push_back(&tag);
+        std::sort(tags.begin(), tags.end(), [](const auto lhs, const auto rhs) {
+            return std::strcmp(lhs->key(), rhs->key()) < 0;
+        });
+        for (const auto tag : tags)
+            append(tag->key(), tag->value());
+    }
+    else
+    {
+        for (const auto &key : way_cache_tags)
+            append(key.c_str(), way.tags().get_value_by_key(key.c_str()));
+    }
+
+    const auto cached = way_cache.find(way_cache_key);
+    if (cached != way_cache.end())
+    {
+        result = cached->second;
+        return;
+    }
+
+    ProcessWay(way, result, relations);
+
+    // the cache is meant for frequent tag sets, start over instead of growing with unique ones
+    const constexpr std::size_t MAX_WAY_CACHE_SIZE = 1 << 16;
+    if (way_cache.size() >= MAX_WAY_CACHE_SIZE)
+        way_cache.clear();
+    way_cache.emplace(way_cache_key, result);
+}
+
 } // namespace extractor
 } // namespace osrm
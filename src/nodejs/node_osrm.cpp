@@ -67,18 +67,26 @@ NAN_MODULE_INIT(Engine::Init)
  * ```
  *
  * @param {Object|String} [options={shared_memory: true}] Options for creating an OSRM object or string to the `.osrm` file.
- * @param {String} [options.algorithm] The algorithm to use for routing. Can be 'CH', 'CoreCH' or 'MLD'. Default is 'CH'.
+ * @param {String} [options.algorithm] The algorithm to use for routing. Can be 'CH', 'CoreCH', 'MLD' or 'CCH'. Default is 'CH'.
  *        Make sure you prepared the dataset with the correct toolchain.
  * @param {Boolean} [options.shared_memory] Connects to the persistent shared memory datastore.
  *        This requires you to run `osrm-datastore` prior to creating an `OSRM` object.
  * @param {String} [options.path] The path to the `.osrm` files. This is mutually exclusive with setting {options.shared_memory} to true.
+ * @param {String} [options.memory_file] Memory-map the dataset from this file instead of loading it into process memory.
+ *        The file is written from the `.osrm` files at `options.path` if it is missing or outdated.
+ * @param {Boolean} [options.share_blocks] Keep blocks that are identical to those of another `OSRM` object of the process,
+ *        like names and coordinates of datasets built from the same extract, only once (default: false).
  * @param {Number} [options.max_locations_trip] Max. locations supported in trip query (default: unlimited).
  * @param {Number} [options.max_locations_viaroute] Max. locations supported in viaroute query (default: unlimited).
  * @param {Number} [options.max_locations_distance_table] Max. locations supported in distance table query (default: unlimited).
  * @param {Number} [options.max_locations_map_matching] Max. locations supported in map-matching query (default: unlimited).
  * @param {Number} [options.max_radius_map_matching] Max. radius size supported in map matching query (default: 5).
  * @param {Number} [options.max_results_nearest] Max. results supported in nearest query (default: unlimited).
+ * @param {Number} [options.max_batch_size_nearest] Max. coordinates supported in a batch nearest query (default: unlimited).
  * @param {Number} [options.max_alternatives] Max. number of alternatives supported in alternative routes query (default: 3).
+ * @param {Number} [options.max_match_sessions] Max. number of match sessions kept in memory, 0 disables match sessions (default: 0).
+ * @param {Number} [options.match_session_timeout] Seconds after its last request a match session expires (default: 300).
+ * @param {Number} [options.max_match_session_points] Max. number of trace points a match session keeps (default: 100).
  *
  * @class OSRM
  *
@@ -111,6 +119,11 @@ NAN_METHOD(Engine::New)
     }
 }
 
+// Selects the overload of a service that takes an engine::api::ResultT
+template <typename ParametersT>
+using ServiceFn = osrm::Status (osrm::OSRM::*)(const ParametersT &,
+                                               osrm::engine::api::ResultT &) const;
+
 template <typename ParameterParser, typename ServiceMemFn>
 inline void async(const Nan::FunctionCallbackInfo<v8::Value> &info,
                   ParameterParser argsToParams,
@@ -144,6 +157,7 @@ inline void async(const Nan::FunctionCallbackInfo<v8::Value> &info,
 
         void Execute() override try
         {
+            initializeResult(*params, result);
             const auto status = ((*osrm).*(service))(*params, result);
             ParseResult(status, result);
         }
@@ -167,11 +181,11 @@ inline void async(const Nan::FunctionCallbackInfo<v8::Value> &info,
         ServiceMemFn service;
         const ParamPtr params;
 
-        // All services return json::Object .. except for Tile!
+        // All services return json::Object or CBOR .. except for Tile!
         using ObjectOrString =
             typename std::conditional<std::is_same<ParamPtr, tile_parameters_ptr>::value,
                                       std::string,
-                                      osrm::json::Object>::type;
+                                      osrm::engine::api::ResultT>::type;
 
         ObjectOrString result;
     };
@@ -202,6 +216,8 @@ inline void async(const Nan::FunctionCallbackInfo<v8::Value> &info,
  * @param {Boolean} [options.continue_straight] Forces the route to keep going straight at waypoints and don't do a uturn even if it would be faster. Default value depends on the profile.
  * @param {Array} [options.approaches] Keep waypoints on curb side. Can be `null` (unrestricted, default) or `curb`.
  *                  `null`/`true`/`false`
+ * @param {String} [options.format=json] Format of the result: `json` for an object or `cbor` for a Buffer
+ *                                        with the response encoded as [CBOR](http://cbor.io).
  * @param {Function} callback
  *
  * @returns {Object} An array of [Waypoint](#waypoint) objects representing all waypoints in order AND an array of [`Route`](#route) objects ordered by descending recommendation rank.
@@ -217,14 +233,18 @@ inline void async(const Nan::FunctionCallbackInfo<v8::Value> &info,
 // clang-format on
 NAN_METHOD(Engine::route) //
 {
-    async(info, &argumentsToRouteParameter, &osrm::OSRM::Route, true);
+    async(info,
+          &argumentsToRouteParameter,
+          ServiceFn<osrm::RouteParameters>{&osrm::OSRM::Route},
+          true);
 }
 
 // clang-format off
 /**
  * Snaps a coordinate to the street network and returns the nearest n matches.
  *
- * Note: `coordinates` in the general options only supports a single `{longitude},{latitude}` entry.
+ * Note: `coordinates` in the general options only supports a single `{longitude},{latitude}` entry,
+ * unless `batch` is set.
  *
  * @name nearest
  * @memberof OSRM
@@ -237,11 +257,16 @@ NAN_METHOD(Engine::route) //
  * @param {Number} [options.number=1] Number of nearest segments that should be returned.
  * Must be an integer greater than or equal to `1`.
  * @param {Array} [options.approaches] Keep waypoints on curb side. Can be `null` (unrestricted, default) or `curb`.
+ * @param {Boolean} [options.batch=false] Snaps every coordinate to its nearest segment and returns packed arrays
+ *                                        instead of `waypoints`. `number`, `hints` and `bearings` are not supported.
+ * @param {String} [options.format=json] Format of the result: `json` for an object or `cbor` for a Buffer
+ *                                        with the response encoded as [CBOR](http://cbor.io).
  * @param {Function} callback
  *
  * @returns {Object} containing `waypoints`.
  * **`waypoints`**: array of [`Ẁaypoint`](#waypoint) objects sorted by distance to the input coordinate.
  *                  Each object has an additional `distance` property, which is the distance in meters to the supplied input coordinate.
+ * With `batch` the object contains `locations`, `distances` and `nodes` instead, see the HTTP API documentation.
  *
  * @example
  * var osrm = new OSRM('network.osrm');
@@ -257,7 +282,10 @@ NAN_METHOD(Engine::route) //
 // clang-format on
 NAN_METHOD(Engine::nearest) //
 {
-    async(info, &argumentsToNearestParameter, &osrm::OSRM::Nearest, false);
+    async(info,
+          &argumentsToNearestParameter,
+          ServiceFn<osrm::NearestParameters>{&osrm::OSRM::Nearest},
+          false);
 }
 
 // clang-format off
@@ -279,11 +307,16 @@ NAN_METHOD(Engine::nearest) //
  * @param {Array} [options.destinations] An array of `index` elements (`0 <= integer <
  * #coordinates`) to use location with given index as destination. Default is to use all.
  * @param {Array} [options.approaches] Keep waypoints on curb side. Can be `null` (unrestricted, default) or `curb`.
+ * @param {Array} [options.annotations] Return the requested table or tables in response. Can be `['duration']` (return the duration matrix, default), `['distance']` (return the distance matrix) or `['duration', 'distance']` (return both).
+ * @param {String} [options.format=json] Format of the result: `json` for an object or `cbor` for a Buffer
+ *                                        with the response encoded as [CBOR](http://cbor.io).
  * @param {Function} callback
  *
- * @returns {Object} containing `durations`, `sources`, and `destinations`.
+ * @returns {Object} containing `durations`, `distances`, `sources`, and `destinations`.
  * **`durations`**: array of arrays that stores the matrix in row-major order. `durations[i][j]` gives the travel time from the i-th waypoint to the j-th waypoint.
  *                  Values are given in seconds.
+ * **`distances`**: array of arrays that stores the matrix in row-major order. `distances[i][j]` gives the travel distance from the i-th waypoint to the j-th waypoint.
+ *                  Values are given in meters. Only present if requested via `annotations`.
  * **`sources`**: array of [`Ẁaypoint`](#waypoint) objects describing all sources in order.
  * **`destinations`**: array of [`Ẁaypoint`](#waypoint) objects describing all destinations in order.
  *
@@ -305,7 +338,10 @@ NAN_METHOD(Engine::nearest) //
 // clang-format on
 NAN_METHOD(Engine::table) //
 {
-    async(info, &argumentsToTableParameter, &osrm::OSRM::Table, true);
+    async(info,
+          &argumentsToTableParameter,
+          ServiceFn<osrm::TableParameters>{&osrm::OSRM::Table},
+          true);
 }
 
 // clang-format off
@@ -362,7 +398,11 @@ NAN_METHOD(Engine::tile)
  * @param {Array} [options.radiuses] Standard deviation of GPS precision used for map matching. If applicable use GPS accuracy. Can be `null` for default value `5` meters or `double >= 0`.
  * @param {String} [options.gaps] Allows the input track splitting based on huge timestamp gaps between points. Either `split` or `ignore` (optional, default `split`).
  * @param {Boolean} [options.tidy] Allows the input track modification to obtain better matching quality for noisy tracks (optional, default `false`).
+ * @param {String} [options.session] Extends the trace of this match session with the coordinates, which may be a single one.
+ *                                    Only the new points are matched. Requires `max_match_sessions` and does not support `tidy`.
  *
+ * @param {String} [options.format=json] Format of the result: `json` for an object or `cbor` for a Buffer
+ *                                        with the response encoded as [CBOR](http://cbor.io).
  * @param {Function} callback
  *
  * @returns {Object} containing `tracepoints` and `matchings`.
@@ -390,7 +430,10 @@ NAN_METHOD(Engine::tile)
 // clang-format on
 NAN_METHOD(Engine::match) //
 {
-    async(info, &argumentsToMatchParameter, &osrm::OSRM::Match, true);
+    async(info,
+          &argumentsToMatchParameter,
+          ServiceFn<osrm::MatchParameters>{&osrm::OSRM::Match},
+          true);
 }
 
 // clang-format off
@@ -427,6 +470,8 @@ NAN_METHOD(Engine::match) //
  * @param {Array|Boolean} [options.annotations=false] An array with strings of `duration`, `nodes`, `distance`, `weight`, `datasources`, `speed` or boolean for enabling/disabling all.
  * @param {String} [options.geometries=polyline] Returned route geometry format (influences overview and per step). Can also be `geojson`.
  * @param {String} [options.overview=simplified] Add overview geometry either `full`, `simplified`
+ * @param {String} [options.format=json] Format of the result: `json` for an object or `cbor` for a Buffer
+ *                                        with the response encoded as [CBOR](http://cbor.io).
  * @param {Function} callback
  * @param {Boolean} [options.roundtrip=true] Return route is a roundtrip.
  * @param {String} [options.source=any] Return route starts at `any` or `first` coordinate.
@@ -460,7 +505,10 @@ NAN_METHOD(Engine::match) //
 // clang-format on
 NAN_METHOD(Engine::trip) //
 {
-    async(info, &argumentsToTripParameter, &osrm::OSRM::Trip, true);
+    async(info,
+          &argumentsToTripParameter,
+          ServiceFn<osrm::TripParameters>{&osrm::OSRM::Trip},
+          true);
 }
 
 /**
@@ -20,6 +20,7 @@ OSRM::OSRM(engine::EngineConfig &config)
 {
     using CH = engine::routing_algorithms::ch::Algorithm;
     using MLD = engine::routing_algorithms::mld::Algorithm;
+    using CCH = engine::routing_algorithms::cch::Algorithm;
 
     // First, check that necessary core data is available
     if (!config.use_shared_memory && !config.storage_config.IsValid())
@@ -68,6 +69,22 @@ OSRM::OSRM(engine::EngineConfig &config)
             throw util::exception("Dataset is not compatible with MLD.");
         }
     }
+    else if (config.algorithm == EngineConfig::Algorithm::CCH)
+    {
+        bool cch_compatible = engine::Engine<CCH>::CheckCompatibility(config);
+        // throw error if dataset is not usable with CCH
+        if (!cch_compatible)
+        {
+            throw util::exception("Dataset is not compatible with CCH, run osrm-customize --cch.");
+        }
+    }
+
+    if (config.live_traffic_updates &&
+        (config.use_shared_memory || config.algorithm != EngineConfig::Algorithm::MLD))
+    {
+        throw util::exception(
+            "Live traffic updates need the MLD algorithm and a dataset in process memory.");
+    }
 
     switch (config.algorithm)
     {
@@ -77,6 +94,9 @@ OSRM::OSRM(engine::EngineConfig &config)
     case EngineConfig::Algorithm::MLD:
         engine_ = std::make_unique<engine::Engine<MLD>>(config);
         break;
+    case EngineConfig::Algorithm::CCH:
+        engine_ = std::make_unique<engine::Engine<CCH>>(config);
+        break;
     default:
         util::exception("Algorithm not implemented!");
     }
@@ -88,28 +108,76 @@ OSRM &OSRM::operator=(OSRM &&) noexcept = default;
 // Forward to implementation
 
 engine::Status OSRM::Route(const engine::api::RouteParameters &params,
-                           util::json::Object &result) const
+                           json::Object &json_result) const
+{
+    engine::api::ResultT result = std::move(json_result);
+    const auto status = engine_->Route(params, result);
+    json_result = std::move(result.get<json::Object>());
+    return status;
+}
+
+engine::Status OSRM::Route(const engine::api::RouteParameters &params,
+                           engine::api::ResultT &result) const
 {
     return engine_->Route(params, result);
 }
 
-engine::Status OSRM::Table(const engine::api::TableParameters &params, json::Object &result) const
+engine::Status OSRM::Table(const engine::api::TableParameters &params,
+                           json::Object &json_result) const
+{
+    engine::api::ResultT result = std::move(json_result);
+    const auto status = engine_->Table(params, result);
+    json_result = std::move(result.get<json::Object>());
+    return status;
+}
+
+engine::Status OSRM::Table(const engine::api::TableParameters &params,
+                           engine::api::ResultT &result) const
 {
     return engine_->Table(params, result);
 }
 
 engine::Status OSRM::Nearest(const engine::api::NearestParameters &params,
-                             json::Object &result) const
+                             json::Object &json_result) const
+{
+    engine::api::ResultT result = std::move(json_result);
+    const auto status = engine_->Nearest(params, result);
+    json_result = std::move(result.get<json::Object>());
+    return status;
+}
+
+engine::Status OSRM::Nearest(const engine::api::NearestParameters &params,
+                             engine::api::ResultT &result) const
 {
     return engine_->Nearest(params, result);
 }
 
-engine::Status OSRM::Trip(const engine::api::TripParameters &params, json::Object &result) const
+engine::Status OSRM::Trip(const engine::api::TripParameters &params,
+                          json::Object &json_result) const
+{
+    engine::api::ResultT result = std::move(json_result);
+    const auto status = engine_->Trip(params, result);
+    json_result = std::move(result.get<json::Object>());
+    return status;
+}
+
+engine::Status OSRM::Trip(const engine::api::TripParameters &params,
+                          engine::api::ResultT &result) const
 {
     return engine_->Trip(params, result);
 }
 
-engine::Status OSRM::Match(const engine::api::MatchParameters &params, json::Object &result) const
+engine::Status OSRM::Match(const engine::api::MatchParameters &params,
+                           json::Object &json_result) const
+{
+    engine::api::ResultT result = std::move(json_result);
+    const auto status = engine_->Match(params, result);
+    json_result = std::move(result.get<json::Object>());
+    return status;
+}
+
+engine::Status OSRM::Match(const engine::api::MatchParameters &params,
+                           engine::api::ResultT &result) const
 {
     return engine_->Match(params, result);
 }
@@ -119,4 +187,12 @@ engine::Status OSRM::Tile(const engine::api::TileParameters &params, std::string
     return engine_->Tile(params, result);
 }
 
+void OSRM::Metrics(json::Object &result) const { engine_->Metrics(result); }
+
+engine::Status OSRM::UpdateSegmentSpeeds(const std::string &segment_speeds,
+                                         json::Object &result) const
+{
+    return engine_->UpdateSegmentSpeeds(segment_speeds, result);
+}
+
 } // ns osrm
@@ -1,7 +1,12 @@
 #include "server/connection.hpp"
 #include "server/request_handler.hpp"
 #include "server/request_parser.hpp"
+#include "server/worker_pool.hpp"
 
+#include "util/json_renderer.hpp"
+#include "util/log.hpp"
+
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/assert.hpp>
 #include <boost/bind.hpp>
 #include <boost/iostreams/filter/gzip.hpp>
@@ -16,8 +21,29 @@ namespace osrm
 namespace server
 {
 
-Connection::Connection(boost::asio::io_service &io_service, RequestHandler &handler)
-    : strand(io_service), TCP_socket(io_service), request_handler(handler)
+namespace
+{
+// The first path segment of the URI names the service, e.g. /table/v1/driving/...
+std::string service_of(const std::string &uri)
+{
+    const auto begin = uri.find_first_not_of('/');
+    if (begin == std::string::npos)
+    {
+        return {};
+    }
+    return uri.substr(begin, uri.find('/', begin) - begin);
+}
+}
+
+Connection::Connection(boost::asio::io_service &io_service,
+                       RequestHandler &handler,
+                       WorkerPool &worker_pool,
+                       const ConnectionConfig &config)
+    : strand(io_service), TCP_socket(io_service), timer(io_service), request_handler(handler),
+      worker_pool(worker_pool), request_parser(config.max_body_size, config.accept_updates), pipelined_begin(nullptr),
+      pipelined_end(nullptr), current_compression(http::no_compression), config(config),
+      remaining_requests(config.keepalive_max_requests), keep_alive(false),
+      waiting_for_request(false), read_pending(false), timer_wait_id(0)
 {
 }
 
@@ -26,6 +52,26 @@ boost::asio::ip::tcp::socket &Connection::socket() { return TCP_socket; }
 /// Start the first asynchronous operation for the connection.
 void Connection::start()
 {
+    // Replies on a persistent connection must not wait for the ACK of the previous one
+    boost::system::error_code ignore_error;
+    TCP_socket.set_option(boost::asio::ip::tcp::no_delay(true), ignore_error);
+
+    // a client that connects has to send its first request in time
+    read_deadline = boost::asio::deadline_timer::traits_type::now() +
+                    boost::posix_time::seconds(config.request_timeout);
+    start_read();
+}
+
+void Connection::start_read()
+{
+    // re-arming keeps the deadline, a client can't extend it by sending a few bytes at a time
+    timer.expires_at(read_deadline);
+    timer.async_wait(strand.wrap(boost::bind(&Connection::handle_timeout,
+                                             this->shared_from_this(),
+                                             boost::asio::placeholders::error,
+                                             ++timer_wait_id)));
+
+    read_pending = true;
     TCP_socket.async_read_some(
         boost::asio::buffer(incoming_data_buffer),
         strand.wrap(boost::bind(&Connection::handle_read,
@@ -36,62 +82,108 @@ void Connection::start()
 
 void Connection::handle_read(const boost::system::error_code &error, std::size_t bytes_transferred)
 {
+    read_pending = false;
+    boost::system::error_code ignore_error;
+    timer.cancel(ignore_error);
+
     if (error)
     {
+        // the read was cancelled at the deadline
+        if (error == boost::asio::error::operation_aborted)
+        {
+            handle_shutdown();
+        }
         return;
     }
 
+    if (waiting_for_request)
+    {
+        waiting_for_request = false;
+        read_deadline = boost::asio::deadline_timer::traits_type::now() +
+                        boost::posix_time::seconds(config.request_timeout);
+    }
+
+    process_input(incoming_data_buffer.data(), incoming_data_buffer.data() + bytes_transferred);
+}
+
+void Connection::process_input(char *begin, char *end)
+{
     // no error detected, let's parse the request
     http::compression_type compression_type(http::no_compression);
     RequestParser::RequestStatus result;
-    std::tie(result, compression_type) =
-        request_parser.parse(current_request,
-                             incoming_data_buffer.data(),
-                             incoming_data_buffer.data() + bytes_transferred);
+    char *parsed_end;
+    std::tie(result, compression_type, parsed_end) =
+        request_parser.parse(current_request, begin, end);
 
     // the request has been parsed
     if (result == RequestParser::RequestStatus::valid)
     {
+        // remember the bytes of any request the client pipelined behind this one
+        pipelined_begin = parsed_end;
+        pipelined_end = end;
+
         current_request.endpoint = TCP_socket.remote_endpoint().address();
-        request_handler.HandleRequest(current_request, current_reply);
+        current_compression = compression_type;
+        keep_alive = wants_keep_alive();
 
-        // compress the result w/ gzip/deflate if requested
-        switch (compression_type)
+        // updates and queries can be served on different ports
+        const bool is_update = http::is_update_uri(current_request.uri);
+        if (is_update ? !config.accept_updates : !config.accept_queries)
         {
-        case http::deflate_rfc1951:
-            // use deflate for compression
-            current_reply.headers.insert(current_reply.headers.begin(),
-                                         {"Content-Encoding", "deflate"});
-            compressed_output = compress_buffers(current_reply.content, compression_type);
-            current_reply.set_size(static_cast<unsigned>(compressed_output.size()));
-            output_buffer = current_reply.headers_to_buffers();
-            output_buffer.push_back(boost::asio::buffer(compressed_output));
-            break;
-        case http::gzip_rfc1952:
-            // use gzip for compression
-            current_reply.headers.insert(current_reply.headers.begin(),
-                                         {"Content-Encoding", "gzip"});
-            compressed_output = compress_buffers(current_reply.content, compression_type);
-            current_reply.set_size(static_cast<unsigned>(compressed_output.size()));
-            output_buffer = current_reply.headers_to_buffers();
-            output_buffer.push_back(boost::asio::buffer(compressed_output));
-            break;
-        case http::no_compression:
-            // don't use any compression
-            current_reply.set_uncompressed_size();
-            output_buffer = current_reply.to_buffers();
-            break;
+            current_reply = http::reply::stock_reply(http::reply::not_found);
+            prepare_reply();
+            write_reply();
+            return;
+        }
+
+        if (current_request.uri == "/metrics")
+        {
+            auto metrics = worker_pool.GetMetrics();
+            request_handler.GetMetrics(metrics);
+            util::json::render(current_reply.content, metrics);
+            current_reply.headers.emplace_back("Content-Type", "application/json; charset=UTF-8");
+            current_reply.headers.emplace_back("Content-Length",
+                                               std::to_string(current_reply.content.size()));
+            prepare_reply();
+            write_reply();
+            return;
+        }
+
+        // routing, rendering and compression run on the worker pool, not on this I/O thread
+        auto self = this->shared_from_this();
+        const auto queued = worker_pool.Post(service_of(current_request.uri), [self] {
+            try
+            {
+                self->request_handler.HandleRequest(self->current_request, self->current_reply);
+                self->prepare_reply();
+            }
+            catch (...)
+            {
+                // the client must get a reply, otherwise the connection hangs
+                util::Log(logWARNING) << "[server error] could not reply to "
+                                      << self->current_request.uri;
+                self->keep_alive = false;
+                self->current_compression = http::no_compression;
+                self->current_reply = http::reply::stock_reply(http::reply::internal_server_error);
+                self->prepare_reply();
+            }
+            self->strand.post(boost::bind(&Connection::write_reply, self));
+        });
+
+        if (!queued)
+        {
+            current_reply = http::reply::stock_reply(http::reply::service_unavailable);
+            prepare_reply();
+            write_reply();
         }
-        // write result to stream
-        boost::asio::async_write(TCP_socket,
-                                 output_buffer,
-                                 strand.wrap(boost::bind(&Connection::handle_write,
-                                                         this->shared_from_this(),
-                                                         boost::asio::placeholders::error)));
     }
-    else if (result == RequestParser::RequestStatus::invalid)
-    { // request is not parseable
-        current_reply = http::reply::stock_reply(http::reply::bad_request);
+    else if (result != RequestParser::RequestStatus::indeterminate)
+    { // request is not parseable or its body is rejected before it is read
+        keep_alive = false;
+        current_reply = http::reply::stock_reply(result == RequestParser::RequestStatus::too_large
+                                                     ? http::reply::payload_too_large
+                                                     : http::reply::bad_request);
+        current_reply.headers.emplace_back("Connection", "close");
 
         boost::asio::async_write(TCP_socket,
                                  current_reply.to_buffers(),
@@ -102,24 +194,142 @@ void Connection::handle_read(const boost::system::error_code &error, std::size_t
     else
     {
         // we don't have a result yet, so continue reading
-        TCP_socket.async_read_some(
-            boost::asio::buffer(incoming_data_buffer),
-            strand.wrap(boost::bind(&Connection::handle_read,
-                                    this->shared_from_this(),
-                                    boost::asio::placeholders::error,
-                                    boost::asio::placeholders::bytes_transferred)));
+        start_read();
     }
 }
 
+void Connection::prepare_reply()
+{
+    if (keep_alive)
+    {
+        current_reply.headers.emplace_back("Connection", "keep-alive");
+        current_reply.headers.emplace_back("Keep-Alive",
+                                           "timeout=" + std::to_string(config.keepalive_timeout) +
+                                               ", max=" + std::to_string(remaining_requests - 1));
+    }
+    else
+    {
+        current_reply.headers.emplace_back("Connection", "close");
+    }
+
+    // compress the result w/ gzip/deflate if requested
+    switch (current_compression)
+    {
+    case http::deflate_rfc1951:
+        // use deflate for compression
+        current_reply.headers.insert(current_reply.headers.begin(),
+                                     {"Content-Encoding", "deflate"});
+        compressed_output = compress_buffers(current_reply.content, current_compression);
+        current_reply.set_size(static_cast<unsigned>(compressed_output.size()));
+        output_buffer = current_reply.headers_to_buffers();
+        output_buffer.push_back(boost::asio::buffer(compressed_output));
+        break;
+    case http::gzip_rfc1952:
+        // use gzip for compression
+        current_reply.headers.insert(current_reply.headers.begin(),
+                                     {"Content-Encoding", "gzip"});
+        compressed_output = compress_buffers(current_reply.content, current_compression);
+        current_reply.set_size(static_cast<unsigned>(compressed_output.size()));
+        output_buffer = current_reply.headers_to_buffers();
+        output_buffer.push_back(boost::asio::buffer(compressed_output));
+        break;
+    case http::no_compression:
+        // don't use any compression
+        current_reply.set_uncompressed_size();
+        output_buffer = current_reply.to_buffers();
+        break;
+    }
+}
+
+void Connection::write_reply()
+{
+    boost::asio::async_write(TCP_socket,
+                             output_buffer,
+                             strand.wrap(boost::bind(&Connection::handle_write,
+                                                     this->shared_from_this(),
+                                                     boost::asio::placeholders::error)));
+}
+
 /// Handle completion of a write operation.
 void Connection::handle_write(const boost::system::error_code &error)
 {
-    if (!error)
+    if (error)
     {
-        // Initiate graceful connection closure.
-        boost::system::error_code ignore_error;
-        TCP_socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignore_error);
+        return;
     }
+
+    if (!keep_alive)
+    {
+        handle_shutdown();
+        return;
+    }
+
+    --remaining_requests;
+    current_request = http::request();
+    current_reply = http::reply();
+    request_parser = RequestParser(config.max_body_size, config.accept_updates);
+    compressed_output.clear();
+    output_buffer.clear();
+
+    // answer pipelined requests in order before reading from the socket again
+    const auto now = boost::asio::deadline_timer::traits_type::now();
+    if (pipelined_begin != pipelined_end)
+    {
+        read_deadline = now + boost::posix_time::seconds(config.request_timeout);
+        process_input(pipelined_begin, pipelined_end);
+    }
+    else
+    {
+        // the connection is idle until the next request arrives
+        read_deadline = now + boost::posix_time::seconds(config.keepalive_timeout);
+        waiting_for_request = true;
+        start_read();
+    }
+}
+
+void Connection::handle_timeout(const boost::system::error_code &error, const unsigned wait_id)
+{
+    // the timer was cancelled or re-armed, or no read is pending because a request is answered
+    if (error == boost::asio::error::operation_aborted || wait_id != timer_wait_id ||
+        !read_pending)
+    {
+        return;
+    }
+
+    // a read that completed in the meantime isn't cancelled, handle_read still sees its bytes
+    // and closes the connection otherwise
+    boost::system::error_code ignore_error;
+    TCP_socket.cancel(ignore_error);
+}
+
+void Connection::handle_shutdown()
+{
+    // Initiate graceful connection closure.
+    boost::system::error_code ignore_error;
+    TCP_socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignore_error);
+}
+
+bool Connection::wants_keep_alive() const
+{
+    // the last request we are willing to answer on this connection
+    if (remaining_requests <= 1 || config.keepalive_timeout == 0)
+    {
+        return false;
+    }
+
+    if (boost::icontains(current_request.connection, "close"))
+    {
+        return false;
+    }
+
+    if (boost::icontains(current_request.connection, "keep-alive"))
+    {
+        return true;
+    }
+
+    // persistent connections are the default since HTTP/1.1
+    return current_request.http_version_major > 1 ||
+           (current_request.http_version_major == 1 && current_request.http_version_minor >= 1);
 }
 
 std::vector<char> Connection::compress_buffers(const std::vector<char> &uncompressed_data,
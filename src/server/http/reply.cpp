@@ -13,11 +13,20 @@ const char ok_html[] = "";
 const char bad_request_html[] = "";
 const char internal_server_error_html[] =
     "{\"code\": \"InternalError\",\"message\":\"Internal Server Error\"}";
+const char not_found_html[] =
+    "{\"code\": \"NotFound\",\"message\":\"The request isn't answered on this port\"}";
+const char payload_too_large_html[] =
+    "{\"code\": \"TooBig\",\"message\":\"Request body too large or not accepted\"}";
+const char service_unavailable_html[] =
+    "{\"code\": \"Overloaded\",\"message\":\"Too many requests queued, try again later\"}";
 const char seperators[] = {':', ' '};
 const char crlf[] = {'\r', '\n'};
-const std::string http_ok_string = "HTTP/1.0 200 OK\r\n";
-const std::string http_bad_request_string = "HTTP/1.0 400 Bad Request\r\n";
-const std::string http_internal_server_error_string = "HTTP/1.0 500 Internal Server Error\r\n";
+const std::string http_ok_string = "HTTP/1.1 200 OK\r\n";
+const std::string http_bad_request_string = "HTTP/1.1 400 Bad Request\r\n";
+const std::string http_not_found_string = "HTTP/1.1 404 Not Found\r\n";
+const std::string http_payload_too_large_string = "HTTP/1.1 413 Payload Too Large\r\n";
+const std::string http_internal_server_error_string = "HTTP/1.1 500 Internal Server Error\r\n";
+const std::string http_service_unavailable_string = "HTTP/1.1 503 Service Unavailable\r\n";
 
 void reply::set_size(const std::size_t size)
 {
@@ -87,6 +96,18 @@ std::string reply::status_to_string(const reply::status_type status)
     {
         return bad_request_html;
     }
+    if (reply::not_found == status)
+    {
+        return not_found_html;
+    }
+    if (reply::payload_too_large == status)
+    {
+        return payload_too_large_html;
+    }
+    if (reply::service_unavailable == status)
+    {
+        return service_unavailable_html;
+    }
     return internal_server_error_html;
 }
 
@@ -100,14 +121,22 @@ boost::asio::const_buffer reply::status_to_buffer(const reply::status_type statu
     {
         return boost::asio::buffer(http_internal_server_error_string);
     }
+    if (reply::not_found == status)
+    {
+        return boost::asio::buffer(http_not_found_string);
+    }
+    if (reply::payload_too_large == status)
+    {
+        return boost::asio::buffer(http_payload_too_large_string);
+    }
+    if (reply::service_unavailable == status)
+    {
+        return boost::asio::buffer(http_service_unavailable_string);
+    }
     return boost::asio::buffer(http_bad_request_string);
 }
 
-reply::reply() : status(ok)
-{
-    // We do not currently support keep alive. Always set 'Connection: close'.
-    headers.emplace_back("Connection", "close");
-}
+reply::reply() : status(ok) {}
 }
 }
 }
@@ -5,6 +5,7 @@
 #include "server/http/reply.hpp"
 #include "server/http/request.hpp"
 
+#include "util/cbor_writer.hpp"
 #include "util/json_renderer.hpp"
 #include "util/log.hpp"
 #include "util/string_util.hpp"
@@ -15,6 +16,8 @@
 #include "osrm/osrm.hpp"
 #include "util/json_container.hpp"
 
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/algorithm/string/trim.hpp>
 #include <boost/iostreams/copy.hpp>
 #include <boost/iostreams/filter/gzip.hpp>
 #include <boost/iostreams/filtering_streambuf.hpp>
@@ -38,6 +41,14 @@ void RequestHandler::RegisterServiceHandler(
     service_handler = std::move(service_handler_);
 }
 
+void RequestHandler::GetMetrics(util::json::Object &metrics) const
+{
+    if (service_handler)
+    {
+        service_handler->GetMetrics(metrics);
+    }
+}
+
 void RequestHandler::HandleRequest(const http::request &current_request, http::reply &current_reply)
 {
     if (!service_handler)
@@ -58,13 +69,52 @@ void RequestHandler::HandleRequest(const http::request &current_request, http::r
 
         util::Log(logDEBUG) << "[req][" << tid << "] " << request_string;
 
-        auto api_iterator = request_string.begin();
-        auto maybe_parsed_url = api::parseURL(api_iterator, request_string.end());
+        // segment speeds for live traffic updates are sent as CSV in the request body
+        const bool is_update = http::is_update_uri(request_string);
+        const std::string update_prefix = "/update";
+
+        // the coordinates of large queries, e.g. a batch of nearest queries, can be sent in the
+        // body of a POST request instead of the URL: POST /nearest/v1/car?batch=true with the body
+        // "13.388860,52.517037;13.397634,52.529407"
+        std::string query_string = request_string;
+        if (!is_update && current_request.method == "POST" && !current_request.body.empty())
+        {
+            const auto query_begin = std::min(query_string.find('?'), query_string.size());
+            const auto separator =
+                query_begin > 0 && query_string[query_begin - 1] == '/' ? "" : "/";
+            query_string.insert(query_begin, separator + boost::trim_copy(current_request.body));
+        }
+
+        auto api_iterator = query_string.begin();
+        auto maybe_parsed_url = api::parseURL(api_iterator, query_string.end());
         ServiceHandler::ResultT result;
 
+        if (is_update)
+        {
+            const auto dataset = request_string.size() > update_prefix.size()
+                                     ? request_string.substr(update_prefix.size() + 1)
+                                     : std::string();
+            result = util::json::Object();
+            auto &json_result = result.get<util::json::Object>();
+            if (current_request.method != "POST")
+            {
+                current_reply.status = http::reply::bad_request;
+                json_result.values["code"] = "InvalidQuery";
+                json_result.values["message"] = "Segment speeds need to be sent with POST";
+            }
+            else if (service_handler->UpdateSegmentSpeeds(
+                         dataset, current_request.body, json_result) != engine::Status::Ok)
+            {
+                current_reply.status = http::reply::bad_request;
+            }
+        }
         // check if the was an error with the request
-        if (maybe_parsed_url && api_iterator == request_string.end())
+        else if (maybe_parsed_url && api_iterator == query_string.end())
         {
+            if (boost::icontains(current_request.accept, "application/cbor"))
+            {
+                result = util::cbor::Buffer();
+            }
 
             const engine::Status status =
                 service_handler->RunQuery(*std::move(maybe_parsed_url), result);
@@ -80,14 +130,14 @@ void RequestHandler::HandleRequest(const http::request &current_request, http::r
         }
         else
         {
-            const auto position = std::distance(request_string.begin(), api_iterator);
+            const auto position = std::distance(query_string.begin(), api_iterator);
             BOOST_ASSERT(position >= 0);
             const auto context_begin =
-                request_string.begin() + ((position < 3) ? 0 : (position - 3UL));
-            BOOST_ASSERT(context_begin >= request_string.begin());
-            const auto context_end = request_string.begin() +
-                                     std::min<std::size_t>(position + 3UL, request_string.size());
-            BOOST_ASSERT(context_end <= request_string.end());
+                query_string.begin() + ((position < 3) ? 0 : (position - 3UL));
+            BOOST_ASSERT(context_begin >= query_string.begin());
+            const auto context_end = query_string.begin() +
+                                     std::min<std::size_t>(position + 3UL, query_string.size());
+            BOOST_ASSERT(context_end <= query_string.end());
             std::string context(context_begin, context_end);
 
             current_reply.status = http::reply::bad_request;
@@ -99,7 +149,7 @@ void RequestHandler::HandleRequest(const http::request &current_request, http::r
         }
 
         current_reply.headers.emplace_back("Access-Control-Allow-Origin", "*");
-        current_reply.headers.emplace_back("Access-Control-Allow-Methods", "GET");
+        current_reply.headers.emplace_back("Access-Control-Allow-Methods", "GET, POST");
         current_reply.headers.emplace_back("Access-Control-Allow-Headers",
                                            "X-Requested-With, Content-Type");
         if (result.is<util::json::Object>())
@@ -110,6 +160,22 @@ void RequestHandler::HandleRequest(const http::request &current_request, http::r
 
             util::json::render(current_reply.content, result.get<util::json::Object>());
         }
+        else if (result.is<std::vector<char>>())
+        {
+            current_reply.headers.emplace_back("Content-Type", "application/json; charset=UTF-8");
+            current_reply.headers.emplace_back("Content-Disposition",
+                                               "inline; filename=\"response.json\"");
+
+            current_reply.content.swap(result.get<std::vector<char>>());
+        }
+        else if (result.is<util::cbor::Buffer>())
+        {
+            current_reply.headers.emplace_back("Content-Type", "application/cbor");
+            current_reply.headers.emplace_back("Content-Disposition",
+                                               "inline; filename=\"response.cbor\"");
+
+            current_reply.content.swap(result.get<util::cbor::Buffer>().bytes);
+        }
         else
         {
             BOOST_ASSERT(result.is<std::string>());
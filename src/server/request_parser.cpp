@@ -6,6 +6,7 @@
 
 #include <boost/algorithm/string/predicate.hpp>
 
+#include <algorithm>
 #include <string>
 
 namespace osrm
@@ -13,26 +14,52 @@ namespace osrm
 namespace server
 {
 
-RequestParser::RequestParser()
+namespace
+{
+// Segment speeds for /update and the coordinates of batch nearest queries are sent as a body
+bool takes_body(const std::string &uri, const bool accept_updates)
+{
+    return http::is_update_uri(uri) ? accept_updates : boost::starts_with(uri, "/nearest/");
+}
+}
+
+RequestParser::RequestParser(const std::size_t max_body_size, const bool accept_updates)
     : state(internal_state::method_start), current_header({"", ""}),
+      max_body_size(max_body_size), accept_updates(accept_updates), content_length(0),
       selected_compression(http::no_compression)
 {
 }
 
-std::tuple<RequestParser::RequestStatus, http::compression_type>
+std::tuple<RequestParser::RequestStatus, http::compression_type, char *>
 RequestParser::parse(http::request &current_request, char *begin, char *end)
 {
     while (begin != end)
     {
+        // the body isn't parsed, so it is copied in one go
+        if (state == internal_state::body)
+        {
+            const auto remaining = content_length - current_request.body.size();
+            const auto available = static_cast<std::size_t>(end - begin);
+            const auto count = std::min(remaining, available);
+            current_request.body.append(begin, count);
+            begin += count;
+
+            if (current_request.body.size() == content_length)
+            {
+                return std::make_tuple(RequestStatus::valid, selected_compression, begin);
+            }
+            continue;
+        }
+
         RequestStatus result = consume(current_request, *begin++);
         if (result != RequestStatus::indeterminate)
         {
-            return std::make_tuple(result, selected_compression);
+            return std::make_tuple(result, selected_compression, begin);
         }
     }
     RequestStatus result = RequestStatus::indeterminate;
 
-    return std::make_tuple(result, selected_compression);
+    return std::make_tuple(result, selected_compression, end);
 }
 
 RequestParser::RequestStatus RequestParser::consume(http::request &current_request,
@@ -46,6 +73,7 @@ RequestParser::RequestStatus RequestParser::consume(http::request &current_reque
             return RequestStatus::invalid;
         }
         state = internal_state::method;
+        current_request.method.push_back(input);
         return RequestStatus::indeterminate;
     case internal_state::method:
         if (input == ' ')
@@ -57,6 +85,7 @@ RequestParser::RequestStatus RequestParser::consume(http::request &current_reque
         {
             return RequestStatus::invalid;
         }
+        current_request.method.push_back(input);
         return RequestStatus::indeterminate;
     case internal_state::uri_start:
         if (is_CTL(input))
@@ -116,6 +145,7 @@ RequestParser::RequestStatus RequestParser::consume(http::request &current_reque
     case internal_state::http_version_major_start:
         if (is_digit(input))
         {
+            current_request.http_version_major = input - '0';
             state = internal_state::http_version_major;
             return RequestStatus::indeterminate;
         }
@@ -128,12 +158,15 @@ RequestParser::RequestStatus RequestParser::consume(http::request &current_reque
         }
         if (is_digit(input))
         {
+            current_request.http_version_major =
+                current_request.http_version_major * 10 + (input - '0');
             return RequestStatus::indeterminate;
         }
         return RequestStatus::invalid;
     case internal_state::http_version_minor_start:
         if (is_digit(input))
         {
+            current_request.http_version_minor = input - '0';
             state = internal_state::http_version_minor;
             return RequestStatus::indeterminate;
         }
@@ -146,6 +179,8 @@ RequestParser::RequestStatus RequestParser::consume(http::request &current_reque
         }
         if (is_digit(input))
         {
+            current_request.http_version_minor =
+                current_request.http_version_minor * 10 + (input - '0');
             return RequestStatus::indeterminate;
         }
         return RequestStatus::invalid;
@@ -180,6 +215,29 @@ RequestParser::RequestStatus RequestParser::consume(http::request &current_reque
             current_request.agent = current_header.value;
         }
 
+        if (boost::iequals(current_header.name, "Connection"))
+        {
+            current_request.connection = current_header.value;
+        }
+
+        if (boost::iequals(current_header.name, "Accept"))
+        {
+            current_request.accept = current_header.value;
+        }
+
+        if (boost::iequals(current_header.name, "Content-Length"))
+        {
+            if (current_header.value.empty() ||
+                !std::all_of(current_header.value.begin(),
+                             current_header.value.end(),
+                             [this](const char c) { return is_digit(c); }) ||
+                current_header.value.size() > 10)
+            {
+                return RequestStatus::invalid;
+            }
+            content_length = std::stoull(current_header.value);
+        }
+
         if (input == '\r')
         {
             state = internal_state::expecting_newline_3;
@@ -247,8 +305,24 @@ RequestParser::RequestStatus RequestParser::consume(http::request &current_reque
             return RequestStatus::indeterminate;
         }
         return RequestStatus::invalid;
-    default: // expecting_newline_3
-        return input == '\n' ? RequestStatus::valid : RequestStatus::invalid;
+    case internal_state::expecting_newline_3:
+        if (input != '\n')
+        {
+            return RequestStatus::invalid;
+        }
+        if (content_length == 0)
+        {
+            return RequestStatus::valid;
+        }
+        // the body grows as it arrives, the announced length doesn't allocate anything up front
+        if (content_length > max_body_size || !takes_body(current_request.uri, accept_updates))
+        {
+            return RequestStatus::too_large;
+        }
+        state = internal_state::body;
+        return RequestStatus::indeterminate;
+    default: // body, is read by parse
+        return RequestStatus::invalid;
     }
 }
 
@@ -44,6 +44,7 @@ std::string getWrongOptionHelp(const engine::api::MatchParameters &parameters)
 engine::Status
 MatchService::RunQuery(std::size_t prefix_length, std::string &query, ResultT &result)
 {
+    const auto accepted_format = GetAcceptedFormat(result);
     result = util::json::Object();
     auto &json_result = result.get<util::json::Object>();
 
@@ -68,7 +69,11 @@ MatchService::RunQuery(std::size_t prefix_length, std::string &query, ResultT &r
     }
     BOOST_ASSERT(parameters->IsValid());
 
-    return BaseService::routing_machine.Match(*parameters, json_result);
+    return RunWithFormat(parameters->format.value_or(accepted_format),
+                         result,
+                         [&](engine::api::ResultT &engine_result) {
+                             return BaseService::routing_machine.Match(*parameters, engine_result);
+                         });
 }
 }
 }
@@ -38,6 +38,7 @@ std::string getWrongOptionHelp(const engine::api::NearestParameters &parameters)
 engine::Status
 NearestService::RunQuery(std::size_t prefix_length, std::string &query, ResultT &result)
 {
+    const auto accepted_format = GetAcceptedFormat(result);
     result = util::json::Object();
     auto &json_result = result.get<util::json::Object>();
 
@@ -62,7 +63,12 @@ NearestService::RunQuery(std::size_t prefix_length, std::string &query, ResultT
     }
     BOOST_ASSERT(parameters->IsValid());
 
-    return BaseService::routing_machine.Nearest(*parameters, json_result);
+    return RunWithFormat(parameters->format.value_or(accepted_format),
+                         result,
+                         [&](engine::api::ResultT &engine_result) {
+                             return BaseService::routing_machine.Nearest(*parameters,
+                                                                         engine_result);
+                         });
 }
 }
 }
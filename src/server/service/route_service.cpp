@@ -42,6 +42,7 @@ std::string getWrongOptionHelp(const engine::api::RouteParameters &parameters)
 engine::Status
 RouteService::RunQuery(std::size_t prefix_length, std::string &query, ResultT &result)
 {
+    const auto accepted_format = GetAcceptedFormat(result);
     result = util::json::Object();
     auto &json_result = result.get<util::json::Object>();
 
@@ -66,7 +67,11 @@ RouteService::RunQuery(std::size_t prefix_length, std::string &query, ResultT &r
     }
     BOOST_ASSERT(parameters->IsValid());
 
-    return BaseService::routing_machine.Route(*parameters, json_result);
+    return RunWithFormat(parameters->format.value_or(accepted_format),
+                         result,
+                         [&](engine::api::ResultT &engine_result) {
+                             return BaseService::routing_machine.Route(*parameters, engine_result);
+                         });
 }
 }
 }
@@ -63,6 +63,7 @@ std::string getWrongOptionHelp(const engine::api::TableParameters &parameters)
 engine::Status
 TableService::RunQuery(std::size_t prefix_length, std::string &query, ResultT &result)
 {
+    const auto accepted_format = GetAcceptedFormat(result);
     result = util::json::Object();
     auto &json_result = result.get<util::json::Object>();
 
@@ -87,7 +88,11 @@ TableService::RunQuery(std::size_t prefix_length, std::string &query, ResultT &r
     }
     BOOST_ASSERT(parameters->IsValid());
 
-    return BaseService::routing_machine.Table(*parameters, json_result);
+    return RunWithFormat(parameters->format.value_or(accepted_format),
+                         result,
+                         [&](engine::api::ResultT &engine_result) {
+                             return BaseService::routing_machine.Table(*parameters, engine_result);
+                         });
 }
 }
 }
@@ -43,6 +43,7 @@ std::string getWrongOptionHelp(const engine::api::TripParameters &parameters)
 
 engine::Status TripService::RunQuery(std::size_t prefix_length, std::string &query, ResultT &result)
 {
+    const auto accepted_format = GetAcceptedFormat(result);
     result = util::json::Object();
     auto &json_result = result.get<util::json::Object>();
 
@@ -69,7 +70,11 @@ engine::Status TripService::RunQuery(std::size_t prefix_length, std::string &que
     }
     BOOST_ASSERT(parameters->IsValid());
 
-    return BaseService::routing_machine.Trip(*parameters, json_result);
+    return RunWithFormat(parameters->format.value_or(accepted_format),
+                         result,
+                         [&](engine::api::ResultT &engine_result) {
+                             return BaseService::routing_machine.Trip(*parameters, engine_result);
+                         });
 }
 }
 }
@@ -51,5 +51,89 @@ engine::Status ServiceHandler::RunQuery(api::ParsedURL parsed_url,
 
     return service->RunQuery(parsed_url.prefix_length, parsed_url.query, result);
 }
+
+void ServiceHandler::GetMetrics(util::json::Object &metrics) const
+{
+    routing_machine.Metrics(metrics);
+}
+
+engine::Status ServiceHandler::UpdateSegmentSpeeds(const std::string &name,
+                                                   const std::string &segment_speeds,
+                                                   util::json::Object &result)
+{
+    // a single dataset is only served as the default one
+    if (!name.empty())
+    {
+        result.values["code"] = "InvalidProfile";
+        result.values["message"] = "Dataset " + name + " not found!";
+        return engine::Status::Error;
+    }
+
+    return routing_machine.UpdateSegmentSpeeds(segment_speeds, result);
+}
+
+DatasetServiceHandler::DatasetServiceHandler(Datasets datasets_) : datasets(std::move(datasets_))
+{
+}
+
+ServiceHandlerInterface *DatasetServiceHandler::GetDataset(const std::string &name) const
+{
+    auto dataset_iter = datasets.find(name);
+    if (dataset_iter == datasets.end())
+    {
+        dataset_iter = datasets.find("");
+    }
+    return dataset_iter == datasets.end() ? nullptr : dataset_iter->second.get();
+}
+
+engine::Status DatasetServiceHandler::RunQuery(api::ParsedURL parsed_url, ResultT &result)
+{
+    auto dataset = GetDataset(parsed_url.profile);
+    if (!dataset)
+    {
+        result = util::json::Object();
+        auto &json_result = result.get<util::json::Object>();
+        json_result.values["code"] = "InvalidProfile";
+        json_result.values["message"] = "Profile " + parsed_url.profile + " not found!";
+        return engine::Status::Error;
+    }
+
+    return dataset->RunQuery(std::move(parsed_url), result);
+}
+
+void DatasetServiceHandler::GetMetrics(util::json::Object &metrics) const
+{
+    util::json::Object dataset_metrics;
+    for (const auto &name_and_dataset : datasets)
+    {
+        if (name_and_dataset.first.empty())
+        {
+            name_and_dataset.second->GetMetrics(metrics);
+        }
+        else
+        {
+            util::json::Object named_metrics;
+            name_and_dataset.second->GetMetrics(named_metrics);
+            dataset_metrics.values[name_and_dataset.first] = std::move(named_metrics);
+        }
+    }
+    metrics.values["datasets"] = std::move(dataset_metrics);
+}
+
+engine::Status DatasetServiceHandler::UpdateSegmentSpeeds(const std::string &name,
+                                                          const std::string &segment_speeds,
+                                                          util::json::Object &result)
+{
+    const auto dataset_iter = datasets.find(name);
+    if (dataset_iter == datasets.end())
+    {
+        result.values["code"] = "InvalidProfile";
+        result.values["message"] =
+            name.empty() ? "No default dataset to update" : "Dataset " + name + " not found!";
+        return engine::Status::Error;
+    }
+
+    return dataset_iter->second->UpdateSegmentSpeeds("", segment_speeds, result);
+}
 }
 }
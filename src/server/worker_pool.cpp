@@ -0,0 +1,152 @@
+#include "server/worker_pool.hpp"
+
+#include "util/log.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+
+namespace osrm
+{
+namespace server
+{
+
+WorkerPool::WorkerPool(const WorkerPoolConfig &config) : stopped(false)
+{
+    BOOST_ASSERT(config.num_threads > 0);
+
+    default_queue = std::make_unique<Queue>("default", config.max_queue_size);
+    for (unsigned i = 0; i < config.num_threads; ++i)
+    {
+        default_queue->threads.emplace_back([this] { Work(*default_queue); });
+    }
+
+    for (const auto &service_and_threads : config.service_threads)
+    {
+        auto queue = std::make_unique<Queue>(service_and_threads.first, config.max_queue_size);
+        auto &queue_ref = *queue;
+        for (unsigned i = 0; i < std::max(1u, service_and_threads.second); ++i)
+        {
+            queue->threads.emplace_back([this, &queue_ref] { Work(queue_ref); });
+        }
+        service_queues.emplace(service_and_threads.first, std::move(queue));
+    }
+}
+
+WorkerPool::~WorkerPool() { Stop(); }
+
+bool WorkerPool::Post(const std::string &service, Task task)
+{
+    const auto iter = service_queues.find(service);
+    auto &queue = iter == service_queues.end() ? *default_queue : *iter->second;
+
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (stopped || queue.entries.size() >= queue.max_size)
+        {
+            ++queue.rejected;
+            return false;
+        }
+        queue.entries.push_back({std::move(task), std::chrono::steady_clock::now()});
+    }
+    queue.has_work.notify_one();
+
+    return true;
+}
+
+void WorkerPool::Stop()
+{
+    if (stopped.exchange(true))
+    {
+        return;
+    }
+
+    auto stop_queue = [](Queue &queue) {
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.entries.clear();
+        }
+        queue.has_work.notify_all();
+        for (auto &thread : queue.threads)
+        {
+            thread.join();
+        }
+    };
+
+    stop_queue(*default_queue);
+    for (auto &service_queue : service_queues)
+    {
+        stop_queue(*service_queue.second);
+    }
+}
+
+void WorkerPool::Work(Queue &queue)
+{
+    while (true)
+    {
+        Queue::Entry entry;
+        {
+            std::unique_lock<std::mutex> lock(queue.mutex);
+            queue.has_work.wait(lock, [&] { return stopped || !queue.entries.empty(); });
+            if (stopped)
+            {
+                return;
+            }
+            entry = std::move(queue.entries.front());
+            queue.entries.pop_front();
+        }
+
+        const std::uint64_t wait_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                                          std::chrono::steady_clock::now() - entry.enqueued)
+                                          .count();
+        queue.total_wait_us += wait_us;
+        auto max_wait_us = queue.max_wait_us.load();
+        while (wait_us > max_wait_us && !queue.max_wait_us.compare_exchange_weak(max_wait_us, wait_us))
+            ;
+
+        try
+        {
+            entry.task();
+        }
+        catch (const std::exception &e)
+        {
+            util::Log(logWARNING) << "[worker][" << queue.name << "] " << e.what();
+        }
+        ++queue.processed;
+    }
+}
+
+util::json::Object WorkerPool::GetMetrics() const
+{
+    auto queue_metrics = [](const Queue &queue) {
+        util::json::Object metrics;
+        std::size_t depth;
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            depth = queue.entries.size();
+        }
+        const auto processed = queue.processed.load();
+        metrics.values["threads"] = util::json::Number(queue.threads.size());
+        metrics.values["max_queue_size"] = util::json::Number(queue.max_size);
+        metrics.values["queue_depth"] = util::json::Number(depth);
+        metrics.values["processed"] = util::json::Number(processed);
+        metrics.values["rejected"] = util::json::Number(queue.rejected.load());
+        metrics.values["mean_wait_ms"] = util::json::Number(
+            processed == 0 ? 0. : queue.total_wait_us.load() / 1000. / processed);
+        metrics.values["max_wait_ms"] = util::json::Number(queue.max_wait_us.load() / 1000.);
+        return metrics;
+    };
+
+    util::json::Object queues;
+    queues.values[default_queue->name] = queue_metrics(*default_queue);
+    for (const auto &service_queue : service_queues)
+    {
+        queues.values[service_queue.first] = queue_metrics(*service_queue.second);
+    }
+
+    util::json::Object result;
+    result.values["queues"] = std::move(queues);
+    return result;
+}
+}
+}
@@ -0,0 +1,60 @@
+#include "storage/dataset_fingerprint.hpp"
+
+#include "util/std_hash.hpp"
+
+#include <boost/filesystem/operations.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <string>
+
+namespace osrm
+{
+namespace storage
+{
+
+namespace
+{
+// Input files that change when new weights are applied to the dataset
+const constexpr char *METRIC_FILES[] = {".osrm.geometry",
+                                        ".osrm.turn_weight_penalties",
+                                        ".osrm.turn_duration_penalties",
+                                        ".osrm.datasource_names",
+                                        ".osrm.cell_metrics",
+                                        ".osrm.mldgr",
+                                        ".osrm.hsgr",
+                                        ".osrm.cch"};
+}
+
+DatasetFingerprint getDatasetFingerprint(const StorageConfig &config)
+{
+    std::size_t topology = 0;
+    std::size_t metric = 0;
+
+    const auto base_path = config.base_path.string();
+    for (const auto &path : config.GetInputPaths())
+    {
+        // only the suffix, so a dataset that is moved as a whole keeps its fingerprint
+        const auto suffix = path.string().substr(base_path.size());
+        const auto is_metric =
+            std::find(std::begin(METRIC_FILES), std::end(METRIC_FILES), suffix) !=
+            std::end(METRIC_FILES);
+        auto &seed = is_metric ? metric : topology;
+
+        if (boost::filesystem::exists(path))
+        {
+            hash_val(seed,
+                     suffix,
+                     static_cast<std::uint64_t>(boost::filesystem::file_size(path)),
+                     static_cast<std::int64_t>(boost::filesystem::last_write_time(path)));
+        }
+        else
+        {
+            hash_val(seed, suffix);
+        }
+    }
+
+    return {topology, metric};
+}
+}
+}
@@ -24,5 +24,18 @@ bool IOConfig::IsValid() const
     }
     return success;
 }
+
+std::vector<boost::filesystem::path> IOConfig::GetInputPaths() const
+{
+    std::vector<boost::filesystem::path> paths;
+    for (const auto *files : {&required_input_files, &optional_input_files})
+    {
+        for (const auto &fileName : *files)
+        {
+            paths.push_back({base_path.string() + fileName.string()});
+        }
+    }
+    return paths;
+}
 }
 }
@@ -1,5 +1,6 @@
 #include "storage/storage.hpp"
 
+#include "storage/dataset_fingerprint.hpp"
 #include "storage/io.hpp"
 #include "storage/shared_datatype.hpp"
 #include "storage/shared_memory.hpp"
@@ -9,6 +10,7 @@
 #include "contractor/files.hpp"
 #include "contractor/query_graph.hpp"
 
+#include "customizer/cch_topology.hpp"
 #include "customizer/edge_based_graph.hpp"
 #include "customizer/files.hpp"
 
@@ -60,6 +62,7 @@
 #include <iterator>
 #include <new>
 #include <string>
+#include <vector>
 
 namespace osrm
 {
@@ -77,7 +80,7 @@ using Monitor = SharedMonitor<SharedDataTimestamp>;
 
 Storage::Storage(StorageConfig config_) : config(std::move(config_)) {}
 
-int Storage::Run(int max_wait)
+int Storage::Run(int max_wait, bool only_metric)
 {
     BOOST_ASSERT_MSG(config.IsValid(), "Invalid storage config");
 
@@ -114,37 +117,113 @@ int Storage::Run(int max_wait)
     // Because of datastore_lock the only write operation can occur sequentially later.
     Monitor monitor(SharedDataTimestamp{REGION_NONE, 0});
     auto in_use_region = monitor.data().region;
+    auto in_use_metric_region = monitor.data().metric_region;
     auto next_timestamp = monitor.data().timestamp + 1;
-    auto next_region =
-        in_use_region == REGION_2 || in_use_region == REGION_NONE ? REGION_1 : REGION_2;
+
+    if (only_metric && (in_use_region == REGION_NONE ||
+                        !storage::SharedMemory::RegionExists(in_use_region)))
+    {
+        throw util::exception("No dataset in shared memory to load the metric for, run "
+                              "osrm-datastore without --only-metric first." +
+                              SOURCE_REF);
+    }
+
+    // A new dataset replaces the data region and drops the metric region, a new metric
+    // only replaces the metric region and keeps the data region in use.
+    auto next_region = in_use_region;
+    auto next_metric_region = REGION_NONE;
+    if (only_metric)
+    {
+        next_metric_region =
+            in_use_metric_region == METRIC_REGION_1 ? METRIC_REGION_2 : METRIC_REGION_1;
+    }
+    else
+    {
+        next_region =
+            in_use_region == REGION_2 || in_use_region == REGION_NONE ? REGION_1 : REGION_2;
+    }
+    const auto load_region = only_metric ? next_metric_region : next_region;
 
     // ensure that the shared memory region we want to write to is really removed
     // this is only needef for failure recovery because we actually wait for all clients
     // to detach at the end of the function
-    if (storage::SharedMemory::RegionExists(next_region))
+    if (storage::SharedMemory::RegionExists(load_region))
     {
-        util::Log(logWARNING) << "Old shared memory region " << regionToString(next_region)
+        util::Log(logWARNING) << "Old shared memory region " << regionToString(load_region)
                               << " still exists.";
         util::UnbufferedLog() << "Retrying removal... ";
-        storage::SharedMemory::Remove(next_region);
+        storage::SharedMemory::Remove(load_region);
         util::UnbufferedLog() << "ok.";
     }
 
-    util::Log() << "Loading data into " << regionToString(next_region);
+    util::Log() << "Loading data into " << regionToString(load_region);
 
     // Populate a memory layout into stack memory
     DataLayout layout;
     PopulateLayout(layout);
 
-    // Allocate shared memory block
-    auto regions_size = sizeof(layout) + layout.GetSizeOfLayout();
-    util::Log() << "Allocating shared memory of " << regions_size << " bytes";
-    auto data_memory = makeSharedMemory(next_region, regions_size);
+    std::unique_ptr<storage::SharedMemory> data_memory;
+    if (only_metric)
+    {
+        auto in_use_memory = makeSharedMemory(in_use_region);
+        const auto &in_use_layout = *reinterpret_cast<DataLayout *>(in_use_memory->Ptr());
 
-    // Copy memory layout to shared memory and populate data
-    char *shared_memory_ptr = static_cast<char *>(data_memory->Ptr());
-    memcpy(shared_memory_ptr, &layout, sizeof(layout));
-    PopulateData(layout, shared_memory_ptr + sizeof(layout));
+        // osrm-contract and osrm-customize --cch store weights in the query graph itself,
+        // which is not part of the metric blocks
+        for (const auto block : {DataLayout::CH_GRAPH_EDGE_LIST, DataLayout::CCH_GRAPH_EDGE_LIST})
+        {
+            if (in_use_layout.num_entries[block] > 0 || layout.num_entries[block] > 0)
+            {
+                throw util::exception("Datasets with CH or CCH graphs can not be loaded with "
+                                      "--only-metric, run osrm-datastore without it." +
+                                      SOURCE_REF);
+            }
+        }
+
+        // the metric blocks are read in place of the ones in the data region,
+        // so they need to belong to the same extracted and partitioned dataset
+        const auto in_use_topology = *in_use_layout.GetBlockPtr<std::uint64_t>(
+            static_cast<char *>(in_use_memory->Ptr()) + sizeof(DataLayout),
+            DataLayout::TOPOLOGY_FINGERPRINT);
+        if (in_use_topology != getDatasetFingerprint(config).topology)
+        {
+            throw util::exception("The dataset in " + regionToString(in_use_region) +
+                                  " is not the one in " + config.base_path.string() +
+                                  " or it was extracted or partitioned again, run "
+                                  "osrm-datastore without --only-metric." + SOURCE_REF);
+        }
+        for (const auto block : metric_blocks)
+        {
+            if (in_use_layout.num_entries[block] != layout.num_entries[block])
+            {
+                throw util::exception("Block " + std::string(block_id_to_name[block]) +
+                                      " does not match the dataset in " +
+                                      regionToString(in_use_region) +
+                                      ", run osrm-datastore without --only-metric." + SOURCE_REF);
+            }
+        }
+
+        const auto metric_layout = makeMetricLayout(layout);
+        auto regions_size = sizeof(metric_layout) + metric_layout.GetSizeOfLayout();
+        util::Log() << "Allocating shared memory of " << regions_size << " bytes";
+        data_memory = makeSharedMemory(next_metric_region, regions_size);
+
+        char *shared_memory_ptr = static_cast<char *>(data_memory->Ptr());
+        memcpy(shared_memory_ptr, &metric_layout, sizeof(metric_layout));
+        PopulateMetricData(layout, metric_layout, shared_memory_ptr + sizeof(metric_layout));
+    }
+    else
+    {
+        // Allocate shared memory block
+        auto regions_size = sizeof(layout) + layout.GetSizeOfLayout();
+        util::Log() << "Allocating shared memory of " << regions_size << " bytes";
+        data_memory = makeSharedMemory(next_region, regions_size);
+
+        // Copy memory layout to shared memory and populate data
+        char *shared_memory_ptr = static_cast<char *>(data_memory->Ptr());
+        memcpy(shared_memory_ptr, &layout, sizeof(layout));
+        PopulateData(layout, shared_memory_ptr + sizeof(layout));
+    }
 
     { // Lock for write access shared region mutex
         boost::interprocess::scoped_lock<Monitor::mutex_type> lock(monitor.get_mutex(),
@@ -161,6 +240,7 @@ int Storage::Run(int max_wait)
                        "attached processes will not receive notifications and must be restarted";
                 Monitor::remove();
                 in_use_region = REGION_NONE;
+                in_use_metric_region = REGION_NONE;
                 monitor = Monitor(SharedDataTimestamp{REGION_NONE, 0});
             }
         }
@@ -169,32 +249,42 @@ int Storage::Run(int max_wait)
             lock.lock();
         }
 
-        // Update the current region ID and timestamp
+        // Update the current region IDs and timestamp
         monitor.data().region = next_region;
+        monitor.data().metric_region = next_metric_region;
         monitor.data().timestamp = next_timestamp;
     }
 
     util::Log() << "All data loaded. Notify all client about new data in "
-                << regionToString(next_region) << " with timestamp " << next_timestamp;
+                << regionToString(load_region) << " with timestamp " << next_timestamp;
     monitor.notify_all();
 
-    // SHMCTL(2): Mark the segment to be destroyed. The segment will actually be destroyed
-    // only after the last process detaches it.
-    if (in_use_region != REGION_NONE && storage::SharedMemory::RegionExists(in_use_region))
+    std::vector<SharedDataType> old_regions = {in_use_metric_region};
+    if (!only_metric)
+    {
+        old_regions.push_back(in_use_region);
+    }
+
+    for (const auto old_region : old_regions)
     {
-        util::UnbufferedLog() << "Marking old shared memory region "
-                              << regionToString(in_use_region) << " for removal... ";
+        // SHMCTL(2): Mark the segment to be destroyed. The segment will actually be destroyed
+        // only after the last process detaches it.
+        if (old_region != REGION_NONE && storage::SharedMemory::RegionExists(old_region))
+        {
+            util::UnbufferedLog() << "Marking old shared memory region "
+                                  << regionToString(old_region) << " for removal... ";
 
-        // aquire a handle for the old shared memory region before we mark it for deletion
-        // we will need this to wait for all users to detach
-        auto in_use_shared_memory = makeSharedMemory(in_use_region);
+            // aquire a handle for the old shared memory region before we mark it for deletion
+            // we will need this to wait for all users to detach
+            auto old_shared_memory = makeSharedMemory(old_region);
 
-        storage::SharedMemory::Remove(in_use_region);
-        util::UnbufferedLog() << "ok.";
+            storage::SharedMemory::Remove(old_region);
+            util::UnbufferedLog() << "ok.";
 
-        util::UnbufferedLog() << "Waiting for clients to detach... ";
-        in_use_shared_memory->WaitForDetach();
-        util::UnbufferedLog() << " ok.";
+            util::UnbufferedLog() << "Waiting for clients to detach... ";
+            old_shared_memory->WaitForDetach();
+            util::UnbufferedLog() << " ok.";
+        }
     }
 
     util::Log() << "All clients switched.";
@@ -307,6 +397,32 @@ void Storage::PopulateLayout(DataLayout &layout)
         }
     }
 
+    if (boost::filesystem::exists(config.GetPath(".osrm.cch")))
+    {
+        io::FileReader reader(config.GetPath(".osrm.cch"), io::FileReader::VerifyFingerprint);
+
+        const auto num_nodes = reader.ReadVectorSize<contractor::QueryGraph::NodeArrayEntry>();
+        const auto num_edges = reader.ReadVectorSize<contractor::QueryGraph::EdgeArrayEntry>();
+        const auto num_tree_nodes = reader.ReadVectorSize<customizer::EliminationTreeNode>();
+
+        layout.SetBlockSize<contractor::QueryGraph::NodeArrayEntry>(
+            DataLayout::CCH_GRAPH_NODE_LIST, num_nodes);
+        layout.SetBlockSize<contractor::QueryGraph::EdgeArrayEntry>(
+            DataLayout::CCH_GRAPH_EDGE_LIST, num_edges);
+        layout.SetBlockSize<unsigned>(DataLayout::CCH_EDGE_FILTER, num_edges);
+        layout.SetBlockSize<customizer::EliminationTreeNode>(DataLayout::CCH_ELIMINATION_TREE,
+                                                             num_tree_nodes);
+    }
+    else
+    {
+        layout.SetBlockSize<contractor::QueryGraph::NodeArrayEntry>(
+            DataLayout::CCH_GRAPH_NODE_LIST, 0);
+        layout.SetBlockSize<contractor::QueryGraph::EdgeArrayEntry>(
+            DataLayout::CCH_GRAPH_EDGE_LIST, 0);
+        layout.SetBlockSize<unsigned>(DataLayout::CCH_EDGE_FILTER, 0);
+        layout.SetBlockSize<customizer::EliminationTreeNode>(DataLayout::CCH_ELIMINATION_TREE, 0);
+    }
+
     // load rsearch tree size
     {
         io::FileReader tree_node_file(config.GetPath(".osrm.ramIndex"),
@@ -331,6 +447,11 @@ void Storage::PopulateLayout(DataLayout &layout)
         layout.SetBlockSize<char>(DataLayout::TIMESTAMP, timestamp_size);
     }
 
+    {
+        layout.SetBlockSize<std::uint64_t>(DataLayout::TOPOLOGY_FINGERPRINT, 1);
+        layout.SetBlockSize<std::uint64_t>(DataLayout::METRIC_FINGERPRINT, 1);
+    }
+
     // load turn weight penalties
     {
         io::FileReader turn_weight_penalties_file(config.GetPath(".osrm.turn_weight_penalties"),
@@ -610,6 +731,42 @@ void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
             memory_ptr, DataLayout::CH_GRAPH_EDGE_LIST);
     }
 
+    // Load the CCH file
+    if (boost::filesystem::exists(config.GetPath(".osrm.cch")))
+    {
+        auto graph_nodes_ptr = layout.GetBlockPtr<contractor::QueryGraphView::NodeArrayEntry, true>(
+            memory_ptr, DataLayout::CCH_GRAPH_NODE_LIST);
+        auto graph_edges_ptr = layout.GetBlockPtr<contractor::QueryGraphView::EdgeArrayEntry, true>(
+            memory_ptr, DataLayout::CCH_GRAPH_EDGE_LIST);
+        auto edge_filter_ptr =
+            layout.GetBlockPtr<unsigned, true>(memory_ptr, DataLayout::CCH_EDGE_FILTER);
+        auto elimination_tree_ptr = layout.GetBlockPtr<customizer::EliminationTreeNode, true>(
+            memory_ptr, DataLayout::CCH_ELIMINATION_TREE);
+
+        util::vector_view<contractor::QueryGraphView::NodeArrayEntry> node_list(
+            graph_nodes_ptr, layout.num_entries[DataLayout::CCH_GRAPH_NODE_LIST]);
+        util::vector_view<contractor::QueryGraphView::EdgeArrayEntry> edge_list(
+            graph_edges_ptr, layout.num_entries[DataLayout::CCH_GRAPH_EDGE_LIST]);
+        util::vector_view<bool> edge_filter(edge_filter_ptr,
+                                            layout.num_entries[DataLayout::CCH_EDGE_FILTER]);
+        util::vector_view<customizer::EliminationTreeNode> elimination_tree(
+            elimination_tree_ptr, layout.num_entries[DataLayout::CCH_ELIMINATION_TREE]);
+
+        contractor::QueryGraphView graph_view(std::move(node_list), std::move(edge_list));
+        customizer::files::readCCH(
+            config.GetPath(".osrm.cch"), graph_view, elimination_tree, edge_filter);
+    }
+    else
+    {
+        layout.GetBlockPtr<contractor::QueryGraphView::NodeArrayEntry, true>(
+            memory_ptr, DataLayout::CCH_GRAPH_NODE_LIST);
+        layout.GetBlockPtr<contractor::QueryGraphView::EdgeArrayEntry, true>(
+            memory_ptr, DataLayout::CCH_GRAPH_EDGE_LIST);
+        layout.GetBlockPtr<unsigned, true>(memory_ptr, DataLayout::CCH_EDGE_FILTER);
+        layout.GetBlockPtr<customizer::EliminationTreeNode, true>(
+            memory_ptr, DataLayout::CCH_ELIMINATION_TREE);
+    }
+
     // store the filename of the on-disk portion of the RTree
     {
         const auto file_index_path_ptr =
@@ -856,6 +1013,15 @@ void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
         timestamp_file.ReadInto(timestamp_ptr, timestamp_size);
     }
 
+    // store the fingerprint of the files the blocks are read from
+    {
+        const auto fingerprint = getDatasetFingerprint(config);
+        *layout.GetBlockPtr<std::uint64_t, true>(memory_ptr, DataLayout::TOPOLOGY_FINGERPRINT) =
+            fingerprint.topology;
+        *layout.GetBlockPtr<std::uint64_t, true>(memory_ptr, DataLayout::METRIC_FINGERPRINT) =
+            fingerprint.metric;
+    }
+
     // store search tree portion of rtree
     {
         io::FileReader tree_node_file(config.GetPath(".osrm.ramIndex"),
@@ -1046,5 +1212,173 @@ void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
         }
     }
 }
+
+void Storage::PopulateMetricData(const DataLayout &layout,
+                                 const DataLayout &metric_layout,
+                                 char *memory_ptr)
+{
+    BOOST_ASSERT(memory_ptr != nullptr);
+
+    // write the canaries of all blocks, also of the ones without data
+    for (const auto block : util::irange<std::size_t>(0, DataLayout::NUM_BLOCKS))
+    {
+        metric_layout.GetBlockPtr<char, true>(memory_ptr, static_cast<DataLayout::BlockID>(block));
+    }
+
+    // The topology blocks of the same files are only read to skip them,
+    // the dataset in shared memory contains them already
+
+    // load compressed geometry weights, durations and datasources
+    {
+        std::vector<unsigned> geometry_begin_indices_buffer(
+            layout.num_entries[DataLayout::GEOMETRIES_INDEX]);
+        util::vector_view<unsigned> geometry_begin_indices(geometry_begin_indices_buffer.data(),
+                                                           geometry_begin_indices_buffer.size());
+
+        auto num_entries = layout.num_entries[DataLayout::GEOMETRIES_NODE_LIST];
+
+        std::vector<NodeID> geometry_node_list_buffer(num_entries);
+        util::vector_view<NodeID> geometry_node_list(geometry_node_list_buffer.data(),
+                                                     geometry_node_list_buffer.size());
+
+        auto geometries_fwd_weight_list_ptr =
+            metric_layout.GetBlockPtr<extractor::SegmentDataView::SegmentWeightVector::block_type>(
+                memory_ptr, DataLayout::GEOMETRIES_FWD_WEIGHT_LIST);
+        extractor::SegmentDataView::SegmentWeightVector geometry_fwd_weight_list(
+            util::vector_view<extractor::SegmentDataView::SegmentWeightVector::block_type>(
+                geometries_fwd_weight_list_ptr,
+                metric_layout.num_entries[DataLayout::GEOMETRIES_FWD_WEIGHT_LIST]),
+            num_entries);
+
+        auto geometries_rev_weight_list_ptr =
+            metric_layout.GetBlockPtr<extractor::SegmentDataView::SegmentWeightVector::block_type>(
+                memory_ptr, DataLayout::GEOMETRIES_REV_WEIGHT_LIST);
+        extractor::SegmentDataView::SegmentWeightVector geometry_rev_weight_list(
+            util::vector_view<extractor::SegmentDataView::SegmentWeightVector::block_type>(
+                geometries_rev_weight_list_ptr,
+                metric_layout.num_entries[DataLayout::GEOMETRIES_REV_WEIGHT_LIST]),
+            num_entries);
+
+        auto geometries_fwd_duration_list_ptr = metric_layout.GetBlockPtr<
+            extractor::SegmentDataView::SegmentDurationVector::block_type>(
+            memory_ptr, DataLayout::GEOMETRIES_FWD_DURATION_LIST);
+        extractor::SegmentDataView::SegmentDurationVector geometry_fwd_duration_list(
+            util::vector_view<extractor::SegmentDataView::SegmentDurationVector::block_type>(
+                geometries_fwd_duration_list_ptr,
+                metric_layout.num_entries[DataLayout::GEOMETRIES_FWD_DURATION_LIST]),
+            num_entries);
+
+        auto geometries_rev_duration_list_ptr = metric_layout.GetBlockPtr<
+            extractor::SegmentDataView::SegmentDurationVector::block_type>(
+            memory_ptr, DataLayout::GEOMETRIES_REV_DURATION_LIST);
+        extractor::SegmentDataView::SegmentDurationVector geometry_rev_duration_list(
+            util::vector_view<extractor::SegmentDataView::SegmentDurationVector::block_type>(
+                geometries_rev_duration_list_ptr,
+                metric_layout.num_entries[DataLayout::GEOMETRIES_REV_DURATION_LIST]),
+            num_entries);
+
+        auto geometries_fwd_datasources_list_ptr = metric_layout.GetBlockPtr<DatasourceID>(
+            memory_ptr, DataLayout::GEOMETRIES_FWD_DATASOURCES_LIST);
+        util::vector_view<DatasourceID> geometry_fwd_datasources_list(
+            geometries_fwd_datasources_list_ptr,
+            metric_layout.num_entries[DataLayout::GEOMETRIES_FWD_DATASOURCES_LIST]);
+
+        auto geometries_rev_datasources_list_ptr = metric_layout.GetBlockPtr<DatasourceID>(
+            memory_ptr, DataLayout::GEOMETRIES_REV_DATASOURCES_LIST);
+        util::vector_view<DatasourceID> geometry_rev_datasources_list(
+            geometries_rev_datasources_list_ptr,
+            metric_layout.num_entries[DataLayout::GEOMETRIES_REV_DATASOURCES_LIST]);
+
+        extractor::SegmentDataView segment_data{std::move(geometry_begin_indices),
+                                                std::move(geometry_node_list),
+                                                std::move(geometry_fwd_weight_list),
+                                                std::move(geometry_rev_weight_list),
+                                                std::move(geometry_fwd_duration_list),
+                                                std::move(geometry_rev_duration_list),
+                                                std::move(geometry_fwd_datasources_list),
+                                                std::move(geometry_rev_datasources_list)};
+
+        extractor::files::readSegmentData(config.GetPath(".osrm.geometry"), segment_data);
+    }
+
+    {
+        const auto datasources_names_ptr =
+            metric_layout.GetBlockPtr<extractor::Datasources>(memory_ptr,
+                                                              DataLayout::DATASOURCES_NAMES);
+        extractor::files::readDatasources(config.GetPath(".osrm.datasource_names"),
+                                          *datasources_names_ptr);
+    }
+
+    {
+        *metric_layout.GetBlockPtr<std::uint64_t>(memory_ptr, DataLayout::METRIC_FINGERPRINT) =
+            getDatasetFingerprint(config).metric;
+    }
+
+    // load turn weight penalties
+    {
+        io::FileReader turn_weight_penalties_file(config.GetPath(".osrm.turn_weight_penalties"),
+                                                  io::FileReader::VerifyFingerprint);
+        const auto number_of_penalties = turn_weight_penalties_file.ReadElementCount64();
+        const auto turn_weight_penalties_ptr =
+            metric_layout.GetBlockPtr<TurnPenalty>(memory_ptr, DataLayout::TURN_WEIGHT_PENALTIES);
+        turn_weight_penalties_file.ReadInto(turn_weight_penalties_ptr, number_of_penalties);
+    }
+
+    // load turn duration penalties
+    {
+        io::FileReader turn_duration_penalties_file(config.GetPath(".osrm.turn_duration_penalties"),
+                                                    io::FileReader::VerifyFingerprint);
+        const auto number_of_penalties = turn_duration_penalties_file.ReadElementCount64();
+        const auto turn_duration_penalties_ptr = metric_layout.GetBlockPtr<TurnPenalty>(
+            memory_ptr, DataLayout::TURN_DURATION_PENALTIES);
+        turn_duration_penalties_file.ReadInto(turn_duration_penalties_ptr, number_of_penalties);
+    }
+
+    if (boost::filesystem::exists(config.GetPath(".osrm.cell_metrics")))
+    {
+        std::vector<customizer::CellMetricView> metrics;
+
+        for (auto index : util::irange<std::size_t>(0, NUM_METRICS))
+        {
+            auto weights_block_id =
+                static_cast<DataLayout::BlockID>(DataLayout::MLD_CELL_WEIGHTS_0 + index);
+            auto durations_block_id =
+                static_cast<DataLayout::BlockID>(DataLayout::MLD_CELL_DURATIONS_0 + index);
+
+            util::vector_view<EdgeWeight> weights(
+                metric_layout.GetBlockPtr<EdgeWeight>(memory_ptr, weights_block_id),
+                metric_layout.GetBlockEntries(weights_block_id));
+            util::vector_view<EdgeDuration> durations(
+                metric_layout.GetBlockPtr<EdgeDuration>(memory_ptr, durations_block_id),
+                metric_layout.GetBlockEntries(durations_block_id));
+
+            metrics.push_back(customizer::CellMetricView{std::move(weights), std::move(durations)});
+        }
+
+        customizer::files::readCellMetrics(config.GetPath(".osrm.cell_metrics"), metrics);
+    }
+
+    if (boost::filesystem::exists(config.GetPath(".osrm.mldgr")))
+    {
+        using GraphView = customizer::MultiLevelEdgeBasedGraphView;
+
+        std::vector<GraphView::NodeArrayEntry> node_list_buffer(
+            layout.num_entries[DataLayout::MLD_GRAPH_NODE_LIST]);
+        std::vector<GraphView::EdgeOffset> node_to_offset_buffer(
+            layout.num_entries[DataLayout::MLD_GRAPH_NODE_TO_OFFSET]);
+
+        util::vector_view<GraphView::NodeArrayEntry> node_list(node_list_buffer.data(),
+                                                               node_list_buffer.size());
+        util::vector_view<GraphView::EdgeArrayEntry> edge_list(
+            metric_layout.GetBlockPtr<GraphView::EdgeArrayEntry>(memory_ptr,
+                                                                 DataLayout::MLD_GRAPH_EDGE_LIST),
+            metric_layout.num_entries[DataLayout::MLD_GRAPH_EDGE_LIST]);
+        util::vector_view<GraphView::EdgeOffset> node_to_offset(node_to_offset_buffer.data(),
+                                                                node_to_offset_buffer.size());
+
+        GraphView graph_view(std::move(node_list), std::move(edge_list), std::move(node_to_offset));
+        partition::files::readGraph(config.GetPath(".osrm.mldgr"), graph_view);
+    }
+}
 }
 }
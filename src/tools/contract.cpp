@@ -66,6 +66,10 @@ return_code parseArguments(int argc,
         "DEPRECATED: Will always be false. Use .level file to retain the contraction level for "
         "each "
         "node from the last run.")(
+        "reuse-order",
+        boost::program_options::bool_switch(&contractor_config.reuse_order)->default_value(false),
+        "Contract the nodes in the order of the .osrm.level file of the last run. Only the "
+        "shortcuts are computed again, falls back to a full contraction if the graph changed.")(
         "edge-weight-updates-over-factor",
         boost::program_options::value<double>(
             &contractor_config.updater_config.log_edge_updates_factor)
@@ -70,7 +70,20 @@ return_code parseArguments(int argc,
                 &customization_config.updater_config.tz_file_path)
                 ->default_value(""),
             "Required for conditional turn restriction parsing, provide a geojson file containing "
-            "time zone boundaries");
+            "time zone boundaries")(
+            "incremental",
+            boost::program_options::bool_switch(&customization_config.incremental)
+                ->default_value(false),
+            "Update the .osrm.cell_metrics of the previous run, only cells with edges that changed "
+            "since then are customized again")(
+            "cch",
+            boost::program_options::bool_switch(&customization_config.cch)->default_value(false),
+            "Also write a customizable contraction hierarchy (.osrm.cch) for the CCH algorithm")(
+            "cch-only",
+            boost::program_options::bool_switch(&customization_config.cch_only)
+                ->default_value(false),
+            "Only write the customizable contraction hierarchy, the cells for the MLD algorithm "
+            "are not customized");
 
     // hidden options, will be allowed on command line, but will not be
     // shown to the user
@@ -161,6 +174,13 @@ int main(int argc, char *argv[]) try
         return EXIT_FAILURE;
     }
 
+    if (customization_config.cch_only && customization_config.incremental)
+    {
+        util::Log(logERROR) << "--incremental only applies to the MLD cells, it can't be used "
+                               "with --cch-only";
+        return EXIT_FAILURE;
+    }
+
     if (!customization_config.IsValid())
     {
         return EXIT_FAILURE;
@@ -6,17 +6,43 @@
 
 #include <tbb/task_scheduler_init.h>
 
+#include <boost/algorithm/string/case_conv.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/program_options.hpp>
 
 #include <cstdlib>
 #include <exception>
+#include <istream>
 #include <new>
+#include <string>
 
 #include "util/meminfo.hpp"
 
 using namespace osrm;
 
+namespace osrm
+{
+namespace extractor
+{
+std::istream &operator>>(std::istream &in, ExtractorConfig::LocationIndexType &type)
+{
+    std::string token;
+    in >> token;
+    boost::to_lower(token);
+
+    if (token == "flex_mem")
+        type = ExtractorConfig::LocationIndexType::FlexMem;
+    else if (token == "dense_file")
+        type = ExtractorConfig::LocationIndexType::DenseFile;
+    else if (token == "sparse_file")
+        type = ExtractorConfig::LocationIndexType::SparseFile;
+    else
+        throw boost::program_options::invalid_option_value(token);
+    return in;
+}
+}
+}
+
 enum class return_code : unsigned
 {
     ok,
@@ -71,7 +97,17 @@ return_code parseArguments(int argc,
         boost::program_options::bool_switch(&extractor_config.use_locations_cache)
             ->implicit_value(false)
             ->default_value(true),
-        "Use internal nodes locations cache for location-dependent data lookups");
+        "Use internal nodes locations cache for location-dependent data lookups")(
+        "location-index",
+        boost::program_options::value<extractor::ExtractorConfig::LocationIndexType>(
+            &extractor_config.location_index_type)
+            ->default_value(extractor::ExtractorConfig::LocationIndexType::FlexMem, "flex_mem"),
+        "Index of the nodes locations cache: flex_mem keeps it in memory, dense_file (dense node "
+        "IDs, e.g. planet) and sparse_file (extracts) memory-map a temporary file")(
+        "location-index-dir",
+        boost::program_options::value<boost::filesystem::path>(
+            &extractor_config.location_index_path),
+        "Directory of the dense_file and sparse_file index, defaults to the output directory");
 
     bool dummy;
     // hidden options, will be allowed on command line, but will not be
@@ -180,6 +216,14 @@ int main(int argc, char *argv[]) try
         return EXIT_FAILURE;
     }
 
+    if (!extractor_config.location_index_path.empty() &&
+        !boost::filesystem::is_directory(extractor_config.location_index_path))
+    {
+        util::Log(logERROR) << "Location index directory "
+                            << extractor_config.location_index_path.string() << " not found!";
+        return EXIT_FAILURE;
+    }
+
     osrm::extract(extractor_config);
 
     util::DumpSTXXLStats();
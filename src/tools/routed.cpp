@@ -18,14 +18,17 @@
 
 #include <signal.h>
 
+#include <algorithm>
 #include <chrono>
 #include <exception>
 #include <future>
 #include <iostream>
 #include <memory>
 #include <new>
+#include <sstream>
 #include <string>
 #include <thread>
+#include <vector>
 
 #ifdef _WIN32
 boost::function0<void> console_ctrl_function;
@@ -52,22 +55,49 @@ const static unsigned INIT_OK_START_ENGINE = 0;
 const static unsigned INIT_OK_DO_NOT_START_ENGINE = 1;
 const static unsigned INIT_FAILED = -1;
 
+// services whose requests can get their own queue with --service-threads
+const static std::string QUEUEABLE_SERVICES[] = {
+    "route", "nearest", "table", "match", "trip", "tile", "update"};
+
 namespace osrm
 {
 namespace engine
 {
-std::istream &operator>>(std::istream &in, EngineConfig::Algorithm &algorithm)
+std::istream &operator>>(std::istream &in, EngineConfig::HeapStorage &storage)
+{
+    std::string token;
+    in >> token;
+    boost::to_lower(token);
+
+    if (token == "hashmap")
+        storage = EngineConfig::HeapStorage::HashMap;
+    else if (token == "array")
+        storage = EngineConfig::HeapStorage::Array;
+    else if (token == "twolevel")
+        storage = EngineConfig::HeapStorage::TwoLevel;
+    else
+        throw boost::program_options::invalid_option_value(token);
+    return in;
+}
+
+std::istream &operator>>(std::istream &in, EngineConfig::MemoryAdvice &advice)
 {
     std::string token;
     in >> token;
     boost::to_lower(token);
 
-    if (token == "ch" || token == "corech")
-        algorithm = EngineConfig::Algorithm::CH;
-    else if (token == "mld")
-        algorithm = EngineConfig::Algorithm::MLD;
+    if (token == "normal")
+        advice = EngineConfig::MemoryAdvice::Normal;
+    else if (token == "random")
+        advice = EngineConfig::MemoryAdvice::Random;
+    else if (token == "sequential")
+        advice = EngineConfig::MemoryAdvice::Sequential;
+    else if (token == "willneed")
+        advice = EngineConfig::MemoryAdvice::WillNeed;
+    else if (token == "populate")
+        advice = EngineConfig::MemoryAdvice::Populate;
     else
-        throw util::RuntimeError(token, ErrorCode::UnknownAlgorithm, SOURCE_REF);
+        in.setstate(std::ios::failbit);
     return in;
 }
 }
@@ -79,9 +109,19 @@ inline unsigned generateServerProgramOptions(const int argc,
                                              boost::filesystem::path &base_path,
                                              std::string &ip_address,
                                              int &ip_port,
+                                             std::string &update_ip_address,
+                                             int &update_port,
                                              bool &trial,
                                              EngineConfig &config,
-                                             int &requested_thread_num)
+                                             int &requested_thread_num,
+                                             int &requested_io_thread_num,
+                                             std::size_t &max_queue_size,
+                                             std::vector<std::string> &service_threads,
+                                             std::vector<std::string> &memory_advice,
+                                             std::vector<std::string> &datasets,
+                                             std::size_t &response_cache_mb,
+                                             std::size_t &unpacking_cache_mb,
+                                             server::ConnectionConfig &connection_config)
 {
     using boost::program_options::value;
     using boost::filesystem::path;
@@ -108,14 +148,88 @@ inline unsigned generateServerProgramOptions(const int argc,
          "TCP/IP port") //
         ("threads,t",
          value<int>(&requested_thread_num)->default_value(hardware_threads),
-         "Number of threads to use") //
+         "Number of threads answering routing requests") //
+        ("io-threads",
+         value<int>(&requested_io_thread_num)->default_value(1),
+         "Number of threads accepting connections and reading/writing requests") //
+        ("max-queue-size",
+         value<std::size_t>(&max_queue_size)->default_value(1024),
+         "Max. number of requests waiting for a routing thread, more are rejected with 503") //
+        ("service-threads",
+         value<std::vector<std::string>>(&service_threads)->multitoken(),
+         "Give a service its own request queue and threads, e.g. --service-threads table=2 "
+         "trip=1") //
+        ("keepalive-timeout,k",
+         value<unsigned>(&connection_config.keepalive_timeout)->default_value(5),
+         "Seconds to keep an idle connection open for further requests, 0 disables "
+         "keep-alive") //
+        ("keepalive-requests",
+         value<unsigned>(&connection_config.keepalive_max_requests)->default_value(512),
+         "Max. number of requests answered on one connection, 0 or 1 disables keep-alive") //
+        ("request-timeout",
+         value<unsigned>(&connection_config.request_timeout)->default_value(30),
+         "Seconds a client has to send a complete request before its connection is closed") //
+        ("max-body-size",
+         value<std::size_t>(&connection_config.max_body_size)
+             ->default_value(server::RequestParser::DEFAULT_MAX_BODY_SIZE),
+         "Max. size in bytes of the body of POST /update and nearest requests") //
         ("shared-memory,s",
          value<bool>(&config.use_shared_memory)->implicit_value(true)->default_value(false),
          "Load data from shared memory") //
+        ("memory-file",
+         value<boost::filesystem::path>(&config.memory_file),
+         "Memory-map the dataset from this file instead of loading it into process memory. "
+         "The file is written from the .osrm files if it is missing or outdated.") //
+        ("memory-advice",
+         value<std::vector<std::string>>(&memory_advice)->multitoken(),
+         "Access pattern hint for blocks of the --memory-file, e.g. --memory-advice all=random "
+         "R_SEARCH_TREE=populate. Can be normal, random, sequential, willneed, populate.") //
+        ("dataset",
+         value<std::vector<std::string>>(&datasets)->multitoken(),
+         "Serve another dataset under the profile name of the URL, e.g. --dataset "
+         "truck=truck.osrm bike=bike.osrm. Blocks equal to those of another dataset are kept "
+         "once. Not available with --shared-memory and --memory-file.") //
+        ("live-traffic-updates",
+         value<bool>(&config.live_traffic_updates)->implicit_value(true)->default_value(false),
+         "Accept segment speeds with POST /update and customize the MLD metric in place. "
+         "Not available with --shared-memory.") //
+        ("update-ip",
+         value<std::string>(&update_ip_address)->default_value("127.0.0.1"),
+         "IP address of --update-port") //
+        ("update-port",
+         value<int>(&update_port)->default_value(0),
+         "Answer POST /update only on this TCP/IP port and nothing else, 0 answers it on "
+         "--port") //
+        ("tile-archive",
+         value<boost::filesystem::path>(&config.tile_archive),
+         "Answer tile requests from the tiles that osrm-tiles rendered into this file, "
+         "tiles that are not in it are rendered as usual.") //
         ("algorithm,a",
          value<EngineConfig::Algorithm>(&config.algorithm)
              ->default_value(EngineConfig::Algorithm::CH, "CH"),
-         "Algorithm to use for the data. Can be CH, CoreCH, MLD.") //
+         "Algorithm to use for the data. Can be CH, CoreCH, MLD, CCH.") //
+        ("heap-storage",
+         value<EngineConfig::HeapStorage>(&config.query_heap_storage)
+             ->default_value(EngineConfig::HeapStorage::HashMap, "HashMap"),
+         "Node index of the route/match/trip query heaps. Can be HashMap, Array, TwoLevel.") //
+        ("many-to-many-heap-storage",
+         value<EngineConfig::HeapStorage>(&config.many_to_many_heap_storage)
+             ->default_value(EngineConfig::HeapStorage::HashMap, "HashMap"),
+         "Node index of the table query heap. Can be HashMap, Array, TwoLevel.") //
+        ("heap-dense-nodes",
+         value<std::size_t>(&config.heap_dense_nodes)->default_value(1 << 20),
+         "Number of node IDs kept in the array of TwoLevel heaps") //
+        ("response-cache-size",
+         value<std::size_t>(&response_cache_mb)->default_value(0),
+         "Megabytes of memory used to cache route, table and nearest responses, 0 disables "
+         "the cache") //
+        ("phantom-node-cache-size",
+         value<std::size_t>(&config.phantom_node_cache_size)->default_value(0),
+         "Number of snapped coordinates to cache, 0 disables the cache") //
+        ("unpacking-cache-size",
+         value<std::size_t>(&unpacking_cache_mb)->default_value(0),
+         "Megabytes of memory used to cache unpacked overlay edges of MLD queries, 0 disables "
+         "the cache") //
         ("max-viaroute-size",
          value<int>(&config.max_locations_viaroute)->default_value(500),
          "Max. locations supported in viaroute query") //
@@ -125,18 +239,33 @@ inline unsigned generateServerProgramOptions(const int argc,
         ("max-table-size",
          value<int>(&config.max_locations_distance_table)->default_value(100),
          "Max. locations supported in distance table query") //
+        ("max-table-threads",
+         value<unsigned>(&config.max_threads_distance_table)->default_value(1),
+         "Max. threads the searches of a single distance table query run on") //
         ("max-matching-size",
          value<int>(&config.max_locations_map_matching)->default_value(100),
          "Max. locations supported in map matching query") //
         ("max-nearest-size",
          value<int>(&config.max_results_nearest)->default_value(100),
          "Max. results supported in nearest query") //
+        ("max-nearest-batch-size",
+         value<int>(&config.max_batch_size_nearest)->default_value(10000),
+         "Max. coordinates supported in a batch nearest query") //
         ("max-alternatives",
          value<int>(&config.max_alternatives)->default_value(3),
          "Max. number of alternatives supported in the MLD route query") //
         ("max-matching-radius",
          value<double>(&config.max_radius_map_matching)->default_value(5),
-         "Max. radius size supported in map matching query");
+         "Max. radius size supported in map matching query") //
+        ("max-match-sessions",
+         value<std::size_t>(&config.max_match_sessions)->default_value(0),
+         "Max. number of match sessions kept in memory, 0 disables match sessions") //
+        ("match-session-timeout",
+         value<unsigned>(&config.match_session_timeout)->default_value(300),
+         "Seconds after its last request a match session expires") //
+        ("max-match-session-points",
+         value<std::size_t>(&config.max_match_session_points)->default_value(100),
+         "Max. number of trace points a match session keeps");
 
     // hidden options, will be allowed on command line, but will not be shown to the user
     boost::program_options::options_description hidden_options("Hidden options");
@@ -186,7 +315,7 @@ inline unsigned generateServerProgramOptions(const int argc,
 
     boost::program_options::notify(option_variables);
 
-    if (!config.use_shared_memory && option_variables.count("base"))
+    if (!config.use_shared_memory && (option_variables.count("base") || !datasets.empty()))
     {
         return INIT_OK_START_ENGINE;
     }
@@ -213,13 +342,39 @@ int main(int argc, const char *argv[]) try
     bool trial_run = false;
     std::string ip_address;
     int ip_port;
+    std::string update_ip_address;
+    int update_port;
 
     EngineConfig config;
     boost::filesystem::path base_path;
 
     int requested_thread_num = 1;
-    const unsigned init_result = generateServerProgramOptions(
-        argc, argv, base_path, ip_address, ip_port, trial_run, config, requested_thread_num);
+    int requested_io_thread_num = 1;
+    std::size_t max_queue_size = 1024;
+    std::vector<std::string> service_threads;
+    std::vector<std::string> memory_advice;
+    std::vector<std::string> datasets;
+    std::size_t response_cache_mb = 0;
+    std::size_t unpacking_cache_mb = 0;
+    server::ConnectionConfig connection_config;
+    const unsigned init_result = generateServerProgramOptions(argc,
+                                                              argv,
+                                                              base_path,
+                                                              ip_address,
+                                                              ip_port,
+                                                              update_ip_address,
+                                                              update_port,
+                                                              trial_run,
+                                                              config,
+                                                              requested_thread_num,
+                                                              requested_io_thread_num,
+                                                              max_queue_size,
+                                                              service_threads,
+                                                              memory_advice,
+                                                              datasets,
+                                                              response_cache_mb,
+                                                              unpacking_cache_mb,
+                                                              connection_config);
     if (init_result == INIT_OK_DO_NOT_START_ENGINE)
     {
         return EXIT_SUCCESS;
@@ -230,23 +385,90 @@ int main(int argc, const char *argv[]) try
     }
 
     util::LogPolicy::GetInstance().SetLevel(config.verbosity);
+    config.response_cache_size = response_cache_mb * 1024 * 1024;
+    config.unpacking_cache_size = unpacking_cache_mb * 1024 * 1024;
+
+    for (const auto &block_and_advice : memory_advice)
+    {
+        const auto separator = block_and_advice.find('=');
+        std::istringstream advice_stream(
+            separator == std::string::npos ? "" : block_and_advice.substr(separator + 1));
+        EngineConfig::MemoryAdvice advice;
+        if (!(advice_stream >> advice))
+        {
+            util::Log(logERROR) << "Invalid --memory-advice value " << block_and_advice
+                                << ", expected <block>=<advice>";
+            return EXIT_FAILURE;
+        }
+        config.memory_file_advice[block_and_advice.substr(0, separator)] = advice;
+    }
+    if (!config.memory_file_advice.empty() && config.memory_file.empty())
+    {
+        util::Log(logWARNING) << "--memory-advice is ignored without --memory-file";
+    }
 
     if (!base_path.empty())
     {
         config.storage_config = storage::StorageConfig(base_path);
     }
-    if (!config.use_shared_memory && !config.storage_config.IsValid())
+
+    // every named dataset gets a copy of the configuration with its own files
+    std::vector<std::pair<std::string, EngineConfig>> dataset_configs;
+    if (!datasets.empty())
     {
-        util::Log(logERROR) << "Required files are missing, cannot continue";
-        return EXIT_FAILURE;
+        if (config.use_shared_memory || !config.memory_file.empty())
+        {
+            util::Log(logERROR) << "--dataset can't be used with --shared-memory or --memory-file";
+            return EXIT_FAILURE;
+        }
+        config.share_blocks = true;
     }
-    if (!config.IsValid())
+    if (datasets.empty() || !base_path.empty())
     {
-        if (base_path.empty() != config.use_shared_memory)
+        dataset_configs.emplace_back("", config);
+    }
+    for (const auto &name_and_path : datasets)
+    {
+        const auto separator = name_and_path.find('=');
+        if (separator == std::string::npos || separator == 0)
         {
-            util::Log(logWARNING) << "Path settings and shared memory conflicts.";
+            util::Log(logERROR) << "Invalid --dataset value " << name_and_path
+                                << ", expected <name>=<base.osrm>";
+            return EXIT_FAILURE;
+        }
+        EngineConfig dataset_config = config;
+        // the tile archive is rendered from the default dataset
+        dataset_config.tile_archive.clear();
+        dataset_config.storage_config = storage::StorageConfig(name_and_path.substr(separator + 1));
+        dataset_configs.emplace_back(name_and_path.substr(0, separator), std::move(dataset_config));
+    }
+
+    for (const auto &name_and_config : dataset_configs)
+    {
+        const auto &dataset_config = name_and_config.second;
+        if (!dataset_config.use_shared_memory && !dataset_config.storage_config.IsValid())
+        {
+            util::Log(logERROR) << "Required files "
+                                << (name_and_config.first.empty()
+                                        ? std::string()
+                                        : "of dataset " + name_and_config.first + " ")
+                                << "are missing, cannot continue";
+            return EXIT_FAILURE;
+        }
+        if (!dataset_config.IsValid())
+        {
+            if (base_path.empty() != dataset_config.use_shared_memory && datasets.empty())
+            {
+                util::Log(logWARNING) << "Path settings and shared memory conflicts.";
+            }
+            if (dataset_config.live_traffic_updates &&
+                (dataset_config.use_shared_memory ||
+                 dataset_config.algorithm != EngineConfig::Algorithm::MLD))
+            {
+                util::Log(logWARNING) << "--live-traffic-updates needs MLD without shared memory.";
+            }
+            return EXIT_FAILURE;
         }
-        return EXIT_FAILURE;
     }
 
     util::Log() << "starting up engines, " << OSRM_VERSION;
@@ -255,10 +477,61 @@ int main(int argc, const char *argv[]) try
     {
         util::Log() << "Loading from shared memory";
     }
+    else if (!config.memory_file.empty())
+    {
+        util::Log() << "Memory-mapping dataset from " << config.memory_file.string();
+    }
+    if (config.live_traffic_updates)
+    {
+        util::Log() << "Accepting live traffic updates on /update";
+        if (update_port == 0)
+        {
+            util::Log(logWARNING) << "POST /update is answered for every client on port "
+                                  << ip_port << ", use --update-port to restrict it";
+        }
+    }
+
+    server::WorkerPoolConfig worker_config;
+    worker_config.num_threads = std::max(1, requested_thread_num);
+    worker_config.max_queue_size = max_queue_size;
+    for (const auto &service_and_threads : service_threads)
+    {
+        const auto separator = service_and_threads.find('=');
+        if (separator == std::string::npos)
+        {
+            util::Log(logERROR) << "Invalid --service-threads value " << service_and_threads
+                                << ", expected <service>=<threads>";
+            return EXIT_FAILURE;
+        }
+        const auto service = service_and_threads.substr(0, separator);
+        if (std::find(std::begin(QUEUEABLE_SERVICES), std::end(QUEUEABLE_SERVICES), service) ==
+            std::end(QUEUEABLE_SERVICES))
+        {
+            util::Log(logERROR) << "Unknown service " << service << " in --service-threads";
+            return EXIT_FAILURE;
+        }
+        const auto threads = service_and_threads.substr(separator + 1);
+        if (threads.empty() || threads.find_first_not_of("0123456789") != std::string::npos)
+        {
+            util::Log(logERROR) << "Invalid --service-threads value " << service_and_threads
+                                << ", expected <service>=<threads>";
+            return EXIT_FAILURE;
+        }
+        worker_config.service_threads[service] = std::stoul(threads);
+    }
 
     util::Log() << "Threads: " << requested_thread_num;
+    util::Log() << "I/O threads: " << requested_io_thread_num;
+    for (const auto &service_and_threads : worker_config.service_threads)
+    {
+        util::Log() << "Threads for " << service_and_threads.first << ": "
+                    << service_and_threads.second;
+    }
     util::Log() << "IP address: " << ip_address;
     util::Log() << "IP port: " << ip_port;
+    util::Log() << "Keep-alive: " << connection_config.keepalive_timeout << "s, max. "
+                << connection_config.keepalive_max_requests << " requests";
+    util::Log() << "Request timeout: " << connection_config.request_timeout << "s";
 
 #ifndef _WIN32
     int sig = 0;
@@ -268,8 +541,38 @@ int main(int argc, const char *argv[]) try
     pthread_sigmask(SIG_BLOCK, &new_mask, &old_mask);
 #endif
 
-    auto service_handler = std::make_unique<server::ServiceHandler>(config);
-    auto routing_server = server::Server::CreateServer(ip_address, ip_port, requested_thread_num);
+    std::unique_ptr<server::ServiceHandlerInterface> service_handler;
+    if (datasets.empty())
+    {
+        service_handler = std::make_unique<server::ServiceHandler>(dataset_configs.front().second);
+    }
+    else
+    {
+        server::DatasetServiceHandler::Datasets dataset_handlers;
+        for (auto &name_and_config : dataset_configs)
+        {
+            const auto &name = name_and_config.first;
+            if (dataset_handlers.count(name) > 0)
+            {
+                util::Log(logERROR) << "Dataset " << name << " is given more than once";
+                return EXIT_FAILURE;
+            }
+            util::Log() << "Loading "
+                        << (name.empty() ? std::string("default dataset") : "dataset " + name)
+                        << " from " << name_and_config.second.storage_config.GetPath("").string();
+            dataset_handlers[name] =
+                std::make_unique<server::ServiceHandler>(name_and_config.second);
+        }
+        service_handler =
+            std::make_unique<server::DatasetServiceHandler>(std::move(dataset_handlers));
+    }
+    auto routing_server = server::Server::CreateServer(ip_address,
+                                                       ip_port,
+                                                       requested_io_thread_num,
+                                                       worker_config,
+                                                       connection_config,
+                                                       update_ip_address,
+                                                       update_port);
 
     routing_server->RegisterServiceHandler(std::move(service_handler));
 
@@ -45,6 +45,8 @@ void springClean()
     {
         deleteRegion(storage::REGION_1);
         deleteRegion(storage::REGION_2);
+        deleteRegion(storage::METRIC_REGION_1);
+        deleteRegion(storage::METRIC_REGION_2);
         removeLocks();
     }
 }
@@ -54,7 +56,8 @@ bool generateDataStoreOptions(const int argc,
                               const char *argv[],
                               std::string &verbosity,
                               boost::filesystem::path &base_path,
-                              int &max_wait)
+                              int &max_wait,
+                              bool &only_metric)
 {
     // declare a group of options that will be allowed only on command line
     boost::program_options::options_description generic_options("Options");
@@ -68,10 +71,15 @@ bool generateDataStoreOptions(const int argc,
     // declare a group of options that will be allowed both on command line
     // as well as in a config file
     boost::program_options::options_description config_options("Configuration");
-    config_options.add_options()("max-wait",
-                                 boost::program_options::value<int>(&max_wait)->default_value(-1),
-                                 "Maximum number of seconds to wait on a running data update "
-                                 "before aquiring the lock by force.");
+    config_options.add_options()(
+        "max-wait",
+        boost::program_options::value<int>(&max_wait)->default_value(-1),
+        "Maximum number of seconds to wait on a running data update "
+        "before aquiring the lock by force.")(
+        "only-metric",
+        boost::program_options::bool_switch(&only_metric)->default_value(false),
+        "Only load the weights and durations of a dataset that was customized again and "
+        "replace the ones of the dataset in shared memory.");
 
     // hidden options, will be allowed on command line but will not be shown to the user
     boost::program_options::options_description hidden_options("Hidden options");
@@ -164,7 +172,8 @@ int main(const int argc, const char *argv[]) try
     std::string verbosity;
     boost::filesystem::path base_path;
     int max_wait = -1;
-    if (!generateDataStoreOptions(argc, argv, verbosity, base_path, max_wait))
+    bool only_metric = false;
+    if (!generateDataStoreOptions(argc, argv, verbosity, base_path, max_wait, only_metric))
     {
         return EXIT_SUCCESS;
     }
@@ -179,7 +188,7 @@ int main(const int argc, const char *argv[]) try
     }
     storage::Storage storage(std::move(config));
 
-    return storage.Run(max_wait);
+    return storage.Run(max_wait, only_metric);
 }
 catch (const osrm::RuntimeError &e)
 {
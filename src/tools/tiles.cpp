@@ -0,0 +1,333 @@
+#include "engine/tile_archive.hpp"
+#include "storage/dataset_fingerprint.hpp"
+#include "storage/io.hpp"
+#include "util/coordinate.hpp"
+#include "util/log.hpp"
+#include "util/std_hash.hpp"
+#include "util/meminfo.hpp"
+#include "util/timing_util.hpp"
+#include "util/version.hpp"
+#include "util/web_mercator.hpp"
+
+#include "osrm/engine_config.hpp"
+#include "osrm/exception.hpp"
+#include "osrm/osrm.hpp"
+#include "osrm/tile_parameters.hpp"
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_scheduler_init.h>
+
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+using namespace osrm;
+
+namespace
+{
+enum class return_code : unsigned
+{
+    ok,
+    fail,
+    exit
+};
+
+// tiles rendered in parallel before they are written to the archive
+const constexpr std::size_t BATCH_SIZE = 4096;
+
+using Tile = std::pair<unsigned, unsigned>;
+
+return_code parseArguments(int argc,
+                           char *argv[],
+                           std::string &verbosity,
+                           boost::filesystem::path &base_path,
+                           boost::filesystem::path &output_path,
+                           EngineConfig &config,
+                           unsigned &min_zoom,
+                           unsigned &max_zoom,
+                           unsigned &requested_num_threads)
+{
+    // declare a group of options that will be allowed only on command line
+    boost::program_options::options_description generic_options("Options");
+    generic_options.add_options()("version,v", "Show version")("help,h", "Show this help message")(
+        "verbosity,l",
+        boost::program_options::value<std::string>(&verbosity)->default_value("INFO"),
+        std::string("Log verbosity level: " + util::LogPolicy::GetLevels()).c_str());
+
+    // declare a group of options that will be allowed both on command line
+    boost::program_options::options_description config_options("Configuration");
+    config_options.add_options()
+        //
+        ("threads,t",
+         boost::program_options::value<unsigned int>(&requested_num_threads)
+             ->default_value(tbb::task_scheduler_init::default_num_threads()),
+         "Number of threads to use")(
+            "algorithm,a",
+            boost::program_options::value<EngineConfig::Algorithm>(&config.algorithm)
+                ->default_value(EngineConfig::Algorithm::CH, "CH"),
+            "Algorithm the dataset was prepared for, turns are rendered with it. Can be CH, "
+            "CoreCH, MLD, CCH.")(
+            "min-zoom",
+            boost::program_options::value<unsigned>(&min_zoom)->default_value(12),
+            "Lowest zoom level to render, at least 12")(
+            "max-zoom",
+            boost::program_options::value<unsigned>(&max_zoom)->default_value(14),
+            "Highest zoom level to render, at most 19")(
+            "output,o",
+            boost::program_options::value<boost::filesystem::path>(&output_path),
+            "Tile archive to write, <input.osrm>.tiles by default");
+
+    // hidden options, will be allowed on command line, but will not be
+    // shown to the user
+    boost::program_options::options_description hidden_options("Hidden options");
+    hidden_options.add_options()(
+        "input,i",
+        boost::program_options::value<boost::filesystem::path>(&base_path),
+        "Input base file path");
+
+    // positional option
+    boost::program_options::positional_options_description positional_options;
+    positional_options.add("input", 1);
+
+    // combine above options for parsing
+    boost::program_options::options_description cmdline_options;
+    cmdline_options.add(generic_options).add(config_options).add(hidden_options);
+
+    const auto *executable = argv[0];
+    boost::program_options::options_description visible_options(
+        boost::filesystem::path(executable).filename().string() + " <input.osrm> [options]");
+    visible_options.add(generic_options).add(config_options);
+
+    // parse command line options
+    boost::program_options::variables_map option_variables;
+    try
+    {
+        boost::program_options::store(boost::program_options::command_line_parser(argc, argv)
+                                          .options(cmdline_options)
+                                          .positional(positional_options)
+                                          .run(),
+                                      option_variables);
+    }
+    catch (const boost::program_options::error &e)
+    {
+        util::Log(logERROR) << e.what();
+        return return_code::fail;
+    }
+
+    if (option_variables.count("version"))
+    {
+        std::cout << OSRM_VERSION << std::endl;
+        return return_code::exit;
+    }
+
+    if (option_variables.count("help"))
+    {
+        std::cout << visible_options;
+        return return_code::exit;
+    }
+
+    boost::program_options::notify(option_variables);
+
+    if (!option_variables.count("input"))
+    {
+        std::cout << visible_options;
+        return return_code::fail;
+    }
+
+    return return_code::ok;
+}
+
+unsigned toTile(const double pixel, const unsigned zoom)
+{
+    const auto max_tile = (1u << zoom) - 1;
+    const auto tile = std::floor(pixel / util::web_mercator::TILE_SIZE);
+    return static_cast<unsigned>(std::min<double>(std::max(tile, 0.), max_tile));
+}
+
+// The tiles of the zoom level that contain at least one node of the dataset.
+// Tiles that are only crossed by an edge are missing and are rendered by osrm-routed.
+std::vector<Tile> getTilesWithNodes(const boost::filesystem::path &nodes_path,
+                                    const unsigned zoom)
+{
+    storage::io::FileReader reader(nodes_path, storage::io::FileReader::VerifyFingerprint);
+    auto number_of_coordinates = reader.ReadElementCount64();
+
+    // a set, so memory grows with the number of tiles and not with the number of nodes
+    std::unordered_set<Tile> unique_tiles;
+    std::vector<util::Coordinate> coordinates(1 << 16);
+    while (number_of_coordinates > 0)
+    {
+        const auto count = std::min<std::uint64_t>(coordinates.size(), number_of_coordinates);
+        reader.ReadInto(coordinates.data(), count);
+        number_of_coordinates -= count;
+
+        for (std::size_t index = 0; index < count; ++index)
+        {
+            const auto lon = util::toFloating(coordinates[index].lon);
+            const auto lat = util::web_mercator::clamp(util::toFloating(coordinates[index].lat));
+            unique_tiles.emplace(toTile(util::web_mercator::degreeToPixel(lon, zoom), zoom),
+                                 toTile(util::web_mercator::degreeToPixel(lat, zoom), zoom));
+        }
+    }
+
+    std::vector<Tile> tiles(unique_tiles.begin(), unique_tiles.end());
+    std::sort(tiles.begin(), tiles.end());
+    return tiles;
+}
+
+std::vector<Tile> getParentTiles(std::vector<Tile> tiles)
+{
+    for (auto &tile : tiles)
+    {
+        tile.first /= 2;
+        tile.second /= 2;
+    }
+    std::sort(tiles.begin(), tiles.end());
+    tiles.erase(std::unique(tiles.begin(), tiles.end()), tiles.end());
+    return tiles;
+}
+
+void renderTiles(const OSRM &osrm,
+                 const unsigned zoom,
+                 const std::vector<Tile> &tiles,
+                 engine::TileArchiveWriter &writer)
+{
+    std::vector<std::string> buffers(BATCH_SIZE);
+    for (std::size_t batch_begin = 0; batch_begin < tiles.size(); batch_begin += BATCH_SIZE)
+    {
+        const auto batch_end = std::min(batch_begin + BATCH_SIZE, tiles.size());
+
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(batch_begin, batch_end),
+                          [&](const tbb::blocked_range<std::size_t> &range) {
+                              for (auto index = range.begin(); index < range.end(); ++index)
+                              {
+                                  const TileParameters parameters{
+                                      tiles[index].first, tiles[index].second, zoom};
+                                  auto &buffer = buffers[index - batch_begin];
+                                  buffer.clear();
+                                  osrm.Tile(parameters, buffer);
+                              }
+                          });
+
+        for (auto index = batch_begin; index < batch_end; ++index)
+        {
+            writer.Add(zoom, tiles[index].first, tiles[index].second, buffers[index - batch_begin]);
+        }
+    }
+}
+}
+
+int main(int argc, char *argv[]) try
+{
+    util::LogPolicy::GetInstance().Unmute();
+    std::string verbosity;
+    boost::filesystem::path base_path;
+    boost::filesystem::path output_path;
+    EngineConfig config;
+    unsigned min_zoom = 12;
+    unsigned max_zoom = 14;
+    unsigned requested_num_threads = 1;
+
+    const auto result = parseArguments(argc,
+                                       argv,
+                                       verbosity,
+                                       base_path,
+                                       output_path,
+                                       config,
+                                       min_zoom,
+                                       max_zoom,
+                                       requested_num_threads);
+
+    if (return_code::fail == result)
+    {
+        return EXIT_FAILURE;
+    }
+
+    if (return_code::exit == result)
+    {
+        return EXIT_SUCCESS;
+    }
+
+    util::LogPolicy::GetInstance().SetLevel(verbosity);
+
+    if (1 > requested_num_threads)
+    {
+        util::Log(logERROR) << "Number of threads must be 1 or larger";
+        return EXIT_FAILURE;
+    }
+
+    // same limits as the tile service
+    if (min_zoom < 12 || max_zoom > 19 || min_zoom > max_zoom)
+    {
+        util::Log(logERROR) << "Zoom levels must be between 12 and 19";
+        return EXIT_FAILURE;
+    }
+
+    config.storage_config = storage::StorageConfig(base_path);
+    config.use_shared_memory = false;
+    config.verbosity = verbosity;
+    if (!config.IsValid())
+    {
+        util::Log(logERROR) << "Required files are missing, cannot continue";
+        return EXIT_FAILURE;
+    }
+
+    if (output_path.empty())
+    {
+        output_path = base_path.string() + ".tiles";
+    }
+
+    tbb::task_scheduler_init init(requested_num_threads);
+
+    const OSRM osrm(config);
+    engine::TileArchiveWriter writer(output_path,
+                                     storage::getDatasetFingerprint(config.storage_config));
+
+    // the tiles of the lower zoom levels are the parents of the tiles of the highest one
+    auto tiles = getTilesWithNodes(config.storage_config.GetPath(".osrm.nbg_nodes"), max_zoom);
+    std::vector<std::pair<unsigned, std::vector<Tile>>> zoom_tiles;
+    for (auto zoom = max_zoom; zoom >= min_zoom; --zoom)
+    {
+        auto parent_tiles = getParentTiles(tiles);
+        zoom_tiles.emplace_back(zoom, std::move(tiles));
+        tiles = std::move(parent_tiles);
+    }
+
+    for (const auto &zoom_and_tiles : zoom_tiles)
+    {
+        TIMER_START(render);
+        renderTiles(osrm, zoom_and_tiles.first, zoom_and_tiles.second, writer);
+        TIMER_STOP(render);
+        util::Log() << "Rendered " << zoom_and_tiles.second.size() << " tiles of zoom level "
+                    << zoom_and_tiles.first << " in " << TIMER_SEC(render) << " seconds";
+    }
+
+    writer.Finish();
+    util::Log() << "Wrote " << output_path.string();
+
+    util::DumpMemoryStats();
+
+    return EXIT_SUCCESS;
+}
+catch (const osrm::RuntimeError &e)
+{
+    util::DumpMemoryStats();
+    util::Log(logERROR) << e.what();
+    return e.GetCode();
+}
+catch (const std::bad_alloc &e)
+{
+    util::DumpMemoryStats();
+    util::Log(logERROR) << "[exception] " << e.what();
+    util::Log(logERROR) << "Please provide more memory or consider using a larger swapfile";
+    return EXIT_FAILURE;
+}
@@ -31,16 +31,20 @@ namespace updater
 {
 namespace csv
 {
-SegmentLookupTable readSegmentValues(const std::vector<std::string> &paths)
+namespace
+{
+CSVFilesParser<Segment, SpeedSource> makeSegmentParser()
 {
     static const auto value_if_blank = std::numeric_limits<double>::quiet_NaN();
-    CSVFilesParser<Segment, SpeedSource> parser(
+    return CSVFilesParser<Segment, SpeedSource>(
         1,
         qi::ulong_long >> ',' >> qi::ulong_long,
         qi::uint_ >> -(',' >> (qi::double_ | qi::attr(value_if_blank))));
+}
 
-    // Check consistency of keys in the result lookup table
-    auto result = parser(paths);
+// Check consistency of keys in the result lookup table
+void checkSegmentValues(const SegmentLookupTable &result)
+{
     const auto found_inconsistency =
         std::find_if(std::begin(result.lookup), std::end(result.lookup), [](const auto &entry) {
             return entry.first.from == entry.first.to;
@@ -50,7 +54,20 @@ SegmentLookupTable readSegmentValues(const std::vector<std::string> &paths)
         util::Log(logWARNING) << "Empty segment in CSV with node " +
                                      std::to_string(found_inconsistency->first.from);
     }
+}
+}
 
+SegmentLookupTable readSegmentValues(const std::vector<std::string> &paths)
+{
+    auto result = makeSegmentParser()(paths);
+    checkSegmentValues(result);
+    return result;
+}
+
+SegmentLookupTable parseSegmentValues(const std::string &name, const std::string &data)
+{
+    auto result = makeSegmentParser()(name, data.data(), data.data() + data.size());
+    checkSegmentValues(result);
     return result;
 }
 
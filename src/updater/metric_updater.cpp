@@ -0,0 +1,435 @@
+#include "updater/metric_updater.hpp"
+#include "updater/speed_conversion.hpp"
+
+#include "customizer/cell_customizer.hpp"
+#include "customizer/cell_metric.hpp"
+#include "customizer/dirty_cells.hpp"
+#include "customizer/edge_based_graph.hpp"
+
+#include "extractor/node_data_container.hpp"
+#include "extractor/packed_osm_ids.hpp"
+#include "extractor/profile_properties.hpp"
+#include "extractor/segment_data_container.hpp"
+
+#include "partition/cell_storage.hpp"
+#include "partition/multi_level_partition.hpp"
+
+#include "util/coordinate.hpp"
+#include "util/coordinate_calculation.hpp"
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+#include "util/exclude_flag.hpp"
+#include "util/integer_range.hpp"
+#include "util/log.hpp"
+#include "util/timing_util.hpp"
+#include "util/typedefs.hpp"
+#include "util/vector_view.hpp"
+
+#include <boost/range/adaptor/reversed.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/concurrent_vector.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+
+#include <algorithm>
+#include <numeric>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace updater
+{
+namespace
+{
+using storage::DataLayout;
+
+template <typename T>
+util::vector_view<T> makeView(const DataLayout &layout, char *memory, const DataLayout::BlockID id)
+{
+    return util::vector_view<T>(layout.GetBlockPtr<T>(memory, id), layout.GetBlockEntries(id));
+}
+
+// The same blocks as ContiguousInternalMemoryDataFacadeBase::InitializeGeometryPointers,
+// but weights, durations and datasources come from the metric memory
+extractor::SegmentDataView makeSegmentData(const DataLayout &layout,
+                                           char *memory,
+                                           const DataLayout &metric_layout,
+                                           char *metric_memory)
+{
+    using WeightVector = extractor::SegmentDataView::SegmentWeightVector;
+    using DurationVector = extractor::SegmentDataView::SegmentDurationVector;
+
+    const auto num_entries = layout.GetBlockEntries(DataLayout::GEOMETRIES_NODE_LIST);
+    const auto make_weights = [&](const DataLayout::BlockID id) {
+        return WeightVector(
+            makeView<WeightVector::block_type>(metric_layout, metric_memory, id), num_entries);
+    };
+    const auto make_durations = [&](const DataLayout::BlockID id) {
+        return DurationVector(
+            makeView<DurationVector::block_type>(metric_layout, metric_memory, id), num_entries);
+    };
+
+    return extractor::SegmentDataView{
+        makeView<unsigned>(layout, memory, DataLayout::GEOMETRIES_INDEX),
+        makeView<NodeID>(layout, memory, DataLayout::GEOMETRIES_NODE_LIST),
+        make_weights(DataLayout::GEOMETRIES_FWD_WEIGHT_LIST),
+        make_weights(DataLayout::GEOMETRIES_REV_WEIGHT_LIST),
+        make_durations(DataLayout::GEOMETRIES_FWD_DURATION_LIST),
+        make_durations(DataLayout::GEOMETRIES_REV_DURATION_LIST),
+        makeView<DatasourceID>(
+            metric_layout, metric_memory, DataLayout::GEOMETRIES_FWD_DATASOURCES_LIST),
+        makeView<DatasourceID>(
+            metric_layout, metric_memory, DataLayout::GEOMETRIES_REV_DATASOURCES_LIST)};
+}
+
+using WeightAndDuration = std::pair<EdgeWeight, EdgeWeight>;
+
+bool geometryLess(const GeometryID lhs, const GeometryID rhs)
+{
+    return std::tie(lhs.id, lhs.forward) < std::tie(rhs.id, rhs.forward);
+}
+
+template <typename WeightRange, typename DurationRange>
+WeightAndDuration sumGeometry(const WeightRange &weights, const DurationRange &durations)
+{
+    EdgeWeight weight = 0;
+    for (const auto segment_weight : weights)
+    {
+        if (segment_weight == INVALID_SEGMENT_WEIGHT)
+        {
+            weight = INVALID_EDGE_WEIGHT;
+            break;
+        }
+        weight += segment_weight;
+    }
+    return std::make_pair(weight,
+                          std::accumulate(durations.begin(), durations.end(), EdgeWeight{0}));
+}
+
+// Writes the speeds of all segments found in the lookup table, returns the sorted ids of the
+// geometries that have at least one segment with a changed value
+std::vector<GeometryID> applySegmentSpeeds(extractor::SegmentDataView &segment_data,
+                                           const util::vector_view<util::Coordinate> &coordinates,
+                                           const extractor::PackedOSMIDsView &osm_node_ids,
+                                           const extractor::ProfileProperties &profile_properties,
+                                           const SegmentLookupTable &segment_speed_lookup,
+                                           const DatasourceID live_datasource)
+{
+    using DirectionalGeometryID = extractor::SegmentDataView::DirectionalGeometryID;
+
+    const auto weight_multiplier = profile_properties.GetWeightMultiplier();
+    tbb::concurrent_vector<GeometryID> updated_geometries;
+
+    // weights, durations and datasources are oriented in forward direction
+    const auto apply_speeds = [&](const auto &nodes,
+                                  const bool forward,
+                                  auto weights,
+                                  auto durations,
+                                  auto datasources) {
+        bool was_updated = false;
+        for (const auto offset : util::irange<std::size_t>(0, weights.size()))
+        {
+            auto u = osm_node_ids[nodes[offset]];
+            auto v = osm_node_ids[nodes[offset + 1]];
+
+            // Self-loops are artifical segments (e.g. traffic light nodes)
+            if (u == v)
+                continue;
+
+            if (!forward)
+                std::swap(u, v);
+
+            if (auto value = segment_speed_lookup({u, v}))
+            {
+                const auto segment_length = util::coordinate_calculation::greatCircleDistance(
+                    coordinates[nodes[offset]], coordinates[nodes[offset + 1]]);
+                const SegmentDuration new_duration =
+                    convertToDuration(value->speed, segment_length);
+                const SegmentWeight new_weight =
+                    convertToWeight(weights[offset], *value, segment_length, weight_multiplier);
+
+                // Only count segments that really change, a feed often repeats most values
+                if (new_weight != weights[offset] || new_duration != durations[offset] ||
+                    live_datasource != datasources[offset])
+                {
+                    weights[offset] = new_weight;
+                    durations[offset] = new_duration;
+                    datasources[offset] = live_datasource;
+                    was_updated = true;
+                }
+            }
+        }
+        return was_updated;
+    };
+
+    auto range = tbb::blocked_range<DirectionalGeometryID>(0, segment_data.GetNumberOfGeometries());
+    tbb::parallel_for(range, [&](const auto &range) {
+        for (auto geometry_id = range.begin(); geometry_id < range.end(); geometry_id++)
+        {
+            const auto nodes = segment_data.GetForwardGeometry(geometry_id);
+
+            if (apply_speeds(nodes,
+                             true,
+                             segment_data.GetForwardWeights(geometry_id),
+                             segment_data.GetForwardDurations(geometry_id),
+                             segment_data.GetForwardDatasources(geometry_id)))
+                updated_geometries.push_back(GeometryID{geometry_id, true});
+
+            // In this case we want it oriented from in forward directions
+            if (apply_speeds(
+                    nodes,
+                    false,
+                    boost::adaptors::reverse(segment_data.GetReverseWeights(geometry_id)),
+                    boost::adaptors::reverse(segment_data.GetReverseDurations(geometry_id)),
+                    boost::adaptors::reverse(segment_data.GetReverseDatasources(geometry_id))))
+                updated_geometries.push_back(GeometryID{geometry_id, false});
+        }
+    });
+
+    std::vector<GeometryID> result(updated_geometries.begin(), updated_geometries.end());
+    tbb::parallel_sort(result.begin(), result.end(), geometryLess);
+    return result;
+}
+}
+
+DatasourceID getLiveDatasource(extractor::Datasources &datasources)
+{
+    // 0 is the profile, the segment speed files of osrm-customize follow
+    for (const auto id : util::irange<std::uint32_t>(1, extractor::Datasources::MAX_NUM_SOURES))
+    {
+        const auto name = datasources.GetSourceName(id);
+        if (name.empty())
+        {
+            datasources.SetSourceName(id, LIVE_DATASOURCE_NAME);
+            return id;
+        }
+        if (name == LIVE_DATASOURCE_NAME)
+        {
+            return id;
+        }
+    }
+    throw util::exception("All datasources of the dataset are in use, live updates need one more" +
+                          SOURCE_REF);
+}
+
+MetricUpdate updateMetric(const DataLayout &layout,
+                          char *memory,
+                          const DataLayout &metric_layout,
+                          char *metric_memory,
+                          const SegmentLookupTable &segment_speed_lookup)
+{
+    if (layout.GetBlockSize(DataLayout::MLD_GRAPH_EDGE_LIST) == 0)
+    {
+        throw util::exception("Live metric updates need a dataset prepared for MLD" + SOURCE_REF);
+    }
+
+    TIMER_START(update);
+    MetricUpdate result;
+
+    const auto &profile_properties =
+        *layout.GetBlockPtr<extractor::ProfileProperties>(memory, DataLayout::PROPERTIES);
+    const auto coordinates =
+        makeView<util::Coordinate>(layout, memory, DataLayout::COORDINATE_LIST);
+    const extractor::PackedOSMIDsView osm_node_ids(
+        makeView<extractor::PackedOSMIDsView::block_type>(
+            layout, memory, DataLayout::OSM_NODE_ID_LIST),
+        coordinates.size());
+    auto segment_data = makeSegmentData(layout, memory, metric_layout, metric_memory);
+    // the names are part of the metric copy, the dataset in memory isn't changed
+    auto &datasources = *metric_layout.GetBlockPtr<extractor::Datasources>(
+        metric_memory, DataLayout::DATASOURCES_NAMES);
+    const auto live_datasource = getLiveDatasource(datasources);
+
+    const auto updated_geometries = applySegmentSpeeds(segment_data,
+                                                       coordinates,
+                                                       osm_node_ids,
+                                                       profile_properties,
+                                                       segment_speed_lookup,
+                                                       live_datasource);
+    result.segments = updated_geometries.size();
+
+    if (updated_geometries.empty())
+    {
+        util::Log() << "No segment changed, the metric is unchanged";
+        return result;
+    }
+
+    // weight and duration of each updated geometry, without any turn
+    std::vector<WeightAndDuration> geometry_values(updated_geometries.size());
+    tbb::parallel_for(
+        tbb::blocked_range<std::size_t>(0, updated_geometries.size()), [&](const auto &range) {
+            for (auto index = range.begin(); index < range.end(); ++index)
+            {
+                const auto id = updated_geometries[index].id;
+                geometry_values[index] =
+                    updated_geometries[index].forward
+                        ? sumGeometry(segment_data.GetForwardWeights(id),
+                                      segment_data.GetForwardDurations(id))
+                        : sumGeometry(segment_data.GetReverseWeights(id),
+                                      segment_data.GetReverseDurations(id));
+            }
+        });
+
+    const extractor::EdgeBasedNodeDataView node_data(
+        makeView<extractor::EdgeBasedNode>(layout, memory, DataLayout::EDGE_BASED_NODE_DATA_LIST),
+        makeView<extractor::NodeBasedEdgeAnnotation>(
+            layout, memory, DataLayout::ANNOTATION_DATA_LIST));
+    const auto turn_weight_penalties =
+        makeView<TurnPenalty>(metric_layout, metric_memory, DataLayout::TURN_WEIGHT_PENALTIES);
+    const auto turn_duration_penalties =
+        makeView<TurnPenalty>(metric_layout, metric_memory, DataLayout::TURN_DURATION_PENALTIES);
+
+    using Graph = customizer::MultiLevelEdgeBasedGraphView;
+    Graph graph(makeView<Graph::NodeArrayEntry>(layout, memory, DataLayout::MLD_GRAPH_NODE_LIST),
+                makeView<Graph::EdgeArrayEntry>(
+                    metric_layout, metric_memory, DataLayout::MLD_GRAPH_EDGE_LIST),
+                makeView<Graph::EdgeOffset>(layout, memory, DataLayout::MLD_GRAPH_NODE_TO_OFFSET));
+
+    // Same computation as in Updater::LoadAndUpdateEdgeExpandedGraph for an edge whose turn
+    // starts at the edge-based node origin. Returns nothing if the origin didn't change.
+    const auto compute_edge =
+        [&](const NodeID origin,
+            const customizer::EdgeBasedGraphEdgeData &data) -> boost::optional<WeightAndDuration> {
+        const auto geometry_id = node_data.GetGeometryID(origin);
+        const auto updated = std::lower_bound(
+            updated_geometries.begin(), updated_geometries.end(), geometry_id, geometryLess);
+        if (updated == updated_geometries.end() || updated->id != geometry_id.id ||
+            updated->forward != geometry_id.forward)
+        {
+            return boost::none;
+        }
+
+        EdgeWeight new_weight;
+        EdgeWeight new_duration;
+        std::tie(new_weight, new_duration) =
+            geometry_values[std::distance(updated_geometries.begin(), updated)];
+
+        if (new_weight == INVALID_EDGE_WEIGHT)
+        {
+            return std::make_pair(INVALID_EDGE_WEIGHT, EdgeWeight{data.duration});
+        }
+
+        auto turn_weight_penalty = turn_weight_penalties[data.turn_id];
+        const auto num_nodes = segment_data.GetForwardGeometry(geometry_id.id).size();
+        const auto weight_min_value = static_cast<EdgeWeight>(num_nodes);
+        if (turn_weight_penalty + new_weight < weight_min_value)
+        {
+            if (turn_weight_penalty < 0)
+            {
+                turn_weight_penalty = weight_min_value - new_weight;
+            }
+            else
+            {
+                new_weight = weight_min_value;
+            }
+        }
+
+        return std::make_pair(new_weight + turn_weight_penalty,
+                              new_duration + turn_duration_penalties[data.turn_id]);
+    };
+
+    tbb::concurrent_vector<std::pair<NodeID, NodeID>> changed_edges;
+    tbb::enumerable_thread_specific<std::size_t> diverged_edges(0);
+    const auto nodes_range = tbb::blocked_range<NodeID>(0, graph.GetNumberOfNodes());
+    tbb::parallel_for(nodes_range, [&](const auto &range) {
+        for (auto node = range.begin(); node < range.end(); ++node)
+        {
+            for (const auto edge : graph.GetAdjacentEdgeRange(node))
+            {
+                auto &data = graph.GetEdgeData(edge);
+                const auto target = graph.GetTarget(edge);
+
+                // the turn of a backward edge starts at its target
+                const auto forward = data.forward ? compute_edge(node, data) : boost::none;
+                const auto backward = data.backward ? compute_edge(target, data) : boost::none;
+                if (!forward && !backward)
+                    continue;
+
+                WeightAndDuration value;
+                if (data.forward && data.backward)
+                {
+                    // The graph merged a forward and a backward edge with the same weight. They
+                    // can't be split without changing the topology, so the merged edge gets the
+                    // larger value of both directions.
+                    const auto current =
+                        std::make_pair(EdgeWeight{data.weight}, EdgeWeight{data.duration});
+                    const auto forward_value = forward ? *forward : current;
+                    const auto backward_value = backward ? *backward : current;
+                    diverged_edges.local() += forward_value != backward_value;
+                    value = std::max(forward_value, backward_value);
+                }
+                else
+                {
+                    value = forward ? *forward : *backward;
+                }
+
+                if (value.first != data.weight || value.second != data.duration)
+                {
+                    data.weight = value.first;
+                    data.duration = value.second;
+                    changed_edges.push_back(std::make_pair(node, target));
+                }
+            }
+        }
+    });
+    result.edges = changed_edges.size();
+
+    const auto num_diverged_edges =
+        diverged_edges.combine([](const auto lhs, const auto rhs) { return lhs + rhs; });
+    if (num_diverged_edges > 0)
+    {
+        util::Log(logWARNING) << num_diverged_edges
+                              << " merged edges got the larger value of their two directions";
+    }
+
+    const partition::MultiLevelPartitionView partition{
+        layout.GetBlockPtr<partition::MultiLevelPartitionView::LevelData>(
+            memory, DataLayout::MLD_LEVEL_DATA),
+        makeView<PartitionID>(layout, memory, DataLayout::MLD_PARTITION),
+        makeView<CellID>(layout, memory, DataLayout::MLD_CELL_TO_CHILDREN)};
+    const partition::CellStorageView cell_storage{
+        makeView<NodeID>(layout, memory, DataLayout::MLD_CELL_SOURCE_BOUNDARY),
+        makeView<NodeID>(layout, memory, DataLayout::MLD_CELL_DESTINATION_BOUNDARY),
+        makeView<partition::CellStorageView::CellData>(layout, memory, DataLayout::MLD_CELLS),
+        makeView<std::uint64_t>(layout, memory, DataLayout::MLD_CELL_LEVEL_OFFSETS)};
+
+    customizer::DirtyCellsView dirty_cells(partition);
+    for (const auto &edge : changed_edges)
+    {
+        dirty_cells.MarkEdge(edge.first, edge.second);
+    }
+    dirty_cells.Propagate();
+
+    for (auto level : util::irange<LevelID>(1, partition.GetNumberOfLevels()))
+    {
+        result.cells += dirty_cells.GetNumberOfDirtyCells(level);
+    }
+
+    const customizer::CellCustomizerView customizer(partition);
+    const auto filters =
+        util::excludeFlagsToNodeFilter(graph.GetNumberOfNodes(), node_data, profile_properties);
+    for (const auto index : util::irange<std::size_t>(0, filters.size()))
+    {
+        const auto weights_id =
+            static_cast<DataLayout::BlockID>(DataLayout::MLD_CELL_WEIGHTS_0 + index);
+        const auto durations_id =
+            static_cast<DataLayout::BlockID>(DataLayout::MLD_CELL_DURATIONS_0 + index);
+        customizer::CellMetricView metric{
+            makeView<EdgeWeight>(metric_layout, metric_memory, weights_id),
+            makeView<EdgeDuration>(metric_layout, metric_memory, durations_id)};
+
+        customizer.Customize(graph, cell_storage, filters[index], metric, dirty_cells);
+    }
+
+    TIMER_STOP(update);
+    util::Log() << "Updated " << result.segments << " geometries, " << result.edges
+                << " edges and " << result.cells << " cells in " << TIMER_MSEC(update) << "ms";
+
+    return result;
+}
+}
+}
@@ -1,5 +1,6 @@
 #include "updater/updater.hpp"
 #include "updater/csv_source.hpp"
+#include "updater/speed_conversion.hpp"
 
 #include "extractor/compressed_edge_container.hpp"
 #include "extractor/edge_based_graph_factory.hpp"
@@ -82,25 +83,6 @@ template <typename T> inline bool is_aligned(const void *pointer)
     return reinterpret_cast<uintptr_t>(pointer) % alignof(T) == 0;
 }
 
-// Returns duration in deci-seconds
-inline SegmentDuration convertToDuration(double speed_in_kmh, double distance_in_meters)
-{
-    if (speed_in_kmh <= 0.)
-        return INVALID_SEGMENT_DURATION;
-
-    const auto speed_in_ms = speed_in_kmh / 3.6;
-    const auto duration = distance_in_meters / speed_in_ms;
-    auto segment_duration = std::max<SegmentDuration>(
-        1, boost::numeric_cast<SegmentDuration>(std::round(duration * 10.)));
-    if (segment_duration >= INVALID_SEGMENT_DURATION)
-    {
-        util::Log(logWARNING) << "Clamping segment duration " << segment_duration << " to "
-                              << MAX_SEGMENT_DURATION;
-        segment_duration = MAX_SEGMENT_DURATION;
-    }
-    return segment_duration;
-}
-
 #if !defined(NDEBUG)
 void checkWeightsConsistency(
     const UpdaterConfig &config,
@@ -164,42 +146,15 @@ updateSegmentData(const UpdaterConfig &config,
     std::atomic<std::uint32_t> fallbacks_to_duration{0};
     auto convertToWeight = [&profile_properties, &fallbacks_to_duration](
         const SegmentWeight &existing_weight, const SpeedSource &value, double distance_in_meters) {
-
-        double rate = std::numeric_limits<double>::quiet_NaN();
-
-        // if value.rate is not set, we fall back to duration
-        //    this happens when there is no 4th column in the input CSV
-        // if value.rate is set but NaN, we keep the existing weight
-        //    this happens when there is an empty 4th column in the input CSV
-        // otherwise, we use the value as the new rate
         if (!value.rate)
         {
             ++fallbacks_to_duration;
-            rate = value.speed / 3.6;
-        }
-        else
-        {
-            rate = *value.rate;
-            if (!std::isfinite(rate))
-            {
-                return existing_weight;
-            }
         }
 
-        if (rate <= 0.)
-            return INVALID_SEGMENT_WEIGHT;
-
-        const auto weight_multiplier = profile_properties.GetWeightMultiplier();
-        const auto weight = distance_in_meters / rate;
-        auto segment_weight = std::max<SegmentWeight>(
-            1, boost::numeric_cast<SegmentWeight>(std::round(weight * weight_multiplier)));
-        if (segment_weight >= INVALID_SEGMENT_WEIGHT)
-        {
-            util::Log(logWARNING) << "Clamping segment weight " << segment_weight << " to "
-                                  << MAX_SEGMENT_WEIGHT;
-            segment_weight = MAX_SEGMENT_WEIGHT;
-        }
-        return segment_weight;
+        return updater::convertToWeight(existing_weight,
+                                        value,
+                                        distance_in_meters,
+                                        profile_properties.GetWeightMultiplier());
     };
 
     // The check here is enabled by the `--edge-weight-updates-over-factor` flag it logs a
@@ -58,13 +58,13 @@ test('constructor: throws if given a non-string/obj argument', function(assert)
 test('constructor: throws if given an unkown algorithm', function(assert) {
     assert.plan(1);
     assert.throws(function() { new OSRM({algorithm: 'Foo', shared_memory: true}); },
-        /algorithm option must be one of 'CH', 'CoreCH', or 'MLD'/);
+        /algorithm option must be one of 'CH', 'CoreCH', 'MLD', or 'CCH'/);
 });
 
 test('constructor: throws if given an invalid algorithm', function(assert) {
     assert.plan(1);
     assert.throws(function() { new OSRM({algorithm: 3, shared_memory: true}); },
-        /algorithm option must be a string and one of 'CH', 'CoreCH', or 'MLD'/);
+        /algorithm option must be a string and one of 'CH', 'CoreCH', 'MLD', or 'CCH'/);
 });
 
 test('constructor: loads MLD if given as algorithm', function(assert) {
@@ -108,6 +108,7 @@ test('constructor: parses custom limits', function(assert) {
         max_locations_distance_table: 1,
         max_locations_map_matching: 1,
         max_results_nearest: 1,
+        max_batch_size_nearest: 1,
         max_alternatives: 1,
     });
     assert.ok(osrm);
@@ -66,3 +66,25 @@ test('nearest: nearest in Monaco without motorways', function(assert) {
         assert.equal(response.waypoints.length, 1);
     });
 });
+
+test('nearest: batch of coordinates', function(assert) {
+    assert.plan(5);
+    var osrm = new OSRM(data_path);
+    osrm.nearest({
+        coordinates: three_test_coordinates,
+        batch: true
+    }, function(err, result) {
+        assert.ifError(err);
+        assert.equal(result.locations.length, 3);
+        assert.equal(result.distances.length, 3);
+        assert.equal(result.nodes.length, 6);
+        assert.notOk(result.hasOwnProperty('waypoints'));
+    });
+});
+
+test('nearest: throws on invalid batch', function(assert) {
+    assert.plan(1);
+    var osrm = new OSRM(data_path);
+    assert.throws(function() { osrm.nearest({coordinates: [three_test_coordinates[0]], batch: 'yes'}, function(err, res) {}); },
+        /batch must be of type Boolean/);
+});
@@ -181,3 +181,30 @@ test('table: table in Monaco without motorways', function(assert) {
     });
 });
 
+
+test('table: table in Monaco as CBOR', function(assert) {
+    assert.plan(5);
+    var osrm = new OSRM(data_path);
+    var options = {
+        coordinates: two_test_coordinates,
+        format: 'cbor'
+    };
+    osrm.table(options, function(err, response) {
+        assert.ifError(err);
+        assert.ok(Buffer.isBuffer(response));
+        assert.equal(response[0], 0xbf);
+        assert.equal(response[response.length - 1], 0xff);
+        assert.notEqual(response.indexOf('durations'), -1);
+    });
+});
+
+test('table: invalid format', function(assert) {
+    assert.plan(1);
+    var osrm = new OSRM(data_path);
+    var options = {
+        coordinates: two_test_coordinates,
+        format: 'xml'
+    };
+    assert.throws(function() { osrm.table(options, function(err, response) {}); },
+        /'format' param must be one of/);
+});
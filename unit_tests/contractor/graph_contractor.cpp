@@ -153,4 +153,51 @@ BOOST_AUTO_TEST_CASE(contract_graph)
     BOOST_CHECK(contracted_graph.FindEdge(5, 1) != SPECIAL_EDGEID);
 }
 
+BOOST_AUTO_TEST_CASE(contract_graph_in_cached_order)
+{
+    tbb::task_scheduler_init scheduler(1);
+    // Same graph as above
+    std::vector<TestEdge> edges = {TestEdge{0, 1, 3},
+                                   TestEdge{0, 5, 1},
+                                   TestEdge{1, 3, 3},
+                                   TestEdge{1, 4, 1},
+                                   TestEdge{3, 1, 1},
+                                   TestEdge{4, 3, 1},
+                                   TestEdge{5, 1, 1}};
+    auto contracted_graph = makeGraph(edges);
+    std::vector<float> node_levels;
+    contractGraph(contracted_graph, {}, {}, {1, 1, 1, 1, 1, 1}, node_levels);
+    BOOST_REQUIRE_EQUAL(node_levels.size(), 6);
+
+    // Contracting in the same order gives the same hierarchy
+    auto cached_levels = node_levels;
+    auto recontracted_graph = makeGraph(edges);
+    std::vector<bool> core =
+        contractGraph(recontracted_graph, {}, {}, {1, 1, 1, 1, 1, 1}, cached_levels);
+    CHECK_EQUAL_RANGE(core, false, false, false, false, false, false);
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+        node_levels.begin(), node_levels.end(), cached_levels.begin(), cached_levels.end());
+    for (const auto node : util::irange<NodeID>(0, contracted_graph.GetNumberOfNodes()))
+    {
+        BOOST_CHECK_EQUAL(recontracted_graph.GetOutDegree(node),
+                          contracted_graph.GetOutDegree(node));
+        for (const auto edge : contracted_graph.GetAdjacentEdgeRange(node))
+        {
+            BOOST_CHECK(recontracted_graph.FindEdge(node, contracted_graph.GetTarget(edge)) !=
+                        SPECIAL_EDGEID);
+        }
+    }
+
+    // The shortcut 4 -> 1 over 3 gets the new weight
+    edges[4] = TestEdge{3, 1, 5};
+    auto updated_graph = makeGraph(edges);
+    contractGraph(updated_graph, {}, {}, {1, 1, 1, 1, 1, 1}, cached_levels);
+    const auto shortcuts = updated_graph.GetAdjacentEdgeRange(4);
+    const auto shortcut = std::find_if(shortcuts.begin(), shortcuts.end(), [&](const auto edge) {
+        return updated_graph.GetTarget(edge) == 1 && updated_graph.GetEdgeData(edge).shortcut;
+    });
+    BOOST_REQUIRE(shortcut != shortcuts.end());
+    BOOST_CHECK_EQUAL(updated_graph.GetEdgeData(*shortcut).weight, 6);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,288 @@
+#include "customizer/cch_customizer.hpp"
+#include "customizer/cch_topology.hpp"
+#include "customizer/files.hpp"
+#include "partition/multi_level_graph.hpp"
+#include "partition/multi_level_partition.hpp"
+#include "util/static_graph.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+using namespace osrm;
+using namespace osrm::customizer;
+using namespace osrm::partition;
+using namespace osrm::util;
+
+namespace
+{
+struct MockEdge
+{
+    NodeID start;
+    NodeID target;
+    EdgeWeight weight;
+};
+
+auto makeGraph(const MultiLevelPartition &mlp, const std::vector<MockEdge> &mock_edges)
+{
+    struct EdgeData
+    {
+        NodeID turn_id;
+        EdgeWeight weight;
+        EdgeDuration duration;
+        bool forward;
+        bool backward;
+    };
+    using Edge = static_graph_details::SortableEdgeWithData<EdgeData>;
+    std::vector<Edge> edges;
+    std::size_t max_id = 0;
+    for (const auto index : irange<NodeID>(0, mock_edges.size()))
+    {
+        const auto &m = mock_edges[index];
+        max_id = std::max<std::size_t>(max_id, std::max(m.start, m.target));
+        edges.push_back(Edge{m.start, m.target, index, m.weight, 2 * m.weight, true, false});
+        edges.push_back(Edge{m.target, m.start, index, m.weight, 2 * m.weight, false, true});
+    }
+    std::sort(edges.begin(), edges.end());
+    return partition::MultiLevelGraph<EdgeData, osrm::storage::Ownership::Container>(
+        mlp, max_id + 1, edges);
+}
+
+const constexpr EdgeWeight INF = std::numeric_limits<EdgeWeight>::max() / 4;
+
+// all pairs shortest paths on the mock edges
+std::vector<std::vector<EdgeWeight>> floydWarshall(const std::size_t num_nodes,
+                                                   const std::vector<MockEdge> &edges)
+{
+    std::vector<std::vector<EdgeWeight>> weights(num_nodes,
+                                                 std::vector<EdgeWeight>(num_nodes, INF));
+    for (const auto node : irange<std::size_t>(0, num_nodes))
+        weights[node][node] = 0;
+    for (const auto &edge : edges)
+        weights[edge.start][edge.target] =
+            std::min(weights[edge.start][edge.target], edge.weight);
+    for (const auto via : irange<std::size_t>(0, num_nodes))
+        for (const auto from : irange<std::size_t>(0, num_nodes))
+            for (const auto to : irange<std::size_t>(0, num_nodes))
+                weights[from][to] =
+                    std::min(weights[from][to], weights[from][via] + weights[via][to]);
+    return weights;
+}
+
+// shortest up-down path over the customized arcs
+EdgeWeight queryMetric(const CCHTopology &topology,
+                       const CCHMetric &metric,
+                       const NodeID source,
+                       const NodeID target)
+{
+    const auto num_nodes = topology.GetNumberOfNodes();
+    std::vector<EdgeWeight> forward(num_nodes, INF);
+    std::vector<EdgeWeight> reverse(num_nodes, INF);
+    forward[topology.GetRank(source)] = 0;
+    reverse[topology.GetRank(target)] = 0;
+
+    EdgeWeight weight = INF;
+    for (const auto rank : irange<NodeID>(0, num_nodes))
+    {
+        weight = std::min(weight, forward[rank] + reverse[rank]);
+        for (const auto arc : topology.GetUpwardArcs(rank))
+        {
+            const auto head = topology.GetHead(arc);
+            if (metric.upward[arc].weight != INVALID_EDGE_WEIGHT)
+                forward[head] = std::min(forward[head], forward[rank] + metric.upward[arc].weight);
+            if (metric.downward[arc].weight != INVALID_EDGE_WEIGHT)
+                reverse[head] =
+                    std::min(reverse[head], reverse[rank] + metric.downward[arc].weight);
+        }
+    }
+    return weight;
+}
+}
+
+BOOST_AUTO_TEST_SUITE(cch_customization_tests)
+
+BOOST_AUTO_TEST_CASE(separators_are_ranked_last)
+{
+    // 0 --- 1 --- 2
+    // |     |     |
+    // 3 --- 4 --- 5
+    // node:                0  1  2  3  4  5
+    std::vector<CellID> l1{{0, 0, 1, 0, 0, 1}};
+    MultiLevelPartition mlp{{l1}, {2}};
+
+    std::vector<MockEdge> edges = {
+        {0, 1, 1}, {1, 2, 1}, {0, 3, 1}, {1, 4, 1}, {2, 5, 1}, {3, 4, 1}, {4, 5, 1}};
+    auto graph = makeGraph(mlp, edges);
+
+    CCHTopology topology(mlp, graph);
+    BOOST_REQUIRE_EQUAL(topology.GetNumberOfNodes(), 6);
+
+    // 1, 2, 4 and 5 are border nodes of the level 1 cells
+    for (const auto inner : {0, 3})
+        for (const auto border : {1, 2, 4, 5})
+            BOOST_CHECK_LT(topology.GetRank(inner), topology.GetRank(border));
+
+    const auto elimination_tree = topology.GetEliminationTree();
+    for (const auto rank : irange<NodeID>(0, topology.GetNumberOfNodes()))
+    {
+        const auto node = topology.GetNode(rank);
+        BOOST_CHECK_EQUAL(elimination_tree[node].rank, rank);
+
+        const auto arcs = topology.GetUpwardArcs(rank);
+        if (arcs.size() == 0)
+        {
+            BOOST_CHECK_EQUAL(topology.GetParent(rank), SPECIAL_NODEID);
+            BOOST_CHECK_EQUAL(elimination_tree[node].parent, SPECIAL_NODEID);
+            continue;
+        }
+
+        // the upward neighbours are a clique with the parent as lowest node
+        const auto parent = topology.GetParent(rank);
+        BOOST_CHECK_EQUAL(parent, topology.GetHead(arcs.front()));
+        BOOST_CHECK_EQUAL(elimination_tree[node].parent, topology.GetNode(parent));
+        for (const auto arc : arcs)
+        {
+            BOOST_CHECK_LT(rank, topology.GetHead(arc));
+            if (topology.GetHead(arc) != parent)
+                BOOST_CHECK_NE(topology.FindArc(parent, topology.GetHead(arc)), SPECIAL_EDGEID);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(customized_paths_are_shortest)
+{
+    // 0 --> 1 <-> 2 --- 3
+    // |     |   / |     |
+    // 4 <-- 5 --- 6 <-- 7
+    // node:                0  1  2  3  4  5  6  7
+    std::vector<CellID> l1{{0, 0, 1, 1, 0, 0, 1, 1}};
+    std::vector<CellID> l2{{0, 0, 0, 0, 0, 0, 0, 0}};
+    MultiLevelPartition mlp{{l1, l2}, {2, 1}};
+
+    std::vector<MockEdge> edges = {{0, 1, 3},
+                                   {1, 2, 1},
+                                   {2, 1, 5},
+                                   {2, 3, 2},
+                                   {3, 2, 2},
+                                   {0, 4, 1},
+                                   {4, 0, 1},
+                                   {1, 5, 7},
+                                   {5, 1, 2},
+                                   {2, 5, 1},
+                                   {5, 2, 4},
+                                   {2, 6, 8},
+                                   {6, 2, 1},
+                                   {3, 7, 1},
+                                   {7, 3, 6},
+                                   {5, 4, 2},
+                                   {5, 6, 3},
+                                   {6, 5, 3},
+                                   {7, 6, 2}};
+    auto graph = makeGraph(mlp, edges);
+
+    CCHTopology topology(mlp, graph);
+    const auto metric = CCHCustomizer{topology}.Customize(graph);
+    BOOST_REQUIRE_EQUAL(metric.upward.size(), topology.GetNumberOfArcs());
+    BOOST_REQUIRE_EQUAL(metric.downward.size(), topology.GetNumberOfArcs());
+    BOOST_CHECK(metric.loops.empty());
+
+    const auto expected = floydWarshall(graph.GetNumberOfNodes(), edges);
+    for (const auto source : irange<NodeID>(0, graph.GetNumberOfNodes()))
+    {
+        for (const auto target : irange<NodeID>(0, graph.GetNumberOfNodes()))
+        {
+            BOOST_CHECK_EQUAL(queryMetric(topology, metric, source, target),
+                              expected[source][target]);
+        }
+    }
+
+    // every arc is stored as a forward and a backward edge at its lower node
+    std::vector<bool> edge_filter;
+    const auto query_graph = makeQueryGraph(topology, metric, edge_filter);
+    BOOST_CHECK_EQUAL(query_graph.GetNumberOfNodes(), graph.GetNumberOfNodes());
+    BOOST_CHECK_EQUAL(query_graph.GetNumberOfEdges(), 2 * topology.GetNumberOfArcs());
+    BOOST_REQUIRE_EQUAL(edge_filter.size(), query_graph.GetNumberOfEdges());
+    for (const auto node : irange<NodeID>(0, query_graph.GetNumberOfNodes()))
+    {
+        for (const auto edge : query_graph.GetAdjacentEdgeRange(node))
+        {
+            const auto &data = query_graph.GetEdgeData(edge);
+            BOOST_CHECK_LT(topology.GetRank(node), topology.GetRank(query_graph.GetTarget(edge)));
+            BOOST_CHECK_NE(data.forward, data.backward);
+            BOOST_CHECK_EQUAL(edge_filter[edge], data.weight != INVALID_EDGE_WEIGHT);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(unreachable_arcs_are_filtered)
+{
+    // 0 --> 1 --> 2
+    // node:                0  1  2
+    std::vector<CellID> l1{{0, 0, 1}};
+    MultiLevelPartition mlp{{l1}, {2}};
+
+    std::vector<MockEdge> edges = {{0, 1, 1}, {1, 2, 1}};
+    auto graph = makeGraph(mlp, edges);
+
+    CCHTopology topology(mlp, graph);
+    const auto metric = CCHCustomizer{topology}.Customize(graph);
+
+    BOOST_CHECK_EQUAL(queryMetric(topology, metric, 0, 2), 2);
+    BOOST_CHECK_EQUAL(queryMetric(topology, metric, 2, 0), INF);
+
+    std::vector<bool> edge_filter;
+    const auto query_graph = makeQueryGraph(topology, metric, edge_filter);
+    BOOST_CHECK_EQUAL(std::count(edge_filter.begin(), edge_filter.end(), true),
+                      query_graph.GetNumberOfEdges() / 2);
+}
+
+BOOST_AUTO_TEST_CASE(stored_topology_is_customized_with_new_weights)
+{
+    // 0 --- 1 --- 2
+    // |     |     |
+    // 3 --- 4 --- 5
+    // node:                0  1  2  3  4  5
+    std::vector<CellID> l1{{0, 0, 1, 0, 0, 1}};
+    MultiLevelPartition mlp{{l1}, {2}};
+
+    std::vector<MockEdge> edges = {
+        {0, 1, 1}, {1, 2, 1}, {0, 3, 1}, {1, 4, 1}, {2, 5, 1}, {3, 4, 1}, {4, 5, 1}};
+    const CCHTopology topology(mlp, makeGraph(mlp, edges));
+
+    const auto path = boost::filesystem::unique_path();
+    files::writeCCHTopology(path, 42, topology);
+    unsigned checksum = 0;
+    CCHTopology stored_topology;
+    files::readCCHTopology(path, checksum, stored_topology);
+    boost::filesystem::remove(path);
+
+    BOOST_CHECK_EQUAL(checksum, 42);
+    BOOST_REQUIRE_EQUAL(stored_topology.GetNumberOfNodes(), topology.GetNumberOfNodes());
+    BOOST_REQUIRE_EQUAL(stored_topology.GetNumberOfArcs(), topology.GetNumberOfArcs());
+    BOOST_CHECK_EQUAL(stored_topology.GetNumberOfHeights(), topology.GetNumberOfHeights());
+    for (const auto arc : irange<EdgeID>(0, topology.GetNumberOfArcs()))
+    {
+        BOOST_CHECK_EQUAL(stored_topology.GetTail(arc), topology.GetTail(arc));
+        BOOST_CHECK_EQUAL(stored_topology.GetHead(arc), topology.GetHead(arc));
+    }
+
+    // new weights only need a new customization of the same topology
+    for (auto &edge : edges)
+        edge.weight = edge.start + 2 * edge.target + 1;
+    const auto graph = makeGraph(mlp, edges);
+    const auto metric = CCHCustomizer{stored_topology}.Customize(graph);
+    const auto expected = floydWarshall(graph.GetNumberOfNodes(), edges);
+    for (const auto source : irange<NodeID>(0, graph.GetNumberOfNodes()))
+    {
+        for (const auto target : irange<NodeID>(0, graph.GetNumberOfNodes()))
+        {
+            BOOST_CHECK_EQUAL(queryMetric(stored_topology, metric, source, target),
+                              expected[source][target]);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -409,4 +409,64 @@ BOOST_AUTO_TEST_CASE(exclude_test)
     CHECK_EQUAL_RANGE(cell_2_1.GetInWeight(5), 1, 0);
 }
 
+BOOST_AUTO_TEST_CASE(dirty_cells_test)
+{
+    // node:                0  1  2  3  4  5  6  7  8  9 10 11 12 13 14 15
+    std::vector<CellID> l1{{0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3}};
+    std::vector<CellID> l2{{0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1}};
+    std::vector<CellID> l3{{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}};
+    MultiLevelPartition mlp{{l1, l2, l3}, {4, 2, 1}};
+
+    std::vector<MockEdge> edges = {
+        {0, 1, 1},   {0, 2, 1},  {3, 1, 1},  {3, 2, 1},  {4, 5, 1},  {4, 6, 1},   {4, 7, 1},
+        {5, 4, 1},   {5, 6, 1},  {5, 7, 1},  {6, 4, 1},  {6, 5, 1},  {6, 7, 1},   {7, 4, 1},
+        {7, 5, 1},   {7, 6, 1},  {9, 11, 1}, {10, 8, 1}, {11, 10, 1}, {13, 12, 10}, {15, 14, 1},
+        {2, 4, 1},   {5, 12, 1}, {8, 3, 1},  {9, 3, 1},  {12, 5, 1}, {13, 7, 1},  {14, 9, 1},
+        {14, 11, 1}, {13, 14, 1}};
+
+    auto graph = makeGraph(mlp, edges);
+    std::vector<bool> node_filter(graph.GetNumberOfNodes(), true);
+
+    CellCustomizer customizer(mlp);
+    CellStorage storage(mlp, graph);
+    auto metric = storage.MakeMetric();
+    customizer.Customize(graph, storage, node_filter, metric);
+
+    // make 13 -> 12 faster and close 13 -> 14, both edges are inside of cell (3, 1, 0)
+    edges[19].weight = 1;
+    edges.back().weight = INVALID_EDGE_WEIGHT;
+    auto updated_graph = makeGraph(mlp, edges);
+
+    DirtyCells dirty_cells(mlp);
+    dirty_cells.MarkEdge(13, 12);
+    dirty_cells.MarkEdge(13, 14);
+    // edge between the cells (1, 0, 0) and (3, 1, 0) only changes the top level cell
+    dirty_cells.MarkEdge(5, 12);
+    dirty_cells.Propagate();
+
+    BOOST_CHECK_EQUAL(dirty_cells.GetNumberOfDirtyCells(1), 1);
+    BOOST_CHECK(dirty_cells.IsDirty(1, 3));
+    BOOST_CHECK_EQUAL(dirty_cells.GetNumberOfDirtyCells(2), 1);
+    BOOST_CHECK(dirty_cells.IsDirty(2, 1));
+    BOOST_CHECK_EQUAL(dirty_cells.GetNumberOfDirtyCells(3), 1);
+    BOOST_CHECK(dirty_cells.IsDirty(3, 0));
+
+    customizer.Customize(updated_graph, storage, node_filter, metric, dirty_cells);
+
+    auto updated_metric = storage.MakeMetric();
+    customizer.Customize(updated_graph, storage, node_filter, updated_metric);
+
+    BOOST_CHECK_EQUAL_COLLECTIONS(metric.weights.begin(),
+                                  metric.weights.end(),
+                                  updated_metric.weights.begin(),
+                                  updated_metric.weights.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(metric.durations.begin(),
+                                  metric.durations.end(),
+                                  updated_metric.durations.begin(),
+                                  updated_metric.durations.end());
+
+    auto cell_1_3 = storage.GetCell(metric, 1, 3);
+    CHECK_EQUAL_RANGE(cell_1_3.GetOutWeight(13), 1, INVALID_EDGE_WEIGHT);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,106 @@
+#include "engine/datafacade/block_sharing_allocator.hpp"
+
+#include "util/integer_range.hpp"
+
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(block_sharing_allocator)
+
+using namespace osrm;
+using namespace osrm::engine::datafacade;
+using storage::DataLayout;
+
+namespace
+{
+// A dataset with names and coordinates filled with the given characters
+class TestAllocator final : public ContiguousBlockAllocator
+{
+  public:
+    TestAllocator(const char name, const char coordinate, const std::size_t size = 10000)
+    {
+        for (const auto block : util::irange<std::size_t>(0, DataLayout::NUM_BLOCKS))
+        {
+            layout.SetBlockSize<char>(static_cast<DataLayout::BlockID>(block), 0);
+        }
+        layout.SetBlockSize<char>(DataLayout::NAME_CHAR_DATA, size);
+        layout.SetBlockSize<char>(DataLayout::COORDINATE_LIST, size);
+        layout.SetBlockSize<char>(DataLayout::TIMESTAMP, size);
+
+        memory = std::make_unique<char[]>(layout.GetSizeOfLayout());
+        for (const auto block : util::irange<std::size_t>(0, DataLayout::NUM_BLOCKS))
+        {
+            layout.GetBlockPtr<char, true>(memory.get(), static_cast<DataLayout::BlockID>(block));
+        }
+        Fill(DataLayout::NAME_CHAR_DATA, name);
+        Fill(DataLayout::COORDINATE_LIST, coordinate);
+        Fill(DataLayout::TIMESTAMP, coordinate);
+    }
+
+    DataLayout &GetLayout() override { return layout; }
+    char *GetMemory() override { return memory.get(); }
+
+  private:
+    void Fill(const DataLayout::BlockID block, const char value)
+    {
+        const auto begin = layout.GetBlockPtr<char>(memory.get(), block);
+        std::fill(begin, begin + layout.GetBlockSize(block), value);
+    }
+
+    DataLayout layout;
+    std::unique_ptr<char[]> memory;
+};
+
+std::string readBlock(ContiguousBlockAllocator &allocator, const DataLayout::BlockID block)
+{
+    const auto begin = allocator.GetBlockMemory(block);
+    return std::string(begin, begin + allocator.GetLayout().GetBlockSize(block));
+}
+}
+
+BOOST_AUTO_TEST_CASE(share_equal_blocks)
+{
+    BlockSharingAllocator first(std::make_shared<TestAllocator>('a', 'b'));
+    BOOST_CHECK_EQUAL(first.GetSharedSize(), 0);
+
+    BlockSharingAllocator second(std::make_shared<TestAllocator>('c', 'b'));
+    BOOST_CHECK_EQUAL(second.GetSharedSize(), 10000);
+    BOOST_CHECK(second.GetBlockMemory(DataLayout::COORDINATE_LIST) ==
+                first.GetBlockMemory(DataLayout::COORDINATE_LIST));
+    BOOST_CHECK(second.GetBlockMemory(DataLayout::NAME_CHAR_DATA) !=
+                first.GetBlockMemory(DataLayout::NAME_CHAR_DATA));
+    BOOST_CHECK_EQUAL(readBlock(second, DataLayout::NAME_CHAR_DATA), std::string(10000, 'c'));
+    BOOST_CHECK_EQUAL(readBlock(second, DataLayout::COORDINATE_LIST), std::string(10000, 'b'));
+
+    // only the shareable blocks are compared
+    BOOST_CHECK(second.GetBlockMemory(DataLayout::TIMESTAMP) !=
+                first.GetBlockMemory(DataLayout::TIMESTAMP));
+}
+
+BOOST_AUTO_TEST_CASE(keep_owner_alive)
+{
+    auto first = std::make_unique<BlockSharingAllocator>(std::make_shared<TestAllocator>('d', 'e'));
+    BlockSharingAllocator second(std::make_shared<TestAllocator>('d', 'e'));
+    BOOST_CHECK_EQUAL(second.GetSharedSize(), 20000);
+
+    // the blocks of the first dataset are used as long as another dataset shares them
+    first.reset();
+    BOOST_CHECK_EQUAL(readBlock(second, DataLayout::NAME_CHAR_DATA), std::string(10000, 'd'));
+    BlockSharingAllocator third(std::make_shared<TestAllocator>('d', 'f'));
+    BOOST_CHECK_EQUAL(third.GetSharedSize(), 10000);
+    BOOST_CHECK(third.GetBlockMemory(DataLayout::NAME_CHAR_DATA) ==
+                second.GetBlockMemory(DataLayout::NAME_CHAR_DATA));
+}
+
+BOOST_AUTO_TEST_CASE(different_sizes)
+{
+    BlockSharingAllocator first(std::make_shared<TestAllocator>('g', 'h', 10000));
+    BlockSharingAllocator second(std::make_shared<TestAllocator>('g', 'h', 10001));
+    BOOST_CHECK_EQUAL(second.GetSharedSize(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
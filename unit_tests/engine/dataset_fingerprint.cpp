@@ -0,0 +1,83 @@
+#include "storage/dataset_fingerprint.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(dataset_fingerprint)
+
+using namespace osrm;
+using namespace osrm::storage;
+
+namespace
+{
+// A directory with empty files for all required inputs of a dataset
+struct TemporaryDataset
+{
+    TemporaryDataset()
+        : directory(boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()),
+          config(directory / "test.osrm")
+    {
+        boost::filesystem::create_directory(directory);
+        for (const auto suffix : {".osrm.ramIndex",
+                                  ".osrm.fileIndex",
+                                  ".osrm.edges",
+                                  ".osrm.geometry",
+                                  ".osrm.timestamp",
+                                  ".osrm.turn_weight_penalties",
+                                  ".osrm.turn_duration_penalties",
+                                  ".osrm.datasource_names",
+                                  ".osrm.names",
+                                  ".osrm.properties",
+                                  ".osrm.icd"})
+        {
+            Write(suffix, "");
+        }
+    }
+
+    ~TemporaryDataset() { boost::filesystem::remove_all(directory); }
+
+    void Write(const std::string &suffix, const std::string &content)
+    {
+        boost::filesystem::ofstream file(config.GetPath(suffix));
+        file << content;
+    }
+
+    boost::filesystem::path directory;
+    StorageConfig config;
+};
+}
+
+BOOST_AUTO_TEST_CASE(new_weights_change_only_the_metric)
+{
+    TemporaryDataset dataset;
+    const auto loaded = getDatasetFingerprint(dataset.config);
+    BOOST_CHECK(loaded == getDatasetFingerprint(dataset.config));
+
+    dataset.Write(".osrm.geometry", "new weights");
+    const auto customized = getDatasetFingerprint(dataset.config);
+    BOOST_CHECK_EQUAL(customized.topology, loaded.topology);
+    BOOST_CHECK_NE(customized.metric, loaded.metric);
+
+    dataset.Write(".osrm.cell_metrics", "new cells");
+    BOOST_CHECK_EQUAL(getDatasetFingerprint(dataset.config).topology, loaded.topology);
+    BOOST_CHECK_NE(getDatasetFingerprint(dataset.config).metric, customized.metric);
+}
+
+BOOST_AUTO_TEST_CASE(new_extract_changes_the_topology)
+{
+    TemporaryDataset dataset;
+    const auto loaded = getDatasetFingerprint(dataset.config);
+
+    dataset.Write(".osrm.edges", "new edges");
+    BOOST_CHECK_NE(getDatasetFingerprint(dataset.config).topology, loaded.topology);
+
+    const auto extracted = getDatasetFingerprint(dataset.config);
+    dataset.Write(".osrm.partition", "");
+    BOOST_CHECK_NE(getDatasetFingerprint(dataset.config).topology, extracted.topology);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
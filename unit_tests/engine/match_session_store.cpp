@@ -0,0 +1,85 @@
+#include "engine/match_session_store.hpp"
+
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(match_session_store)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+namespace
+{
+std::size_t getMetric(const MatchSessionStore &store, const std::string &name)
+{
+    const auto metrics = store.GetMetrics();
+    return metrics.values.at(name).get<util::json::Number>().value;
+}
+}
+
+BOOST_AUTO_TEST_CASE(reuse_session)
+{
+    MatchSessionStore store(2, std::chrono::seconds(60));
+    const auto now = MatchSessionStore::Clock::now();
+
+    const auto first = store.Get("a", now);
+    BOOST_CHECK(store.Get("a", now) == first);
+    BOOST_CHECK(store.Get("b", now) != first);
+    BOOST_CHECK_EQUAL(getMetric(store, "sessions"), 2);
+    BOOST_CHECK_EQUAL(getMetric(store, "created"), 2);
+}
+
+BOOST_AUTO_TEST_CASE(evict_least_recently_used)
+{
+    MatchSessionStore store(2, std::chrono::seconds(60));
+    const auto now = MatchSessionStore::Clock::now();
+
+    const auto a = store.Get("a", now);
+    const auto b = store.Get("b", now);
+    // makes b the least recently used session
+    store.Get("a", now);
+    store.Get("c", now);
+
+    BOOST_CHECK(store.Get("a", now) == a);
+    BOOST_CHECK_EQUAL(getMetric(store, "evicted"), 1);
+    BOOST_CHECK(store.Get("b", now) != b);
+    BOOST_CHECK_EQUAL(getMetric(store, "evicted"), 2);
+    BOOST_CHECK_EQUAL(getMetric(store, "sessions"), 2);
+}
+
+BOOST_AUTO_TEST_CASE(expire_unused)
+{
+    MatchSessionStore store(4, std::chrono::seconds(60));
+    const auto now = MatchSessionStore::Clock::now();
+
+    const auto a = store.Get("a", now);
+    const auto b = store.Get("b", now);
+    BOOST_CHECK(store.Get("b", now + std::chrono::seconds(40)) == b);
+
+    // a was last used 70s ago, b 30s ago
+    BOOST_CHECK(store.Get("c", now + std::chrono::seconds(70)) != a);
+    BOOST_CHECK_EQUAL(getMetric(store, "expired"), 1);
+    BOOST_CHECK(store.Get("b", now + std::chrono::seconds(70)) == b);
+    BOOST_CHECK(store.Get("a", now + std::chrono::seconds(70)) != a);
+    BOOST_CHECK_EQUAL(getMetric(store, "evicted"), 0);
+}
+
+BOOST_AUTO_TEST_CASE(reset_on_new_facade)
+{
+    MatchSession session;
+    auto facade = std::make_shared<int>(1);
+
+    auto *state = &session.UseFacade(facade);
+    state->trace_coordinates.push_back(util::Coordinate{});
+    BOOST_CHECK_EQUAL(session.UseFacade(facade).trace_coordinates.size(), 1);
+
+    auto other_facade = std::make_shared<int>(2);
+    BOOST_CHECK(session.UseFacade(other_facade).trace_coordinates.empty());
+
+    // the state of an expired facade is dropped, even if a new facade has the same address
+    session.UseFacade(other_facade).trace_coordinates.push_back(util::Coordinate{});
+    other_facade.reset();
+    BOOST_CHECK(session.UseFacade(std::make_shared<int>(3)).trace_coordinates.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,93 @@
+#include "engine/datafacade/metric_buffer_allocator.hpp"
+
+#include "util/integer_range.hpp"
+
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+BOOST_AUTO_TEST_SUITE(metric_buffer_allocator)
+
+using namespace osrm;
+using namespace osrm::engine::datafacade;
+using storage::DataLayout;
+
+namespace
+{
+// A dataset with every block filled with the given character
+class TestAllocator final : public ContiguousBlockAllocator
+{
+  public:
+    TestAllocator(const char value, const std::size_t size = 1000)
+    {
+        for (const auto block : util::irange<std::size_t>(0, DataLayout::NUM_BLOCKS))
+        {
+            layout.SetBlockSize<char>(static_cast<DataLayout::BlockID>(block), size);
+        }
+
+        memory = std::make_unique<char[]>(layout.GetSizeOfLayout());
+        for (const auto block : util::irange<std::size_t>(0, DataLayout::NUM_BLOCKS))
+        {
+            const auto begin = layout.GetBlockPtr<char, true>(
+                memory.get(), static_cast<DataLayout::BlockID>(block));
+            std::fill(begin, begin + size, value);
+        }
+    }
+
+    DataLayout &GetLayout() override { return layout; }
+    char *GetMemory() override { return memory.get(); }
+
+  private:
+    DataLayout layout;
+    std::unique_ptr<char[]> memory;
+};
+
+std::string readBlock(DataLayout &layout, char *memory, const DataLayout::BlockID block)
+{
+    const auto begin = layout.GetBlockPtr<char>(memory, block);
+    return std::string(begin, begin + layout.GetBlockSize(block));
+}
+}
+
+BOOST_AUTO_TEST_CASE(metric_layout)
+{
+    TestAllocator allocator('a');
+    const auto metric_layout = storage::makeMetricLayout(allocator.GetLayout());
+
+    std::size_t reserved_blocks = 0;
+    for (const auto block : util::irange<std::size_t>(0, DataLayout::NUM_BLOCKS))
+    {
+        reserved_blocks += metric_layout.num_entries[block] > 0;
+        BOOST_CHECK_EQUAL(metric_layout.entry_size[block], 1);
+    }
+    BOOST_CHECK_EQUAL(reserved_blocks, std::extent<decltype(storage::metric_blocks)>::value);
+    BOOST_CHECK_EQUAL(metric_layout.GetBlockSize(DataLayout::TURN_WEIGHT_PENALTIES), 1000);
+    BOOST_CHECK_EQUAL(metric_layout.GetBlockSize(DataLayout::MLD_GRAPH_EDGE_LIST), 1000);
+    BOOST_CHECK_EQUAL(metric_layout.GetBlockSize(DataLayout::MLD_GRAPH_NODE_LIST), 0);
+    BOOST_CHECK_EQUAL(metric_layout.GetBlockSize(DataLayout::GEOMETRIES_NODE_LIST), 0);
+}
+
+BOOST_AUTO_TEST_CASE(copy_metric_blocks)
+{
+    auto topology = std::make_shared<TestAllocator>('a');
+    TestAllocator metric_source('b');
+    MetricBufferAllocator allocator(topology, metric_source);
+
+    BOOST_CHECK(allocator.GetMemory() == topology->GetMemory());
+    BOOST_CHECK(allocator.GetMetricMemory() != metric_source.GetMemory());
+    for (const auto block : storage::metric_blocks)
+    {
+        BOOST_CHECK_EQUAL(
+            readBlock(allocator.GetMetricLayout(), allocator.GetMetricMemory(), block),
+            std::string(1000, 'b'));
+    }
+    BOOST_CHECK_EQUAL(
+        readBlock(allocator.GetLayout(), allocator.GetMemory(), DataLayout::GEOMETRIES_INDEX),
+        std::string(1000, 'a'));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -281,6 +281,15 @@ class ContiguousInternalMemoryDataFacade<routing_algorithms::offline::Algorithm>
         return {};
     }
 
+    std::vector<std::vector<PhantomNodeWithDistance>>
+    NearestPhantomNodes(const std::vector<util::Coordinate> & /*input_coordinates*/,
+                        const unsigned /*max_results*/,
+                        const std::vector<boost::optional<double>> & /*max_distances*/,
+                        const std::vector<boost::optional<Approach>> & /*approaches*/) const override
+    {
+        return {};
+    }
+
     std::pair<PhantomNode, PhantomNode>
     NearestPhantomNodeWithAlternativeFromBigComponent(const util::Coordinate /*input_coordinate*/,
                                                       const Approach /*approach*/) const override
@@ -334,6 +343,7 @@ class ContiguousInternalMemoryDataFacade<routing_algorithms::offline::Algorithm>
     StringView GetDestinationsForID(const NameID /*id*/) const override { return StringView{}; }
     StringView GetExitsForID(const NameID /*id*/) const override { return StringView{}; }
     std::string GetTimestamp() const override { return std::string(); }
+    storage::DatasetFingerprint GetDatasetFingerprint() const override { return {0, 0}; }
     bool GetContinueStraightDefault() const override { return false; }
     double GetMapMatchingMaxSpeed() const override { return 0; }
     const char *GetWeightName() const override { return ""; }
@@ -0,0 +1,69 @@
+#include "engine/phantom_node_cache.hpp"
+
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(phantom_node_cache)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+namespace
+{
+PhantomNodeCache::Key makeKey(std::uint32_t owner, std::int32_t lon)
+{
+    PhantomNodeCache::Key key;
+    key.owner = owner;
+    key.lon = lon;
+    key.lat = 43730000;
+    key.max_results = 1;
+    return key;
+}
+
+PhantomNodeCache::Value makeValue(double distance)
+{
+    PhantomNodeWithDistance phantom;
+    phantom.distance = distance;
+    return {phantom};
+}
+}
+
+BOOST_AUTO_TEST_CASE(separate_owners)
+{
+    PhantomNodeCache cache(64);
+    const auto first = cache.NewOwner();
+    const auto second = cache.NewOwner();
+    BOOST_CHECK_NE(first, second);
+
+    PhantomNodeCache::Value value;
+    BOOST_CHECK(!cache.Get(makeKey(first, 7410000), value));
+    cache.Put(makeKey(first, 7410000), makeValue(1.));
+    BOOST_CHECK(cache.Get(makeKey(first, 7410000), value));
+    BOOST_CHECK_EQUAL(value.size(), 1);
+    BOOST_CHECK_EQUAL(value.front().distance, 1.);
+
+    BOOST_CHECK(!cache.Get(makeKey(second, 7410000), value));
+    BOOST_CHECK(!cache.Get(makeKey(first, 7410001), value));
+
+    const auto metrics = cache.GetMetrics();
+    BOOST_CHECK_EQUAL(metrics.values.at("entries").get<util::json::Number>().value, 1);
+    BOOST_CHECK_EQUAL(metrics.values.at("hits").get<util::json::Number>().value, 1);
+    BOOST_CHECK_EQUAL(metrics.values.at("misses").get<util::json::Number>().value, 3);
+}
+
+BOOST_AUTO_TEST_CASE(evict_least_recently_used)
+{
+    PhantomNodeCache cache(32);
+    for (std::int32_t lon = 0; lon < 1000; ++lon)
+    {
+        cache.Put(makeKey(0, lon), makeValue(lon));
+    }
+
+    PhantomNodeCache::Value value;
+    BOOST_CHECK(cache.GetMetrics().values.at("entries").get<util::json::Number>().value <= 32);
+    BOOST_CHECK(!cache.Get(makeKey(0, 0), value));
+    BOOST_CHECK(cache.Get(makeKey(0, 999), value));
+    BOOST_CHECK_EQUAL(value.front().distance, 999.);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
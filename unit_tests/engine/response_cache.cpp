@@ -0,0 +1,140 @@
+#include "engine/response_cache.hpp"
+
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(response_cache)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+namespace
+{
+api::NearestParameters makeParameters(double lon, double lat)
+{
+    api::NearestParameters parameters;
+    parameters.coordinates.push_back(
+        util::Coordinate{util::FloatLongitude{lon}, util::FloatLatitude{lat}});
+    return parameters;
+}
+
+api::ResultT makeResponse(const std::string &code)
+{
+    util::json::Object response;
+    response.values["code"] = code;
+    return response;
+}
+
+std::string getCode(const api::ResultT &response)
+{
+    return response.get<util::json::Object>().values.at("code").get<util::json::String>().value;
+}
+}
+
+BOOST_AUTO_TEST_CASE(keys_of_different_parameters)
+{
+    const auto parameters = makeParameters(7.41, 43.73);
+    BOOST_CHECK(MakeResponseCacheKey(parameters) == MakeResponseCacheKey(parameters));
+
+    // beyond the fixed point precision
+    BOOST_CHECK(MakeResponseCacheKey(parameters) ==
+                MakeResponseCacheKey(makeParameters(7.4100000001, 43.73)));
+    BOOST_CHECK(MakeResponseCacheKey(parameters) !=
+                MakeResponseCacheKey(makeParameters(7.41, 43.74)));
+
+    auto more_results = parameters;
+    more_results.number_of_results = 2;
+    BOOST_CHECK(MakeResponseCacheKey(parameters) != MakeResponseCacheKey(more_results));
+
+    auto with_radius = parameters;
+    with_radius.radiuses.push_back(10.);
+    BOOST_CHECK(MakeResponseCacheKey(parameters) != MakeResponseCacheKey(with_radius));
+
+    auto batch = parameters;
+    batch.batch = true;
+    BOOST_CHECK(MakeResponseCacheKey(parameters) != MakeResponseCacheKey(batch));
+
+    auto with_exclude = parameters;
+    with_exclude.exclude.push_back("toll");
+    BOOST_CHECK(MakeResponseCacheKey(parameters) != MakeResponseCacheKey(with_exclude));
+
+    // same base parameters, different services
+    api::TableParameters table_parameters;
+    table_parameters.coordinates = parameters.coordinates;
+    BOOST_CHECK(MakeResponseCacheKey(parameters) != MakeResponseCacheKey(table_parameters));
+}
+
+BOOST_AUTO_TEST_CASE(hit_and_miss)
+{
+    ResponseCache cache(1 << 20);
+    api::ResultT result;
+
+    BOOST_CHECK(!cache.Get("a", 0, result));
+    cache.Put("a", 0, makeResponse("Ok"));
+    BOOST_CHECK(cache.Get("a", 0, result));
+    BOOST_CHECK_EQUAL(getCode(result), "Ok");
+
+    const auto metrics = cache.GetMetrics();
+    BOOST_CHECK_EQUAL(metrics.values.at("entries").get<util::json::Number>().value, 1);
+    BOOST_CHECK_EQUAL(metrics.values.at("hits").get<util::json::Number>().value, 1);
+    BOOST_CHECK_EQUAL(metrics.values.at("misses").get<util::json::Number>().value, 1);
+    BOOST_CHECK_EQUAL(metrics.values.at("hit_rate").get<util::json::Number>().value, 0.5);
+}
+
+BOOST_AUTO_TEST_CASE(evict_least_recently_used)
+{
+    const auto response = makeResponse("Ok");
+
+    // measure the size of an entry to fit exactly two into the cache
+    ResponseCache measure(1 << 20);
+    measure.Put("a", 0, response);
+    const auto entry_size = static_cast<std::size_t>(
+        measure.GetMetrics().values.at("bytes").get<util::json::Number>().value);
+
+    ResponseCache cache(2 * entry_size);
+    api::ResultT result;
+    cache.Put("a", 0, response);
+    cache.Put("b", 0, response);
+    BOOST_CHECK(cache.Get("a", 0, result));
+    cache.Put("c", 0, response);
+
+    BOOST_CHECK(cache.Get("a", 0, result));
+    BOOST_CHECK(!cache.Get("b", 0, result));
+    BOOST_CHECK(cache.Get("c", 0, result));
+}
+
+BOOST_AUTO_TEST_CASE(invalidate_on_new_dataset)
+{
+    ResponseCache cache(1 << 20);
+    api::ResultT result;
+
+    cache.Put("a", 1, makeResponse("Old"));
+    BOOST_CHECK(!cache.Get("a", 2, result));
+    BOOST_CHECK_EQUAL(
+        cache.GetMetrics().values.at("invalidations").get<util::json::Number>().value, 1);
+
+    // responses computed on the previous dataset are not cached anymore
+    cache.Put("a", 1, makeResponse("Old"));
+    BOOST_CHECK(!cache.Get("a", 2, result));
+
+    cache.Put("a", 2, makeResponse("New"));
+    BOOST_CHECK(cache.Get("a", 2, result));
+    BOOST_CHECK_EQUAL(getCode(result), "New");
+}
+
+BOOST_AUTO_TEST_CASE(rendered_responses)
+{
+    ResponseCache cache(1 << 20);
+    const std::string text = "{\"code\":\"Ok\"}";
+
+    cache.Put("a", 0, api::ResultT{std::vector<char>(text.begin(), text.end())});
+    api::ResultT result = std::vector<char>();
+    BOOST_CHECK(cache.Get("a", 0, result));
+    BOOST_CHECK(result.is<std::vector<char>>());
+    const auto &buffer = result.get<std::vector<char>>();
+    BOOST_CHECK_EQUAL(std::string(buffer.begin(), buffer.end()), text);
+    BOOST_CHECK(cache.GetMetrics().values.at("bytes").get<util::json::Number>().value >=
+                text.size());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,48 @@
+#include "engine/search_engine_data.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(search_engine_data)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+namespace
+{
+SearchEngineHeapStorage makeTwoLevelStorage(const std::size_t dense_nodes)
+{
+    SearchEngineHeapStorage heap_storage;
+    heap_storage.query_heap = EngineConfig::HeapStorage::TwoLevel;
+    heap_storage.many_to_many_heap = EngineConfig::HeapStorage::TwoLevel;
+    heap_storage.dense_nodes = dense_nodes;
+    return heap_storage;
+}
+}
+
+BOOST_AUTO_TEST_CASE(heaps_are_reused_by_smaller_datasets)
+{
+    using MLD = routing_algorithms::mld::Algorithm;
+    SearchEngineData<MLD> engine_working_data(makeTwoLevelStorage(1000));
+
+    engine_working_data.InitializeOrClearFirstThreadLocalStorage(5000);
+    auto *large_heap = engine_working_data.forward_heap_1.get();
+    BOOST_CHECK_EQUAL(large_heap->GetIndexStorage().DenseSize(), 1000);
+
+    // switching to a dataset with fewer nodes and back keeps the heap
+    large_heap->Insert(4999, 1, 4999);
+    engine_working_data.InitializeOrClearFirstThreadLocalStorage(100);
+    BOOST_CHECK_EQUAL(engine_working_data.forward_heap_1.get(), large_heap);
+    BOOST_CHECK(engine_working_data.forward_heap_1->Empty());
+    BOOST_CHECK(!engine_working_data.forward_heap_1->WasInserted(4999));
+    engine_working_data.InitializeOrClearFirstThreadLocalStorage(5000);
+    BOOST_CHECK_EQUAL(engine_working_data.forward_heap_1.get(), large_heap);
+
+    // a larger dense array grows the heap
+    SearchEngineData<MLD> larger_working_data(makeTwoLevelStorage(2000));
+    larger_working_data.InitializeOrClearFirstThreadLocalStorage(5000);
+    BOOST_CHECK_EQUAL(larger_working_data.forward_heap_1->GetIndexStorage().DenseSize(), 2000);
+    engine_working_data.InitializeOrClearFirstThreadLocalStorage(5000);
+    BOOST_CHECK_EQUAL(engine_working_data.forward_heap_1->GetIndexStorage().DenseSize(), 2000);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
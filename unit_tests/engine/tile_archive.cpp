@@ -0,0 +1,105 @@
+#include "engine/tile_archive.hpp"
+
+#include "util/exception.hpp"
+#include "util/fingerprint.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(tile_archive)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+namespace
+{
+struct TemporaryFile
+{
+    TemporaryFile() : path(boost::filesystem::unique_path()) {}
+    ~TemporaryFile() { boost::filesystem::remove(path); }
+
+    boost::filesystem::path path;
+};
+}
+
+BOOST_AUTO_TEST_CASE(write_and_read_tiles)
+{
+    TemporaryFile file;
+    {
+        TileArchiveWriter writer(file.path, storage::DatasetFingerprint{17, 42});
+        writer.Add(14, 8800, 5373, "second");
+        writer.Add(12, 2200, 1343, "first");
+        writer.Add(14, 8801, 5373, "");
+        writer.Finish();
+    }
+
+    const TileArchive archive(file.path);
+    BOOST_CHECK_EQUAL(archive.GetDatasetFingerprint().topology, 17);
+    BOOST_CHECK_EQUAL(archive.GetDatasetFingerprint().metric, 42);
+    BOOST_CHECK_EQUAL(archive.GetNumberOfTiles(), 3);
+
+    std::string buffer = "stale";
+    BOOST_CHECK(archive.Get(12, 2200, 1343, buffer));
+    BOOST_CHECK_EQUAL(buffer, "first");
+    BOOST_CHECK(archive.Get(14, 8800, 5373, buffer));
+    BOOST_CHECK_EQUAL(buffer, "second");
+    BOOST_CHECK(archive.Get(14, 8801, 5373, buffer));
+    BOOST_CHECK_EQUAL(buffer, "");
+
+    BOOST_CHECK(!archive.Get(13, 4400, 2686, buffer));
+    BOOST_CHECK(!archive.Get(14, 5373, 8800, buffer));
+
+    auto metrics = archive.GetMetrics();
+    BOOST_CHECK_EQUAL(metrics.values["hits"].get<util::json::Number>().value, 3);
+    BOOST_CHECK_EQUAL(metrics.values["misses"].get<util::json::Number>().value, 2);
+}
+
+BOOST_AUTO_TEST_CASE(empty_archive)
+{
+    TemporaryFile file;
+    {
+        TileArchiveWriter writer(file.path, storage::DatasetFingerprint{0, 0});
+        writer.Finish();
+    }
+
+    const TileArchive archive(file.path);
+    BOOST_CHECK_EQUAL(archive.GetNumberOfTiles(), 0);
+
+    std::string buffer;
+    BOOST_CHECK(!archive.Get(12, 0, 0, buffer));
+}
+
+BOOST_AUTO_TEST_CASE(index_outside_of_tiles)
+{
+    TemporaryFile file;
+    {
+        TileArchiveWriter writer(file.path, storage::DatasetFingerprint{0, 0});
+        writer.Add(14, 8800, 5373, "tile");
+        writer.Finish();
+    }
+
+    // move the offset of the only tile behind the end of the tiles
+    {
+        boost::filesystem::fstream archive(file.path,
+                                           std::ios::binary | std::ios::in | std::ios::out);
+        archive.seekp(sizeof(util::FingerPrint) + sizeof(std::uint64_t) + 4 +
+                      sizeof(std::uint64_t) + offsetof(TileArchiveEntry, offset));
+        const std::uint64_t offset = 1;
+        archive.write(reinterpret_cast<const char *>(&offset), sizeof(offset));
+    }
+
+    BOOST_CHECK_THROW(TileArchive{file.path}, util::exception);
+}
+
+BOOST_AUTO_TEST_CASE(missing_archive)
+{
+    BOOST_CHECK_THROW(TileArchive(boost::filesystem::unique_path()), util::exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,81 @@
+#include "engine/unpacking_cache.hpp"
+
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(unpacking_cache)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+namespace
+{
+UnpackingCache::Key makeKey(std::uint32_t owner, NodeID source)
+{
+    UnpackingCache::Key key;
+    key.owner = owner;
+    key.level = 1;
+    key.cell = 3;
+    key.source = source;
+    key.target = source + 2;
+    return key;
+}
+
+UnpackingCache::Value makeValue(NodeID source)
+{
+    return {{source, source + 1, source + 2}, {10 * source, 10 * source + 1}};
+}
+}
+
+BOOST_AUTO_TEST_CASE(separate_owners)
+{
+    UnpackingCache cache(1024 * 1024);
+    const auto first = UnpackingCache::NewOwner();
+    const auto second = UnpackingCache::NewOwner();
+    BOOST_CHECK_NE(first, second);
+
+    UnpackingCache::Value value;
+    BOOST_CHECK(!cache.Get(makeKey(first, 7), value));
+    cache.Put(makeKey(first, 7), makeValue(7), std::chrono::microseconds(20));
+    BOOST_CHECK(cache.Get(makeKey(first, 7), value));
+    const std::vector<NodeID> expected_nodes = {7, 8, 9};
+    const std::vector<EdgeID> expected_edges = {70, 71};
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+        value.nodes.begin(), value.nodes.end(), expected_nodes.begin(), expected_nodes.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+        value.edges.begin(), value.edges.end(), expected_edges.begin(), expected_edges.end());
+
+    BOOST_CHECK(!cache.Get(makeKey(second, 7), value));
+    auto loop_key = makeKey(first, 7);
+    loop_key.force_loop_forward = true;
+    BOOST_CHECK(!cache.Get(loop_key, value));
+
+    const auto metrics = cache.GetMetrics();
+    BOOST_CHECK_EQUAL(metrics.values.at("entries").get<util::json::Number>().value, 1);
+    BOOST_CHECK_EQUAL(metrics.values.at("hits").get<util::json::Number>().value, 1);
+    BOOST_CHECK_EQUAL(metrics.values.at("misses").get<util::json::Number>().value, 3);
+    BOOST_CHECK_EQUAL(metrics.values.at("hit_rate").get<util::json::Number>().value, 0.25);
+    BOOST_CHECK_EQUAL(metrics.values.at("mean_unpacking_us").get<util::json::Number>().value,
+                      20.);
+}
+
+BOOST_AUTO_TEST_CASE(evict_least_recently_used)
+{
+    const std::size_t max_bytes = 16 * 1024;
+    UnpackingCache cache(max_bytes);
+    for (NodeID source = 0; source < 10000; ++source)
+    {
+        cache.Put(makeKey(0, source), makeValue(source), std::chrono::microseconds(1));
+    }
+
+    const auto metrics = cache.GetMetrics();
+    BOOST_CHECK(metrics.values.at("bytes").get<util::json::Number>().value <= max_bytes);
+    BOOST_CHECK(metrics.values.at("entries").get<util::json::Number>().value < 10000);
+
+    UnpackingCache::Value value;
+    BOOST_CHECK(!cache.Get(makeKey(0, 0), value));
+    BOOST_CHECK(cache.Get(makeKey(0, 9999), value));
+    BOOST_CHECK_EQUAL(value.nodes.front(), 9999);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,119 @@
+#include "extractor/native_turn_function.hpp"
+#include "extractor/travel_mode.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <limits>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(native_turn_function)
+
+using namespace osrm;
+using namespace osrm::extractor;
+
+namespace
+{
+// the values of car.lua
+CarTurnFunction makeCarTurnFunction(const CarTurnFunction::WeightType weight_type)
+{
+    CarTurnFunction function;
+    function.turn_penalty = 7.5;
+    function.turn_bias = 1.075;
+    function.u_turn_penalty = 20;
+    function.traffic_light_penalty = 2;
+    function.weight_type = weight_type;
+    function.max_turn_weight = std::numeric_limits<std::int16_t>::max();
+    return function;
+}
+
+ExtractionTurn makeTurn(const double angle,
+                        const int number_of_roads,
+                        const bool is_u_turn,
+                        const bool has_traffic_light,
+                        const bool target_restricted = false)
+{
+    const std::vector<ExtractionTurnLeg> no_roads;
+    return ExtractionTurn(angle,
+                          number_of_roads,
+                          is_u_turn,
+                          has_traffic_light,
+                          false,
+                          false,
+                          TRAVEL_MODE_DRIVING,
+                          false,
+                          false,
+                          1,
+                          0,
+                          0,
+                          50,
+                          target_restricted,
+                          TRAVEL_MODE_DRIVING,
+                          false,
+                          false,
+                          1,
+                          0,
+                          0,
+                          50,
+                          no_roads,
+                          no_roads);
+}
+}
+
+BOOST_AUTO_TEST_CASE(no_penalty_along_road)
+{
+    const auto function = makeCarTurnFunction(CarTurnFunction::WeightType::Duration);
+
+    auto turn = makeTurn(180, 2, false, false);
+    function(turn);
+    BOOST_CHECK_EQUAL(turn.duration, 0);
+    BOOST_CHECK_EQUAL(turn.weight, 0);
+
+    auto traffic_light = makeTurn(180, 2, false, true);
+    function(traffic_light);
+    BOOST_CHECK_EQUAL(traffic_light.duration, 2);
+    BOOST_CHECK_EQUAL(traffic_light.weight, 2);
+}
+
+BOOST_AUTO_TEST_CASE(turn_penalties)
+{
+    const auto function = makeCarTurnFunction(CarTurnFunction::WeightType::Duration);
+
+    auto straight = makeTurn(180, 3, false, false);
+    auto right = makeTurn(90, 3, false, false);
+    auto left = makeTurn(270, 3, false, false);
+    function(straight);
+    function(right);
+    function(left);
+
+    BOOST_CHECK_GT(straight.duration, 0);
+    BOOST_CHECK_LT(straight.duration, right.duration);
+    // right hand driving makes left turns more expensive
+    BOOST_CHECK_LT(right.duration, left.duration);
+    BOOST_CHECK_LT(left.duration, 7.5);
+    BOOST_CHECK_EQUAL(left.weight, left.duration);
+
+    auto u_turn = makeTurn(0, 2, true, false);
+    function(u_turn);
+    BOOST_CHECK_GT(u_turn.duration, 20);
+    BOOST_CHECK_LT(u_turn.duration, 27.5);
+}
+
+BOOST_AUTO_TEST_CASE(weight_types)
+{
+    const auto distance = makeCarTurnFunction(CarTurnFunction::WeightType::Distance);
+    auto turn = makeTurn(90, 3, false, true);
+    distance(turn);
+    BOOST_CHECK_GT(turn.duration, 2);
+    BOOST_CHECK_EQUAL(turn.weight, 0);
+
+    const auto routability = makeCarTurnFunction(CarTurnFunction::WeightType::Routability);
+    auto unrestricted = makeTurn(90, 3, false, false);
+    auto restricted = makeTurn(90, 3, false, false, true);
+    routability(unrestricted);
+    routability(restricted);
+    BOOST_CHECK_EQUAL(unrestricted.weight, unrestricted.duration);
+    BOOST_CHECK_EQUAL(restricted.weight, std::numeric_limits<std::int16_t>::max());
+    BOOST_CHECK_EQUAL(restricted.duration, unrestricted.duration);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
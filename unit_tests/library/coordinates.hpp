@@ -40,4 +40,39 @@ inline Locations get_locations_in_big_component()
             {Longitude{7.421315}, Latitude{43.738814}}};
 }
 
+// A dense GPS trace, its points have several candidates close to each other
+inline Locations get_match_trace_locations()
+{
+    return {{Longitude{7.422177}, Latitude{43.737546}},
+            {Longitude{7.421715}, Latitude{43.737445}},
+            {Longitude{7.421490}, Latitude{43.737383}},
+            {Longitude{7.421286}, Latitude{43.737275}},
+            {Longitude{7.420911}, Latitude{43.737143}},
+            {Longitude{7.420696}, Latitude{43.736996}},
+            {Longitude{7.420492}, Latitude{43.736903}},
+            {Longitude{7.420310}, Latitude{43.736724}},
+            {Longitude{7.420160}, Latitude{43.736662}},
+            {Longitude{7.420149}, Latitude{43.736623}},
+            {Longitude{7.419934}, Latitude{43.736476}},
+            {Longitude{7.419806}, Latitude{43.736228}},
+            {Longitude{7.419602}, Latitude{43.736143}},
+            {Longitude{7.419376}, Latitude{43.735957}},
+            {Longitude{7.419248}, Latitude{43.735748}},
+            {Longitude{7.419044}, Latitude{43.735662}},
+            {Longitude{7.418733}, Latitude{43.735406}},
+            {Longitude{7.418658}, Latitude{43.735321}},
+            {Longitude{7.418593}, Latitude{43.735213}},
+            {Longitude{7.418368}, Latitude{43.735081}},
+            {Longitude{7.418346}, Latitude{43.734848}},
+            {Longitude{7.418057}, Latitude{43.734437}},
+            {Longitude{7.417810}, Latitude{43.734143}},
+            {Longitude{7.417864}, Latitude{43.733755}},
+            {Longitude{7.417810}, Latitude{43.733864}},
+            {Longitude{7.417896}, Latitude{43.733654}},
+            {Longitude{7.418067}, Latitude{43.733437}},
+            {Longitude{7.418035}, Latitude{43.733197}},
+            {Longitude{7.418025}, Latitude{43.732957}},
+            {Longitude{7.417907}, Latitude{43.732848}}};
+}
+
 #endif
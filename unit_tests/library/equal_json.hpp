@@ -5,6 +5,12 @@
 
 #include "osrm/json_container.hpp"
 #include "util/json_deep_compare.hpp"
+#include "util/json_renderer.hpp"
+
+#include <rapidjson/document.h>
+
+#include <string>
+#include <vector>
 
 inline boost::test_tools::predicate_result compareJSON(const osrm::util::json::Value &reference,
                                                        const osrm::util::json::Value &result)
@@ -25,4 +31,33 @@ inline boost::test_tools::predicate_result compareJSON(const osrm::util::json::V
 
 #define CHECK_EQUAL_JSON(reference, result) BOOST_CHECK(compareJSON(reference, result));
 
+// Compares JSON text written without building an object to the rendered reference object,
+// regardless of the order of keys
+inline boost::test_tools::predicate_result
+compareRenderedJSON(const osrm::util::json::Object &reference, const std::vector<char> &result)
+{
+    std::vector<char> rendered;
+    osrm::util::json::render(rendered, reference);
+
+    rapidjson::Document reference_document;
+    reference_document.Parse(rendered.data(), rendered.size());
+    rapidjson::Document result_document;
+    result_document.Parse(result.data(), result.size());
+
+    if (result_document.HasParseError() || reference_document != result_document)
+    {
+        boost::test_tools::predicate_result res(false);
+
+        res.message() << std::string(result.begin(), result.end()) << " is not "
+                      << std::string(rendered.begin(), rendered.end());
+
+        return res;
+    }
+
+    return true;
+}
+
+#define CHECK_EQUAL_RENDERED_JSON(reference, result)                                               \
+    BOOST_CHECK(compareRenderedJSON(reference, result));
+
 #endif
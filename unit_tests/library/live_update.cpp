@@ -0,0 +1,130 @@
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "coordinates.hpp"
+
+#include "osrm/engine_config.hpp"
+#include "osrm/exception.hpp"
+#include "osrm/json_container.hpp"
+#include "osrm/osrm.hpp"
+#include "osrm/route_parameters.hpp"
+#include "osrm/status.hpp"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(live_update)
+
+namespace
+{
+osrm::EngineConfig makeConfig(const std::string &base_path,
+                              const osrm::EngineConfig::Algorithm algorithm,
+                              const bool live_traffic_updates)
+{
+    osrm::EngineConfig config;
+    config.storage_config = {base_path};
+    config.use_shared_memory = false;
+    config.algorithm = algorithm;
+    config.live_traffic_updates = live_traffic_updates;
+    return config;
+}
+
+// Duration and OSM nodes of a route through the big component
+std::pair<double, std::vector<std::uint64_t>> routeThroughBigComponent(const osrm::OSRM &osrm)
+{
+    using namespace osrm;
+
+    RouteParameters params;
+    params.coordinates = get_locations_in_big_component();
+    params.annotations_type = RouteParameters::AnnotationsType::Nodes;
+
+    json::Object result;
+    const auto rc = osrm.Route(params, result);
+    BOOST_REQUIRE(rc == Status::Ok);
+
+    const auto &route =
+        result.values.at("routes").get<json::Array>().values.at(0).get<json::Object>();
+    const auto duration = route.values.at("duration").get<json::Number>().value;
+
+    std::vector<std::uint64_t> nodes;
+    for (const auto &leg : route.values.at("legs").get<json::Array>().values)
+    {
+        const auto &annotation =
+            leg.get<json::Object>().values.at("annotation").get<json::Object>();
+        for (const auto &node : annotation.values.at("nodes").get<json::Array>().values)
+        {
+            nodes.push_back(static_cast<std::uint64_t>(node.get<json::Number>().value));
+        }
+    }
+
+    return std::make_pair(duration, std::move(nodes));
+}
+}
+
+BOOST_AUTO_TEST_CASE(test_update_segment_speeds)
+{
+    using namespace osrm;
+
+    auto config =
+        makeConfig(OSRM_TEST_DATA_DIR "/mld/monaco.osrm", EngineConfig::Algorithm::MLD, true);
+    const OSRM osrm{config};
+
+    const auto before = routeThroughBigComponent(osrm);
+    BOOST_REQUIRE_GT(before.second.size(), 1);
+
+    // slow down every segment of the route in both directions
+    std::string segment_speeds;
+    for (std::size_t index = 1; index < before.second.size(); ++index)
+    {
+        const auto from = std::to_string(before.second[index - 1]);
+        const auto to = std::to_string(before.second[index]);
+        segment_speeds += from + "," + to + ",1\n" + to + "," + from + ",1\n";
+    }
+
+    json::Object result;
+    BOOST_CHECK(osrm.UpdateSegmentSpeeds(segment_speeds, result) == Status::Ok);
+    BOOST_CHECK_EQUAL(result.values.at("code").get<json::String>().value, "Ok");
+    BOOST_CHECK_GT(result.values.at("segments").get<json::Number>().value, 0);
+    BOOST_CHECK_GT(result.values.at("edges").get<json::Number>().value, 0);
+    BOOST_CHECK_GT(result.values.at("cells").get<json::Number>().value, 0);
+
+    const auto after = routeThroughBigComponent(osrm);
+    BOOST_CHECK_GT(after.first, before.first);
+
+    // the same speeds again don't change any segment
+    json::Object repeated;
+    BOOST_CHECK(osrm.UpdateSegmentSpeeds(segment_speeds, repeated) == Status::Ok);
+    BOOST_CHECK_EQUAL(repeated.values.at("segments").get<json::Number>().value, 0);
+    BOOST_CHECK_EQUAL(routeThroughBigComponent(osrm).first, after.first);
+
+    json::Object invalid;
+    BOOST_CHECK(osrm.UpdateSegmentSpeeds("1,2,fast\n", invalid) == Status::Error);
+    BOOST_CHECK_EQUAL(invalid.values.at("code").get<json::String>().value, "InvalidValue");
+}
+
+BOOST_AUTO_TEST_CASE(test_update_without_live_updates)
+{
+    using namespace osrm;
+
+    auto config =
+        makeConfig(OSRM_TEST_DATA_DIR "/mld/monaco.osrm", EngineConfig::Algorithm::MLD, false);
+    const OSRM osrm{config};
+
+    json::Object result;
+    BOOST_CHECK(osrm.UpdateSegmentSpeeds("1,2,10\n", result) == Status::Error);
+    BOOST_CHECK_EQUAL(result.values.at("code").get<json::String>().value, "NotImplemented");
+}
+
+BOOST_AUTO_TEST_CASE(test_live_updates_need_mld)
+{
+    using namespace osrm;
+
+    auto config =
+        makeConfig(OSRM_TEST_DATA_DIR "/ch/monaco.osrm", EngineConfig::Algorithm::CH, true);
+    BOOST_CHECK(!config.IsValid());
+    BOOST_CHECK_THROW(OSRM{config}, osrm::exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
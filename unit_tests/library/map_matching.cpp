@@ -0,0 +1,318 @@
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "coordinates.hpp"
+
+#include "engine/algorithm.hpp"
+#include "engine/datafacade.hpp"
+#include "engine/datafacade/process_memory_allocator.hpp"
+#include "engine/map_matching/hidden_markov_model.hpp"
+#include "engine/match_session_store.hpp"
+#include "engine/routing_algorithms/map_matching.hpp"
+#include "engine/routing_algorithms/routing_base_cch.hpp"
+#include "engine/routing_algorithms/routing_base_ch.hpp"
+#include "engine/routing_algorithms/routing_base_mld.hpp"
+#include "engine/search_engine_data.hpp"
+
+#include "util/integer_range.hpp"
+
+#include "osrm/engine_config.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(map_matching)
+
+using namespace osrm;
+using namespace osrm::engine;
+using namespace osrm::engine::routing_algorithms;
+
+namespace
+{
+// Candidates of a trace point and matchings of a trace on a dataset loaded into process memory
+template <typename Algorithm> struct MatchingFixture
+{
+    explicit MatchingFixture(const std::string &base_path)
+        : facade(std::make_shared<const DataFacade<Algorithm>>(
+              std::make_shared<datafacade::ProcessMemoryAllocator>(
+                  storage::StorageConfig{base_path}),
+              0,
+              nullptr)),
+          heaps(makeSearchEngineData<Algorithm>(EngineConfig{}))
+    {
+    }
+
+    CandidateList GetCandidates(const Location &location) const
+    {
+        // large enough for several candidates at each point
+        return facade->NearestPhantomNodesInRange(location, 30., Approach::UNRESTRICTED);
+    }
+
+    SubMatchingList Match(const Locations &trace)
+    {
+        CandidateLists candidates_list;
+        for (const auto &location : trace)
+        {
+            candidates_list.push_back(GetCandidates(location));
+        }
+        return mapMatching(heaps, *facade, candidates_list, trace, {}, {}, true);
+    }
+
+    // Matches a trace that doesn't break with one point to point search per pair of candidates,
+    // the way map matching computed the transitions before the many-to-many search
+    std::vector<PhantomNode> MatchPerPair(const Locations &trace)
+    {
+        // the parameters of mapMatching
+        const engine::map_matching::EmissionLogProbability emission_log_probability(
+            DEFAULT_GPS_PRECISION);
+        const engine::map_matching::TransitionLogProbability transition_log_probability(10.);
+        const double max_distance_delta = 2000.;
+
+        heaps.InitializeOrClearFirstThreadLocalStorage(facade->GetNumberOfNodes());
+        auto &forward_heap = *heaps.forward_heap_1;
+        auto &reverse_heap = *heaps.reverse_heap_1;
+
+        CandidateLists candidates_list;
+        std::vector<std::vector<double>> viterbi;
+        std::vector<std::vector<std::size_t>> parents;
+        for (const auto t : util::irange<std::size_t>(0UL, trace.size()))
+        {
+            candidates_list.push_back(GetCandidates(trace[t]));
+            const auto &candidates = candidates_list.back();
+            viterbi.emplace_back(candidates.size(), engine::map_matching::IMPOSSIBLE_LOG_PROB);
+            parents.emplace_back(candidates.size(), 0);
+
+            if (t == 0)
+            {
+                for (const auto s : util::irange<std::size_t>(0UL, candidates.size()))
+                {
+                    viterbi[t][s] = emission_log_probability(candidates[s].distance);
+                }
+                continue;
+            }
+
+            const auto haversine_distance =
+                util::coordinate_calculation::haversineDistance(trace[t - 1], trace[t]);
+            const EdgeWeight weight_upper_bound =
+                ((haversine_distance + max_distance_delta) / 4.) * facade->GetWeightMultiplier();
+            for (const auto s : util::irange<std::size_t>(0UL, viterbi[t - 1].size()))
+            {
+                if (viterbi[t - 1][s] == engine::map_matching::IMPOSSIBLE_LOG_PROB)
+                {
+                    continue;
+                }
+
+                for (const auto s_prime : util::irange<std::size_t>(0UL, candidates.size()))
+                {
+                    double new_value = viterbi[t - 1][s] +
+                                       emission_log_probability(candidates[s_prime].distance);
+                    if (viterbi[t][s_prime] > new_value)
+                    {
+                        continue;
+                    }
+
+                    const double network_distance =
+                        getNetworkDistance(heaps,
+                                           *facade,
+                                           forward_heap,
+                                           reverse_heap,
+                                           candidates_list[t - 1][s].phantom_node,
+                                           candidates[s_prime].phantom_node,
+                                           weight_upper_bound);
+                    const auto d_t = std::abs(network_distance - haversine_distance);
+                    if (d_t >= max_distance_delta)
+                    {
+                        continue;
+                    }
+
+                    new_value += transition_log_probability(d_t);
+                    if (new_value > viterbi[t][s_prime])
+                    {
+                        viterbi[t][s_prime] = new_value;
+                        parents[t][s_prime] = s;
+                    }
+                }
+            }
+            BOOST_REQUIRE(std::any_of(viterbi[t].begin(), viterbi[t].end(), [](const double value) {
+                return value != engine::map_matching::IMPOSSIBLE_LOG_PROB;
+            }));
+        }
+
+        std::vector<PhantomNode> nodes(trace.size());
+        auto s = std::distance(viterbi.back().begin(),
+                               std::max_element(viterbi.back().begin(), viterbi.back().end()));
+        for (auto t = trace.size(); t > 0; --t)
+        {
+            nodes[t - 1] = candidates_list[t - 1][s].phantom_node;
+            s = parents[t - 1][s];
+        }
+        return nodes;
+    }
+
+    std::shared_ptr<const DataFacade<Algorithm>> facade;
+    SearchEngineData<Algorithm> heaps;
+};
+
+// Point indices of the matchings are shifted by `offset`
+void checkEqualMatchings(const SubMatchingList &lhs,
+                         const std::size_t lhs_offset,
+                         const SubMatchingList &rhs,
+                         const std::size_t rhs_offset)
+{
+    BOOST_REQUIRE_EQUAL(lhs.size(), rhs.size());
+    for (const auto index : util::irange<std::size_t>(0UL, lhs.size()))
+    {
+        BOOST_REQUIRE_EQUAL(lhs[index].indices.size(), rhs[index].indices.size());
+        for (const auto point : util::irange<std::size_t>(0UL, lhs[index].indices.size()))
+        {
+            BOOST_CHECK_EQUAL(lhs[index].indices[point] + lhs_offset,
+                              rhs[index].indices[point] + rhs_offset);
+            const auto &lhs_node = lhs[index].nodes[point];
+            const auto &rhs_node = rhs[index].nodes[point];
+            BOOST_CHECK_EQUAL(lhs_node.forward_segment_id.id, rhs_node.forward_segment_id.id);
+            BOOST_CHECK_EQUAL(lhs_node.reverse_segment_id.id, rhs_node.reverse_segment_id.id);
+            BOOST_CHECK(lhs_node.location == rhs_node.location);
+        }
+    }
+}
+
+// The part of the matchings of a trace that a session reports when `new_point` is added: the
+// matchings that reach the point, starting at the last matched point before it
+SubMatchingList getReportedPart(const SubMatchingList &sub_matchings, const std::size_t new_point)
+{
+    SubMatchingList reported;
+    for (const auto &sub_matching : sub_matchings)
+    {
+        if (sub_matching.indices.back() < new_point)
+        {
+            continue;
+        }
+
+        const auto first = std::distance(sub_matching.indices.begin(),
+                                         std::lower_bound(sub_matching.indices.begin(),
+                                                          sub_matching.indices.end(),
+                                                          new_point));
+        BOOST_REQUIRE_GT(first, 0);
+
+        engine::map_matching::SubMatching part;
+        part.indices.assign(sub_matching.indices.begin() + first - 1, sub_matching.indices.end());
+        part.nodes.assign(sub_matching.nodes.begin() + first - 1, sub_matching.nodes.end());
+        reported.push_back(std::move(part));
+    }
+    return reported;
+}
+
+// Feeds the trace point by point to a match session that keeps few points and expires in the
+// middle of the trace. After each point the session reports the same matching as a batch
+// matching of all points of the session so far.
+template <typename Algorithm> void checkSessionMatchesBatch(const std::string &base_path)
+{
+    MatchingFixture<Algorithm> fixture(base_path);
+    const auto trace = get_match_trace_locations();
+
+    const std::size_t max_points = 6;
+    const std::size_t expiry_point = trace.size() / 2;
+    MatchSessionStore store(1, std::chrono::seconds(60));
+    auto now = MatchSessionStore::Clock::time_point{};
+
+    std::size_t session_begin = 0;
+    std::size_t number_of_points = 0;
+    bool shrunk = false;
+    for (const auto point : util::irange<std::size_t>(0UL, trace.size()))
+    {
+        now += std::chrono::seconds(point == expiry_point ? 120 : 1);
+        auto session = store.Get("trace", now);
+        auto &state = session->UseFacade(fixture.facade);
+        if (state.GetNumberOfPoints() == 0)
+        {
+            session_begin = point;
+            number_of_points = 0;
+        }
+
+        state.Shrink(max_points);
+        shrunk = shrunk || state.GetNumberOfPoints() < number_of_points;
+        state.AddPoint(fixture.GetCandidates(trace[point]), trace[point], boost::none, boost::none);
+        ++number_of_points;
+        const auto incremental = mapMatching(fixture.heaps, *fixture.facade, state, true);
+
+        if (point == session_begin)
+        {
+            BOOST_CHECK(incremental.empty());
+            continue;
+        }
+
+        const Locations session_trace(trace.begin() + session_begin, trace.begin() + point + 1);
+        const auto batch = fixture.Match(session_trace);
+        const auto first_kept_point = point + 1 - state.GetNumberOfPoints();
+        checkEqualMatchings(incremental,
+                            first_kept_point,
+                            getReportedPart(batch, point - session_begin),
+                            session_begin);
+    }
+
+    BOOST_CHECK(shrunk);
+    BOOST_CHECK_EQUAL(
+        store.GetMetrics().values.at("expired").get<util::json::Number>().value, 1);
+}
+
+// The network distances of the many-to-many search are floats, check that they pick the same
+// candidates as the point to point searches on a trace with candidates close to each other
+template <typename Algorithm> void checkBoundedSearchMatchesPerPair(const std::string &base_path)
+{
+    MatchingFixture<Algorithm> fixture(base_path);
+    const auto trace = get_match_trace_locations();
+
+    const auto per_pair = fixture.MatchPerPair(trace);
+    const auto sub_matchings = fixture.Match(trace);
+
+    BOOST_REQUIRE_EQUAL(sub_matchings.size(), 1);
+    BOOST_REQUIRE_EQUAL(sub_matchings.front().nodes.size(), per_pair.size());
+    for (const auto point : util::irange<std::size_t>(0UL, per_pair.size()))
+    {
+        const auto &node = sub_matchings.front().nodes[point];
+        BOOST_CHECK_EQUAL(sub_matchings.front().indices[point], point);
+        BOOST_CHECK_EQUAL(node.forward_segment_id.id, per_pair[point].forward_segment_id.id);
+        BOOST_CHECK_EQUAL(node.reverse_segment_id.id, per_pair[point].reverse_segment_id.id);
+        BOOST_CHECK(node.location == per_pair[point].location);
+    }
+}
+}
+
+BOOST_AUTO_TEST_CASE(test_bounded_search_matches_per_pair_ch)
+{
+    checkBoundedSearchMatchesPerPair<ch::Algorithm>(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+}
+
+BOOST_AUTO_TEST_CASE(test_bounded_search_matches_per_pair_mld)
+{
+    checkBoundedSearchMatchesPerPair<mld::Algorithm>(OSRM_TEST_DATA_DIR "/mld/monaco.osrm");
+}
+
+BOOST_AUTO_TEST_CASE(test_bounded_search_matches_per_pair_cch)
+{
+    checkBoundedSearchMatchesPerPair<cch::Algorithm>(OSRM_TEST_DATA_DIR "/mld/monaco.osrm");
+}
+
+BOOST_AUTO_TEST_CASE(test_session_matches_batch_ch)
+{
+    checkSessionMatchesBatch<ch::Algorithm>(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+}
+
+BOOST_AUTO_TEST_CASE(test_session_matches_batch_mld)
+{
+    checkSessionMatchesBatch<mld::Algorithm>(OSRM_TEST_DATA_DIR "/mld/monaco.osrm");
+}
+
+BOOST_AUTO_TEST_CASE(test_session_matches_batch_cch)
+{
+    // the MLD dataset is also customized for CCH
+    checkSessionMatchesBatch<cch::Algorithm>(OSRM_TEST_DATA_DIR "/mld/monaco.osrm");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,97 @@
+#include <boost/filesystem.hpp>
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "coordinates.hpp"
+
+#include "osrm/engine_config.hpp"
+#include "osrm/exception.hpp"
+#include "osrm/json_container.hpp"
+#include "osrm/osrm.hpp"
+#include "osrm/route_parameters.hpp"
+#include "osrm/status.hpp"
+
+BOOST_AUTO_TEST_SUITE(memory_file)
+
+void test_route_from_memory_file(const std::string &base_path,
+                                 osrm::EngineConfig::Algorithm algorithm)
+{
+    using namespace osrm;
+
+    const auto memory_file = boost::filesystem::temp_directory_path() /
+                             boost::filesystem::unique_path("osrm-%%%%-%%%%.mmap");
+
+    EngineConfig config;
+    config.storage_config = {base_path};
+    config.use_shared_memory = false;
+    config.algorithm = algorithm;
+    config.memory_file = memory_file;
+    config.memory_file_advice["all"] = EngineConfig::MemoryAdvice::Random;
+    config.memory_file_advice["R_SEARCH_TREE"] = EngineConfig::MemoryAdvice::Populate;
+
+    RouteParameters params;
+    params.coordinates.push_back(get_dummy_location());
+    params.coordinates.push_back(get_dummy_location());
+
+    // the first instance writes the image, the second one maps the existing image
+    for (auto run = 0; run < 2; ++run)
+    {
+        const OSRM osrm{config};
+        BOOST_CHECK(boost::filesystem::exists(memory_file));
+
+        json::Object result;
+        const auto rc = osrm.Route(params, result);
+        BOOST_CHECK(rc == Status::Ok);
+        BOOST_CHECK_EQUAL(result.values.at("code").get<json::String>().value, "Ok");
+    }
+
+    config.memory_file_advice["NO_SUCH_BLOCK"] = EngineConfig::MemoryAdvice::Random;
+    BOOST_CHECK_THROW(OSRM{config}, osrm::exception);
+
+    boost::filesystem::remove(memory_file);
+}
+
+BOOST_AUTO_TEST_CASE(test_route_from_memory_file_ch)
+{
+    test_route_from_memory_file(OSRM_TEST_DATA_DIR "/ch/monaco.osrm",
+                                osrm::EngineConfig::Algorithm::CH);
+}
+
+BOOST_AUTO_TEST_CASE(test_route_from_memory_file_mld)
+{
+    test_route_from_memory_file(OSRM_TEST_DATA_DIR "/mld/monaco.osrm",
+                                osrm::EngineConfig::Algorithm::MLD);
+}
+
+BOOST_AUTO_TEST_CASE(test_memory_file_of_other_dataset)
+{
+    using namespace osrm;
+
+    const auto memory_file = boost::filesystem::temp_directory_path() /
+                             boost::filesystem::unique_path("osrm-%%%%-%%%%.mmap");
+
+    RouteParameters params;
+    params.coordinates.push_back(get_dummy_location());
+    params.coordinates.push_back(get_dummy_location());
+
+    // the image of the MLD dataset is newer than the files of the CH dataset, but is not used
+    for (const auto algorithm : {EngineConfig::Algorithm::MLD, EngineConfig::Algorithm::CH})
+    {
+        EngineConfig config;
+        config.storage_config = {algorithm == EngineConfig::Algorithm::MLD
+                                     ? OSRM_TEST_DATA_DIR "/mld/monaco.osrm"
+                                     : OSRM_TEST_DATA_DIR "/ch/monaco.osrm"};
+        config.use_shared_memory = false;
+        config.algorithm = algorithm;
+        config.memory_file = memory_file;
+
+        const OSRM osrm{config};
+        json::Object result;
+        BOOST_CHECK(osrm.Route(params, result) == Status::Ok);
+        BOOST_CHECK_EQUAL(result.values.at("code").get<json::String>().value, "Ok");
+    }
+
+    boost::filesystem::remove(memory_file);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
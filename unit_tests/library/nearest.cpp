@@ -12,6 +12,8 @@
 #include "osrm/osrm.hpp"
 #include "osrm/status.hpp"
 
+#include "util/integer_range.hpp"
+
 BOOST_AUTO_TEST_SUITE(nearest)
 
 BOOST_AUTO_TEST_CASE(test_nearest_response)
@@ -113,4 +115,119 @@ BOOST_AUTO_TEST_CASE(test_nearest_response_for_location_in_small_component)
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_nearest_batch_response)
+{
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+
+    using namespace osrm;
+
+    const auto locations = get_locations_in_small_component();
+
+    NearestParameters params;
+    params.batch = true;
+    params.coordinates.push_back(get_dummy_location());
+    params.coordinates.insert(params.coordinates.end(), locations.begin(), locations.end());
+    // the last coordinate is in the sea and not snapped within 100m
+    params.coordinates.push_back({util::FloatLongitude{7.43}, util::FloatLatitude{43.70}});
+    params.radiuses.resize(params.coordinates.size());
+    params.radiuses.back() = 100.;
+
+    json::Object result;
+    const auto rc = osrm.Nearest(params, result);
+    BOOST_REQUIRE(rc == Status::Ok);
+
+    const auto code = result.values.at("code").get<json::String>().value;
+    BOOST_CHECK_EQUAL(code, "Ok");
+
+    const auto &result_locations = result.values.at("locations").get<json::Array>().values;
+    const auto &distances = result.values.at("distances").get<json::Array>().values;
+    const auto &nodes = result.values.at("nodes").get<json::Array>().values;
+    BOOST_REQUIRE_EQUAL(result_locations.size(), params.coordinates.size());
+    BOOST_REQUIRE_EQUAL(distances.size(), params.coordinates.size());
+    BOOST_REQUIRE_EQUAL(nodes.size(), 2 * params.coordinates.size());
+
+    // every result is the same as the one of a single nearest request
+    for (const auto index : util::irange<std::size_t>(0, params.coordinates.size() - 1))
+    {
+        NearestParameters single_params;
+        single_params.coordinates.push_back(params.coordinates[index]);
+        json::Object single_result;
+        BOOST_REQUIRE(osrm.Nearest(single_params, single_result) == Status::Ok);
+        const auto &waypoint = single_result.values.at("waypoints")
+                                   .get<json::Array>()
+                                   .values.front()
+                                   .get<json::Object>();
+
+        BOOST_CHECK_CLOSE(distances[index].get<json::Number>().value,
+                          waypoint.values.at("distance").get<json::Number>().value,
+                          0.0001);
+        const auto &location = result_locations[index].get<json::Array>().values;
+        const auto &single_location = waypoint.values.at("location").get<json::Array>().values;
+        BOOST_CHECK_EQUAL(location[0].get<json::Number>().value,
+                          single_location[0].get<json::Number>().value);
+        BOOST_CHECK_EQUAL(location[1].get<json::Number>().value,
+                          single_location[1].get<json::Number>().value);
+        const auto &single_nodes = waypoint.values.at("nodes").get<json::Array>().values;
+        BOOST_CHECK_EQUAL(nodes[2 * index].get<json::Number>().value,
+                          single_nodes[0].get<json::Number>().value);
+        BOOST_CHECK_EQUAL(nodes[2 * index + 1].get<json::Number>().value,
+                          single_nodes[1].get<json::Number>().value);
+    }
+
+    BOOST_CHECK(distances.back().is<json::Null>());
+    BOOST_CHECK_EQUAL(nodes.back().get<json::Number>().value, 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_nearest_batch_response_cache)
+{
+    using namespace osrm;
+
+    EngineConfig config;
+    config.storage_config = {OSRM_TEST_DATA_DIR "/ch/monaco.osrm"};
+    config.use_shared_memory = false;
+    config.response_cache_size = 1 << 20;
+    const OSRM osrm{config};
+
+    NearestParameters params;
+    params.coordinates.push_back(get_dummy_location());
+    NearestParameters batch_params = params;
+    batch_params.batch = true;
+
+    // the same coordinate is answered as waypoints and as a batch in either order
+    for (const auto repetition : util::irange(0, 2))
+    {
+        (void)repetition;
+
+        json::Object result;
+        BOOST_REQUIRE(osrm.Nearest(params, result) == Status::Ok);
+        BOOST_CHECK(result.values.count("waypoints") == 1);
+        BOOST_CHECK(result.values.count("locations") == 0);
+
+        json::Object batch_result;
+        BOOST_REQUIRE(osrm.Nearest(batch_params, batch_result) == Status::Ok);
+        BOOST_CHECK(batch_result.values.count("waypoints") == 0);
+        BOOST_CHECK(batch_result.values.count("locations") == 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_nearest_batch_invalid_options)
+{
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+
+    using namespace osrm;
+
+    NearestParameters params;
+    params.batch = true;
+    params.coordinates.push_back(get_dummy_location());
+    params.coordinates.push_back(get_dummy_location());
+    params.number_of_results = 2;
+
+    json::Object result;
+    const auto rc = osrm.Nearest(params, result);
+    BOOST_REQUIRE(rc == Status::Error);
+
+    const auto code = result.values.at("code").get<json::String>().value;
+    BOOST_CHECK_EQUAL(code, "InvalidOptions");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -448,4 +448,70 @@ BOOST_AUTO_TEST_CASE(test_manual_setting_of_annotations_property)
     BOOST_CHECK_EQUAL(annotations.size(), 5);
 }
 
+BOOST_AUTO_TEST_CASE(test_route_written_response)
+{
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+
+    using namespace osrm;
+
+    for (const auto geometries : {RouteParameters::GeometriesType::Polyline,
+                                  RouteParameters::GeometriesType::Polyline6,
+                                  RouteParameters::GeometriesType::GeoJSON})
+    {
+        RouteParameters params;
+        params.steps = true;
+        params.annotations = true;
+        params.geometries = geometries;
+        params.overview = RouteParameters::OverviewType::Full;
+        params.coordinates.push_back(get_dummy_location());
+        params.coordinates.push_back(get_dummy_location());
+        params.coordinates.push_back(get_dummy_location());
+
+        json::Object reference;
+        BOOST_CHECK(osrm.Route(params, reference) == Status::Ok);
+
+        engine::api::ResultT result = std::vector<char>();
+        BOOST_CHECK(osrm.Route(params, result) == Status::Ok);
+        CHECK_EQUAL_RENDERED_JSON(reference, result.get<std::vector<char>>());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_route_cch_matches_mld)
+{
+    using namespace osrm;
+
+    // the MLD dataset is also customized for CCH
+    auto mld = getOSRM(OSRM_TEST_DATA_DIR "/mld/monaco.osrm", EngineConfig::Algorithm::MLD);
+    auto cch = getOSRM(OSRM_TEST_DATA_DIR "/mld/monaco.osrm", EngineConfig::Algorithm::CCH);
+
+    auto locations = get_locations_in_big_component();
+    const auto trace = get_split_trace_locations();
+    locations.insert(locations.end(), trace.begin(), trace.end());
+    locations.push_back(get_dummy_location());
+
+    for (const auto &source : locations)
+    {
+        for (const auto &target : locations)
+        {
+            RouteParameters params;
+            params.coordinates = {source, target};
+
+            json::Object mld_result;
+            json::Object cch_result;
+            const auto mld_status = mld.Route(params, mld_result);
+            BOOST_REQUIRE(cch.Route(params, cch_result) == mld_status);
+            if (mld_status != Status::Ok)
+                continue;
+
+            // both find a shortest path, equally short paths may differ in duration
+            const auto &mld_route =
+                mld_result.values["routes"].get<json::Array>().values.at(0).get<json::Object>();
+            const auto &cch_route =
+                cch_result.values["routes"].get<json::Array>().values.at(0).get<json::Object>();
+            BOOST_CHECK_EQUAL(mld_route.values.at("weight").get<json::Number>().value,
+                              cch_route.values.at("weight").get<json::Number>().value);
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -2,6 +2,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include "coordinates.hpp"
+#include "equal_json.hpp"
 #include "fixture.hpp"
 #include "waypoint_check.hpp"
 
@@ -151,6 +152,90 @@ BOOST_AUTO_TEST_CASE(test_table_three_coordinates_matrix)
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_table_durations_and_distances_matrix)
+{
+    using namespace osrm;
+
+    for (const auto algorithm : {std::string("ch"), std::string("mld")})
+    {
+        auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/" + algorithm + "/monaco.osrm",
+                            algorithm == "ch" ? EngineConfig::Algorithm::CH
+                                              : EngineConfig::Algorithm::MLD);
+
+        TableParameters params;
+        params.coordinates = get_locations_in_big_component();
+        params.annotations =
+            TableParameters::AnnotationsType::Duration | TableParameters::AnnotationsType::Distance;
+
+        json::Object result;
+
+        const auto rc = osrm.Table(params, result);
+
+        BOOST_CHECK(rc == Status::Ok);
+        const auto code = result.values.at("code").get<json::String>().value;
+        BOOST_CHECK_EQUAL(code, "Ok");
+
+        const auto &durations_array = result.values.at("durations").get<json::Array>().values;
+        const auto &distances_array = result.values.at("distances").get<json::Array>().values;
+        BOOST_CHECK_EQUAL(durations_array.size(), params.coordinates.size());
+        BOOST_CHECK_EQUAL(distances_array.size(), params.coordinates.size());
+        for (unsigned int i = 0; i < distances_array.size(); i++)
+        {
+            const auto durations_row = durations_array[i].get<json::Array>().values;
+            const auto distances_row = distances_array[i].get<json::Array>().values;
+            BOOST_CHECK_EQUAL(distances_row.size(), params.coordinates.size());
+            for (unsigned int j = 0; j < distances_row.size(); j++)
+            {
+                const auto duration = durations_row[j].get<json::Number>().value;
+                const auto distance = distances_row[j].get<json::Number>().value;
+                if (i == j)
+                {
+                    BOOST_CHECK_EQUAL(distance, 0);
+                }
+                // travelling for some time covers some distance
+                BOOST_CHECK_EQUAL(duration > 0, distance > 0);
+            }
+        }
+
+        // only the requested matrices are returned
+        params.annotations = TableParameters::AnnotationsType::Distance;
+        json::Object distances_only;
+        BOOST_CHECK(osrm.Table(params, distances_only) == Status::Ok);
+        BOOST_CHECK(distances_only.values.count("durations") == 0);
+        BOOST_CHECK(distances_only.values.count("distances") == 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_table_parallel_searches)
+{
+    using namespace osrm;
+
+    for (const auto algorithm : {std::string("ch"), std::string("mld")})
+    {
+        EngineConfig config;
+        config.storage_config = {OSRM_TEST_DATA_DIR "/" + algorithm + "/monaco.osrm"};
+        config.use_shared_memory = false;
+        config.algorithm =
+            algorithm == "ch" ? EngineConfig::Algorithm::CH : EngineConfig::Algorithm::MLD;
+
+        TableParameters params;
+        params.coordinates = get_locations_in_big_component();
+        params.annotations =
+            TableParameters::AnnotationsType::Duration | TableParameters::AnnotationsType::Distance;
+
+        json::Object sequential_result;
+        config.max_threads_distance_table = 1;
+        BOOST_CHECK(OSRM{config}.Table(params, sequential_result) == Status::Ok);
+
+        // rows and columns searched on several threads yield the same matrices
+        json::Object parallel_result;
+        config.max_threads_distance_table = 4;
+        BOOST_CHECK(OSRM{config}.Table(params, parallel_result) == Status::Ok);
+
+        CHECK_EQUAL_JSON(sequential_result, parallel_result);
+    }
+}
+
 // See https://github.com/Project-OSRM/osrm-backend/pull/3992
 BOOST_AUTO_TEST_CASE(test_table_no_segment_for_some_coordinates)
 {
@@ -174,4 +259,59 @@ BOOST_AUTO_TEST_CASE(test_table_no_segment_for_some_coordinates)
     BOOST_CHECK_EQUAL(code, "NoSegment");
 }
 
+BOOST_AUTO_TEST_CASE(test_table_written_response)
+{
+    using namespace osrm;
+
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+
+    TableParameters params;
+    params.coordinates.push_back(get_dummy_location());
+    params.coordinates.push_back(get_dummy_location());
+    params.coordinates.push_back(get_dummy_location());
+    params.sources.push_back(0);
+    params.sources.push_back(2);
+    params.annotations = TableParameters::AnnotationsType::All;
+
+    json::Object reference;
+    BOOST_CHECK(osrm.Table(params, reference) == Status::Ok);
+
+    engine::api::ResultT result = std::vector<char>();
+    BOOST_CHECK(osrm.Table(params, result) == Status::Ok);
+    CHECK_EQUAL_RENDERED_JSON(reference, result.get<std::vector<char>>());
+
+    // errors are written as well
+    params.coordinates.push_back(
+        util::Coordinate{util::FloatLongitude{200.}, util::FloatLatitude{0.}});
+    BOOST_CHECK(osrm.Table(params, result) == Status::Error);
+    CHECK_EQUAL_RENDERED_JSON(
+        (json::Object{{{"code", "InvalidOptions"}, {"message", "Coordinates are invalid"}}}),
+        result.get<std::vector<char>>());
+}
+
+BOOST_AUTO_TEST_CASE(test_table_cbor_response)
+{
+    using namespace osrm;
+
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+
+    TableParameters params;
+    params.coordinates.push_back(get_dummy_location());
+    params.coordinates.push_back(get_dummy_location());
+
+    engine::api::ResultT result = util::cbor::Buffer();
+    BOOST_CHECK(osrm.Table(params, result) == Status::Ok);
+
+    const auto &bytes = result.get<util::cbor::Buffer>().bytes;
+    BOOST_REQUIRE(!bytes.empty());
+    BOOST_CHECK_EQUAL(static_cast<unsigned char>(bytes.front()), 0xbf);
+    BOOST_CHECK_EQUAL(static_cast<unsigned char>(bytes.back()), 0xff);
+
+    // every row of durations is a float64 typed array: tag 86 and a byte string of 2 * 8 bytes
+    const std::string row_header = {static_cast<char>(0xd8), static_cast<char>(86), 0x50};
+    const std::string text(bytes.begin(), bytes.end());
+    BOOST_CHECK(text.find("durations") != std::string::npos);
+    BOOST_CHECK(text.find(row_header) != std::string::npos);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -157,6 +157,15 @@ class MockBaseDataFacade : public engine::datafacade::BaseDataFacade
         return {};
     }
 
+    std::vector<std::vector<engine::PhantomNodeWithDistance>>
+    NearestPhantomNodes(const std::vector<util::Coordinate> & /*input_coordinates*/,
+                        const unsigned /*max_results*/,
+                        const std::vector<boost::optional<double>> & /*max_distances*/,
+                        const std::vector<boost::optional<engine::Approach>> & /*approaches*/) const override
+    {
+        return {};
+    }
+
     std::pair<engine::PhantomNode, engine::PhantomNode>
     NearestPhantomNodeWithAlternativeFromBigComponent(
         const util::Coordinate /*input_coordinate*/,
@@ -218,6 +227,7 @@ class MockBaseDataFacade : public engine::datafacade::BaseDataFacade
     StringView GetExitsForID(const NameID) const override final { return {}; }
 
     std::string GetTimestamp() const override { return ""; }
+    storage::DatasetFingerprint GetDatasetFingerprint() const override { return {0, 0}; }
     bool GetContinueStraightDefault() const override { return true; }
     double GetMapMatchingMaxSpeed() const override { return 180 / 3.6; }
     const char *GetWeightName() const override final { return "duration"; }
@@ -0,0 +1,319 @@
+#include "server/connection.hpp"
+#include "server/api/parsed_url.hpp"
+#include "server/request_handler.hpp"
+#include "server/service_handler.hpp"
+#include "server/worker_pool.hpp"
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/asio.hpp>
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+BOOST_AUTO_TEST_SUITE(connection)
+
+using namespace osrm;
+using namespace osrm::server;
+
+namespace
+{
+// Answers every query with {"code":"Ok"} and counts them
+class CountingServiceHandler final : public ServiceHandlerInterface
+{
+  public:
+    explicit CountingServiceHandler(std::atomic<unsigned> &queries) : queries(queries) {}
+
+    engine::Status RunQuery(api::ParsedURL, service::BaseService::ResultT &result) override
+    {
+        ++queries;
+        result = util::json::Object();
+        result.get<util::json::Object>().values["code"] = "Ok";
+        return engine::Status::Ok;
+    }
+
+    engine::Status
+    UpdateSegmentSpeeds(const std::string &, const std::string &, util::json::Object &) override
+    {
+        return engine::Status::Error;
+    }
+
+  private:
+    std::atomic<unsigned> &queries;
+};
+
+// Accepts a single connection on a local port and serves it on a background thread
+class TestServer
+{
+  public:
+    TestServer(const unsigned keepalive_timeout,
+               const unsigned keepalive_max_requests,
+               const unsigned request_timeout = 30)
+        : TestServer(makeConfig(keepalive_timeout, keepalive_max_requests, request_timeout))
+    {
+    }
+
+    explicit TestServer(const ConnectionConfig &config)
+        : acceptor(io_service,
+                   boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0)),
+          work(io_service), worker_pool(WorkerPoolConfig{})
+    {
+        request_handler.RegisterServiceHandler(std::make_unique<CountingServiceHandler>(queries));
+
+        auto connection =
+            std::make_shared<Connection>(io_service, request_handler, worker_pool, config);
+        acceptor.async_accept(connection->socket(),
+                              [connection](const boost::system::error_code &error) {
+                                  if (!error)
+                                      connection->start();
+                              });
+        thread = std::thread([this] { io_service.run(); });
+    }
+
+    ~TestServer()
+    {
+        io_service.stop();
+        thread.join();
+        worker_pool.Stop();
+    }
+
+    boost::asio::ip::tcp::endpoint endpoint() const { return acceptor.local_endpoint(); }
+
+    std::atomic<unsigned> queries{0};
+
+  private:
+    static ConnectionConfig makeConfig(const unsigned keepalive_timeout,
+                                       const unsigned keepalive_max_requests,
+                                       const unsigned request_timeout)
+    {
+        ConnectionConfig config;
+        config.keepalive_timeout = keepalive_timeout;
+        config.keepalive_max_requests = keepalive_max_requests;
+        config.request_timeout = request_timeout;
+        return config;
+    }
+
+    boost::asio::io_service io_service;
+    boost::asio::ip::tcp::acceptor acceptor;
+    // keeps the I/O thread running while the workers answer a request, like the pending
+    // accept of the server
+    boost::asio::io_service::work work;
+    RequestHandler request_handler;
+    WorkerPool worker_pool;
+    std::thread thread;
+};
+
+class TestClient
+{
+  public:
+    explicit TestClient(const TestServer &server) : socket(io_service)
+    {
+        socket.connect(server.endpoint());
+    }
+
+    void Send(const std::string &requests)
+    {
+        boost::asio::write(socket, boost::asio::buffer(requests));
+    }
+
+    // Reads the header and the body of the next reply, an empty string if the server closed
+    std::string Receive()
+    {
+        boost::system::error_code error;
+        const auto header_size = boost::asio::read_until(socket, buffer, "\r\n\r\n", error);
+        if (error)
+        {
+            return {};
+        }
+
+        std::string reply(boost::asio::buffers_begin(buffer.data()),
+                          boost::asio::buffers_begin(buffer.data()) + header_size);
+        buffer.consume(header_size);
+
+        const std::string length_header = "Content-Length: ";
+        const auto length_begin = reply.find(length_header) + length_header.size();
+        const auto content_length =
+            std::stoul(reply.substr(length_begin, reply.find("\r\n", length_begin)));
+        if (buffer.size() < content_length)
+        {
+            boost::asio::read(
+                socket, buffer, boost::asio::transfer_exactly(content_length - buffer.size()));
+        }
+        reply.append(boost::asio::buffers_begin(buffer.data()),
+                     boost::asio::buffers_begin(buffer.data()) + content_length);
+        buffer.consume(content_length);
+        return reply;
+    }
+
+    bool IsClosed()
+    {
+        boost::system::error_code error;
+        boost::asio::read(socket, buffer, boost::asio::transfer_at_least(1), error);
+        return error == boost::asio::error::eof || error == boost::asio::error::connection_reset;
+    }
+
+  private:
+    boost::asio::io_service io_service;
+    boost::asio::ip::tcp::socket socket;
+    boost::asio::streambuf buffer;
+};
+
+const std::string REQUEST = "GET /route/v1/driving/1,2;3,4 HTTP/1.1\r\nHost: localhost\r\n\r\n";
+const std::string CLOSE_REQUEST =
+    "GET /route/v1/driving/1,2;3,4 HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n";
+}
+
+BOOST_AUTO_TEST_CASE(reuse_kept_alive_connection)
+{
+    TestServer server(5, 512);
+    TestClient client(server);
+
+    client.Send(REQUEST);
+    const auto first = client.Receive();
+    BOOST_CHECK(boost::starts_with(first, "HTTP/1.1 200 OK\r\n"));
+    BOOST_CHECK(boost::contains(first, "Connection: keep-alive\r\n"));
+    BOOST_CHECK(boost::contains(first, "Keep-Alive: timeout=5, max=511\r\n"));
+    BOOST_CHECK(boost::ends_with(first, "{\"code\":\"Ok\"}"));
+
+    client.Send(CLOSE_REQUEST);
+    const auto second = client.Receive();
+    BOOST_CHECK(boost::starts_with(second, "HTTP/1.1 200 OK\r\n"));
+    BOOST_CHECK(boost::contains(second, "Connection: close\r\n"));
+    BOOST_CHECK(client.IsClosed());
+    BOOST_CHECK_EQUAL(server.queries, 2);
+}
+
+BOOST_AUTO_TEST_CASE(close_after_max_requests)
+{
+    TestServer server(5, 2);
+    TestClient client(server);
+
+    client.Send(REQUEST);
+    BOOST_CHECK(boost::contains(client.Receive(), "Connection: keep-alive\r\n"));
+    client.Send(REQUEST);
+    BOOST_CHECK(boost::contains(client.Receive(), "Connection: close\r\n"));
+    BOOST_CHECK(client.IsClosed());
+    BOOST_CHECK_EQUAL(server.queries, 2);
+}
+
+BOOST_AUTO_TEST_CASE(answer_pipelined_requests_in_order)
+{
+    TestServer server(5, 512);
+    TestClient client(server);
+
+    client.Send(REQUEST + "GET /nearest/v1/driving/1,2 HTTP/1.1\r\n\r\n" + CLOSE_REQUEST);
+    BOOST_CHECK(boost::contains(client.Receive(), "Connection: keep-alive\r\n"));
+    BOOST_CHECK(boost::contains(client.Receive(), "Connection: keep-alive\r\n"));
+    BOOST_CHECK(boost::contains(client.Receive(), "Connection: close\r\n"));
+    BOOST_CHECK(client.IsClosed());
+    BOOST_CHECK_EQUAL(server.queries, 3);
+}
+
+BOOST_AUTO_TEST_CASE(zero_timeout_disables_keep_alive)
+{
+    TestServer server(0, 512);
+    TestClient client(server);
+
+    // the first request is answered even though the client is slow to send it
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    client.Send(REQUEST);
+    const auto reply = client.Receive();
+    BOOST_CHECK(boost::starts_with(reply, "HTTP/1.1 200 OK\r\n"));
+    BOOST_CHECK(boost::contains(reply, "Connection: close\r\n"));
+    BOOST_CHECK(client.IsClosed());
+}
+
+BOOST_AUTO_TEST_CASE(close_idle_connection)
+{
+    TestServer server(1, 512);
+    TestClient client(server);
+
+    // waiting for the first request doesn't count as idle
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+    client.Send(REQUEST);
+    BOOST_CHECK(boost::contains(client.Receive(), "Connection: keep-alive\r\n"));
+    BOOST_CHECK(client.IsClosed());
+}
+
+BOOST_AUTO_TEST_CASE(close_silent_connection)
+{
+    TestServer server(5, 512, 1);
+    TestClient client(server);
+
+    BOOST_CHECK(client.IsClosed());
+    BOOST_CHECK_EQUAL(server.queries, 0);
+}
+
+BOOST_AUTO_TEST_CASE(close_incomplete_request)
+{
+    TestServer server(5, 512, 1);
+    TestClient client(server);
+
+    // sending a few bytes at a time doesn't extend the deadline
+    client.Send("GET /route/v1/driving/1,2;3,4 HTTP/1.1\r\n");
+    std::this_thread::sleep_for(std::chrono::milliseconds(400));
+    client.Send("Host: localhost\r\n");
+    std::this_thread::sleep_for(std::chrono::milliseconds(400));
+    client.Send("Accept: */*\r\n");
+    BOOST_CHECK(client.IsClosed());
+    BOOST_CHECK_EQUAL(server.queries, 0);
+}
+
+BOOST_AUTO_TEST_CASE(request_timeout_starts_with_the_next_request)
+{
+    TestServer server(5, 512, 1);
+    TestClient client(server);
+
+    client.Send(REQUEST);
+    BOOST_CHECK(boost::contains(client.Receive(), "Connection: keep-alive\r\n"));
+    // idling on a kept-alive connection is limited by the keep-alive timeout
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+    client.Send(CLOSE_REQUEST);
+    BOOST_CHECK(boost::contains(client.Receive(), "Connection: close\r\n"));
+    BOOST_CHECK_EQUAL(server.queries, 2);
+}
+
+BOOST_AUTO_TEST_CASE(reject_body_on_route_without_body)
+{
+    TestServer server(5, 512);
+    TestClient client(server);
+
+    client.Send("POST /route/v1/driving HTTP/1.1\r\nContent-Length: 7\r\n\r\n1,2;3,4");
+    const auto reply = client.Receive();
+    BOOST_CHECK(boost::starts_with(reply, "HTTP/1.1 413 Payload Too Large\r\n"));
+    BOOST_CHECK(boost::contains(reply, "Connection: close\r\n"));
+    BOOST_CHECK(client.IsClosed());
+    BOOST_CHECK_EQUAL(server.queries, 0);
+}
+
+BOOST_AUTO_TEST_CASE(answer_updates_only_where_accepted)
+{
+    ConnectionConfig query_config;
+    query_config.accept_updates = false;
+    TestServer query_server(query_config);
+    TestClient query_client(query_server);
+
+    query_client.Send("POST /update HTTP/1.1\r\n\r\n" + REQUEST);
+    BOOST_CHECK(boost::starts_with(query_client.Receive(), "HTTP/1.1 404 Not Found\r\n"));
+    BOOST_CHECK(boost::starts_with(query_client.Receive(), "HTTP/1.1 200 OK\r\n"));
+    BOOST_CHECK_EQUAL(query_server.queries, 1);
+
+    ConnectionConfig update_config;
+    update_config.accept_queries = false;
+    TestServer update_server(update_config);
+    TestClient update_client(update_server);
+
+    update_client.Send(REQUEST + "GET /metrics HTTP/1.1\r\n\r\n" +
+                       "POST /update HTTP/1.1\r\nContent-Length: 7\r\n\r\n1,2,10\n");
+    BOOST_CHECK(boost::starts_with(update_client.Receive(), "HTTP/1.1 404 Not Found\r\n"));
+    BOOST_CHECK(boost::starts_with(update_client.Receive(), "HTTP/1.1 404 Not Found\r\n"));
+    // the handler rejects the speeds, but the update reaches it
+    BOOST_CHECK(boost::starts_with(update_client.Receive(), "HTTP/1.1 400 Bad Request\r\n"));
+    BOOST_CHECK_EQUAL(update_server.queries, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
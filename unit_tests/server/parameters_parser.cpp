@@ -84,6 +84,28 @@ BOOST_AUTO_TEST_CASE(invalid_table_urls)
         testInvalidOptions<TableParameters>("1,2;3,4?sources=1&destinations=1&bla=foo"), 32UL);
     BOOST_CHECK_EQUAL(testInvalidOptions<TableParameters>("1,2;3,4?sources=foo"), 16UL);
     BOOST_CHECK_EQUAL(testInvalidOptions<TableParameters>("1,2;3,4?destinations=foo"), 21UL);
+    BOOST_CHECK_EQUAL(testInvalidOptions<TableParameters>("1,2;3,4?annotations=speed"), 20UL);
+}
+
+BOOST_AUTO_TEST_CASE(format_suffix)
+{
+    using OutputFormatType = BaseParameters::OutputFormatType;
+
+    const auto parse = [](std::string options) {
+        auto iter = options.begin();
+        const auto result = parseParameters<TableParameters>(iter, options.end());
+        BOOST_CHECK(result);
+        BOOST_CHECK(iter == options.end());
+        return result ? result->format : boost::none;
+    };
+
+    BOOST_CHECK(!parse("1,2;3,4"));
+    BOOST_CHECK(parse("1,2;3,4.json") == OutputFormatType::JSON);
+    BOOST_CHECK(parse("1,2;3,4.cbor") == OutputFormatType::CBOR);
+    BOOST_CHECK(parse("1,2;3,4.5.cbor?sources=0") == OutputFormatType::CBOR);
+    BOOST_CHECK(parse("polyline(_ibE_seK_seK_seK).cbor") == OutputFormatType::CBOR);
+
+    BOOST_CHECK_EQUAL(testInvalidOptions<TableParameters>("1,2;3,4.xml"), 8UL);
 }
 
 BOOST_AUTO_TEST_CASE(valid_route_hint)
@@ -528,6 +550,18 @@ BOOST_AUTO_TEST_CASE(valid_table_urls)
     CHECK_EQUAL_RANGE(reference_1.radiuses, result_3->radiuses);
     CHECK_EQUAL_RANGE(reference_1.approaches, result_3->approaches);
     CHECK_EQUAL_RANGE(reference_1.coordinates, result_3->coordinates);
+    BOOST_CHECK(result_3->annotations == TableParameters::AnnotationsType::Duration);
+
+    auto result_4 = parseParameters<TableParameters>("1,2;3,4?annotations=duration,distance");
+    BOOST_CHECK(result_4);
+    BOOST_CHECK(result_4->annotations == TableParameters::AnnotationsType::All);
+    CHECK_EQUAL_RANGE(reference_1.coordinates, result_4->coordinates);
+
+    std::vector<std::size_t> sources_5 = {1};
+    auto result_5 = parseParameters<TableParameters>("1,2;3,4?sources=1&annotations=distance");
+    BOOST_CHECK(result_5);
+    BOOST_CHECK(result_5->annotations == TableParameters::AnnotationsType::Distance);
+    CHECK_EQUAL_RANGE(sources_5, result_5->sources);
 }
 
 BOOST_AUTO_TEST_CASE(valid_match_urls)
@@ -571,6 +605,18 @@ BOOST_AUTO_TEST_CASE(valid_match_urls)
     CHECK_EQUAL_RANGE(reference_3.radiuses, result_3->radiuses);
     CHECK_EQUAL_RANGE(reference_3.approaches, result_3->approaches);
     CHECK_EQUAL_RANGE(reference_3.coordinates, result_3->coordinates);
+
+    // a session can be extended by a single coordinate
+    auto result_4 = parseParameters<MatchParameters>("1,2?session=vehicle_42-a&timestamps=5");
+    BOOST_CHECK(result_4);
+    BOOST_CHECK_EQUAL(result_4->session, "vehicle_42-a");
+    BOOST_CHECK_EQUAL(result_4->coordinates.size(), 1);
+    BOOST_CHECK(result_4->IsValid());
+
+    auto result_5 = parseParameters<MatchParameters>("1,2");
+    BOOST_CHECK(result_5);
+    BOOST_CHECK(result_5->session.empty());
+    BOOST_CHECK(!result_5->IsValid());
 }
 
 BOOST_AUTO_TEST_CASE(invalid_match_urls)
@@ -596,6 +642,8 @@ BOOST_AUTO_TEST_CASE(invalid_match_urls)
     BOOST_CHECK_EQUAL(testInvalidOptions<MatchParameters>("1,2;3,4?waypoints=0,4"), 19UL);
     BOOST_CHECK_EQUAL(testInvalidOptions<MatchParameters>("1,2;3,4?waypoints=x;4"), 18UL);
     BOOST_CHECK_EQUAL(testInvalidOptions<MatchParameters>("1,2;3,4?waypoints=0;3.5"), 21UL);
+    BOOST_CHECK_EQUAL(testInvalidOptions<MatchParameters>("1,2;3,4?session="), 16UL);
+    BOOST_CHECK_EQUAL(testInvalidOptions<MatchParameters>("1,2;3,4?session=a/b"), 17UL);
 }
 
 BOOST_AUTO_TEST_CASE(valid_nearest_urls)
@@ -622,6 +670,12 @@ BOOST_AUTO_TEST_CASE(valid_nearest_urls)
     CHECK_EQUAL_RANGE(reference_2.radiuses, result_2->radiuses);
     CHECK_EQUAL_RANGE(reference_2.approaches, result_2->approaches);
     CHECK_EQUAL_RANGE(reference_2.coordinates, result_2->coordinates);
+
+    auto result_3 = parseParameters<NearestParameters>("1,2;3,4?batch=true");
+    BOOST_CHECK(result_3);
+    BOOST_CHECK(result_3->batch);
+    BOOST_CHECK_EQUAL(result_3->coordinates.size(), 2);
+    BOOST_CHECK(!result_1->batch);
 }
 
 BOOST_AUTO_TEST_CASE(invalid_tile_urls)
@@ -0,0 +1,171 @@
+#include "server/request_parser.hpp"
+#include "server/http/request.hpp"
+
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(request_parser)
+
+using namespace osrm;
+using namespace osrm::server;
+
+BOOST_AUTO_TEST_CASE(parse_http_version_and_connection)
+{
+    std::string input = "GET /route/v1/driving/1,2;3,4 HTTP/1.1\r\n"
+                        "Connection: keep-alive\r\n"
+                        "\r\n";
+
+    RequestParser parser;
+    http::request request;
+    RequestParser::RequestStatus status;
+    http::compression_type compression;
+    char *parsed_end;
+    std::tie(status, compression, parsed_end) =
+        parser.parse(request, &input[0], &input[0] + input.size());
+
+    BOOST_CHECK(status == RequestParser::RequestStatus::valid);
+    BOOST_CHECK(compression == http::no_compression);
+    BOOST_CHECK(parsed_end == &input[0] + input.size());
+    BOOST_CHECK_EQUAL(request.uri, "/route/v1/driving/1,2;3,4");
+    BOOST_CHECK_EQUAL(request.connection, "keep-alive");
+    BOOST_CHECK_EQUAL(request.http_version_major, 1);
+    BOOST_CHECK_EQUAL(request.http_version_minor, 1);
+}
+
+BOOST_AUTO_TEST_CASE(parse_pipelined_requests)
+{
+    const std::string first = "GET /nearest/v1/driving/1,2 HTTP/1.1\r\n"
+                              "Accept-Encoding: gzip\r\n"
+                              "\r\n";
+    const std::string second = "GET /nearest/v1/driving/3,4 HTTP/1.0\r\n"
+                               "Connection: close\r\n"
+                               "\r\n";
+    std::string input = first + second;
+    char *begin = &input[0];
+    char *end = begin + input.size();
+
+    RequestParser::RequestStatus status;
+    http::compression_type compression;
+    char *parsed_end;
+
+    RequestParser first_parser;
+    http::request first_request;
+    std::tie(status, compression, parsed_end) = first_parser.parse(first_request, begin, end);
+    BOOST_CHECK(status == RequestParser::RequestStatus::valid);
+    BOOST_CHECK(compression == http::gzip_rfc1952);
+    BOOST_CHECK(parsed_end == begin + first.size());
+    BOOST_CHECK_EQUAL(first_request.uri, "/nearest/v1/driving/1,2");
+    BOOST_CHECK_EQUAL(first_request.connection, "");
+
+    RequestParser second_parser;
+    http::request second_request;
+    std::tie(status, compression, parsed_end) =
+        second_parser.parse(second_request, parsed_end, end);
+    BOOST_CHECK(status == RequestParser::RequestStatus::valid);
+    BOOST_CHECK(compression == http::no_compression);
+    BOOST_CHECK(parsed_end == end);
+    BOOST_CHECK_EQUAL(second_request.uri, "/nearest/v1/driving/3,4");
+    BOOST_CHECK_EQUAL(second_request.connection, "close");
+    BOOST_CHECK_EQUAL(second_request.http_version_major, 1);
+    BOOST_CHECK_EQUAL(second_request.http_version_minor, 0);
+}
+
+BOOST_AUTO_TEST_CASE(parse_incomplete_request)
+{
+    std::string input = "GET /nearest/v1/driving/1,2 HTTP/1.1\r\n";
+
+    RequestParser parser;
+    http::request request;
+    RequestParser::RequestStatus status;
+    http::compression_type compression;
+    char *parsed_end;
+    std::tie(status, compression, parsed_end) =
+        parser.parse(request, &input[0], &input[0] + input.size());
+
+    BOOST_CHECK(status == RequestParser::RequestStatus::indeterminate);
+    BOOST_CHECK(parsed_end == &input[0] + input.size());
+}
+
+BOOST_AUTO_TEST_CASE(parse_post_body)
+{
+    const std::string head = "POST /update HTTP/1.1\r\n"
+                             "Content-Length: 14\r\n"
+                             "\r\n"
+                             "1,2,10\n";
+    const std::string tail = "2,1,10\n";
+    std::string input = head + tail;
+    char *begin = &input[0];
+    char *end = begin + input.size();
+
+    RequestParser parser;
+    http::request request;
+    RequestParser::RequestStatus status;
+    http::compression_type compression;
+    char *parsed_end;
+
+    std::tie(status, compression, parsed_end) = parser.parse(request, begin, begin + head.size());
+    BOOST_CHECK(status == RequestParser::RequestStatus::indeterminate);
+    BOOST_CHECK(parsed_end == begin + head.size());
+
+    std::tie(status, compression, parsed_end) = parser.parse(request, parsed_end, end);
+    BOOST_CHECK(status == RequestParser::RequestStatus::valid);
+    BOOST_CHECK(parsed_end == end);
+    BOOST_CHECK_EQUAL(request.method, "POST");
+    BOOST_CHECK_EQUAL(request.uri, "/update");
+    BOOST_CHECK_EQUAL(request.body, "1,2,10\n2,1,10\n");
+}
+
+BOOST_AUTO_TEST_CASE(parse_invalid_content_length)
+{
+    for (const std::string length : {"12a", "", "99999999999"})
+    {
+        std::string input = "POST /update HTTP/1.1\r\nContent-Length: " + length + "\r\n\r\n";
+
+        RequestParser parser;
+        http::request request;
+        RequestParser::RequestStatus status;
+        http::compression_type compression;
+        char *parsed_end;
+        std::tie(status, compression, parsed_end) =
+            parser.parse(request, &input[0], &input[0] + input.size());
+
+        BOOST_CHECK(status == RequestParser::RequestStatus::invalid);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(reject_unexpected_or_large_body)
+{
+    const auto parse_headers = [](const std::string &uri,
+                                  const std::size_t length,
+                                  const bool accept_updates = true) {
+        std::string input =
+            "POST " + uri + " HTTP/1.1\r\nContent-Length: " + std::to_string(length) + "\r\n\r\n";
+
+        RequestParser parser(1024, accept_updates);
+        http::request request;
+        RequestParser::RequestStatus status;
+        http::compression_type compression;
+        char *parsed_end;
+        std::tie(status, compression, parsed_end) =
+            parser.parse(request, &input[0], &input[0] + input.size());
+        BOOST_CHECK(request.body.empty());
+        return status;
+    };
+
+    BOOST_CHECK(parse_headers("/update", 1024) == RequestParser::RequestStatus::indeterminate);
+    BOOST_CHECK(parse_headers("/update/berlin", 1024) ==
+                RequestParser::RequestStatus::indeterminate);
+    BOOST_CHECK(parse_headers("/nearest/v1/driving?batch=true", 10) ==
+                RequestParser::RequestStatus::indeterminate);
+
+    BOOST_CHECK(parse_headers("/update", 1025) == RequestParser::RequestStatus::too_large);
+    BOOST_CHECK(parse_headers("/nearest/v1/driving", 4000000000) ==
+                RequestParser::RequestStatus::too_large);
+    BOOST_CHECK(parse_headers("/route/v1/driving", 10) == RequestParser::RequestStatus::too_large);
+    BOOST_CHECK(parse_headers("/updates", 10) == RequestParser::RequestStatus::too_large);
+    BOOST_CHECK(parse_headers("/update", 10, false) == RequestParser::RequestStatus::too_large);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,89 @@
+#include "server/worker_pool.hpp"
+
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <condition_variable>
+#include <future>
+#include <mutex>
+
+BOOST_AUTO_TEST_SUITE(worker_pool)
+
+using namespace osrm;
+using namespace osrm::server;
+
+// Blocks the workers that run it until released
+struct Gate
+{
+    void Wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        opened.wait(lock, [&] { return is_open; });
+    }
+
+    void Open()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            is_open = true;
+        }
+        opened.notify_all();
+    }
+
+    std::mutex mutex;
+    std::condition_variable opened;
+    bool is_open = false;
+};
+
+BOOST_AUTO_TEST_CASE(reject_when_queue_full)
+{
+    WorkerPoolConfig config;
+    config.num_threads = 1;
+    config.max_queue_size = 2;
+    // declared before the pool so they outlive its workers
+    Gate gate;
+    std::promise<void> started;
+    WorkerPool pool(config);
+
+    BOOST_CHECK(pool.Post("route", [&] {
+        started.set_value();
+        gate.Wait();
+    }));
+    // make sure the only worker is busy so the following tasks stay queued
+    started.get_future().wait();
+
+    BOOST_CHECK(pool.Post("route", [] {}));
+    BOOST_CHECK(pool.Post("route", [] {}));
+    BOOST_CHECK(!pool.Post("route", [] {}));
+
+    const auto metrics = pool.GetMetrics();
+    const auto &queue = metrics.values.at("queues")
+                            .get<util::json::Object>()
+                            .values.at("default")
+                            .get<util::json::Object>();
+    BOOST_CHECK_EQUAL(queue.values.at("queue_depth").get<util::json::Number>().value, 2);
+    BOOST_CHECK_EQUAL(queue.values.at("rejected").get<util::json::Number>().value, 1);
+
+    gate.Open();
+}
+
+BOOST_AUTO_TEST_CASE(service_queue_not_blocked_by_default_queue)
+{
+    WorkerPoolConfig config;
+    config.num_threads = 1;
+    config.max_queue_size = 10;
+    config.service_threads["nearest"] = 1;
+    Gate gate;
+    std::promise<void> nearest_done;
+    WorkerPool pool(config);
+
+    BOOST_CHECK(pool.Post("table", [&] { gate.Wait(); }));
+
+    BOOST_CHECK(pool.Post("nearest", [&] { nearest_done.set_value(); }));
+    BOOST_CHECK(nearest_done.get_future().wait_for(std::chrono::seconds(10)) ==
+                std::future_status::ready);
+
+    gate.Open();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
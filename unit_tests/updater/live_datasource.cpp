@@ -0,0 +1,41 @@
+#include "updater/metric_updater.hpp"
+
+#include "extractor/datasources.hpp"
+#include "util/exception.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(live_datasource)
+
+using namespace osrm;
+
+BOOST_AUTO_TEST_CASE(live_datasource_follows_dataset_sources)
+{
+    auto datasources = std::make_unique<extractor::Datasources>();
+    datasources->SetSourceName(0, "lua profile");
+    datasources->SetSourceName(1, "speeds.csv");
+
+    BOOST_CHECK_EQUAL(updater::getLiveDatasource(*datasources), 2);
+    BOOST_CHECK_EQUAL(datasources->GetSourceName(2), updater::LIVE_DATASOURCE_NAME);
+    BOOST_CHECK_EQUAL(datasources->GetSourceName(1), "speeds.csv");
+
+    // later updates reuse the datasource
+    BOOST_CHECK_EQUAL(updater::getLiveDatasource(*datasources), 2);
+    BOOST_CHECK(datasources->GetSourceName(3).empty());
+}
+
+BOOST_AUTO_TEST_CASE(live_datasource_needs_a_free_source)
+{
+    auto datasources = std::make_unique<extractor::Datasources>();
+    for (unsigned id = 0; id < extractor::Datasources::MAX_NUM_SOURES; ++id)
+    {
+        datasources->SetSourceName(id, "speeds_" + std::to_string(id) + ".csv");
+    }
+
+    BOOST_CHECK_THROW(updater::getLiveDatasource(*datasources), util::exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,114 @@
+#include "util/cbor_writer.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(cbor_writer)
+
+using namespace osrm;
+using namespace osrm::util;
+
+namespace
+{
+std::vector<std::uint8_t> toBytes(const std::vector<char> &buffer)
+{
+    return std::vector<std::uint8_t>(buffer.begin(), buffer.end());
+}
+}
+
+BOOST_AUTO_TEST_CASE(scalar_values)
+{
+    std::vector<char> written;
+    cbor::Writer writer(written);
+    writer.Number(10);
+    writer.Number(500);
+    writer.Number(-1);
+    writer.Number(1.5);
+    writer.String("Ok");
+    writer.Bool(true);
+    writer.Null();
+
+    const std::vector<std::uint8_t> expected = {
+        0x0a,                                                 // 10
+        0x19, 0x01, 0xf4,                                     // 500
+        0x20,                                                 // -1
+        0xfb, 0x3f, 0xf8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 1.5
+        0x62, 'O',  'k',                                      // "Ok"
+        0xf5,                                                 // true
+        0xf6                                                  // null
+    };
+    const auto bytes = toBytes(written);
+    BOOST_CHECK_EQUAL_COLLECTIONS(bytes.begin(), bytes.end(), expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(containers_and_trees)
+{
+    json::Array coordinate;
+    coordinate.values.push_back(json::Number{7});
+    coordinate.values.push_back(json::Number{43});
+
+    std::vector<char> written;
+    cbor::Writer writer(written);
+    writer.StartObject();
+    writer.Key("location");
+    writer.Value(coordinate);
+    writer.Key("waypoints");
+    writer.StartArray();
+    writer.EndArray();
+    writer.EndObject();
+
+    const std::vector<std::uint8_t> expected = {
+        0xbf,                                                // object of indefinite length
+        0x68, 'l', 'o', 'c', 'a', 't', 'i', 'o', 'n',        // "location"
+        0x82, 0x07, 0x18, 0x2b,                              // [7, 43]
+        0x69, 'w', 'a', 'y', 'p', 'o', 'i', 'n', 't', 's',   // "waypoints"
+        0x9f, 0xff,                                          // []
+        0xff};
+    const auto bytes = toBytes(written);
+    BOOST_CHECK_EQUAL_COLLECTIONS(bytes.begin(), bytes.end(), expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(typed_arrays)
+{
+    const std::vector<double> durations = {1.0, std::numeric_limits<double>::quiet_NaN()};
+    const std::vector<std::uint64_t> nodes = {1, 258};
+
+    std::vector<char> written;
+    cbor::Writer writer(written);
+    writer.NumberArray(durations.begin(), durations.end(), [](const double value) {
+        return value;
+    });
+    writer.IntegerArray(nodes.begin(), nodes.end(), [](const std::uint64_t value) {
+        return value;
+    });
+
+    const auto bytes = toBytes(written);
+    BOOST_REQUIRE_EQUAL(bytes.size(), 2 * (3 + 16));
+
+    // tag 86 and a byte string of 16 bytes: two little endian float64
+    BOOST_CHECK_EQUAL(bytes[0], 0xd8);
+    BOOST_CHECK_EQUAL(bytes[1], 86);
+    BOOST_CHECK_EQUAL(bytes[2], 0x50);
+    double first, second;
+    std::memcpy(&first, written.data() + 3, sizeof(first));
+    std::memcpy(&second, written.data() + 11, sizeof(second));
+    BOOST_CHECK_EQUAL(first, 1.0);
+    BOOST_CHECK(std::isnan(second));
+
+    // tag 71 and a byte string of 16 bytes: two little endian uint64
+    BOOST_CHECK_EQUAL(bytes[19], 0xd8);
+    BOOST_CHECK_EQUAL(bytes[20], 71);
+    BOOST_CHECK_EQUAL(bytes[21], 0x50);
+    const std::vector<std::uint8_t> expected_nodes = {
+        0x01, 0, 0, 0, 0, 0, 0, 0, 0x02, 0x01, 0, 0, 0, 0, 0, 0};
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+        bytes.begin() + 22, bytes.end(), expected_nodes.begin(), expected_nodes.end());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,89 @@
+#include "util/json_renderer.hpp"
+#include "util/json_writer.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(json_writer)
+
+using namespace osrm;
+using namespace osrm::util;
+
+namespace
+{
+std::string toString(const std::vector<char> &buffer)
+{
+    return std::string(buffer.begin(), buffer.end());
+}
+}
+
+BOOST_AUTO_TEST_CASE(same_output_as_renderer)
+{
+    // objects with a single key only, the order of keys in an Object is unspecified
+    json::Array inner;
+    inner.values.push_back(json::Number{1.5});
+    inner.values.push_back(json::Number{0.1234567});
+    inner.values.push_back(json::Null());
+    inner.values.push_back(json::True());
+    inner.values.push_back(json::False());
+    inner.values.push_back(json::String{"Aleja \"Solidarnosci\""});
+    json::Object nested;
+    nested.values["empty"] = json::Array();
+    inner.values.push_back(nested);
+    json::Object object;
+    object.values["values"] = inner;
+
+    std::vector<char> rendered;
+    json::render(rendered, object);
+
+    std::vector<char> written;
+    json::Writer writer(written);
+    writer.StartObject();
+    writer.Key("values");
+    writer.StartArray();
+    writer.Number(1.5);
+    writer.Number(0.1234567);
+    writer.Null();
+    writer.Bool(true);
+    writer.Bool(false);
+    writer.String("Aleja \"Solidarnosci\"");
+    writer.StartObject();
+    writer.Key("empty");
+    writer.StartArray();
+    writer.EndArray();
+    writer.EndObject();
+    writer.EndArray();
+    writer.EndObject();
+
+    BOOST_CHECK_EQUAL(toString(written), toString(rendered));
+}
+
+BOOST_AUTO_TEST_CASE(separate_keys_and_values)
+{
+    json::Array coordinate;
+    coordinate.values.push_back(json::Number{7.41});
+    coordinate.values.push_back(json::Number{43.73});
+
+    std::vector<char> written;
+    json::Writer writer(written);
+    writer.StartObject();
+    writer.Key("code");
+    writer.String("Ok");
+    writer.Key("location");
+    writer.Value(coordinate);
+    writer.Key("waypoints");
+    writer.StartArray();
+    writer.Value(coordinate);
+    writer.Value(coordinate);
+    writer.EndArray();
+    writer.EndObject();
+
+    BOOST_CHECK_EQUAL(toString(written),
+                      "{\"code\":\"Ok\",\"location\":[7.41,43.73],"
+                      "\"waypoints\":[[7.41,43.73],[7.41,43.73]]}");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -23,9 +23,18 @@ struct TestData
 typedef NodeID TestNodeID;
 typedef int TestKey;
 typedef int TestWeight;
+// keeps the lower half of the IDs in the array and the upper half in the hash map
+struct HalfDenseStorage : TwoLevelStorage<TestNodeID, TestKey>
+{
+    explicit HalfDenseStorage(std::size_t size) : TwoLevelStorage(size, size / 2) {}
+};
+
 typedef boost::mpl::list<ArrayStorage<TestNodeID, TestKey>,
                          MapStorage<TestNodeID, TestKey>,
-                         UnorderedMapStorage<TestNodeID, TestKey>>
+                         UnorderedMapStorage<TestNodeID, TestKey>,
+                         GenerationArrayStorage<TestNodeID, TestKey>,
+                         TwoLevelStorage<TestNodeID, TestKey>,
+                         HalfDenseStorage>
     storage_types;
 
 template <unsigned NUM_ELEM> struct RandomDataFixture
@@ -123,6 +132,30 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(delete_all_test, T, storage_types, RandomDataFi
     BOOST_CHECK(heap.Empty());
 }
 
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(clear_test, T, storage_types, RandomDataFixture<NUM_NODES>)
+{
+    QueryHeap<TestNodeID, TestKey, TestWeight, TestData, T> heap(NUM_NODES);
+
+    for (unsigned idx : order)
+    {
+        heap.Insert(ids[idx], weights[idx], data[idx]);
+    }
+
+    heap.Clear();
+
+    BOOST_CHECK(heap.Empty());
+    for (auto id : ids)
+    {
+        BOOST_CHECK(!heap.WasInserted(id));
+    }
+
+    // re-use the heap like the engine does for consecutive queries
+    heap.Insert(ids.back(), weights.back(), data.back());
+    BOOST_CHECK(heap.WasInserted(ids.back()));
+    BOOST_CHECK(!heap.WasInserted(ids.front()));
+    BOOST_CHECK_EQUAL(heap.GetData(ids.back()).value, data.back().value);
+}
+
 BOOST_FIXTURE_TEST_CASE_TEMPLATE(decrease_key_test, T, storage_types, RandomDataFixture<10>)
 {
     QueryHeap<TestNodeID, TestKey, TestWeight, TestData, T> heap(10);
@@ -0,0 +1,79 @@
+#include "util/sharded_lru_cache.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(sharded_lru_cache)
+
+using namespace osrm;
+using namespace osrm::util;
+
+namespace
+{
+// Puts every key into the same shard
+struct SameShardHash
+{
+    std::size_t operator()(const int key) const { return static_cast<std::size_t>(key) & 0xffff; }
+};
+
+struct StringSize
+{
+    std::size_t operator()(const std::string &value) const { return value.size(); }
+};
+}
+
+BOOST_AUTO_TEST_CASE(evict_least_recently_used)
+{
+    // two entries per shard
+    ShardedLRUCache<int, int, SameShardHash> cache(2 * ShardedLRUCache<int, int>::NUMBER_OF_SHARDS);
+
+    cache.Put(1, 10);
+    cache.Put(2, 20);
+    int value = 0;
+    BOOST_CHECK(cache.Get(1, value));
+    BOOST_CHECK_EQUAL(value, 10);
+
+    // 2 is the least recently used entry
+    cache.Put(3, 30);
+    BOOST_CHECK(!cache.Get(2, value));
+    BOOST_CHECK(cache.Get(1, value));
+    BOOST_CHECK(cache.Get(3, value));
+    BOOST_CHECK_EQUAL(value, 30);
+
+    // an existing value is kept
+    cache.Put(3, 31);
+    BOOST_CHECK(cache.Get(3, value));
+    BOOST_CHECK_EQUAL(value, 30);
+
+    BOOST_CHECK_EQUAL(cache.GetNumberOfEntries(), 2);
+    BOOST_CHECK_EQUAL(cache.GetSize(), 2);
+    BOOST_CHECK_EQUAL(cache.GetHits(), 4);
+    BOOST_CHECK_EQUAL(cache.GetMisses(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(evict_by_size)
+{
+    // ten characters per shard
+    ShardedLRUCache<int, std::string, SameShardHash, StringSize> cache(
+        10 * ShardedLRUCache<int, std::string>::NUMBER_OF_SHARDS);
+
+    cache.Put(1, "abcd");
+    cache.Put(2, "efgh");
+    BOOST_CHECK_EQUAL(cache.GetSize(), 8);
+
+    // doesn't fit into a shard at all
+    cache.Put(3, "too long to be cached");
+    BOOST_CHECK_EQUAL(cache.GetNumberOfEntries(), 2);
+
+    // evicts both entries
+    cache.Put(4, "ijklmnop");
+    std::string value;
+    BOOST_CHECK(!cache.Get(1, value));
+    BOOST_CHECK(!cache.Get(2, value));
+    BOOST_CHECK(cache.Get(4, value));
+    BOOST_CHECK_EQUAL(value, "ijklmnop");
+    BOOST_CHECK_EQUAL(cache.GetSize(), 8);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -444,6 +444,188 @@ BOOST_AUTO_TEST_CASE(bearing_tests)
     }
 }
 
+BOOST_AUTO_TEST_CASE(cached_bearing_tests)
+{
+    using Coord = std::pair<FloatLongitude, FloatLatitude>;
+    using Edge = std::pair<unsigned, unsigned>;
+    GraphFixture fixture(
+        {
+            Coord(FloatLongitude{0.0}, FloatLatitude{0.0}),
+            Coord(FloatLongitude{10.0}, FloatLatitude{10.0}),
+        },
+        {Edge(0, 1), Edge(1, 0)});
+
+    std::string leaves_path;
+    std::string nodes_path;
+    build_rtree<GraphFixture, MiniStaticRTree>(
+        "test_cached_bearing", &fixture, leaves_path, nodes_path);
+    MiniStaticRTree rtree(nodes_path, leaves_path, fixture.coords);
+    TestDataFacade mockfacade;
+    engine::PhantomNodeCache cache(64);
+    engine::GeospatialQuery<MiniStaticRTree, TestDataFacade> query(
+        rtree, fixture.coords, mockfacade, &cache);
+
+    Coordinate input(FloatLongitude{5.1}, FloatLatitude{5.0});
+
+    // the second run of every query is answered from the cache
+    for (auto run = 0; run < 2; ++run)
+    {
+        {
+            auto results =
+                query.NearestPhantomNodes(input, 5, osrm::engine::Approach::UNRESTRICTED);
+            BOOST_CHECK_EQUAL(results.size(), 2);
+            BOOST_CHECK_EQUAL(results.back().phantom_node.forward_segment_id.id, 0);
+            BOOST_CHECK_EQUAL(results.back().phantom_node.reverse_segment_id.id, 1);
+        }
+
+        {
+            auto results =
+                query.NearestPhantomNodes(input, 5, 270, 10, osrm::engine::Approach::UNRESTRICTED);
+            BOOST_CHECK_EQUAL(results.size(), 0);
+        }
+
+        {
+            auto results =
+                query.NearestPhantomNodes(input, 5, 45, 10, osrm::engine::Approach::UNRESTRICTED);
+            BOOST_CHECK_EQUAL(results.size(), 2);
+            BOOST_CHECK(results[0].phantom_node.forward_segment_id.enabled);
+            BOOST_CHECK(!results[0].phantom_node.reverse_segment_id.enabled);
+            BOOST_CHECK_EQUAL(results[0].phantom_node.forward_segment_id.id, 1);
+        }
+
+        {
+            auto results = query.NearestPhantomNodeWithAlternativeFromBigComponent(
+                input, osrm::engine::Approach::UNRESTRICTED);
+            BOOST_CHECK(results.first.IsValid());
+            BOOST_CHECK_EQUAL(results.first.forward_segment_id.id,
+                              results.second.forward_segment_id.id);
+        }
+    }
+
+    const auto metrics = cache.GetMetrics();
+    BOOST_CHECK_EQUAL(metrics.values.at("entries").get<util::json::Number>().value, 4);
+    BOOST_CHECK_EQUAL(metrics.values.at("hits").get<util::json::Number>().value, 4);
+    BOOST_CHECK_EQUAL(metrics.values.at("misses").get<util::json::Number>().value, 4);
+}
+
+BOOST_FIXTURE_TEST_CASE(query_group_test, TestRandomGraphFixture_MultipleLevels)
+{
+    std::string leaves_path;
+    std::string nodes_path;
+    build_rtree<TestRandomGraphFixture_MultipleLevels>(
+        "test_query_group", this, leaves_path, nodes_path);
+    TestStaticRTree rtree(nodes_path, leaves_path, coords);
+
+    std::mt19937 g(RANDOM_SEED);
+    std::uniform_int_distribution<> lat_udist(WORLD_MIN_LAT, WORLD_MAX_LAT);
+    std::uniform_int_distribution<> lon_udist(WORLD_MIN_LON, WORLD_MAX_LON);
+    std::uniform_int_distribution<> offset_udist(0, COORDINATE_PRECISION);
+
+    // a group of queries close to each other and one spread over the world
+    std::vector<Coordinate> close_queries;
+    std::vector<Coordinate> spread_queries;
+    const auto center_lon = lon_udist(g) / 2;
+    const auto center_lat = lat_udist(g) / 2;
+    for (unsigned i = 0; i < 50; i++)
+    {
+        close_queries.emplace_back(FixedLongitude{center_lon + offset_udist(g)},
+                                   FixedLatitude{center_lat + offset_udist(g)});
+        spread_queries.emplace_back(FixedLongitude{lon_udist(g)}, FixedLatitude{lat_udist(g)});
+    }
+
+    for (const auto &queries : {close_queries, spread_queries})
+    {
+        auto group = rtree.MakeQueryGroup(queries.begin(), queries.end());
+        for (const auto &q : queries)
+        {
+            const auto result = rtree.Nearest(q, 3);
+            const auto group_result = rtree.Nearest(
+                group,
+                q,
+                [](const TestStaticRTree::CandidateSegment &) { return std::make_pair(true, true); },
+                [](const std::size_t num_results, const TestStaticRTree::CandidateSegment &) {
+                    return num_results >= 3;
+                });
+            BOOST_REQUIRE_EQUAL(result.size(), group_result.size());
+            for (std::size_t i = 0; i < result.size(); ++i)
+            {
+                BOOST_CHECK_CLOSE(
+                    coordinate_calculation::perpendicularDistance(
+                        coords[result[i].u], coords[result[i].v], q),
+                    coordinate_calculation::perpendicularDistance(
+                        coords[group_result[i].u], coords[group_result[i].v], q),
+                    0.0001);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(batch_nearest_tests)
+{
+    using Coord = std::pair<FloatLongitude, FloatLatitude>;
+    using Edge = std::pair<unsigned, unsigned>;
+
+    // a grid of horizontal streets
+    std::vector<Coord> grid_coords;
+    std::vector<Edge> grid_edges;
+    for (unsigned row = 0; row < 10; ++row)
+    {
+        for (unsigned column = 0; column < 10; ++column)
+        {
+            grid_coords.emplace_back(FloatLongitude{column * 0.01}, FloatLatitude{row * 0.01});
+            if (column > 0)
+            {
+                grid_edges.emplace_back(row * 10 + column - 1, row * 10 + column);
+            }
+        }
+    }
+    GraphFixture fixture(grid_coords, grid_edges);
+
+    std::string leaves_path;
+    std::string nodes_path;
+    build_rtree<GraphFixture, MiniStaticRTree>("test_batch", &fixture, leaves_path, nodes_path);
+    MiniStaticRTree rtree(nodes_path, leaves_path, fixture.coords);
+    TestDataFacade mockfacade;
+    engine::GeospatialQuery<MiniStaticRTree, TestDataFacade> query(
+        rtree, fixture.coords, mockfacade);
+
+    std::vector<Coordinate> inputs;
+    std::vector<boost::optional<double>> radiuses;
+    for (unsigned i = 0; i < 100; ++i)
+    {
+        inputs.emplace_back(FloatLongitude{(i * 37 % 100) * 0.001},
+                            FloatLatitude{(i * 59 % 100) * 0.001 + 0.00005});
+        radiuses.push_back(i % 3 == 0 ? boost::optional<double>{10.} : boost::optional<double>{});
+    }
+
+    const auto results = query.NearestPhantomNodes(inputs, 1, radiuses, {});
+    BOOST_REQUIRE_EQUAL(results.size(), inputs.size());
+    std::size_t in_radius = 0;
+    std::size_t out_of_radius = 0;
+    for (std::size_t i = 0; i < inputs.size(); ++i)
+    {
+        const auto expected =
+            radiuses[i] ? query.NearestPhantomNodes(
+                              inputs[i], 1, *radiuses[i], osrm::engine::Approach::UNRESTRICTED)
+                        : query.NearestPhantomNodes(
+                              inputs[i], 1, osrm::engine::Approach::UNRESTRICTED);
+        BOOST_REQUIRE_EQUAL(results[i].size(), expected.size());
+        if (radiuses[i])
+        {
+            in_radius += !expected.empty();
+            out_of_radius += expected.empty();
+        }
+        if (!expected.empty())
+        {
+            BOOST_CHECK_CLOSE(results[i].front().distance, expected.front().distance, 0.0001);
+            BOOST_CHECK_EQUAL(results[i].front().phantom_node.location,
+                              expected.front().phantom_node.location);
+        }
+    }
+    BOOST_CHECK_GT(in_radius, 0);
+    BOOST_CHECK_GT(out_of_radius, 0);
+}
+
 BOOST_AUTO_TEST_CASE(bbox_search_tests)
 {
     using Coord = std::pair<FloatLongitude, FloatLatitude>;